@@ -0,0 +1,15 @@
+#include "AttitudeDataBus.hpp"
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+SeqlockTopic<PMCommands> PMCommandsTopic;
+SeqlockTopic<IMU_Data_t> IMUDataTopic;
+SeqlockTopic<Airspeed_Data_t> AirspeedDataTopic;
+SeqlockTopic<SFOutput_t> SFOutputTopic;
+SeqlockTopic<PID_Output_t> PIDOutputTopic;
+SeqlockTopic<ChannelOut_t> ChannelOutTopic;
+SeqlockTopic<LatencySummary_t> LatencySummaryTopic;
+SeqlockTopic<AttitudeTaskStats_t> AttitudeTaskStatsTopic;
+SeqlockTopic<PathSetpoint_t> PathSetpointTopic;
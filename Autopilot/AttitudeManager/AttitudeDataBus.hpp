@@ -0,0 +1,33 @@
+/**
+ * Topics through which the attitude manager stages (and any other task) exchange data.
+ *
+ * Each topic has exactly one writer, the attitude manager state that produces the data. Any task may read a topic,
+ * either directly with read() or through its own SeqlockSubscriber if it needs to know whether the data is fresh.
+ * See SeqlockTopic.hpp for the guarantees this gives.
+ */
+
+#ifndef ATTITUDE_DATA_BUS_HPP
+#define ATTITUDE_DATA_BUS_HPP
+
+#include "SeqlockTopic.hpp"
+#include "AttitudeDatatypes.hpp"
+#include "GetFromPathManager.hpp"
+#include "SensorFusion.hpp"
+#include "LatencyTrace.hpp"
+#include "AttitudeTask.hpp"
+
+/***********************************************************************************************************************
+ * Topics
+ **********************************************************************************************************************/
+
+extern SeqlockTopic<PMCommands> PMCommandsTopic;            // written by fetchInstructionsMode
+extern SeqlockTopic<IMU_Data_t> IMUDataTopic;               // written by fetchSensorMeasurementsMode
+extern SeqlockTopic<Airspeed_Data_t> AirspeedDataTopic;     // written by fetchSensorMeasurementsMode
+extern SeqlockTopic<SFOutput_t> SFOutputTopic;              // written by sensorFusionMode
+extern SeqlockTopic<PID_Output_t> PIDOutputTopic;           // written by PIDloopMode
+extern SeqlockTopic<ChannelOut_t> ChannelOutTopic;          // written by OutputMixingMode
+extern SeqlockTopic<LatencySummary_t> LatencySummaryTopic;  // written by sendToSafetyMode, through LatencyTrace
+extern SeqlockTopic<AttitudeTaskStats_t> AttitudeTaskStatsTopic; // written by AttitudeTask
+extern SeqlockTopic<PathSetpoint_t> PathSetpointTopic;      // written by PathGuidance, every PATH_TO_ATTITUDE_RATE_RATIO cycles
+
+#endif
@@ -1,6 +1,11 @@
 #ifndef ATTITUDE_DATATYPES_HPP
 #define ATTITUDE_DATATYPES_HPP
 
+#include <stdint.h>
+
+// Every structure derived from an IMU sample carries the sample's TimeStamp_GetMicroseconds() stamp along,
+// see LatencyTrace.hpp
+
 // Output of the PID module and input to the OutputMixing module
 typedef struct
 {
@@ -9,6 +14,8 @@ typedef struct
     float yawPercent;
     float throttlePercent;
 
+    uint32_t sampleTimeUs;
+
 } PID_Output_t;
 
 #ifdef SPIKE
@@ -22,6 +29,16 @@ typedef struct
 #define AILERON_OUT_CHANNEL 2
 #define THROTTLE_OUT_CHANNEL 3
 
+#define NUM_MIXED_CHANNELS 4
+
+// Output of the OutputMixing module and input to the SendToSafety module
+struct ChannelOut_t
+{
+    float channel[NUM_MIXED_CHANNELS]; // percentage each channel should be set to
+
+    uint32_t sampleTimeUs;
+};
+
 // New datatypes store the IMU and Airspeed data so SensorFusion and other modules
 // do not need to include "IMU.hpp" and "airspeed.hpp"
 struct IMU_Data_t
@@ -33,6 +50,8 @@ struct IMU_Data_t
     bool isDataNew; 
     int sensorStatus; 
     float utcTime; 
+    uint32_t sampleTimeUs;  // when the sample was taken
+    float deltaTime;        // s, the interval the rates are means over, 0 if the driver does not report one
 };
 
 struct Airspeed_Data_t
@@ -0,0 +1,240 @@
+#include "AttitudeRecorder.hpp"
+
+#include <string.h>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+static const uint8_t RECORDING_MAGIC[4] = {'Z', 'P', 'A', 'R'};
+
+static AttitudeRecorder_Sink recorderSink = nullptr;
+static void *recorderContext = nullptr;
+static AttitudeFrame_t pendingFrame;
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+static uint8_t *putFloat(uint8_t *buffer, float value);
+static uint8_t *putDouble(uint8_t *buffer, double value);
+static uint8_t *putInt16(uint8_t *buffer, int value);
+static uint8_t *putUint32(uint8_t *buffer, uint32_t value);
+static uint8_t *putBool(uint8_t *buffer, bool value);
+
+static const uint8_t *getFloat(const uint8_t *buffer, float *value);
+static const uint8_t *getDouble(const uint8_t *buffer, double *value);
+static const uint8_t *getInt16(const uint8_t *buffer, int *value);
+static const uint8_t *getUint32(const uint8_t *buffer, uint32_t *value);
+static const uint8_t *getBool(const uint8_t *buffer, bool *value);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+void AttitudeRecorder_Start(AttitudeRecorder_Sink sink, void *context)
+{
+    uint8_t header[ATTITUDE_RECORDING_HEADER_SIZE];
+
+    recorderSink = sink;
+    recorderContext = context;
+    memset(&pendingFrame, 0, sizeof(pendingFrame));
+
+    if (recorderSink != nullptr)
+    {
+        recorderSink(header, AttitudeRecorder_EncodeHeader(header), recorderContext);
+    }
+}
+
+void AttitudeRecorder_Stop(void)
+{
+    recorderSink = nullptr;
+    recorderContext = nullptr;
+}
+
+void AttitudeRecorder_RecordCommands(const PMCommands *Commands, int errorCode)
+{
+    if (recorderSink == nullptr)
+    {
+        return;
+    }
+
+    pendingFrame.commands = *Commands;
+    pendingFrame.commandsErrorCode = errorCode;
+}
+
+void AttitudeRecorder_RecordSensors(const IMU_Data_t *imudata, const Airspeed_Data_t *airspeeddata, int errorCode)
+{
+    uint8_t frame[ATTITUDE_FRAME_SIZE];
+
+    if (recorderSink == nullptr)
+    {
+        return;
+    }
+
+    pendingFrame.imu = *imudata;
+    pendingFrame.airspeed = *airspeeddata;
+    pendingFrame.sensorErrorCode = errorCode;
+
+    recorderSink(frame, AttitudeFrame_Encode(&pendingFrame, frame), recorderContext);
+}
+
+size_t AttitudeRecorder_EncodeHeader(uint8_t *buffer)
+{
+    uint8_t *cursor = buffer;
+
+    memcpy(cursor, RECORDING_MAGIC, sizeof(RECORDING_MAGIC));
+    cursor += sizeof(RECORDING_MAGIC);
+
+    cursor = putInt16(cursor, ATTITUDE_RECORDING_VERSION);
+    cursor = putInt16(cursor, ATTITUDE_FRAME_SIZE);
+
+    return cursor - buffer;
+}
+
+bool AttitudeRecorder_CheckHeader(const uint8_t *buffer)
+{
+    int version;
+    int frameSize;
+
+    if (memcmp(buffer, RECORDING_MAGIC, sizeof(RECORDING_MAGIC)) != 0)
+    {
+        return false;
+    }
+
+    getInt16(getInt16(buffer + sizeof(RECORDING_MAGIC), &version), &frameSize);
+
+    return version == ATTITUDE_RECORDING_VERSION && frameSize == ATTITUDE_FRAME_SIZE;
+}
+
+size_t AttitudeFrame_Encode(const AttitudeFrame_t *Frame, uint8_t *buffer)
+{
+    uint8_t *cursor = buffer;
+
+    cursor = putFloat(cursor, Frame->commands.roll);
+    cursor = putFloat(cursor, Frame->commands.pitch);
+    cursor = putFloat(cursor, Frame->commands.yaw);
+    cursor = putFloat(cursor, Frame->commands.airspeed);
+    cursor = putInt16(cursor, Frame->commandsErrorCode);
+
+    cursor = putFloat(cursor, Frame->imu.magx);
+    cursor = putFloat(cursor, Frame->imu.magy);
+    cursor = putFloat(cursor, Frame->imu.magz);
+    cursor = putFloat(cursor, Frame->imu.accx);
+    cursor = putFloat(cursor, Frame->imu.accy);
+    cursor = putFloat(cursor, Frame->imu.accz);
+    cursor = putFloat(cursor, Frame->imu.gyrx);
+    cursor = putFloat(cursor, Frame->imu.gyry);
+    cursor = putFloat(cursor, Frame->imu.gyrz);
+    cursor = putFloat(cursor, Frame->imu.utcTime);
+    cursor = putUint32(cursor, Frame->imu.sampleTimeUs);
+    cursor = putFloat(cursor, Frame->imu.deltaTime);
+    cursor = putInt16(cursor, Frame->imu.sensorStatus);
+    cursor = putBool(cursor, Frame->imu.isDataNew);
+
+    cursor = putDouble(cursor, Frame->airspeed.airspeed);
+    cursor = putFloat(cursor, Frame->airspeed.utcTime);
+    cursor = putInt16(cursor, Frame->airspeed.sensorStatus);
+    cursor = putBool(cursor, Frame->airspeed.isDataNew);
+    cursor = putInt16(cursor, Frame->sensorErrorCode);
+
+    return cursor - buffer;
+}
+
+void AttitudeFrame_Decode(const uint8_t *buffer, AttitudeFrame_t *Frame)
+{
+    const uint8_t *cursor = buffer;
+
+    cursor = getFloat(cursor, &Frame->commands.roll);
+    cursor = getFloat(cursor, &Frame->commands.pitch);
+    cursor = getFloat(cursor, &Frame->commands.yaw);
+    cursor = getFloat(cursor, &Frame->commands.airspeed);
+    cursor = getInt16(cursor, &Frame->commandsErrorCode);
+
+    cursor = getFloat(cursor, &Frame->imu.magx);
+    cursor = getFloat(cursor, &Frame->imu.magy);
+    cursor = getFloat(cursor, &Frame->imu.magz);
+    cursor = getFloat(cursor, &Frame->imu.accx);
+    cursor = getFloat(cursor, &Frame->imu.accy);
+    cursor = getFloat(cursor, &Frame->imu.accz);
+    cursor = getFloat(cursor, &Frame->imu.gyrx);
+    cursor = getFloat(cursor, &Frame->imu.gyry);
+    cursor = getFloat(cursor, &Frame->imu.gyrz);
+    cursor = getFloat(cursor, &Frame->imu.utcTime);
+    cursor = getUint32(cursor, &Frame->imu.sampleTimeUs);
+    cursor = getFloat(cursor, &Frame->imu.deltaTime);
+    cursor = getInt16(cursor, &Frame->imu.sensorStatus);
+    cursor = getBool(cursor, &Frame->imu.isDataNew);
+
+    cursor = getDouble(cursor, &Frame->airspeed.airspeed);
+    cursor = getFloat(cursor, &Frame->airspeed.utcTime);
+    cursor = getInt16(cursor, &Frame->airspeed.sensorStatus);
+    cursor = getBool(cursor, &Frame->airspeed.isDataNew);
+    getInt16(cursor, &Frame->sensorErrorCode);
+}
+
+// Status and error codes are small (-1, 0, 1 ...) so 16 bits are plenty.
+// memcpy is used so unaligned buffers are fine.
+
+static uint8_t *putFloat(uint8_t *buffer, float value)
+{
+    memcpy(buffer, &value, sizeof(value));
+    return buffer + sizeof(value);
+}
+
+static uint8_t *putDouble(uint8_t *buffer, double value)
+{
+    memcpy(buffer, &value, sizeof(value));
+    return buffer + sizeof(value);
+}
+
+static uint8_t *putInt16(uint8_t *buffer, int value)
+{
+    int16_t narrowed = (int16_t) value;
+    memcpy(buffer, &narrowed, sizeof(narrowed));
+    return buffer + sizeof(narrowed);
+}
+
+static uint8_t *putUint32(uint8_t *buffer, uint32_t value)
+{
+    memcpy(buffer, &value, sizeof(value));
+    return buffer + sizeof(value);
+}
+
+static uint8_t *putBool(uint8_t *buffer, bool value)
+{
+    *buffer = value ? 1 : 0;
+    return buffer + 1;
+}
+
+static const uint8_t *getFloat(const uint8_t *buffer, float *value)
+{
+    memcpy(value, buffer, sizeof(*value));
+    return buffer + sizeof(*value);
+}
+
+static const uint8_t *getDouble(const uint8_t *buffer, double *value)
+{
+    memcpy(value, buffer, sizeof(*value));
+    return buffer + sizeof(*value);
+}
+
+static const uint8_t *getInt16(const uint8_t *buffer, int *value)
+{
+    int16_t narrowed;
+    memcpy(&narrowed, buffer, sizeof(narrowed));
+    *value = narrowed;
+    return buffer + sizeof(narrowed);
+}
+
+static const uint8_t *getUint32(const uint8_t *buffer, uint32_t *value)
+{
+    memcpy(value, buffer, sizeof(*value));
+    return buffer + sizeof(*value);
+}
+
+static const uint8_t *getBool(const uint8_t *buffer, bool *value)
+{
+    *value = (*buffer != 0);
+    return buffer + 1;
+}
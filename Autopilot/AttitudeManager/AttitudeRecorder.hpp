@@ -0,0 +1,107 @@
+/**
+ * Records the inputs of the attitude manager so that a flight can be replayed on a workstation.
+ *
+ * Every cycle the attitude manager gets its commands from PM_GetCommands and its sensor data from
+ * SensorMeasurements_GetResult. The recorder captures both (along with the error codes they returned) as one
+ * compact binary frame and hands the frame to a sink. Feeding the frames back through the same code with the
+ * attitudeReplay host tool reproduces the exact actuator commands of the recorded flight. On the autopilot the sink is
+ * the RAM ring of AttitudeRecordingRing.hpp, which telemetry drains.
+ *
+ * A recording is a header (see AttitudeRecorder_EncodeHeader) followed by ATTITUDE_FRAME_SIZE byte frames.
+ * All values are stored little endian, which is the native byte order of both the autopilot and workstations.
+ */
+
+#ifndef ATTITUDE_RECORDER_HPP
+#define ATTITUDE_RECORDER_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "AttitudeDatatypes.hpp"
+#include "GetFromPathManager.hpp"
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define ATTITUDE_RECORDING_VERSION 3
+#define ATTITUDE_RECORDING_HEADER_SIZE 8
+#define ATTITUDE_FRAME_SIZE 86
+
+// Everything the attitude manager consumed during one cycle
+struct AttitudeFrame_t
+{
+    PMCommands commands;
+    int commandsErrorCode;          // what PM_GetCommands returned
+
+    IMU_Data_t imu;
+    Airspeed_Data_t airspeed;
+    int sensorErrorCode;            // what SensorMeasurements_GetResult returned
+};
+
+/**
+ * Receives complete frames (and the recording header). Runs in the context of the attitude manager, so it must be
+ * quick: copy the bytes somewhere and return.
+ */
+typedef void (*AttitudeRecorder_Sink)(const uint8_t *data, size_t length, void *context);
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+/**
+* Starts a recording. The header is handed to the sink right away.
+* @param[in]    sink        where the header and the frames should go.
+* @param[in]    context     passed back untouched to the sink.
+*/
+void AttitudeRecorder_Start(AttitudeRecorder_Sink sink, void *context);
+
+/**
+* Stops the recording. Does nothing if no recording is in progress.
+*/
+void AttitudeRecorder_Stop(void);
+
+/**
+* Captures the commands the attitude manager fetched at the start of the cycle.
+* @param[in]    Commands    commands returned by PM_GetCommands.
+* @param[in]    errorCode   error code returned by PM_GetCommands.
+*/
+void AttitudeRecorder_RecordCommands(const PMCommands *Commands, int errorCode);
+
+/**
+* Captures the sensor data of the cycle. This completes the frame, which is handed to the sink.
+* @param[in]    imudata         IMU data returned by SensorMeasurements_GetResult.
+* @param[in]    airspeeddata    airspeed data returned by SensorMeasurements_GetResult.
+* @param[in]    errorCode       error code returned by SensorMeasurements_GetResult.
+*/
+void AttitudeRecorder_RecordSensors(const IMU_Data_t *imudata, const Airspeed_Data_t *airspeeddata, int errorCode);
+
+/**
+* Writes the recording header.
+* @param[out]   buffer      at least ATTITUDE_RECORDING_HEADER_SIZE bytes.
+* @return                   the number of bytes written.
+*/
+size_t AttitudeRecorder_EncodeHeader(uint8_t *buffer);
+
+/**
+* @param[in]    buffer      ATTITUDE_RECORDING_HEADER_SIZE bytes.
+* @return                   true if the buffer holds a header this code can replay.
+*/
+bool AttitudeRecorder_CheckHeader(const uint8_t *buffer);
+
+/**
+* Serialises a frame.
+* @param[in]    Frame       the frame.
+* @param[out]   buffer      at least ATTITUDE_FRAME_SIZE bytes.
+* @return                   the number of bytes written.
+*/
+size_t AttitudeFrame_Encode(const AttitudeFrame_t *Frame, uint8_t *buffer);
+
+/**
+* Deserialises a frame.
+* @param[in]    buffer      ATTITUDE_FRAME_SIZE bytes.
+* @param[out]   Frame       the frame.
+*/
+void AttitudeFrame_Decode(const uint8_t *buffer, AttitudeFrame_t *Frame);
+
+#endif
@@ -0,0 +1,75 @@
+#include "AttitudeRecordingRing.hpp"
+
+#include <atomic>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+static_assert((ATTITUDE_RECORDING_RING_SIZE & (ATTITUDE_RECORDING_RING_SIZE - 1)) == 0,
+              "The byte counts wrap around at 2^32, the ring size must divide that");
+
+static uint8_t ring[ATTITUDE_RECORDING_RING_SIZE];
+
+// Free running byte counts, the index into the ring is the count modulo its size. Only the attitude task moves
+// written and only the telemetry task moves taken.
+static std::atomic<uint32_t> written(0);
+static std::atomic<uint32_t> taken(0);
+
+static std::atomic<uint32_t> dropped(0);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+void AttitudeRecordingRing_Reset(void)
+{
+    written.store(0, std::memory_order_relaxed);
+    taken.store(0, std::memory_order_relaxed);
+    dropped.store(0, std::memory_order_relaxed);
+}
+
+void AttitudeRecordingRing_Sink(const uint8_t *data, size_t length, void *context)
+{
+    (void) context;
+
+    uint32_t head = written.load(std::memory_order_relaxed);
+    uint32_t used = head - taken.load(std::memory_order_acquire);
+
+    if (length > ATTITUDE_RECORDING_RING_SIZE - used)
+    {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    for (size_t i = 0; i < length; i++)
+    {
+        ring[(head + i) % ATTITUDE_RECORDING_RING_SIZE] = data[i];
+    }
+
+    // The bytes are in place before the reader can see them
+    written.store(head + (uint32_t) length, std::memory_order_release);
+}
+
+size_t AttitudeRecordingRing_Read(uint8_t *buffer, size_t maxLength)
+{
+    uint32_t tail = taken.load(std::memory_order_relaxed);
+    uint32_t available = written.load(std::memory_order_acquire) - tail;
+
+    size_t length = (available < maxLength) ? available : maxLength;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        buffer[i] = ring[(tail + i) % ATTITUDE_RECORDING_RING_SIZE];
+    }
+
+    // The bytes are copied out before the writer can reuse them
+    taken.store(tail + (uint32_t) length, std::memory_order_release);
+
+    return length;
+}
+
+uint32_t AttitudeRecordingRing_GetDropped(void)
+{
+    return dropped.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,51 @@
+/**
+ * The sink the autopilot records into (see AttitudeRecorder.hpp): a ring in RAM that telemetry drains a chunk at a
+ * time and sends to the ground, where the chunks are appended back together into a recording for attitudeReplay.
+ *
+ * The attitude task writes and the telemetry task reads, one of each, without a lock. A write is taken whole or not
+ * at all: a frame that does not fit is dropped and counted, never split. A recording with drops still decodes, but it
+ * no longer replays to the outputs of the flight.
+ */
+
+#ifndef ATTITUDE_RECORDING_RING_HPP
+#define ATTITUDE_RECORDING_RING_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define ATTITUDE_RECORDING_RING_SIZE 8192  // bytes, about half a second of frames at the attitude rate
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+/**
+* Empties the ring and clears the drop count. Only while neither task is using it.
+*/
+void AttitudeRecordingRing_Reset(void);
+
+/**
+* An AttitudeRecorder_Sink, pass it to AttitudeRecorder_Start. Called by the attitude task only.
+* @param[in]    data, length    the header or a frame.
+* @param[in]    context         unused.
+*/
+void AttitudeRecordingRing_Sink(const uint8_t *data, size_t length, void *context);
+
+/**
+* Takes the oldest bytes out of the ring. Called by the telemetry task only.
+* @param[out]   buffer          where the bytes go.
+* @param[in]    maxLength       size of buffer.
+* @return                       the number of bytes taken, 0 if the ring is empty.
+*/
+size_t AttitudeRecordingRing_Read(uint8_t *buffer, size_t maxLength);
+
+/**
+* @return                       the number of writes dropped because the ring was full.
+*/
+uint32_t AttitudeRecordingRing_GetDropped(void);
+
+#endif
@@ -0,0 +1,74 @@
+#include "AttitudeTask.hpp"
+#include "AttitudeDataBus.hpp"
+#include "TimeStamp.h"
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+// A cycle is 6 states long, anything longer means the state machine is stuck
+#define MAX_STEPS_PER_CYCLE 16
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+AttitudeTask::AttitudeTask(AttitudeTickSource &_tickSource, uint32_t rateHz) : tickSource(_tickSource), jitter(ATTITUDE_JITTER_BIN_WIDTH_US)
+{
+    stats.periodUs = 1000000UL / rateHz;
+    stats.cycles = 0;
+    stats.missedTicks = 0;
+    stats.overruns = 0;
+    stats.timeouts = 0;
+    stats.lastJitterUs = 0;
+    stats.maxJitterUs = 0;
+    stats.lastCycleUs = 0;
+    stats.maxCycleUs = 0;
+    stats.inFailureMode = false;
+}
+
+bool AttitudeTask::runOnce()
+{
+    uint32_t ticks = tickSource.waitForTick();
+
+    if (ticks == 0)
+    {
+        stats.timeouts++;
+        AttitudeTaskStatsTopic.publish(stats);
+        return false;
+    }
+
+    stats.missedTicks += ticks - 1;
+
+    uint32_t tickTimeUs = tickSource.getTickTimeUs();
+    uint32_t startJitterUs = TimeStamp_GetMicroseconds() - tickTimeUs;
+
+    runCycle();
+
+    uint32_t cycleUs = TimeStamp_GetMicroseconds() - tickTimeUs;
+
+    stats.cycles++;
+    stats.lastJitterUs = startJitterUs;
+    stats.maxJitterUs = (startJitterUs > stats.maxJitterUs) ? startJitterUs : stats.maxJitterUs;
+    stats.lastCycleUs = cycleUs;
+    stats.maxCycleUs = (cycleUs > stats.maxCycleUs) ? cycleUs : stats.maxCycleUs;
+    stats.overruns += (cycleUs > stats.periodUs) ? 1 : 0;
+    stats.inFailureMode = (attMng.getStatus() == FAILURE_MODE);
+
+    jitter.add(startJitterUs);
+
+    AttitudeTaskStatsTopic.publish(stats);
+
+    return true;
+}
+
+void AttitudeTask::runCycle()
+{
+    int steps = 0;
+
+    do
+    {
+        attMng.execute();
+        steps++;
+    } while (attMng.getStatus() == IN_CYCLE && steps < MAX_STEPS_PER_CYCLE);
+}
@@ -0,0 +1,91 @@
+/**
+ * Runs the attitude manager at a fixed rate, one full cycle per tick of a periodic time source.
+ *
+ * On the autopilot the ticks come from TIM10, whose interrupt wakes the attitude task with a direct to task
+ * notification (see Src/AttitudeTimerTick.cpp). On the host the tests provide their own tick source. Everything in
+ * here is independent of the RTOS and of the hardware.
+ *
+ * Each cycle records
+ *  - the start jitter: how long after the tick the cycle actually started
+ *  - overruns: cycles that were still running when the next tick was due, or ticks that were never serviced
+ */
+
+#ifndef ATTITUDE_TASK_HPP
+#define ATTITUDE_TASK_HPP
+
+#include <stdint.h>
+
+#include "attitudeManager.hpp"
+#include "RollingHistogram.hpp"
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define ATTITUDE_TASK_RATE_HZ 200
+
+#define ATTITUDE_JITTER_BINS 32
+#define ATTITUDE_JITTER_BIN_WIDTH_US 5      // 160 us of range, anything later lands in the last bin
+#define ATTITUDE_JITTER_WINDOW 256          // cycles
+
+typedef RollingHistogram<ATTITUDE_JITTER_BINS, ATTITUDE_JITTER_WINDOW> JitterHistogram;
+
+struct AttitudeTaskStats_t
+{
+    uint32_t periodUs;
+    uint32_t cycles;            // completed cycles
+    uint32_t missedTicks;       // ticks that passed without a cycle being started for them
+    uint32_t overruns;          // cycles that ended after the next tick was due
+    uint32_t timeouts;          // waits that gave up without a tick
+    uint32_t lastJitterUs;
+    uint32_t maxJitterUs;
+    uint32_t lastCycleUs;       // time from the tick to the end of the cycle
+    uint32_t maxCycleUs;
+    bool inFailureMode;
+};
+
+// Where the ticks come from
+class AttitudeTickSource
+{
+    public:
+        /**
+        * Blocks until the next tick.
+        * @return   the number of ticks since the previous call: 1 normally, more if ticks were missed,
+        *           0 if the wait timed out.
+        */
+        virtual uint32_t waitForTick() = 0;
+
+        /**
+        * @return   TimeStamp_GetMicroseconds() at the most recent tick.
+        */
+        virtual uint32_t getTickTimeUs() = 0;
+};
+
+class AttitudeTask
+{
+    public:
+        AttitudeTask(AttitudeTickSource &_tickSource, uint32_t rateHz);
+
+        /**
+        * Waits for the next tick and runs one attitude manager cycle.
+        * @return   false if no tick came.
+        */
+        bool runOnce();
+
+        const AttitudeTaskStats_t& getStats() const {return stats;}
+        const JitterHistogram& getJitterHistogram() const {return jitter;}
+        attitudeManager& getAttitudeManager() {return attMng;}
+
+    private:
+        AttitudeTask(const AttitudeTask& other);
+        AttitudeTask& operator =(const AttitudeTask& other);
+
+        void runCycle();
+
+        AttitudeTickSource &tickSource;
+        attitudeManager attMng;
+        AttitudeTaskStats_t stats;
+        JitterHistogram jitter;
+};
+
+#endif
@@ -1,13 +1,34 @@
 #include "GetFromPathManager.hpp"
+#include "SetpointInterpolator.hpp"
+#include "AttitudeDataBus.hpp"
+#include "AutoSteer.hpp"
+#include "TimeStamp.h"
+
+/***********************************************************************************************************************
+ * Variables
+ **********************************************************************************************************************/
+
+static const PMCommands LEVEL_AT_CRUISING_SPEED = {0.0f, 0.0f, 0.0f, CRUISING_SPEED};
+
+static SeqlockSubscriber<PathSetpoint_t> setpoints(PathSetpointTopic);
+static SetpointInterpolator interpolator(PATH_GUIDANCE_PERIOD_US, LEVEL_AT_CRUISING_SPEED);
 
 /***********************************************************************************************************************
  * Code
  **********************************************************************************************************************/
 
-// dummy implementation until real one is required.
 PMError_t PM_GetCommands(PMCommands *Commands)
 {
-	(void) Commands;
+	uint32_t nowUs = TimeStamp_GetMicroseconds();
+
+	// If the path manager is mid publish, the ramp towards the previous setpoint simply carries on
+	PathSetpoint_t setpoint;
+	if (setpoints.poll(setpoint) == SEQLOCK_READ_NEW)
+	{
+		interpolator.setTarget(setpoint, nowUs);
+	}
+
+	interpolator.getCommands(nowUs, *Commands);
 
 	PMError_t errorStruct;
 	errorStruct.errorCode = 0;
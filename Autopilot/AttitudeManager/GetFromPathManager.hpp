@@ -1,13 +1,28 @@
 /**
  * Gets the commanded orientation and airspeed from the path manager.
  * Author: Anthony Berbari
+ *
+ * The path manager runs once every PATH_TO_ATTITUDE_RATE_RATIO attitude cycles and publishes a time stamped
+ * PathSetpoint_t on PathSetpointTopic (see PathGuidance.hpp). PM_GetCommands interpolates between those setpoints, so
+ * the commands the attitude manager gets change a little every cycle instead of stepping at the path manager rate.
  */
 
 #ifndef GET_FROM_PATH_MANAGER_HPP
 #define GET_FROM_PATH_MANAGER_HPP
 
+#include <stdint.h>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define PATH_TO_ATTITUDE_RATE_RATIO 10 // attitude cycles per path manager update, 20 Hz at the 200 Hz attitude rate
+
+// Nominal time between two setpoints. ATTITUDE_TASK_RATE_HZ comes from AttitudeTask.hpp.
+#define PATH_GUIDANCE_PERIOD_US (PATH_TO_ATTITUDE_RATE_RATIO * (1000000UL / ATTITUDE_TASK_RATE_HZ))
+
 struct PMCommands{
-	float roll, pitch, yaw;	// commanded orientation (radians)
+	float roll, pitch, yaw;	// commanded orientation (radians), PIDloopMode passes the yaw to the rudder as a percentage
 	float airspeed;			// commanded airspeed m/s
 };
 
@@ -15,8 +30,20 @@ struct PMError_t{
     int errorCode;
 };
 
+struct PathSetpoint_t{
+	float roll, pitch;		// radians
+	float rudder;			// percent, -100 to 100
+	float airspeed;			// m/s
+	uint32_t timeUs;		// TimeStamp_GetMicroseconds() when the path manager computed the setpoint
+};
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
 /**
 * Communicates with the higher level state machine to retrieve orientation and airspeed commands.
+* Until the path manager publishes its first setpoint the commands are level flight at cruising speed.
 * @param[out]	Commands 	Pointer to the struct containing the commands.
 * @return 					error struct
 */
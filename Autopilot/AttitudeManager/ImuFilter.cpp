@@ -0,0 +1,163 @@
+/**
+ * IMU pre-filtering, see ImuFilter.hpp.
+ */
+
+#include "ImuFilter.hpp"
+#include "AttitudeTask.hpp"
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+// The attitude cycle runs at 200 Hz on means of 5 IMU samples, which already takes the worst of the aliasing off
+#define DEFAULT_GYRO_CUTOFF_HZ 50.0f
+#define DEFAULT_ACCEL_CUTOFF_HZ 20.0f
+#define DEFAULT_MAG_CUTOFF_HZ 10.0f
+#define DEFAULT_NOTCH_Q 2.0f
+#define DEFAULT_DYNAMIC_NOTCH_MIN_HZ 20.0f
+#define DEFAULT_DYNAMIC_NOTCH_MAX_HZ 90.0f
+#define DEFAULT_DYNAMIC_NOTCH_Q 3.0f
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+ImuFilterConfig_t ImuFilter_DefaultConfig()
+{
+    ImuFilterConfig_t config;
+
+    config.sampleRateHz = ATTITUDE_TASK_RATE_HZ;
+    config.gyroCutoffHz = DEFAULT_GYRO_CUTOFF_HZ;
+    config.accelCutoffHz = DEFAULT_ACCEL_CUTOFF_HZ;
+    config.magCutoffHz = DEFAULT_MAG_CUTOFF_HZ;
+    config.notchHz = 0.0f;
+    config.notchQ = DEFAULT_NOTCH_Q;
+    config.dynamicNotch = true;
+    config.dynamicNotchMinHz = DEFAULT_DYNAMIC_NOTCH_MIN_HZ;
+    config.dynamicNotchMaxHz = DEFAULT_DYNAMIC_NOTCH_MAX_HZ;
+    config.dynamicNotchQ = DEFAULT_DYNAMIC_NOTCH_Q;
+
+    return config;
+}
+
+ImuFilter::ImuFilter(const ImuFilterConfig_t &_config) : config(_config), analyser(analyserConfig()), primed(false)
+{
+    configure(_config);
+
+    for (int channel = 0; channel < IMU_FILTER_CHANNELS; channel++)
+    {
+        lastOutput[channel] = 0.0f;
+    }
+}
+
+void ImuFilter::reset()
+{
+    analyser.reset();
+
+    for (int axis = 0; axis < VIBRATION_AXES; axis++)
+    {
+        retuneDynamicNotches(axis);
+    }
+
+    primed = false;
+}
+
+void ImuFilter::configure(const ImuFilterConfig_t &_config)
+{
+    config = _config;
+    analyser.configure(analyserConfig());
+
+    const float cutoffs[3] = {config.gyroCutoffHz, config.accelCutoffHz, config.magCutoffHz};
+    BiquadCoefficients_t notch = Biquad_Notch(config.notchHz, config.sampleRateHz, config.notchQ);
+
+    for (int sensor = 0; sensor < 3; sensor++)
+    {
+        BiquadCoefficients_t lowPass = Biquad_LowPass(cutoffs[sensor], config.sampleRateHz, BIQUAD_BUTTERWORTH_Q);
+
+        for (int axis = 0; axis < 3; axis++)
+        {
+            int channel = 3 * sensor + axis;
+
+            bank.setSection(IMU_FILTER_LOW_PASS, channel, lowPass);
+            bank.setSection(IMU_FILTER_NOTCH, channel, (channel < IMU_FILTER_MAG) ? notch : Biquad_PassThrough());
+        }
+    }
+
+    // The analyser starts over, so do the notches it drives
+    for (int axis = 0; axis < VIBRATION_AXES; axis++)
+    {
+        retuneDynamicNotches(axis);
+    }
+}
+
+void ImuFilter::apply(IMU_Data_t &imudata)
+{
+    if (imudata.isDataNew || ! primed)
+    {
+        const float input[IMU_FILTER_CHANNELS] = {
+            imudata.gyrx, imudata.gyry, imudata.gyrz,
+            imudata.accx, imudata.accy, imudata.accz,
+            imudata.magx, imudata.magy, imudata.magz
+        };
+
+        if ( ! primed)
+        {
+            bank.prime(input);
+            primed = true;
+        }
+
+        // The analyser sees the gyro before the notches, or it would lose the peaks it put them on
+        if (config.dynamicNotch)
+        {
+            analyser.addSample(&input[IMU_FILTER_GYRO]);
+
+            int updatedAxis = analyser.step();
+
+            if (updatedAxis >= 0)
+            {
+                retuneDynamicNotches(updatedAxis);
+            }
+        }
+
+        bank.apply(input, lastOutput);
+    }
+
+    imudata.gyrx = lastOutput[IMU_FILTER_GYRO];
+    imudata.gyry = lastOutput[IMU_FILTER_GYRO + 1];
+    imudata.gyrz = lastOutput[IMU_FILTER_GYRO + 2];
+    imudata.accx = lastOutput[IMU_FILTER_ACCEL];
+    imudata.accy = lastOutput[IMU_FILTER_ACCEL + 1];
+    imudata.accz = lastOutput[IMU_FILTER_ACCEL + 2];
+    imudata.magx = lastOutput[IMU_FILTER_MAG];
+    imudata.magy = lastOutput[IMU_FILTER_MAG + 1];
+    imudata.magz = lastOutput[IMU_FILTER_MAG + 2];
+}
+
+VibrationAnalyserConfig_t ImuFilter::analyserConfig() const
+{
+    VibrationAnalyserConfig_t analyserConfig = VibrationAnalyser_DefaultConfig(config.sampleRateHz);
+
+    analyserConfig.minHz = config.dynamicNotchMinHz;
+    analyserConfig.maxHz = config.dynamicNotchMaxHz;
+
+    return analyserConfig;
+}
+
+// The filter state is kept, a notch that moves a little at a time does not need to start over
+void ImuFilter::retuneDynamicNotches(int axis)
+{
+    const float *peaks = analyser.getPeaks(axis);
+
+    for (int p = 0; p < VIBRATION_PEAKS; p++)
+    {
+        BiquadCoefficients_t notch = Biquad_PassThrough();
+
+        if (config.dynamicNotch)
+        {
+            notch = Biquad_Notch(peaks[p], config.sampleRateHz, config.dynamicNotchQ);
+        }
+
+        bank.setSection(IMU_FILTER_DYNAMIC_NOTCH + p, IMU_FILTER_GYRO + axis, notch);
+        bank.setSection(IMU_FILTER_DYNAMIC_NOTCH + p, IMU_FILTER_ACCEL + axis, notch);
+    }
+}
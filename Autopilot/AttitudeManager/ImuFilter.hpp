@@ -0,0 +1,95 @@
+/**
+ * Pre-filtering of the IMU measurements, between the sensor driver and everything that uses them (sensor fusion and,
+ * through the rates, the derivative terms of the PIDs).
+ *
+ * All nine channels go through one BiquadBank: a second order low pass per channel followed by a fixed notch on the
+ * gyro and the accelerometer, for a known vibration peak. The coefficients are computed from the configuration, once,
+ * and the bank runs at the rate of fetchSensorMeasurementsMode.
+ *
+ * The motor's vibration moves with the throttle, so a VibrationAnalyser also watches the raw gyro. Whenever it has
+ * new peaks for an axis, the dynamic notches of that axis' gyro and accelerometer channels are moved onto them.
+ */
+
+#ifndef IMU_FILTER_HPP
+#define IMU_FILTER_HPP
+
+#include "AttitudeDatatypes.hpp"
+#include "BiquadBank.hpp"
+#include "VibrationAnalyser.hpp"
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+// Channels of the bank
+#define IMU_FILTER_GYRO 0           // x y z
+#define IMU_FILTER_ACCEL 3
+#define IMU_FILTER_MAG 6
+#define IMU_FILTER_CHANNELS 9
+
+// Sections of the bank
+#define IMU_FILTER_LOW_PASS 0
+#define IMU_FILTER_NOTCH 1
+#define IMU_FILTER_DYNAMIC_NOTCH 2       // one per tracked peak
+#define IMU_FILTER_SECTIONS (IMU_FILTER_DYNAMIC_NOTCH + VIBRATION_PEAKS)
+
+// A cutoff or centre of 0 turns that filter off
+struct ImuFilterConfig_t
+{
+    float sampleRateHz;
+    float gyroCutoffHz;
+    float accelCutoffHz;
+    float magCutoffHz;
+    float notchHz;              // gyro and accelerometer
+    float notchQ;
+
+    bool dynamicNotch;
+    float dynamicNotchMinHz;    // band the vibration peaks are tracked in
+    float dynamicNotchMaxHz;
+    float dynamicNotchQ;
+};
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+// Runs at ATTITUDE_TASK_RATE_HZ with the fixed notch off and the dynamic notches on
+ImuFilterConfig_t ImuFilter_DefaultConfig();
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+class ImuFilter
+{
+    public:
+        explicit ImuFilter(const ImuFilterConfig_t &_config = ImuFilter_DefaultConfig());
+
+        // Recomputes the coefficients, the filter state is kept. The vibration peaks are searched for from scratch.
+        void configure(const ImuFilterConfig_t &_config);
+        const ImuFilterConfig_t& getConfig() const {return config;}
+
+        // The next sample primes the filters, see BiquadBank::prime. The tracked peaks are dropped.
+        void reset();
+
+        /**
+        * Filters the measurements in place. A sample that is not new is not run through the filters again, it gets
+        * the previous output.
+        */
+        void apply(IMU_Data_t &imudata);
+
+        // Centres of the dynamic notches of one axis in Hz, 0 where a notch is off
+        const float* getDynamicNotches(int axis) const {return analyser.getPeaks(axis);}
+
+    private:
+        VibrationAnalyserConfig_t analyserConfig() const;
+        void retuneDynamicNotches(int axis);
+
+        ImuFilterConfig_t config;
+        BiquadBank<IMU_FILTER_CHANNELS, IMU_FILTER_SECTIONS> bank;
+        VibrationAnalyser analyser;
+        bool primed;
+        float lastOutput[IMU_FILTER_CHANNELS];
+};
+
+#endif
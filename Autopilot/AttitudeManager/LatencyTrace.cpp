@@ -0,0 +1,92 @@
+#include "LatencyTrace.hpp"
+#include "AttitudeDataBus.hpp"
+#include "TimeStamp.h"
+
+#include <string.h>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+static LatencyHistogram histograms[NUM_LATENCY_STAGES] =
+{
+    LatencyHistogram(LATENCY_HISTOGRAM_BIN_WIDTH_US),
+    LatencyHistogram(LATENCY_HISTOGRAM_BIN_WIDTH_US),
+    LatencyHistogram(LATENCY_HISTOGRAM_BIN_WIDTH_US),
+    LatencyHistogram(LATENCY_HISTOGRAM_BIN_WIDTH_US),
+};
+
+static uint32_t tracedCycles = 0;
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+static void publishSummary(void);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+void LatencyTrace_Mark(_LatencyStage stage, uint32_t sampleTimeUs)
+{
+    // unsigned subtraction, so this survives the time base wrapping around
+    uint32_t ageUs = TimeStamp_GetMicroseconds() - sampleTimeUs;
+
+    histograms[stage].add(ageUs);
+
+    if (stage == LATENCY_STAGE_HANDOFF)
+    {
+        tracedCycles++;
+
+        if (tracedCycles % LATENCY_SUMMARY_PERIOD == 0)
+        {
+            publishSummary();
+        }
+    }
+}
+
+const LatencyHistogram& LatencyTrace_GetHistogram(_LatencyStage stage)
+{
+    return histograms[stage];
+}
+
+void LatencyTrace_Reset(void)
+{
+    for (int stage = 0; stage < NUM_LATENCY_STAGES; stage++)
+    {
+        histograms[stage].reset();
+    }
+
+    tracedCycles = 0;
+}
+
+bool LatencyTrace_GetSummary(LatencySummary_t *summary)
+{
+    uint32_t generation;
+
+    if ( ! LatencySummaryTopic.read(*summary, &generation) || (generation == 0))
+    {
+        memset(summary, 0, sizeof(*summary));
+        return false;
+    }
+
+    return true;
+}
+
+static void publishSummary(void)
+{
+    LatencySummary_t summary;
+
+    for (int stage = 0; stage < NUM_LATENCY_STAGES; stage++)
+    {
+        summary.latestUs[stage] = histograms[stage].getLatest();
+        summary.p50Us[stage] = histograms[stage].percentile(50);
+        summary.p99Us[stage] = histograms[stage].percentile(99);
+        summary.maxUs[stage] = histograms[stage].max();
+    }
+
+    summary.cycles = tracedCycles;
+
+    LatencySummaryTopic.publish(summary);
+}
@@ -0,0 +1,75 @@
+/**
+ * Measures how old an IMU sample is by the time each attitude manager stage is done with it.
+ *
+ * The IMU driver stamps each sample (IMUData_t::sampleTimeUs). The ICM20602 does it in Begin_Measuring, which the
+ * sensor bindings of fetchSensorMeasurementsMode call every cycle. The stamp travels with the data through
+ * SFOutput_t, PID_Output_t and ChannelOut_t and on into the interchip packet. With a driver that leaves the stamp
+ * unset the ages are meaningless. Each stage marks itself once it is done, which adds the age of the sample at that
+ * point to the stage's rolling histogram. The ages are cumulative: the hand-off figure is the full sensor to SPI
+ * latency, the difference between two stages is the time spent in between.
+ *
+ * Every LATENCY_SUMMARY_PERIOD cycles a summary is published on LatencySummaryTopic, telemetry reads it through
+ * LatencyTrace_GetSummary.
+ */
+
+#ifndef LATENCY_TRACE_HPP
+#define LATENCY_TRACE_HPP
+
+#include <stdint.h>
+
+#include "RollingHistogram.hpp"
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+enum _LatencyStage {LATENCY_STAGE_FUSION = 0, LATENCY_STAGE_PID, LATENCY_STAGE_MIX, LATENCY_STAGE_HANDOFF, NUM_LATENCY_STAGES};
+
+#define LATENCY_HISTOGRAM_BINS 64
+#define LATENCY_HISTOGRAM_BIN_WIDTH_US 50   // 3.2 ms of range, anything older lands in the last bin and reads as 3.2 ms
+#define LATENCY_HISTOGRAM_WINDOW 256        // cycles
+#define LATENCY_SUMMARY_PERIOD 16           // cycles
+
+typedef RollingHistogram<LATENCY_HISTOGRAM_BINS, LATENCY_HISTOGRAM_WINDOW> LatencyHistogram;
+
+// Age of the sample when each stage was done with it, in us. The percentiles and the maximum are bin edges and stop at
+// the histogram's range, latestUs is exact.
+struct LatencySummary_t
+{
+    uint32_t latestUs[NUM_LATENCY_STAGES];
+    uint32_t p50Us[NUM_LATENCY_STAGES];
+    uint32_t p99Us[NUM_LATENCY_STAGES];
+    uint32_t maxUs[NUM_LATENCY_STAGES];
+    uint32_t cycles;    // number of hand-offs traced since the last reset
+};
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+/**
+* Records that a stage is done with a sample. Must be called from the attitude manager task only.
+* @param[in]    stage           the stage that just finished.
+* @param[in]    sampleTimeUs    the time stamp the sample was taken at.
+*/
+void LatencyTrace_Mark(_LatencyStage stage, uint32_t sampleTimeUs);
+
+/**
+* @param[in]    stage       the stage.
+* @return                   the histogram of the stage, for the attitude manager task and host tests.
+*/
+const LatencyHistogram& LatencyTrace_GetHistogram(_LatencyStage stage);
+
+/**
+* Empties all histograms.
+*/
+void LatencyTrace_Reset(void);
+
+/**
+* Takes a snapshot of the last summary, for telemetry. Safe from any task.
+* @param[out]   summary     all zero until the first summary is published.
+* @return                   true if a summary was published since start up.
+*/
+bool LatencyTrace_GetSummary(LatencySummary_t *summary);
+
+#endif
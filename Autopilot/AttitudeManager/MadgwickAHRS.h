@@ -14,21 +14,87 @@
 #ifndef MadgwickAHRS_h
 #define MadgwickAHRS_h
 
+#include <stdint.h>
+
 #ifdef __cplusplus
-extern "C" {
+#include "SampleInterval.hpp"
 #endif
 
 //----------------------------------------------------------------------------------------------------
-// Variable declaration
-extern float betag;				// algorithm gain
-extern float q0, q1, q2, q3;	// quaternion of sensor frame relative to auxiliary frame
-extern float qDot1, qDot2, qDot3, qDot4; //rate of change of quaternion
+// Definitions
+
+#define MADGWICK_BETA_DEFAULT	0.1f		// 2 * proportional gain
+
+// Limits on the time step taken from sample timestamps, in s
+#define MADGWICK_MIN_DT			0.0002f		// 5 kHz, faster than any IMU we fly
+#define MADGWICK_MAX_DT			0.05f		// 20 Hz, the slowest rate fusion is expected to run at
+#define MADGWICK_GAP_DT			0.25f		// longer than this the gyro can not be integrated across
+
+#ifdef __cplusplus
+
+//----------------------------------------------------------------------------------------------------
+// Filter instance
+
+struct MadgwickQuaternion_t {
+	float q0, q1, q2, q3;
+};
+
+class MadgwickFilter {
+	public:
+		// Nominal sample frequency ATTITUDE_TASK_RATE_HZ, the rate sensor fusion runs at
+		MadgwickFilter();
+		explicit MadgwickFilter(float sampleFrequency, float beta = MADGWICK_BETA_DEFAULT);
+
+		// Integrate over the nominal sample period
+		void update(float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz) {update(gx, gy, gz, ax, ay, az, mx, my, mz, samplePeriod);}
+		void updateIMU(float gx, float gy, float gz, float ax, float ay, float az) {updateIMU(gx, gy, gz, ax, ay, az, samplePeriod);}
+
+		// Integrate over dt seconds, see getTimeStep
+		void update(float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz, float dt);
+		void updateIMU(float gx, float gy, float gz, float ax, float ay, float az, float dt);
+
+		/**
+		* Time step to integrate the sample taken at sampleTimeUs over, measured from the previous sample.
+		* Limited by MADGWICK_MIN_DT, MADGWICK_MAX_DT and MADGWICK_GAP_DT, see SampleInterval.hpp.
+		*/
+		float getTimeStep(uint32_t sampleTimeUs) {return interval.next(sampleTimeUs);}
+		uint32_t getGapCount() const {return interval.getGapCount();}
+
+		// Back to the identity quaternion and forgets the previous sample time, the gain and rate are kept
+		void reset();
+
+		void setBeta(float beta) {betag = beta;}
+		float getBeta() const {return betag;}
+
+		void setSampleFrequency(float sampleFrequency) {samplePeriod = 1.0f / sampleFrequency; interval.setNominalPeriod(samplePeriod);}
+		float getSampleFrequency() const {return 1.0f / samplePeriod;}
+
+		// quaternion of sensor frame relative to auxiliary frame
+		MadgwickQuaternion_t getQuaternion() const;
+		// rate of change of quaternion from the last update
+		MadgwickQuaternion_t getQuaternionRate() const;
+
+	private:
+		float betag;						// algorithm gain
+		float samplePeriod;					// in s
+		float q0, q1, q2, q3;
+		float qDot1, qDot2, qDot3, qDot4;
+
+		SampleInterval interval;
+};
+
+// The instance behind the C functions below
+MadgwickFilter& MadgwickAHRS_GetDefaultFilter();
+
+extern "C" {
+#endif
 
 //---------------------------------------------------------------------------------------------------
-// Function declarations
+// Function declarations, these work on the default filter
 
 void MadgwickAHRSupdate(float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz);
 void MadgwickAHRSupdateIMU(float gx, float gy, float gz, float ax, float ay, float az);
+void MadgwickAHRSgetQuaternion(float *q0, float *q1, float *q2, float *q3);
 
 #ifdef __cplusplus
 }
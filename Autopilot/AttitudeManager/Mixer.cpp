@@ -0,0 +1,124 @@
+#include "Mixer.hpp"
+
+#include <cstddef>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+// Servo channels travel the whole range, motors only forward
+#define SERVO_LIMITS {-100.0f, -100.0f, -100.0f, -100.0f}, {100.0f, 100.0f, 100.0f, 100.0f}
+#define MOTOR_LIMITS {0.0f, 0.0f, 0.0f, 0.0f}, {100.0f, 100.0f, 100.0f, 100.0f}
+
+// Rows are {roll, pitch, yaw, throttle}. Channels past numChannels are left zero.
+static const MixerConfig_t PRESETS[MIXER_NUM_PRESETS] = {
+	// MIXER_PRESET_CONVENTIONAL
+	{
+		4,
+		{
+			{0.0f, 1.0f, 0.0f, 0.0f},
+			{0.0f, 0.0f, 1.0f, 0.0f},
+			{1.0f, 0.0f, 0.0f, 0.0f},
+			{0.0f, 0.0f, 0.0f, 1.0f},
+		},
+		{0.0f},
+		SERVO_LIMITS,
+		{false},
+	},
+
+	// MIXER_PRESET_V_TAIL, 0.75 of the rudder and of the elevator on each ruddervator, for a tail at 45 degrees
+	{
+		4,
+		{
+			{0.0f, -0.75f, 0.75f, 0.0f},
+			{0.0f, 0.75f, 0.75f, 0.0f},
+			{1.0f, 0.0f, 0.0f, 0.0f},
+			{0.0f, 0.0f, 0.0f, 1.0f},
+		},
+		{0.0f},
+		SERVO_LIMITS,
+		{false},
+	},
+
+	// MIXER_PRESET_FLYING_WING, half of the elevator and of the aileron on each elevon, the right one taking the aileron
+	// negated, so that a full command on one axis still moves the elevons through their whole travel
+	{
+		3,
+		{
+			{0.5f, 0.5f, 0.0f, 0.0f},
+			{-0.5f, 0.5f, 0.0f, 0.0f},
+			{0.0f, 0.0f, 0.0f, 1.0f},
+		},
+		{0.0f},
+		SERVO_LIMITS,
+		{false},
+	},
+
+	// MIXER_PRESET_QUAD_X, the attitude commands at half weight, so that a full command from half throttle reaches the
+	// motor limits. Rolling right speeds up the left motors, pitching up the front ones and yawing right the
+	// anticlockwise ones.
+	{
+		4,
+		{
+			{0.5f, 0.5f, -0.5f, 1.0f},
+			{-0.5f, 0.5f, 0.5f, 1.0f},
+			{-0.5f, -0.5f, -0.5f, 1.0f},
+			{0.5f, -0.5f, 0.5f, 1.0f},
+		},
+		{0.0f},
+		MOTOR_LIMITS,
+		{false},
+	},
+};
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+const MixerConfig_t *Mixer_GetPreset(MixerPreset_t preset)
+{
+	if ((preset < 0) || (preset >= MIXER_NUM_PRESETS))
+	{
+		return NULL;
+	}
+
+	return &PRESETS[preset];
+}
+
+Mixer_error_t Mixer_Execute(const MixerConfig_t *config, const PID_Output_t *PidOutput, float *channelOut)
+{
+	Mixer_error_t error;
+
+	if ((config->numChannels < 0) || (config->numChannels > MIXER_MAX_CHANNELS))
+	{
+		error.errorCode = 1;
+		return error;
+	}
+
+	const float roll = PidOutput->rollPercent;
+	const float pitch = PidOutput->pitchPercent;
+	const float yaw = PidOutput->yawPercent;
+	const float throttle = PidOutput->throttlePercent;
+
+	for (int channel = 0; channel < config->numChannels; channel++)
+	{
+		const float *row = config->weights[channel];
+
+		float mixed = (row[MIXER_ROLL] * roll) + (row[MIXER_PITCH] * pitch) + (row[MIXER_YAW] * yaw) + (row[MIXER_THROTTLE] * throttle);
+		mixed = (config->reversed[channel] ? -mixed : mixed) + config->trim[channel];
+
+		if (mixed < config->minOutput[channel])
+		{
+			mixed = config->minOutput[channel];
+		}
+		else if (mixed > config->maxOutput[channel])
+		{
+			mixed = config->maxOutput[channel];
+		}
+
+		channelOut[channel] = mixed;
+	}
+
+	error.errorCode = 0;
+	return error;
+}
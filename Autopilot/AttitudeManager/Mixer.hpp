@@ -0,0 +1,87 @@
+/**
+ * Table driven output mixing.
+ *
+ * A mixer is a matrix with a row per output channel and a column per PID output (roll, pitch, yaw, throttle), plus a
+ * trim, limits and a reversal per channel. Each channel is the dot product of its row with the PID outputs, negated
+ * when reversed, offset by its trim and clamped to its limits, so an airframe is data rather than code: the presets
+ * below are tables, and a MixerConfig_t filled in at run time works the same way.
+ */
+
+#ifndef MIXER_HPP
+#define MIXER_HPP
+
+#include "AttitudeDatatypes.hpp"
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define MIXER_MAX_CHANNELS 12 // as many as the PWM outputs of the interchip packet
+
+// Columns of the mixing matrix
+enum MixerInput_t
+{
+	MIXER_ROLL,
+	MIXER_PITCH,
+	MIXER_YAW,
+	MIXER_THROTTLE,
+	MIXER_NUM_INPUTS
+};
+
+typedef struct
+{
+	int numChannels;
+
+	float weights[MIXER_MAX_CHANNELS][MIXER_NUM_INPUTS];
+	float trim[MIXER_MAX_CHANNELS];                     // percent, added after the reversal
+	float minOutput[MIXER_MAX_CHANNELS];                // percent
+	float maxOutput[MIXER_MAX_CHANNELS];                // percent
+	bool reversed[MIXER_MAX_CHANNELS];
+
+} MixerConfig_t;
+
+/**
+ * Channel layouts of the presets:
+ * CONVENTIONAL     elevator, rudder, aileron, throttle, the layout of AttitudeDatatypes.hpp
+ * V_TAIL           left and right ruddervators, aileron, throttle, the layout of AttitudeDatatypes.hpp for SPIKE
+ * FLYING_WING      left and right elevons, throttle
+ * QUAD_X           front left, front right, rear right and rear left motors, the front left and rear right propellers
+ *                  turning clockwise seen from above
+ */
+typedef enum
+{
+	MIXER_PRESET_CONVENTIONAL,
+	MIXER_PRESET_V_TAIL,
+	MIXER_PRESET_FLYING_WING,
+	MIXER_PRESET_QUAD_X,
+	MIXER_NUM_PRESETS
+
+} MixerPreset_t;
+
+typedef struct
+{
+	int errorCode;
+
+} Mixer_error_t;
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+/**
+* @param[in]		preset 		one of MixerPreset_t.
+* @return						the preset's table, nullptr for an unknown preset.
+*/
+const MixerConfig_t *Mixer_GetPreset(MixerPreset_t preset);
+
+/**
+* Mixes the PID outputs into config->numChannels channel percentages.
+* @param[in]		config 			the mixing table.
+* @param[in]		PidOutput 		the desired attitude percentages.
+* @param[out]		channelOut 		config->numChannels percentages, one per channel.
+* @return							the error struct, errorCode 1 when config->numChannels is out of range, in which case
+*									nothing is written.
+*/
+Mixer_error_t Mixer_Execute(const MixerConfig_t *config, const PID_Output_t *PidOutput, float *channelOut);
+
+#endif
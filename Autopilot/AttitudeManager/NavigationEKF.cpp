@@ -0,0 +1,368 @@
+#include "NavigationEKF.hpp"
+
+#include <math.h>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define EARTH_RADIUS 6371000.0      // m
+#define DEG_TO_RAD 0.017453292519943295
+
+// Initial standard deviations
+#define INITIAL_POSITION_SIGMA 100.0f       // m, until the first fix there is no position
+#define INITIAL_VELOCITY_SIGMA 5.0f         // m/s
+#define INITIAL_TILT_SIGMA 0.1f             // rad, roll and pitch
+#define INITIAL_YAW_SIGMA 0.5f              // rad, nothing but GPS observes yaw
+#define INITIAL_GYRO_BIAS_SIGMA 0.02f       // rad/s
+#define INITIAL_ACCEL_BIAS_SIGMA 0.2f       // m/s^2
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+NavigationEKFConfig_t NavigationEKF_DefaultConfig()
+{
+    NavigationEKFConfig_t config;
+
+    config.gyroNoise = 0.002f;
+    config.accelNoise = 0.05f;
+    config.gyroBiasWalk = 0.0001f;
+    config.accelBiasWalk = 0.001f;
+
+    config.gravityNoise = 2.0f;
+    config.gravityGate = 1.0f;
+    config.gpsPositionNoise = 2.5f;
+    config.gpsVelocityNoise = 0.3f;
+    config.altimeterNoise = 1.0f;
+    config.airspeedNoise = 1.0f;
+
+    return config;
+}
+
+NavigationEKF::NavigationEKF(const NavigationEKFConfig_t &_config) : config(_config),
+    interval(EKF_NOMINAL_DT, EKF_MIN_DT, EKF_MAX_DT, EKF_GAP_DT)
+{
+    reset();
+}
+
+void NavigationEKF::reset()
+{
+    for (int i = 0; i < 3; i++)
+    {
+        state.position[i] = 0.0f;
+        state.velocity[i] = 0.0f;
+        state.gyroBias[i] = 0.0f;
+        state.accelBias[i] = 0.0f;
+        bodyRates[i] = 0.0f;
+    }
+
+    state.quaternion[0] = 1.0f;
+    state.quaternion[1] = 0.0f;
+    state.quaternion[2] = 0.0f;
+    state.quaternion[3] = 0.0f;
+
+    P = Covariance::zeros();
+
+    for (int i = 0; i < 3; i++)
+    {
+        P(EKF_POSITION + i, EKF_POSITION + i) = INITIAL_POSITION_SIGMA * INITIAL_POSITION_SIGMA;
+        P(EKF_VELOCITY + i, EKF_VELOCITY + i) = INITIAL_VELOCITY_SIGMA * INITIAL_VELOCITY_SIGMA;
+        P(EKF_ATTITUDE + i, EKF_ATTITUDE + i) = INITIAL_TILT_SIGMA * INITIAL_TILT_SIGMA;
+        P(EKF_GYRO_BIAS + i, EKF_GYRO_BIAS + i) = INITIAL_GYRO_BIAS_SIGMA * INITIAL_GYRO_BIAS_SIGMA;
+        P(EKF_ACCEL_BIAS + i, EKF_ACCEL_BIAS + i) = INITIAL_ACCEL_BIAS_SIGMA * INITIAL_ACCEL_BIAS_SIGMA;
+    }
+
+    P(EKF_ATTITUDE + 2, EKF_ATTITUDE + 2) = INITIAL_YAW_SIGMA * INITIAL_YAW_SIGMA;
+
+    interval.reset();
+
+    aligned = false;
+    rejectedCount = 0;
+
+    hasOrigin = false;
+    originLatitude = 0.0;
+    originLongitude = 0.0;
+    originCosLatitude = 1.0;
+}
+
+void NavigationEKF::alignToGravity(float ax, float ay, float az)
+{
+    if (ax == 0.0f && ay == 0.0f && az == 0.0f)
+    {
+        return;
+    }
+
+    float halfRoll = 0.5f * atan2f(ay, az);
+    float halfPitch = 0.5f * atan2f(-ax, sqrtf(ay * ay + az * az));
+
+    float cr = cosf(halfRoll);
+    float sr = sinf(halfRoll);
+    float cp = cosf(halfPitch);
+    float sp = sinf(halfPitch);
+
+    // Roll then pitch, yaw 0
+    state.quaternion[0] = cr * cp;
+    state.quaternion[1] = sr * cp;
+    state.quaternion[2] = cr * sp;
+    state.quaternion[3] = -sr * sp;
+
+    aligned = true;
+}
+
+void NavigationEKF::predict(float gx, float gy, float gz, float ax, float ay, float az, float dt)
+{
+    // Remove the biases
+    Vec3 w = {{gx - state.gyroBias[0], gy - state.gyroBias[1], gz - state.gyroBias[2]}};
+    Vec3 f = {{ax - state.accelBias[0], ay - state.accelBias[1], az - state.accelBias[2]}};
+
+    w.toArray(bodyRates);
+
+    Mat3 rotation = attitude().toRotationMatrix();
+
+    // Acceleration in the earth frame, the accelerometer reads +g on the up axis at rest
+    Vec3 acceleration = rotation * f;
+    acceleration[2] -= EKF_GRAVITY;
+
+    Vec3 position = Vec3::fromArray(state.position);
+    Vec3 velocity = Vec3::fromArray(state.velocity);
+
+    position += velocity * dt + acceleration * (0.5f * dt * dt);
+    velocity += acceleration * dt;
+
+    position.toArray(state.position);
+    velocity.toArray(state.velocity);
+
+    // Rotate the attitude by w * dt
+    (attitude() * Quat::fromRotationVector(w * dt)).normalized().toArray(state.quaternion);
+
+    // Error state transition, first order in dt
+    Covariance F = Covariance::identity();
+
+    F.setBlock(EKF_POSITION, EKF_VELOCITY, Mat3::identity() * dt);
+    F.setBlock(EKF_VELOCITY, EKF_ATTITUDE, (rotation * skew(f)) * -dt);
+    F.setBlock(EKF_VELOCITY, EKF_ACCEL_BIAS, rotation * -dt);
+    F.setBlock(EKF_ATTITUDE, EKF_ATTITUDE, Mat3::identity() - skew(w) * dt);
+    F.setBlock(EKF_ATTITUDE, EKF_GYRO_BIAS, Mat3::identity() * -dt);
+
+    P = multiplyTransposed(F * P, F);
+
+    for (int i = 0; i < 3; i++)
+    {
+        P(EKF_VELOCITY + i, EKF_VELOCITY + i) += config.accelNoise * config.accelNoise * dt;
+        P(EKF_ATTITUDE + i, EKF_ATTITUDE + i) += config.gyroNoise * config.gyroNoise * dt;
+        P(EKF_GYRO_BIAS + i, EKF_GYRO_BIAS + i) += config.gyroBiasWalk * config.gyroBiasWalk * dt;
+        P(EKF_ACCEL_BIAS + i, EKF_ACCEL_BIAS + i) += config.accelBiasWalk * config.accelBiasWalk * dt;
+    }
+}
+
+bool NavigationEKF::updateGravity(float ax, float ay, float az, float forwardSpeed)
+{
+    Vec3 measured = {{ax, ay, az}};
+
+    // w x (forwardSpeed, 0, 0), it depends on the gyro bias through w
+    Vec3 centripetal = {{0.0f, bodyRates[2] * forwardSpeed, -bodyRates[1] * forwardSpeed}};
+
+    if (fabsf(distance(measured, centripetal) - EKF_GRAVITY) > config.gravityGate)
+    {
+        return false;
+    }
+
+    const Vec3 up = {{0.0f, 0.0f, EKF_GRAVITY}};
+
+    // One axis at a time, the prediction is refreshed after each since the state moves
+    for (int axis = 0; axis < 3; axis++)
+    {
+        // Gravity seen from the body
+        Vec3 g = attitude().conjugate().rotate(up);
+
+        Mat3 gravitySkew = skew(g);
+        MeasurementRow H = MeasurementRow::zeros();
+
+        for (int j = 0; j < 3; j++)
+        {
+            H(0, EKF_ATTITUDE + j) = gravitySkew(axis, j);
+        }
+
+        H(0, EKF_ACCEL_BIAS + axis) = 1.0f;
+        H(0, EKF_GYRO_BIAS + 1) = (axis == 2) ? forwardSpeed : 0.0f;
+        H(0, EKF_GYRO_BIAS + 2) = (axis == 1) ? -forwardSpeed : 0.0f;
+
+        float predicted = g[axis] + state.accelBias[axis] + centripetal[axis];
+        updateScalar(H, measured[axis] - predicted, config.gravityNoise);
+    }
+
+    return true;
+}
+
+int NavigationEKF::updatePosition(float north, float west, float up)
+{
+    float measured[3] = {north, west, up};
+    int accepted = 0;
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        MeasurementRow H = MeasurementRow::zeros();
+        H(0, EKF_POSITION + axis) = 1.0f;
+
+        accepted += updateScalar(H, measured[axis] - state.position[axis], config.gpsPositionNoise) ? 1 : 0;
+    }
+
+    return accepted;
+}
+
+int NavigationEKF::updateHorizontalVelocity(float north, float west)
+{
+    float measured[2] = {north, west};
+    int accepted = 0;
+
+    for (int axis = 0; axis < 2; axis++)
+    {
+        MeasurementRow H = MeasurementRow::zeros();
+        H(0, EKF_VELOCITY + axis) = 1.0f;
+
+        accepted += updateScalar(H, measured[axis] - state.velocity[axis], config.gpsVelocityNoise) ? 1 : 0;
+    }
+
+    return accepted;
+}
+
+int NavigationEKF::updateAltitude(float up)
+{
+    MeasurementRow H = MeasurementRow::zeros();
+    H(0, EKF_POSITION + 2) = 1.0f;
+
+    return updateScalar(H, up - state.position[2], config.altimeterNoise) ? 1 : 0;
+}
+
+int NavigationEKF::updateAirspeed(float airspeed)
+{
+    Vec3 v = Vec3::fromArray(state.velocity);
+    float speed = norm(v);
+
+    // Without wind the airspeed is the length of the velocity
+    if ( ! hasOrigin || speed < EKF_MIN_AIRSPEED || airspeed < EKF_MIN_AIRSPEED)
+    {
+        return 0;
+    }
+
+    MeasurementRow H = MeasurementRow::zeros();
+
+    for (int j = 0; j < 3; j++)
+    {
+        H(0, EKF_VELOCITY + j) = v[j] / speed;
+    }
+
+    return updateScalar(H, airspeed - speed, config.airspeedNoise) ? 1 : 0;
+}
+
+int NavigationEKF::updateGps(const GpsData_t &gps)
+{
+    if (gps.sensorStatus == 0 || ! gps.dataIsNew)
+    {
+        return 0;
+    }
+
+    double latitude = (double) gps.latitude * DEG_TO_RAD;
+    double longitude = (double) gps.longitude * DEG_TO_RAD;
+
+    if ( ! hasOrigin)
+    {
+        originLatitude = latitude;
+        originLongitude = longitude;
+        originCosLatitude = cos(latitude);
+        hasOrigin = true;
+
+        // Whatever was integrated before the first fix is meaningless, start from the origin
+        state.position[0] = 0.0f;
+        state.position[1] = 0.0f;
+    }
+
+    float north = (float) ((latitude - originLatitude) * EARTH_RADIUS);
+    float west = (float) (-(longitude - originLongitude) * EARTH_RADIUS * originCosLatitude);
+
+    // Heading is clockwise from north, west is the other way
+    float heading = (float) (gps.heading * DEG_TO_RAD);
+
+    int accepted = updatePosition(north, west, (float) gps.altitude);
+    accepted += updateHorizontalVelocity(gps.groundSpeed * cosf(heading), -gps.groundSpeed * sinf(heading));
+
+    return accepted;
+}
+
+int NavigationEKF::updateAltimeter(const AltimeterData_t &altimeter)
+{
+    if (altimeter.status != 0 || ! altimeter.isDataNew)
+    {
+        return 0;
+    }
+
+    return updateAltitude(altimeter.altitude);
+}
+
+void NavigationEKF::getBodyRates(float rates[3]) const
+{
+    for (int i = 0; i < 3; i++)
+    {
+        rates[i] = bodyRates[i];
+    }
+}
+
+bool NavigationEKF::updateScalar(const MeasurementRow &H, float innovation, float noise)
+{
+    // P * H^T
+    Mat<EKF_NUM_STATES, 1> PHt = multiplyTransposed(P, H);
+
+    float innovationVariance = noise * noise;
+
+    for (int i = 0; i < EKF_NUM_STATES; i++)
+    {
+        innovationVariance += H(0, i) * PHt(i, 0);
+    }
+
+    if ( ! (innovationVariance > 0.0f) || innovation * innovation > EKF_INNOVATION_GATE * EKF_INNOVATION_GATE * innovationVariance)
+    {
+        rejectedCount++;
+        return false;
+    }
+
+    float gain[EKF_NUM_STATES];
+    float error[EKF_NUM_STATES];
+
+    for (int i = 0; i < EKF_NUM_STATES; i++)
+    {
+        gain[i] = PHt(i, 0) / innovationVariance;
+        error[i] = gain[i] * innovation;
+    }
+
+    // P - K * H * P, and H * P is PHt transposed since P is symmetric. Rounding is kept from breaking the symmetry.
+    for (int i = 0; i < EKF_NUM_STATES; i++)
+    {
+        for (int j = i; j < EKF_NUM_STATES; j++)
+        {
+            float updated = P(i, j) - 0.5f * (gain[i] * PHt(j, 0) + gain[j] * PHt(i, 0));
+            P(i, j) = updated;
+            P(j, i) = updated;
+        }
+    }
+
+    injectError(error);
+
+    return true;
+}
+
+void NavigationEKF::injectError(const float error[EKF_NUM_STATES])
+{
+    for (int i = 0; i < 3; i++)
+    {
+        state.position[i] += error[EKF_POSITION + i];
+        state.velocity[i] += error[EKF_VELOCITY + i];
+        state.gyroBias[i] += error[EKF_GYRO_BIAS + i];
+        state.accelBias[i] += error[EKF_ACCEL_BIAS + i];
+    }
+
+    // The attitude error is a small rotation in the body frame
+    Quat delta = {1.0f, 0.5f * error[EKF_ATTITUDE], 0.5f * error[EKF_ATTITUDE + 1], 0.5f * error[EKF_ATTITUDE + 2]};
+
+    (attitude() * delta).normalized().toArray(state.quaternion);
+}
@@ -0,0 +1,164 @@
+/**
+ * Error state extended Kalman filter estimating attitude, velocity and position from the IMU, aided by GPS, the
+ * barometric altimeter and the airspeed sensor. It is the alternative to Madgwick in SensorFusion, see
+ * SF_SelectEngine.
+ *
+ * The nominal state (position, velocity, attitude quaternion, gyro and accelerometer biases) is propagated with the
+ * IMU. A 15 element error state (see the EKF_ indices below) carries the uncertainty. Every measurement is applied
+ * one scalar at a time, so no matrix is ever inverted. After each of them the error is folded back into the
+ * nominal state.
+ *
+ * Frames follow MadgwickFilter. The earth frame is north, west, up, and the body frame is x forward, z up. An
+ * accelerometer at rest and level reads +g on z. Position is measured from the first GPS fix. Up is the altitude
+ * itself, so GPS and barometer share it.
+ *
+ * All matrices have fixed dimensions (LinearAlgebra.hpp), so the filter uses no heap.
+ */
+
+#ifndef NAVIGATION_EKF_HPP
+#define NAVIGATION_EKF_HPP
+
+#include <stdint.h>
+
+#include "LinearAlgebra.hpp"
+#include "SampleInterval.hpp"
+#include "gps.hpp"
+#include "altimeter.hpp"
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+// Error state layout, each block is 3 long
+#define EKF_POSITION 0
+#define EKF_VELOCITY 3
+#define EKF_ATTITUDE 6      // small rotation in the body frame
+#define EKF_GYRO_BIAS 9
+#define EKF_ACCEL_BIAS 12
+#define EKF_NUM_STATES 15
+
+#define EKF_GRAVITY 9.80665f            // m/s^2
+
+// Limits on the time step taken from IMU time stamps, in s, see SampleInterval.hpp
+#define EKF_NOMINAL_DT 0.005f
+#define EKF_MIN_DT 0.0002f
+#define EKF_MAX_DT 0.05f
+#define EKF_GAP_DT 0.25f
+
+#define EKF_INNOVATION_GATE 5.0f        // measurements further than this many standard deviations out are dropped
+#define EKF_MIN_AIRSPEED 3.0f           // m/s, below this the airspeed carries no direction and is not fused
+
+struct NavigationEKFConfig_t
+{
+    // Process noise, as continuous densities
+    float gyroNoise;            // rad/s/sqrt(Hz)
+    float accelNoise;           // m/s^2/sqrt(Hz)
+    float gyroBiasWalk;         // rad/s/sqrt(s)
+    float accelBiasWalk;        // m/s^2/sqrt(s)
+
+    // Measurement noise, standard deviations
+    float gravityNoise;         // m/s^2, the accelerometer used as a gravity reference
+    float gravityGate;          // m/s^2, the gravity reference is only used while |accel| is this close to g
+    float gpsPositionNoise;     // m
+    float gpsVelocityNoise;     // m/s
+    float altimeterNoise;       // m
+    float airspeedNoise;        // m/s
+};
+
+struct NavigationState_t
+{
+    float position[3];          // m, north west up
+    float velocity[3];          // m/s, north west up
+    float quaternion[4];        // body to earth, q0 is the scalar part
+    float gyroBias[3];          // rad/s
+    float accelBias[3];         // m/s^2
+};
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+NavigationEKFConfig_t NavigationEKF_DefaultConfig();
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+class NavigationEKF
+{
+    public:
+        typedef Mat<EKF_NUM_STATES, EKF_NUM_STATES> Covariance;
+        typedef Mat<1, EKF_NUM_STATES> MeasurementRow;
+
+        explicit NavigationEKF(const NavigationEKFConfig_t &_config = NavigationEKF_DefaultConfig());
+
+        // Back to the initial uncertainty, not aligned and without a GPS origin
+        void reset();
+
+        /**
+        * Sets roll and pitch from an accelerometer sample taken at rest, with yaw at 0.
+        * Called by SensorFusion on the first sample. Until then the filter assumes it is level.
+        */
+        void alignToGravity(float ax, float ay, float az);
+        bool isAligned() const {return aligned;}
+
+        /**
+        * Propagates the state and its uncertainty by one IMU sample.
+        * @param[in]    gx, gy, gz      rad/s
+        * @param[in]    ax, ay, az      m/s^2
+        * @param[in]    dt              s, see getTimeStep
+        */
+        void predict(float gx, float gy, float gz, float ax, float ay, float az, float dt);
+
+        /**
+        * Uses the accelerometer as a measurement of gravity, which is what keeps roll and pitch from drifting without
+        * GPS. The centripetal acceleration of flying at forwardSpeed along the body x axis while rotating is taken
+        * out first, which is what keeps turns from being read as bank. Skipped while the rest of the acceleration is
+        * too large to ignore.
+        * @param[in]    forwardSpeed    m/s, the airspeed, 0 if unknown.
+        * @return                       true if the sample was used.
+        */
+        bool updateGravity(float ax, float ay, float az, float forwardSpeed);
+
+        // Fuse one source. Each one returns the number of scalar measurements that were accepted. The airspeed is
+        // only fused once GPS has given the velocity a direction.
+        int updatePosition(float north, float west, float up);
+        int updateHorizontalVelocity(float north, float west);
+        int updateAltitude(float up);
+        int updateAirspeed(float airspeed);
+
+        // Converts a fix to the local frame. The first fix becomes the origin.
+        int updateGps(const GpsData_t &gps);
+        int updateAltimeter(const AltimeterData_t &altimeter);
+
+        float getTimeStep(uint32_t sampleTimeUs) {return interval.next(sampleTimeUs);}
+
+        const NavigationState_t& getState() const {return state;}
+        const Covariance& getCovariance() const {return P;}
+
+        // Gyro minus the estimated bias, from the last predict, in rad/s
+        void getBodyRates(float rates[3]) const;
+
+        uint32_t getRejectedCount() const {return rejectedCount;}
+
+    private:
+        bool updateScalar(const MeasurementRow &H, float innovation, float noise);
+        void injectError(const float error[EKF_NUM_STATES]);
+        Quat attitude() const {return Quat::fromArray(state.quaternion);}
+
+        NavigationEKFConfig_t config;
+        NavigationState_t state;
+        Covariance P;
+        SampleInterval interval;
+
+        bool aligned;
+        float bodyRates[3];
+        uint32_t rejectedCount;
+
+        bool hasOrigin;
+        double originLatitude;      // rad
+        double originLongitude;     // rad
+        double originCosLatitude;
+};
+
+#endif
@@ -1,19 +1,15 @@
 #include "OutputMixing.hpp"
+#include "Mixer.hpp"
 
 /***********************************************************************************************************************
  * Definitions
  **********************************************************************************************************************/
 
-// tails supported by this module
-#define CONVENTIONAL_TAIL 0
-#define INV_V_TAIL 1
-
+// The airframe's preset, whose channels are those of AttitudeDatatypes.hpp
 #ifdef SPIKE
-	#define TAIL_TYPE INV_V_TAIL
-	static const float RUDDER_PROPORTION = 0.75f; // has to do with the angle of the inverse V tail, 0.75 means spike's tail is at 45 degrees.
-	static const float ELEVATOR_PROPORTION 0.75f;
+	#define AIRFRAME_PRESET MIXER_PRESET_V_TAIL // spike's tail is an inverse V at 45 degrees
 #else
-	#define TAIL_TYPE CONVENTIONAL_TAIL
+	#define AIRFRAME_PRESET MIXER_PRESET_CONVENTIONAL
 #endif
 
 /***********************************************************************************************************************
@@ -21,7 +17,6 @@
  **********************************************************************************************************************/
 
 static int checkInputValidity(PID_Output_t *PidOutput);
-static void constrainOutput(float *channelOut);
 
 /***********************************************************************************************************************
  * Code
@@ -35,18 +30,7 @@ OutputMixing_error_t OutputMixing_Execute(PID_Output_t *PidOutput, float *channe
 	OutputMixing_error_t error;
 	error.errorCode = checkInputValidity(PidOutput);
 
-#if TAIL_TYPE == INV_V_TAIL
-    channelOut[L_TAIL_OUT_CHANNEL] =  (PidOutput->yawPercent * RUDDER_PROPORTION) - (PidOutput->pitchPercent * ELEVATOR_PROPORTION); //Tail Output Left
-    channelOut[R_TAIL_OUT_CHANNEL] =  (PidOutput->yawPercent * RUDDER_PROPORTION) + (PidOutput->pitchPercent * ELEVATOR_PROPORTION); //Tail Output Right
-#else
-    channelOut[ELEVATOR_OUT_CHANNEL] =  PidOutput->pitchPercent;
-    channelOut[RUDDER_OUT_CHANNEL] =  PidOutput->yawPercent;
-#endif
-
-    channelOut[AILERON_OUT_CHANNEL] = PidOutput->rollPercent;
-    channelOut[THROTTLE_OUT_CHANNEL] = PidOutput->throttlePercent;
-
-    constrainOutput(channelOut);
+	Mixer_Execute(Mixer_GetPreset(AIRFRAME_PRESET), PidOutput, channelOut);
 
 	return error;
 }
@@ -70,18 +54,3 @@ static int checkInputValidity(PID_Output_t *PidOutput)
 
 	return errorCode;
 }
-
-static void constrainOutput(float *channelOut)
-{
-	for (int i = 0; i < 4; i++)
-	{
-		if (channelOut[i] < -100.0f)
-		{
-			channelOut[i] = -100.0f;
-		}
-		else if (channelOut[i] > 100.0f)
-		{
-			channelOut[i] = 100.0f;
-		}
-	}
-}
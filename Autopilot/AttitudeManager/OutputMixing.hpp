@@ -26,6 +26,7 @@ typedef struct
 /**
 * Converts the desired roll, pitch, yaw, and thrust percentages into an array of percentages
 * corresponding directly to what percentage of full the actuator attached to each channel should be set to.
+* The mixing is the airframe's preset of Mixer.hpp.
 * @param[in]		PidOutput 		pointer to the struct containing the desired attitude percentages.
 * @param[out]		channelOut 		the array (size of 4 floats) of percentages each channel should be set to.
 * @return							the error struct, containing all info about any errors that may have occured.
@@ -0,0 +1,84 @@
+/**
+ * Turns the TimeStamp_GetMicroseconds() stamps of consecutive sensor samples into the time step a filter should
+ * integrate over.
+ *
+ * The step is clamped to [minDt, maxDt]. The nominal period is used for the first sample, for samples whose stamp did
+ * not advance (sources without time stamps) and after a gap longer than gapDt, which is also counted: the
+ * gyro can not be integrated across a gap like that.
+ */
+
+#ifndef SAMPLE_INTERVAL_HPP
+#define SAMPLE_INTERVAL_HPP
+
+#include <stdint.h>
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+class SampleInterval
+{
+    public:
+        SampleInterval(float _nominalPeriod, float _minDt, float _maxDt, float _gapDt) :
+            nominalPeriod(_nominalPeriod), minDt(_minDt), maxDt(_maxDt), gapDt(_gapDt)
+        {
+            reset();
+        }
+
+        // Forgets the previous sample time and the gaps
+        void reset()
+        {
+            hasSampleTime = false;
+            lastSampleTimeUs = 0;
+            gapCount = 0;
+        }
+
+        /**
+        * @param[in]    sampleTimeUs    stamp of the sample about to be integrated.
+        * @return                       time step in s.
+        */
+        float next(uint32_t sampleTimeUs)
+        {
+            // Unsigned difference, so the wrap of the microsecond counter is harmless
+            uint32_t elapsedUs = sampleTimeUs - lastSampleTimeUs;
+            bool isFirst = !hasSampleTime;
+
+            hasSampleTime = true;
+            lastSampleTimeUs = sampleTimeUs;
+
+            if (isFirst || elapsedUs == 0)
+            {
+                return nominalPeriod;
+            }
+
+            float dt = (float) elapsedUs * 1e-6f;
+
+            if (dt > gapDt)
+            {
+                gapCount++;
+                return nominalPeriod;
+            }
+
+            dt = (dt < minDt) ? minDt : dt;
+            dt = (dt > maxDt) ? maxDt : dt;
+
+            return dt;
+        }
+
+        void setNominalPeriod(float period) {nominalPeriod = period;}
+        float getNominalPeriod() const {return nominalPeriod;}
+
+        uint32_t getGapCount() const {return gapCount;}
+
+    private:
+        float nominalPeriod;
+        float minDt;
+        float maxDt;
+        float gapDt;
+
+        bool hasSampleTime;
+        uint32_t lastSampleTimeUs;
+        uint32_t gapCount;
+};
+
+#endif
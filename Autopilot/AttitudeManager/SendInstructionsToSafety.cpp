@@ -1,10 +1,15 @@
 #include "SendInstructionsToSafety.hpp"
 #include "Interchip_A.h"
-#define PWM_CHANNELS 12
+#define PWM_CHANNELS INTERCHIP_PWM_CHANNELS
+#define ALL_CHANNELS ((1u << PWM_CHANNELS) - 1)
 
 static int16_t pwmPercentages[PWM_CHANNELS] = {0};
 static int16_t initialPWMPercentages[PWM_CHANNELS] = {0}; //TODO: put in initial PWM states in here. 
 
+// Channels that differ from what the interchip buffer holds. All of them until the first hand-off, as the buffer starts
+// out uninitialised.
+static uint32_t dirtyChannels = ALL_CHANNELS;
+
 
 void SendToSafety_Init(void)
 {
@@ -12,6 +17,8 @@ void SendToSafety_Init(void)
     {
         pwmPercentages[i] = initialPWMPercentages[i];
     }
+
+    dirtyChannels = ALL_CHANNELS;
 }
 
 SendToSafety_error_t SendToSafety_Execute(int channel, int percent)
@@ -23,5 +30,39 @@ SendToSafety_error_t SendToSafety_Execute(int channel, int percent)
     pwmPercentages[channel] = percent;
 
     Interchip_SetPWM(pwmPercentages);
+    dirtyChannels = 0;
+    return error;
+}
+
+SendToSafety_error_t SendToSafety_Commit(const float *percent, int numChannels, uint32_t sampleTimeUs)
+{
+    SendToSafety_error_t error;
+
+    if ((numChannels < 0) || (numChannels > PWM_CHANNELS))
+    {
+        error.errorCode = 1;
+        return error;
+    }
+
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        int16_t value = (int16_t) percent[channel];
+
+        dirtyChannels |= (uint32_t) (value != pwmPercentages[channel]) << channel;
+        pwmPercentages[channel] = value;
+    }
+
+    if (dirtyChannels != 0)
+    {
+        Interchip_SetFrame(pwmPercentages, dirtyChannels, sampleTimeUs);
+        dirtyChannels = 0;
+    }
+
+    error.errorCode = 0;
     return error;
 }
+
+void SendToSafety_SetSampleTime(uint32_t sampleTimeUs)
+{
+    Interchip_SetSampleTime(sampleTimeUs);
+}
@@ -7,6 +7,8 @@
 #ifndef SEND_INSTRUCTIONS_TO_SAFETY_HPP
 #define	SEND_INSTRUCTIONS_TO_SAFETY_HPP
 
+#include <stdint.h>
+
 /***********************************************************************************************************************
  * Definitions
  **********************************************************************************************************************/
@@ -38,4 +40,23 @@ void SendToSafety_Init(void);
 */
 SendToSafety_error_t SendToSafety_Execute(int channel, int percent);
 
+/**
+* Publishes a whole frame of actuator commands, tagged with the sample time stamp, to the safety chip in one hand-off
+* to the interchip buffer. Only the channels whose PWM value changed since the last hand-off are copied, and when none
+* did the hand-off is skipped altogether; the time stamp then stays that of the last frame that changed something.
+* Percentages are truncated to integers, as SendToSafety_Execute's are. This function is non blocking.
+* @param[in]		percent 		numChannels percentages, channel i of the frame going to PWM channel i.
+* @param[in]		numChannels 	at most 12, the PWM channels of the interchip packet.
+* @param[in]		sampleTimeUs	TimeStamp_GetMicroseconds() of the IMU sample the frame was computed from.
+* @return							the error struct, errorCode 1 when numChannels is out of range.
+*/
+SendToSafety_error_t SendToSafety_Commit(const float *percent, int numChannels, uint32_t sampleTimeUs);
+
+/**
+* Tags the commands sent so far with the time stamp of the IMU sample they were computed from,
+* so the age of the sample can be measured all the way to the safety chip.
+* @param[in]		sampleTimeUs	TimeStamp_GetMicroseconds() of the IMU sample.
+*/
+void SendToSafety_SetSampleTime(uint32_t sampleTimeUs);
+
 #endif
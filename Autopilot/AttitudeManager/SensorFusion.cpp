@@ -3,25 +3,159 @@
 * Author: Lucy Gong, Dhruv Rawat
 */
 #include "SensorFusion.hpp"
-#include "MadgwickAHRS.h"
+#include "FastMath.hpp"
 #include <math.h>
 
+#define RAD_TO_DEG 57.29578f
+
+static SFEngine_t selectedEngine = SF_ENGINE_MADGWICK;
+static NavigationEKF defaultEkf;
+
+static GpsData_t pendingGps;
+static bool hasPendingGps = false;
+static AltimeterData_t pendingAltimeter;
+static bool hasPendingAltimeter = false;
+
+static SFError_t CheckInputs(IMU_Data_t *imudata, Airspeed_Data_t *airspeeddata);
+static float integrationStep(float stampStep, const IMU_Data_t *imudata);
+static void SetAnglesFromQuaternion(float q0, float q1, float q2, float q3, SFOutput_t *Output);
+
+void SF_SelectEngine(SFEngine_t engine) {
+    if (engine == SF_ENGINE_EKF && selectedEngine != SF_ENGINE_EKF) {
+        defaultEkf.reset();
+    }
+
+    selectedEngine = engine;
+}
+
+SFEngine_t SF_GetEngine() {
+    return selectedEngine;
+}
+
+void SF_SetAidingData(const GpsData_t *gps, const AltimeterData_t *altimeter) {
+    if (gps != nullptr) {
+        pendingGps = *gps;
+        hasPendingGps = true;
+    }
+
+    if (altimeter != nullptr) {
+        pendingAltimeter = *altimeter;
+        hasPendingAltimeter = true;
+    }
+}
+
 SFError_t SF_GetResult(SFOutput_t *Output, IMU_Data_t *imudata, Airspeed_Data_t *airspeeddata) {
+    if (selectedEngine == SF_ENGINE_EKF) {
+        SFError_t SFError = SF_GetResultFrom(defaultEkf, Output, imudata, airspeeddata, hasPendingGps ? &pendingGps : nullptr,
+                                             hasPendingAltimeter ? &pendingAltimeter : nullptr);
+
+        hasPendingGps = false;
+        hasPendingAltimeter = false;
+
+        return SFError;
+    }
+
+    return SF_GetResultFrom(MadgwickAHRS_GetDefaultFilter(), Output, imudata, airspeeddata);
+}
+
+SFError_t SF_GetResultFrom(MadgwickFilter &filter, SFOutput_t *Output, IMU_Data_t *imudata, Airspeed_Data_t *airspeeddata) {
     
-    //Error output
-    SFError_t SFError;
+    SFError_t SFError = CheckInputs(imudata, airspeeddata);
 
-    SFError.errorCode = 0;
+    if (SFError.errorCode == -1) {
+        return SFError;
+    }
 
     //IMU integration outputs
-    float imu_RollAngle = 0;
-    float imu_PitchAngle = 0;
-    float imu_YawAngle = 0;
-
     float imu_RollRate = 0;
     float imu_PitchRate = 0;
     float imu_YawRate = 0;
 
+    // Integrate over the time that actually passed since the previous sample, the cycle rate is not fixed
+    float dt = integrationStep(filter.getTimeStep(imudata->sampleTimeUs), imudata);
+
+    filter.update(imudata->gyrx, imudata->gyry, imudata->gyrz, imudata->accx, imudata->accy, imudata->accz, imudata->magx, imudata->magy, imudata->magz, dt);
+
+    MadgwickQuaternion_t q = filter.getQuaternion();
+    MadgwickQuaternion_t qDot = filter.getQuaternionRate();
+
+    SetAnglesFromQuaternion(q.q0, q.q1, q.q2, q.q3, Output);
+
+    //Convert rate of change of quaternion to angular velocity (in deg/s)
+    imu_RollRate = FastMath_Atan2(qDot.q0 * qDot.q1 + qDot.q2 * qDot.q3, 0.5f - qDot.q1 * qDot.q1 - qDot.q2 * qDot.q2) * RAD_TO_DEG;
+    imu_PitchRate = FastMath_Asin(-2.0f * (qDot.q1 * qDot.q3 - qDot.q0 * qDot.q2)) * RAD_TO_DEG;
+    imu_YawRate = FastMath_Atan2(qDot.q1 * qDot.q2 + qDot.q0 * qDot.q3, 0.5f - qDot.q2 * qDot.q2 - qDot.q3 * qDot.q3) * RAD_TO_DEG + 180.0f;
+
+    //Transfer Fused IMU data into SF Output struct
+    Output->IMUpitchrate = imu_PitchRate;
+    Output->IMUrollrate = imu_RollRate;
+    Output->IMUyawrate = imu_YawRate;
+
+    //Transfer Airspeed data
+    Output->Airspeed = airspeeddata->airspeed;
+
+    Output->sampleTimeUs = imudata->sampleTimeUs;
+
+    return SFError;
+}
+
+SFError_t SF_GetResultFrom(NavigationEKF &ekf, SFOutput_t *Output, IMU_Data_t *imudata, Airspeed_Data_t *airspeeddata,
+                           const GpsData_t *gps, const AltimeterData_t *altimeter) {
+
+    SFError_t SFError = CheckInputs(imudata, airspeeddata);
+
+    if (SFError.errorCode == -1) {
+        return SFError;
+    }
+
+    float dt = integrationStep(ekf.getTimeStep(imudata->sampleTimeUs), imudata);
+
+    // The first sample levels the filter, there is nothing to propagate from yet
+    if (!ekf.isAligned()) {
+        ekf.alignToGravity(imudata->accx, imudata->accy, imudata->accz);
+    } else {
+        ekf.predict(imudata->gyrx, imudata->gyry, imudata->gyrz, imudata->accx, imudata->accy, imudata->accz, dt);
+    }
+
+    float forwardSpeed = airspeeddata->isDataNew ? (float) airspeeddata->airspeed : 0.0f;
+    ekf.updateGravity(imudata->accx, imudata->accy, imudata->accz, forwardSpeed);
+
+    if (airspeeddata->isDataNew) {
+        ekf.updateAirspeed((float) airspeeddata->airspeed);
+    }
+
+    if (gps != nullptr) {
+        ekf.updateGps(*gps);
+    }
+
+    if (altimeter != nullptr) {
+        ekf.updateAltimeter(*altimeter);
+    }
+
+    const float *q = ekf.getState().quaternion;
+    SetAnglesFromQuaternion(q[0], q[1], q[2], q[3], Output);
+
+    float rates[3];
+    ekf.getBodyRates(rates);
+
+    Output->IMUrollrate = rates[0] * RAD_TO_DEG;
+    Output->IMUpitchrate = rates[1] * RAD_TO_DEG;
+    Output->IMUyawrate = rates[2] * RAD_TO_DEG;
+
+    Output->Airspeed = airspeeddata->airspeed;
+
+    Output->sampleTimeUs = imudata->sampleTimeUs;
+
+    return SFError;
+}
+
+static SFError_t CheckInputs(IMU_Data_t *imudata, Airspeed_Data_t *airspeeddata) {
+
+    //Error output
+    SFError_t SFError;
+
+    SFError.errorCode = 0;
+
     //Abort if both sensors are busy or failed data collection
     if(imudata->sensorStatus != 0 || airspeeddata->sensorStatus != 0)
     {  
@@ -53,30 +187,18 @@ SFError_t SF_GetResult(SFOutput_t *Output, IMU_Data_t *imudata, Airspeed_Data_t
         imudata->magz = 0.0f;
     }
 
-    MadgwickAHRSupdate(imudata->gyrx, imudata->gyry, imudata->gyrz, imudata->accx, imudata->accy, imudata->accz, imudata->magx, imudata->magy, imudata->magz);
-
-    //Convert quaternion output to angles (in deg)
-    imu_RollAngle = atan2f(q0 * q1 + q2 * q3, 0.5f - q1 * q1 - q2 * q2) * 57.29578f;
-    imu_PitchAngle = asinf(-2.0f * (q1 * q3 - q0 * q2)) * 57.29578f;
-    imu_YawAngle = atan2f(q1 * q2 + q0 * q3, 0.5f - q2 * q2 - q3 * q3) * 57.29578f + 180.0f;
-
-    //Convert rate of change of quaternion to angular velocity (in deg/s)
-    imu_RollRate = atan2f(qDot1 * qDot2 + qDot3 * qDot4, 0.5f - qDot2 * qDot2 - qDot3 * qDot3) * 57.29578f;
-    imu_PitchRate = asinf(-2.0f * (qDot2 * qDot4 - qDot1 * qDot3)) * 57.29578f;
-    imu_YawRate = atan2f(qDot2 * qDot3 + qDot1 * qDot4, 0.5f - qDot3 * qDot3 - qDot4 * qDot4) * 57.29578f + 180.0f;
-
-    //Transfer Fused IMU data into SF Output struct
-    Output->IMUpitch = imu_PitchAngle;
-    Output->IMUroll = imu_RollAngle;
-    Output->IMUyaw = imu_YawAngle;
-
-    Output->IMUpitchrate = imu_PitchRate;
-    Output->IMUrollrate = imu_RollRate;
-    Output->IMUyawrate = imu_YawRate;
-
-    //Transfer Airspeed data
-    Output->Airspeed = airspeeddata->airspeed;
-
     return SFError;
 }
 
+// The rates of a driver that reports an interval are means over exactly that interval, the stamps only place it in
+// time and jitter with the cycle. The stamp step is still taken so the filter keeps following the stamps.
+static float integrationStep(float stampStep, const IMU_Data_t *imudata) {
+    return (imudata->deltaTime > 0.0f) ? imudata->deltaTime : stampStep;
+}
+
+static void SetAnglesFromQuaternion(float q0, float q1, float q2, float q3, SFOutput_t *Output) {
+    //Convert quaternion output to angles (in deg)
+    Output->IMUroll = FastMath_Atan2(q0 * q1 + q2 * q3, 0.5f - q1 * q1 - q2 * q2) * RAD_TO_DEG;
+    Output->IMUpitch = FastMath_Asin(-2.0f * (q1 * q3 - q0 * q2)) * RAD_TO_DEG;
+    Output->IMUyaw = FastMath_Atan2(q1 * q2 + q0 * q3, 0.5f - q2 * q2 - q3 * q3) * RAD_TO_DEG + 180.0f;
+}
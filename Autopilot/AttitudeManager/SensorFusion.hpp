@@ -4,6 +4,8 @@
  */
 
 #include "AttitudeDatatypes.hpp"
+#include "MadgwickAHRS.h"
+#include "NavigationEKF.hpp"
 
 #ifndef SENSORFUSION_HPP
 #define SENSORFUSION_HPP
@@ -13,6 +15,8 @@ struct SFOutput_t {
     float IMUrollrate, IMUpitchrate, IMUyawrate; //in rad/s (for now)
 
     float Airspeed; //in m/s (for now)
+
+    uint32_t sampleTimeUs; // of the IMU sample this was computed from
 };
 
 // -1 = FAILED
@@ -22,10 +26,40 @@ struct SFError_t{
     int errorCode;
 };
 
+// The estimator behind SF_GetResult
+enum SFEngine_t {SF_ENGINE_MADGWICK = 0, SF_ENGINE_EKF};
+
 /**
  * Method takes in the data from the imu and airspeed sensors along with a SFOutput_t reference.
  * This ensures SensorFusion does not have access to the sensor drivers
  */ 
 SFError_t SF_GetResult(SFOutput_t *Output, IMU_Data_t *imudata, Airspeed_Data_t *airspeeddata);
 
+/**
+ * Same as SF_GetResult but runs the given filter instead of the default one, eg for a redundant IMU or a shadow filter
+ * with different gains.
+ */
+SFError_t SF_GetResultFrom(MadgwickFilter &filter, SFOutput_t *Output, IMU_Data_t *imudata, Airspeed_Data_t *airspeeddata);
+
+/**
+ * Same as SF_GetResult but runs the given EKF. The EKF reports the bias corrected gyro as the rates rather than a
+ * quaternion derivative. Madgwick has no use for GPS or barometer data, the EKF fuses them when given.
+ * @param[in]   gps, altimeter      nullptr when there is nothing new to fuse.
+ */
+SFError_t SF_GetResultFrom(NavigationEKF &ekf, SFOutput_t *Output, IMU_Data_t *imudata, Airspeed_Data_t *airspeeddata,
+                           const GpsData_t *gps, const AltimeterData_t *altimeter);
+
+/**
+ * Chooses the estimator SF_GetResult runs, Madgwick by default. Selecting the EKF restarts it, it realigns on the
+ * next sample.
+ */
+void SF_SelectEngine(SFEngine_t engine);
+SFEngine_t SF_GetEngine();
+
+/**
+ * Hands the latest GPS and barometer readings to SF_GetResult, which fuses them on its next call if the EKF is
+ * selected. Either can be nullptr.
+ */
+void SF_SetAidingData(const GpsData_t *gps, const AltimeterData_t *altimeter);
+
 #endif
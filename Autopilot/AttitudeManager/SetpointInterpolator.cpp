@@ -0,0 +1,73 @@
+#include "SetpointInterpolator.hpp"
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+static float Interpolate(float from, float to, float fraction);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+SetpointInterpolator::SetpointInterpolator(uint32_t _nominalPeriodUs, const PMCommands &initial) : nominalPeriodUs(_nominalPeriodUs)
+{
+    from = initial;
+    to = initial;
+    rampStartUs = 0;
+    rampUs = 0;
+
+    hasSetpoint = false;
+    lastSetpointUs = 0;
+}
+
+void SetpointInterpolator::setTarget(const PathSetpoint_t &setpoint, uint32_t nowUs)
+{
+    getCommands(nowUs, from);
+
+    // A late setpoint is spread over a little more time and an early one over a little less, within reason
+    uint32_t periodUs = hasSetpoint ? setpoint.timeUs - lastSetpointUs : nominalPeriodUs;
+
+    if (periodUs < nominalPeriodUs / 2)
+    {
+        periodUs = nominalPeriodUs / 2;
+    }
+    else if (periodUs > nominalPeriodUs * 2)
+    {
+        periodUs = nominalPeriodUs * 2;
+    }
+
+    to.roll = setpoint.roll;
+    to.pitch = setpoint.pitch;
+    to.yaw = setpoint.rudder;
+    to.airspeed = setpoint.airspeed;
+
+    rampStartUs = nowUs;
+    rampUs = periodUs;
+
+    hasSetpoint = true;
+    lastSetpointUs = setpoint.timeUs;
+}
+
+void SetpointInterpolator::getCommands(uint32_t nowUs, PMCommands &commands) const
+{
+    uint32_t elapsedUs = nowUs - rampStartUs;
+
+    if (elapsedUs >= rampUs)
+    {
+        commands = to;
+        return;
+    }
+
+    float fraction = (float) elapsedUs / (float) rampUs;
+
+    commands.roll = Interpolate(from.roll, to.roll, fraction);
+    commands.pitch = Interpolate(from.pitch, to.pitch, fraction);
+    commands.yaw = Interpolate(from.yaw, to.yaw, fraction);
+    commands.airspeed = Interpolate(from.airspeed, to.airspeed, fraction);
+}
+
+static float Interpolate(float from, float to, float fraction)
+{
+    return from + (to - from) * fraction;
+}
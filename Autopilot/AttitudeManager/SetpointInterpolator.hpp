@@ -0,0 +1,57 @@
+/**
+ * Turns the setpoints that the path manager publishes every few attitude cycles into commands that change a little
+ * every attitude cycle.
+ *
+ * When a new setpoint comes in, the commands ramp linearly from wherever they are at that moment to the new setpoint.
+ * The ramp lasts as long as the time between the stamps of the last two setpoints, which is PATH_GUIDANCE_PERIOD_US
+ * while the path manager keeps its rate. Starting from the current commands rather than from the previous setpoint
+ * keeps the commands continuous even when a setpoint comes in early or late. The price is that the commands lag the
+ * path manager by about one of its periods.
+ */
+
+#ifndef SETPOINT_INTERPOLATOR_HPP
+#define SETPOINT_INTERPOLATOR_HPP
+
+#include <stdint.h>
+
+#include "GetFromPathManager.hpp"
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+class SetpointInterpolator
+{
+    public:
+        /**
+        * @param[in]    _nominalPeriodUs    the expected time between two setpoints.
+        * @param[in]    initial             the commands until the first setpoint comes in.
+        */
+        SetpointInterpolator(uint32_t _nominalPeriodUs, const PMCommands &initial);
+
+        /**
+        * Starts a ramp from the commands at nowUs to a new setpoint.
+        * @param[in]    setpoint    the new setpoint.
+        * @param[in]    nowUs       the current time.
+        */
+        void setTarget(const PathSetpoint_t &setpoint, uint32_t nowUs);
+
+        /**
+        * @param[in]    nowUs       the current time, not before the last call to setTarget.
+        * @param[out]   commands    the commands at nowUs.
+        */
+        void getCommands(uint32_t nowUs, PMCommands &commands) const;
+
+    private:
+        uint32_t nominalPeriodUs;
+
+        PMCommands from;
+        PMCommands to;
+        uint32_t rampStartUs;
+        uint32_t rampUs;
+
+        bool hasSetpoint;
+        uint32_t lastSetpointUs;
+};
+
+#endif
@@ -1,15 +1,18 @@
 #include "attitudeStateClasses.hpp"
 
+#include <cmath>
+
 /***********************************************************************************************************************
  * Definitions
  **********************************************************************************************************************/
 
-float OutputMixingMode::_channelOut[4];
+ChannelOut_t OutputMixingMode::_channelOut;
 PMCommands fetchInstructionsMode::_PMInstructions;
 SFOutput_t sensorFusionMode::_SFOutput;
 PID_Output_t PIDloopMode::_PidOutput;
 IMU_Data_t fetchSensorMeasurementsMode::_imudata;
 Airspeed_Data_t fetchSensorMeasurementsMode::_airspeeddata;
+ImuFilter fetchSensorMeasurementsMode::_imuFilter;
 
 /***********************************************************************************************************************
  * Code
@@ -19,9 +22,12 @@ void fetchInstructionsMode::execute(attitudeManager* attitudeMgr)
 {
 
     PMError_t ErrorStruct = PM_GetCommands(&_PMInstructions);
+    AttitudeRecorder_RecordCommands(&_PMInstructions, ErrorStruct.errorCode);
 
     if (ErrorStruct.errorCode == 0)
     {
+        PMCommandsTopic.publish(_PMInstructions);
+
         // Before calling sensor fusion, we must first get the new sensor data
         attitudeMgr->setState(fetchSensorMeasurementsMode::getInstance()); 
     }
@@ -40,13 +46,26 @@ attitudeState& fetchInstructionsMode::getInstance()
 void fetchSensorMeasurementsMode::execute(attitudeManager* attitudeMgr) 
 {
     // Initializes the sensor data structures 
-    SensorError_t ErrorStruct = SensorMeasurements_GetResult(&ImuSens, &AirspeedSens, &_imudata, &_airspeeddata); 
+    SensorError_t ErrorStruct = SensorBinding::fetch(ImuSens, AirspeedSens, &_imudata, &_airspeeddata);
+    AttitudeRecorder_RecordSensors(&_imudata, &_airspeeddata, ErrorStruct.errorCode);
 
     if (ErrorStruct.errorCode == 0)
     {
+        // The recorder keeps the raw measurements, a replay runs them through the same filters
+        _imuFilter.apply(_imudata);
+
+        IMUDataTopic.publish(_imudata);
+        AirspeedDataTopic.publish(_airspeeddata);
+
         // Sets state to sensor fusion
         attitudeMgr->setState(sensorFusionMode::getInstance()); 
     }
+    else if (ErrorStruct.errorCode == 1)
+    {
+        // Nothing new to act on (the IMU is starting up or dropped an overflowed FIFO), the outputs keep their last
+        // commands and the next cycle tries again
+        attitudeMgr->setState(fetchInstructionsMode::getInstance());
+    }
     else 
     {
         attitudeMgr->setState(FatalFailureMode::getInstance());
@@ -61,13 +80,22 @@ attitudeState& fetchSensorMeasurementsMode::getInstance()
 
 void sensorFusionMode::execute(attitudeManager* attitudeMgr)
 {   
-    IMU_Data_t *dataimu = fetchSensorMeasurementsMode::GetIMUOutput();
-    Airspeed_Data_t *dataairspeed = fetchSensorMeasurementsMode::GetAirspeedOutput();
+    IMU_Data_t dataimu;
+    Airspeed_Data_t dataairspeed;
+
+    // Both topics are written earlier in this same cycle, so a failed read means something else is writing them
+    if ( ! IMUDataTopic.read(dataimu) || ! AirspeedDataTopic.read(dataairspeed))
+    {
+        attitudeMgr->setState(FatalFailureMode::getInstance());
+        return;
+    }
 
-    SFError_t ErrorStruct = SF_GetResult(&_SFOutput, dataimu, dataairspeed);
+    SFError_t ErrorStruct = SF_GetResult(&_SFOutput, &dataimu, &dataairspeed);
 
     if (ErrorStruct.errorCode == 0)
     {
+        LatencyTrace_Mark(LATENCY_STAGE_FUSION, _SFOutput.sampleTimeUs);
+        SFOutputTopic.publish(_SFOutput);
         attitudeMgr->setState(PIDloopMode::getInstance());
     }
     else
@@ -82,29 +110,43 @@ attitudeState& sensorFusionMode::getInstance()
     return singleton;
 }
 
-void PIDloopMode::execute(attitudeManager* attitudeMgr)
+PIDloopMode::PIDloopMode()
 {
+    _pids.setAxis(ROLL_AXIS, 1, 0, 0, 0, -100, 100);
+    _pids.setAxis(PITCH_AXIS, 1, 0, 0, 0, -100, 100);
+    _pids.setAxis(AIRSPEED_AXIS, 1, 0, 0, 0, 0, 100);
+}
 
-    PMCommands *PMInstructions = fetchInstructionsMode::GetPMInstructions();
-    SFOutput_t *SFOutput = sensorFusionMode::GetSFOutput();
-
-    // Gets roll, pitch, yaw, and airspeed commands from the path manager module
-    PMCommands pathManagerOutput;
-    PMError_t pmError = PM_GetCommands(&pathManagerOutput);
+void PIDloopMode::execute(attitudeManager* attitudeMgr)
+{
 
-    _PidOutput.rollPercent = _rollPid.execute(PMInstructions->roll, SFOutput->IMUroll, SFOutput->IMUrollrate);
-    _PidOutput.pitchPercent = _pitchPid.execute(PMInstructions->pitch, SFOutput->IMUpitch, SFOutput->IMUpitchrate);
-    _PidOutput.yawPercent = pathManagerOutput.yaw;
-    _PidOutput.throttlePercent = _airspeedPid.execute(PMInstructions->airspeed, SFOutput->Airspeed);
+    PMCommands PMInstructions;
+    SFOutput_t SFOutput;
 
-    if (pmError.errorCode == 0) 
-    {
-        attitudeMgr->setState(OutputMixingMode::getInstance());
-    }
-    else 
+    if ( ! PMCommandsTopic.read(PMInstructions) || ! SFOutputTopic.read(SFOutput))
     {
         attitudeMgr->setState(FatalFailureMode::getInstance());
+        return;
     }
+
+    // The airspeed has no measured rate, its derivative comes from the history
+    const float desired[NUM_AXES] = {PMInstructions.roll, PMInstructions.pitch, PMInstructions.airspeed};
+    const float actual[NUM_AXES] = {SFOutput.IMUroll, SFOutput.IMUpitch, SFOutput.Airspeed};
+    const float actualRate[NUM_AXES] = {SFOutput.IMUrollrate, SFOutput.IMUpitchrate, std::nanf("")};
+    float percent[NUM_AXES];
+
+    _pids.execute(desired, actual, actualRate, percent);
+
+    _PidOutput.rollPercent = percent[ROLL_AXIS];
+    _PidOutput.pitchPercent = percent[PITCH_AXIS];
+    _PidOutput.yawPercent = PMInstructions.yaw;
+    _PidOutput.throttlePercent = percent[AIRSPEED_AXIS];
+    _PidOutput.sampleTimeUs = SFOutput.sampleTimeUs;
+
+    LatencyTrace_Mark(LATENCY_STAGE_PID, _PidOutput.sampleTimeUs);
+    PIDOutputTopic.publish(_PidOutput);
+
+    attitudeMgr->setState(OutputMixingMode::getInstance());
 }
 
 attitudeState& PIDloopMode::getInstance()
@@ -115,12 +157,21 @@ attitudeState& PIDloopMode::getInstance()
 
 void OutputMixingMode::execute(attitudeManager* attitudeMgr)
 {
-    PID_Output_t *PidOutput = PIDloopMode::GetPidOutput();
+    PID_Output_t PidOutput;
+
+    if ( ! PIDOutputTopic.read(PidOutput))
+    {
+        attitudeMgr->setState(FatalFailureMode::getInstance());
+        return;
+    }
 
-    OutputMixing_error_t ErrorStruct = OutputMixing_Execute(PidOutput, _channelOut);
+    OutputMixing_error_t ErrorStruct = OutputMixing_Execute(&PidOutput, _channelOut.channel);
+    _channelOut.sampleTimeUs = PidOutput.sampleTimeUs;
 
     if (ErrorStruct.errorCode == 0)
     {
+        LatencyTrace_Mark(LATENCY_STAGE_MIX, _channelOut.sampleTimeUs);
+        ChannelOutTopic.publish(_channelOut);
         attitudeMgr->setState(sendToSafetyMode::getInstance());
     }
     else
@@ -138,22 +189,26 @@ attitudeState& OutputMixingMode::getInstance()
 
 void sendToSafetyMode::execute(attitudeManager* attitudeMgr)
 {
-    SendToSafety_error_t ErrorStruct;
-    float *channelOut = OutputMixingMode::GetChannelOut();
-    for(int channel = 0; channel < 4; channel++)
+    ChannelOut_t channelOut;
+
+    if ( ! ChannelOutTopic.read(channelOut))
     {
-        ErrorStruct = SendToSafety_Execute(channel, channelOut[channel]);
-        if(ErrorStruct.errorCode == 1)
-        {
-            attitudeMgr->setState(FatalFailureMode::getInstance());
-            break;
-        }
+        attitudeMgr->setState(FatalFailureMode::getInstance());
+        return;
     }
 
+    SendToSafety_error_t ErrorStruct = SendToSafety_Commit(channelOut.channel, NUM_MIXED_CHANNELS, channelOut.sampleTimeUs);
+
     if (ErrorStruct.errorCode == 0)
     {
+        LatencyTrace_Mark(LATENCY_STAGE_HANDOFF, channelOut.sampleTimeUs);
+
         attitudeMgr->setState(fetchInstructionsMode::getInstance());
     }
+    else
+    {
+        attitudeMgr->setState(FatalFailureMode::getInstance());
+    }
 
 }
 
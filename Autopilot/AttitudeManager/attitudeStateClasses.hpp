@@ -3,40 +3,52 @@
 #include "attitudeStateManager.hpp"
 #include "attitudeManager.hpp"
 #include "AttitudeDatatypes.hpp"
+#include "AttitudeDataBus.hpp"
+#include "AttitudeRecorder.hpp"
+#include "LatencyTrace.hpp"
 
 #include "GetFromPathManager.hpp"
 #include "SensorFusion.hpp"
 #include "OutputMixing.hpp"
-#include "PID.hpp"
+#include "PIDBank.hpp"
 #include "SendInstructionsToSafety.hpp"
 #include "IMU.hpp"
 #include "airspeed.hpp"
 #include "fetchSensorMeasurementsMode.hpp"
+#include "ImuFilter.hpp"
 
 /***********************************************************************************************************************
  * Definitions
  **********************************************************************************************************************/
 
+// Which sensor drivers fetchSensorMeasurementsMode owns, and whether it calls them directly (see fetchSensorMeasurementsMode.hpp)
+
 #ifdef SIMULATION
 
-#define IMU_CLASS SimulatedIMU
-#define AIRSPEED_CLASS SimulatedAirspeed
+typedef StaticSensorBinding<SimulatedIMU, SimulatedAirspeed> SensorBinding;
+
+#elif defined(ATTITUDE_REPLAY)
+
+// The replay harness intercepts SensorMeasurements_GetResult, so the sensor objects are never touched
+typedef DynamicSensorBinding<ICM20602, dummyairspeed> SensorBinding;
 
 #elif defined(UNIT_TESTING)
 
-#define IMU_CLASS MockIMU
-#define AIRSPEED_CLASS MockAirspeed
+// The tests fake SensorMeasurements_GetResult
+typedef DynamicSensorBinding<MockIMU, MockAirspeed> SensorBinding;
 
 #else
 
-#define IMU_CLASS ICM20602  // TODO to be replaced with the real classes once the sensor drivers are built
-#define AIRSPEED_CLASS dummyairspeed
+typedef StaticSensorBinding<ICM20602, dummyairspeed> SensorBinding; // TODO to be replaced with the real classes once the sensor drivers are built
 
 #endif
 /***********************************************************************************************************************
  * Code
  **********************************************************************************************************************/
 
+// Every state that produces data keeps its working copy in a private static member and publishes it on the
+// corresponding topic of AttitudeDataBus.hpp once it is complete. Consumers only ever read from the topics.
+
 
 class fetchInstructionsMode : public attitudeState
 {
@@ -45,7 +57,6 @@ class fetchInstructionsMode : public attitudeState
         void execute(attitudeManager* attitudeMgr);
         void exit(attitudeManager* attitudeMgr) {(void) attitudeMgr;}
         static attitudeState& getInstance();
-        static PMCommands *GetPMInstructions(void) {return &_PMInstructions;}
     private:
         fetchInstructionsMode() {}
         fetchInstructionsMode(const fetchInstructionsMode& other);
@@ -60,16 +71,15 @@ class fetchSensorMeasurementsMode : public attitudeState
         void execute(attitudeManager* attitudeMgr);
         void exit(attitudeManager* attitudeMgr) {(void) attitudeMgr;}
         static attitudeState& getInstance();
-        static IMU_Data_t *GetIMUOutput(void) {return &_imudata;}
-        static Airspeed_Data_t *GetAirspeedOutput(void) {return &_airspeeddata;}
     private:
         fetchSensorMeasurementsMode() {}
         fetchSensorMeasurementsMode(const fetchSensorMeasurementsMode& other);
         fetchSensorMeasurementsMode& operator =(const fetchSensorMeasurementsMode& other);
         static IMU_Data_t _imudata;
         static Airspeed_Data_t _airspeeddata;
-        IMU_CLASS ImuSens;
-        AIRSPEED_CLASS AirspeedSens;
+        static ImuFilter _imuFilter;
+        SensorBinding::ImuDriver ImuSens;
+        SensorBinding::AirspeedDriver AirspeedSens;
 };
 
 class sensorFusionMode : public attitudeState
@@ -79,7 +89,6 @@ class sensorFusionMode : public attitudeState
         void execute(attitudeManager* attitudeMgr);
         void exit(attitudeManager* attitudeMgr) {(void) attitudeMgr;}
         static attitudeState& getInstance();
-        static SFOutput_t *GetSFOutput(void) {return &_SFOutput;}
     private:
         sensorFusionMode() {}
         sensorFusionMode(const sensorFusionMode& other);
@@ -94,15 +103,12 @@ class PIDloopMode : public attitudeState
         void execute(attitudeManager* attitudeMgr);
         void exit(attitudeManager* attitudeMgr) {(void) attitudeMgr;}
         static attitudeState& getInstance();
-        static PID_Output_t *GetPidOutput(void) {return &_PidOutput;}
     private:
-        PIDloopMode() {}
+        PIDloopMode();
         PIDloopMode(const PIDloopMode& other);
         PIDloopMode& operator =(const PIDloopMode& other);
-        PIDController _rollPid{1, 0, 0, 0, -100, 100};
-        PIDController _pitchPid{1, 0, 0, 0, -100, 100};
-        PIDController _yawPid{1, 0, 0, 0, -100, 100};
-        PIDController _airspeedPid{1, 0, 0, 0, 0, 100};
+        enum {ROLL_AXIS = 0, PITCH_AXIS, AIRSPEED_AXIS, NUM_AXES};  // yaw comes from the path manager as is
+        PIDBank<NUM_AXES> _pids;
         static PID_Output_t _PidOutput;
 };
 
@@ -113,12 +119,11 @@ class OutputMixingMode : public attitudeState
         void execute(attitudeManager* attitudeMgr);
         void exit(attitudeManager* attitudeMgr) {(void) attitudeMgr;}
         static attitudeState& getInstance();
-        static float *GetChannelOut(void) {return _channelOut;}
     private:
         OutputMixingMode() {}
         OutputMixingMode(const OutputMixingMode& other);
         OutputMixingMode& operator =(const OutputMixingMode& other);
-        static float _channelOut[4];
+        static ChannelOut_t _channelOut;
 };
 
 class sendToSafetyMode : public attitudeState
@@ -20,9 +20,116 @@ struct SensorError_t {
 
 /**
  * Takes in sensor objects and the output data structures as parameters. 
- * This is the only module that interacts with the sensor drivers
+ * This is the only module that interacts with the sensor drivers.
+ *
+ * The drivers are reached through the IMU and airspeed base classes, ie one virtual call per sensor. This is what the
+ * unit tests hook into (fakes and GMock mocks); flight code binds the drivers at compile time, see StaticSensorBinding.
  */ 
 SensorError_t SensorMeasurements_GetResult(IMU *imusns, airspeed *airspeedsns, IMU_Data_t *imudata, Airspeed_Data_t *airspeeddata);
 
-#endif
+/**
+ * Same as SensorMeasurements_GetResult, for drivers whose type is known at compile time. When ImuT and AirspeedT are
+ * concrete (final) driver classes, GetResult is called directly and can be inlined.
+ */
+template <typename ImuT, typename AirspeedT>
+SensorError_t SensorMeasurements_Fetch(ImuT &imusns, AirspeedT &airspeedsns, IMU_Data_t *imudata, Airspeed_Data_t *airspeeddata)
+{
+    SensorError_t error;
+    error.errorCode = 0;
+
+    // Structures from sensor driver files
+    /* 
+        Why am I making these? 
+
+        When cleaning up the Attitude Manager, one of the goals was to ensure that only a select few modules have access to the senor driver files (IMU.hpp, etc.)
+        To accomplish this, new structs to store the sensor data were created and declared in AttitudeDatatypes.hpp. These structs ensure that moduels (ex. Sensor Fusion)
+        that need access to sensor data do not need to inclued the sensor driver header files. Unfortunately, the sensor drivers only accept the structs declared in the sensor
+        driver header files, so we need to declare these temporary data structures to get the sensor data. 
+    */
+    // Zeroed so fields a driver does not fill in (deltaTime for most) read as not reported
+    IMUData_t tempIMUdata = {};
+    airspeedData_t tempAirspeedData = {};
+
+    //Retrieve raw IMU and Airspeed data
+    imusns.GetResult(tempIMUdata);
+    airspeedsns.GetResult(tempAirspeedData);
+
+    // Copies values over to the attitude manager's sensor data structs 
+    imudata->gyrx = tempIMUdata.gyrx;
+    imudata->gyry = tempIMUdata.gyry;
+    imudata->gyrz = tempIMUdata.gyrz;
+
+    imudata->accx = tempIMUdata.accx;
+    imudata->accy = tempIMUdata.accy;
+    imudata->accz = tempIMUdata.accz;
+
+    imudata->magx = tempIMUdata.magx;
+    imudata->magy = tempIMUdata.magy;
+    imudata->magz = tempIMUdata.magz;
+
+    imudata->isDataNew = tempIMUdata.isDataNew;
+    imudata->sensorStatus = tempIMUdata.sensorStatus;
+    imudata->utcTime = tempIMUdata.utcTime;
+    imudata->sampleTimeUs = tempIMUdata.sampleTimeUs;
+    imudata->deltaTime = tempIMUdata.deltaTime;
+
+    airspeeddata->airspeed = tempAirspeedData.airspeed;
+    airspeeddata->sensorStatus = tempAirspeedData.sensorStatus;
+    airspeeddata->isDataNew = tempAirspeedData.isDataNew;
+    airspeeddata->utcTime = tempAirspeedData.utcTime;
+
+    //Abort if both sensors are busy or failed data collection
+    if(imudata->sensorStatus != 0 || airspeeddata->sensorStatus != 0)
+    {  
+
+        /************************************************************************************************
+         * THIS WILL PUT THE STATE MACHINE INTO FATAL FAILURE MODE... WE NEED TO DECIDE IF THIS IS WHAT
+         * WE WANT OR IF WE SHOULD RETHINK HOW WE WANT THIS MODULE TO RETURN A SENSOR ERROR! 
+         ************************************************************************************************/
 
+        error.errorCode = -1;
+        return error;
+    }
+
+    //Check if data is old
+    if(!imudata->isDataNew || !airspeeddata->isDataNew){
+        error.errorCode = 1;
+    }
+
+    return error;
+}
+
+/**
+ * Sensor policies for fetchSensorMeasurementsMode. A policy names the driver types the state owns and how it fetches
+ * from them. Every fetch first has the IMU drain what it sampled since the last cycle (Begin_Measuring), then reads it.
+ */
+
+// Drivers bound at compile time. Use with final driver classes so the calls are direct.
+template <typename ImuT, typename AirspeedT>
+struct StaticSensorBinding
+{
+    typedef ImuT ImuDriver;
+    typedef AirspeedT AirspeedDriver;
+
+    static SensorError_t fetch(ImuT &imusns, AirspeedT &airspeedsns, IMU_Data_t *imudata, Airspeed_Data_t *airspeeddata)
+    {
+        imusns.Begin_Measuring();
+        return SensorMeasurements_Fetch(imusns, airspeedsns, imudata, airspeeddata);
+    }
+};
+
+// Drivers reached through SensorMeasurements_GetResult, so it can be faked or intercepted
+template <typename ImuT, typename AirspeedT>
+struct DynamicSensorBinding
+{
+    typedef ImuT ImuDriver;
+    typedef AirspeedT AirspeedDriver;
+
+    static SensorError_t fetch(ImuT &imusns, AirspeedT &airspeedsns, IMU_Data_t *imudata, Airspeed_Data_t *airspeeddata)
+    {
+        imusns.Begin_Measuring();
+        return SensorMeasurements_GetResult(&imusns, &airspeedsns, imudata, airspeeddata);
+    }
+};
+
+#endif
@@ -0,0 +1,27 @@
+/**
+ * Drives the attitude task from TIM10. The timer interrupt notifies the task, which runs one attitude manager
+ * cycle per notification (see AttitudeTask.hpp).
+ */
+
+#ifndef ATTITUDE_TIMER_TICK_H
+#define ATTITUDE_TIMER_TICK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+* Attitude task entry point, started by freertos.c.
+*/
+void Attitude_Run(void const *argument);
+
+/**
+* To be called from HAL_TIM_PeriodElapsedCallback when TIM10 elapses.
+*/
+void AttitudeTimerTick_OnTimerElapsed(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
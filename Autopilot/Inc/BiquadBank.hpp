@@ -0,0 +1,183 @@
+/**
+ * Cascaded biquad filters over a fixed number of channels.
+ *
+ * Every channel runs the same number of sections, each with its own coefficients. The state and the coefficients are
+ * stored section major with the channels innermost (structure of arrays), so one section of every channel is updated
+ * by one loop over contiguous floats. The host compiler vectorises that loop and on the M7 the independent channels
+ * fill the FPU pipeline, where a channel by channel cascade would wait on each multiply-add in turn.
+ *
+ * The sections are in transposed direct form II:
+ *
+ *   y = b0 x + z1,    z1 = b1 x - a1 y + z2,    z2 = b2 x - a2 y
+ *
+ * The design functions follow the RBJ Audio EQ Cookbook. A section with a cutoff or centre at or above Nyquist (or
+ * at 0 Hz) is returned as a pass through, so a filter can be disabled through its configuration.
+ */
+
+#ifndef BIQUAD_BANK_HPP
+#define BIQUAD_BANK_HPP
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define BIQUAD_BUTTERWORTH_Q 0.70710678f
+
+// Normalised so that a0 is 1
+struct BiquadCoefficients_t
+{
+    float b0, b1, b2;
+    float a1, a2;
+};
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+BiquadCoefficients_t Biquad_PassThrough(void);
+
+/**
+* Second order low pass, unity gain at DC.
+* @param[in]    cutoffHz        -3 dB frequency for q = BIQUAD_BUTTERWORTH_Q.
+* @param[in]    sampleRateHz    rate at which the section is run.
+*/
+BiquadCoefficients_t Biquad_LowPass(float cutoffHz, float sampleRateHz, float q);
+
+/**
+* Notch, unity gain away from the centre.
+* @param[in]    centreHz        frequency that is removed.
+* @param[in]    q               centre frequency over the -3 dB bandwidth.
+*/
+BiquadCoefficients_t Biquad_Notch(float centreHz, float sampleRateHz, float q);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+template <int CHANNELS, int SECTIONS>
+class BiquadBank
+{
+    public:
+        // Every section starts out as a pass through
+        BiquadBank()
+        {
+            BiquadCoefficients_t passThrough = Biquad_PassThrough();
+
+            for (int section = 0; section < SECTIONS; section++)
+            {
+                for (int channel = 0; channel < LANES; channel++)
+                {
+                    setSection(section, channel, passThrough);
+                }
+            }
+
+            reset();
+        }
+
+        static constexpr int channels() {return CHANNELS;}
+        static constexpr int sections() {return SECTIONS;}
+
+        // Changing coefficients keeps the state, so a filter can be retuned while it runs
+        void setSection(int section, int channel, const BiquadCoefficients_t &coefficients)
+        {
+            b0[section][channel] = coefficients.b0;
+            b1[section][channel] = coefficients.b1;
+            b2[section][channel] = coefficients.b2;
+            a1[section][channel] = coefficients.a1;
+            a2[section][channel] = coefficients.a2;
+        }
+
+        void setSection(int section, const BiquadCoefficients_t &coefficients)
+        {
+            for (int channel = 0; channel < CHANNELS; channel++)
+            {
+                setSection(section, channel, coefficients);
+            }
+        }
+
+        void reset()
+        {
+            for (int section = 0; section < SECTIONS; section++)
+            {
+                for (int channel = 0; channel < LANES; channel++)
+                {
+                    z1[section][channel] = 0.0f;
+                    z2[section][channel] = 0.0f;
+                }
+            }
+        }
+
+        /**
+        * Sets the state to where it would have settled had input been held forever, so the first samples do not ring
+        * from 0 up to the actual value.
+        */
+        void prime(const float input[CHANNELS])
+        {
+            float x[CHANNELS];
+
+            for (int channel = 0; channel < CHANNELS; channel++)
+            {
+                x[channel] = input[channel];
+            }
+
+            for (int section = 0; section < SECTIONS; section++)
+            {
+                for (int channel = 0; channel < CHANNELS; channel++)
+                {
+                    float gain = (b0[section][channel] + b1[section][channel] + b2[section][channel]) /
+                                 (1.0f + a1[section][channel] + a2[section][channel]);
+                    float y = gain * x[channel];
+
+                    z1[section][channel] = y - b0[section][channel] * x[channel];
+                    z2[section][channel] = b2[section][channel] * x[channel] - a2[section][channel] * y;
+                    x[channel] = y;
+                }
+            }
+        }
+
+        // One sample of every channel through every section. input and output may be the same array.
+        void apply(const float input[CHANNELS], float output[CHANNELS])
+        {
+            float x[LANES];
+
+            for (int channel = 0; channel < LANES; channel++)
+            {
+                x[channel] = (channel < CHANNELS) ? input[channel] : 0.0f;
+            }
+
+            for (int section = 0; section < SECTIONS; section++)
+            {
+                for (int channel = 0; channel < LANES; channel++)
+                {
+                    float y = b0[section][channel] * x[channel] + z1[section][channel];
+
+                    z1[section][channel] = b1[section][channel] * x[channel] - a1[section][channel] * y +
+                                           z2[section][channel];
+                    z2[section][channel] = b2[section][channel] * x[channel] - a2[section][channel] * y;
+                    x[channel] = y;
+                }
+            }
+
+            for (int channel = 0; channel < CHANNELS; channel++)
+            {
+                output[channel] = x[channel];
+            }
+        }
+
+    private:
+        // The rows are padded to a multiple of 4 channels. Loops with a trip count like that get vectorised without
+        // a scalar remainder, which at -O2 is the difference between being vectorised or not. The padding runs the
+        // pass through on 0.
+        static const int LANES = (CHANNELS + 3) & ~3;
+
+        float b0[SECTIONS][LANES];
+        float b1[SECTIONS][LANES];
+        float b2[SECTIONS][LANES];
+        float a1[SECTIONS][LANES];
+        float a2[SECTIONS][LANES];
+
+        float z1[SECTIONS][LANES];
+        float z2[SECTIONS][LANES];
+};
+
+#endif
@@ -6,6 +6,11 @@
 #ifndef IMU_HPP
 #define IMU_HPP
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ImuFifo.hpp"
+
 #define ICM_20602 0
 #define MPU9255 1
 
@@ -20,6 +25,8 @@ struct IMUData_t {
     bool isDataNew; 
     int sensorStatus; //TBD but probably 0 = SUCCESS, -1 = FAIL, 1 = BUSY 
     float utcTime; //Last time GetResult was called
+    uint32_t sampleTimeUs; //TimeStamp_GetMicroseconds() when the newest sample was taken, to within a sample period, not when it was read
+    float deltaTime; //s the rates are means over, 0 for drivers that report single samples
 };
 
 class IMU{
@@ -41,26 +48,57 @@ class IMU{
  * Derived classes
  **********************************************************************************************************************/
 
-//To be replaced with implementation of actual sensor
-class ICM20602: public IMU{
+// Output data rate and full scales the driver configures
+#define ICM20602_SAMPLE_RATE_HZ 1000
+#define ICM20602_ACCEL_RANGE_G 16
+#define ICM20602_GYRO_RANGE_DPS 2000
+
+/**
+ * Runs the IMU at ICM20602_SAMPLE_RATE_HZ with every sample going through the FIFO. Each Begin_Measuring drains the
+ * FIFO in one burst and pre-integrates it (ImuFifo.hpp), GetResult then reports the interval as its mean rates:
+ * gyr* is the delta angle and acc* the delta velocity divided by the interval, in rad/s and m/s^2. The ICM-20602 has
+ * no magnetometer, mag* are 0.
+ */
+class ICM20602 final : public IMU{
     public:
+        ICM20602();
+
         /**
          * Initializes IMU
          * */
-        void Init(){}; 
+        void Init();
 
         /**
-         * Triggers interrupt for new IMU measurement - stores raw data in variables and returns right away
+         * Reads everything the FIFO holds in one burst and integrates it, after an Init if the IMU is not configured
+         * yet or the last one failed. A FIFO that overflowed is reset and what it held is dropped.
          * */
-        void Begin_Measuring(){}; 
+        void Begin_Measuring();
 
         /**GetResult should:
          * 1. Reset dataIsNew flag
          * 2. Transfers raw data from variables to struct
          * 3. Updates utcTime and status values in struct as well
          * */
-        void GetResult(IMUData_t &Data){}; //
+        void GetResult(IMUData_t &Data);
+
+        /**
+         * What Begin_Measuring does with a burst once it has it off the bus.
+         * @param[in]   bytes, length       the FIFO contents, oldest frame first.
+         * @param[in]   countTimeUs         TimeStamp_GetMicroseconds() just before the FIFO count was read, the newest
+         *                                  frame is at most one sample period older.
+         * */
+        void IngestFifo(const uint8_t *bytes, size_t length, uint32_t countTimeUs);
+
+        // The increment the last GetResult reported
+        const ImuIncrement_t& GetIncrement() const {return increment;}
 
+    private:
+        ImuPreintegrator integrator;
+        ImuFifoScale_t scale;
+        ImuIncrement_t increment;
+        uint32_t newestSampleTimeUs;
+        int status;
+        bool configured;
 };
 
 
@@ -0,0 +1,107 @@
+/**
+ * IMU FIFO ingestion: turns a burst read of the ICM-20602 FIFO into one pre-integrated increment for sensor fusion.
+ *
+ * The IMU samples much faster than the attitude manager runs. Instead of reading one sample per cycle and dropping
+ * the rest, the driver drains the hardware FIFO once per cycle and every sample in it goes through
+ * ImuPreintegrator. What fusion gets is the rotation and the velocity change over the whole interval. The coning
+ * and sculling terms, which come from the axes rotating while the interval is integrated, are included.
+ *
+ * Nothing here touches the bus, so it all runs on the host.
+ */
+
+#ifndef IMU_FIFO_HPP
+#define IMU_FIFO_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "LinearAlgebra.hpp"
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+// With the accelerometer and gyro enabled in FIFO_EN, the ICM-20602 pushes accel x y z, temperature, gyro x y z.
+// Every value is a big endian int16.
+#define ICM20602_FIFO_FRAME_SIZE 14
+#define ICM20602_FIFO_SIZE 1008             // bytes, the FIFO holds 72 frames
+
+#define IMU_FIFO_GRAVITY 9.80665f           // m/s^2 per g
+#define IMU_FIFO_DEG_TO_RAD 0.017453293f
+
+struct ImuFifoScale_t
+{
+    float accel;            // m/s^2 per LSB
+    float gyro;             // rad/s per LSB
+};
+
+// Everything the IMU measured over one fusion interval
+struct ImuIncrement_t
+{
+    float deltaAngle[3];        // rad, rotation vector from the body at the start of the interval to the body at the end
+    float deltaVelocity[3];     // m/s, specific force integrated over the interval, in the body at the start
+    float deltaTime;            // s
+    uint16_t sampleCount;
+    uint32_t sampleTimeUs;      // of the newest sample
+};
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+/**
+* @param[in]    accelRangeG         full scale of the accelerometer, 2, 4, 8 or 16 g.
+* @param[in]    gyroRangeDps        full scale of the gyro, 250, 500, 1000 or 2000 deg/s.
+*/
+ImuFifoScale_t ImuFifo_Scale(int accelRangeG, int gyroRangeDps);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+class ImuPreintegrator
+{
+    public:
+        ImuPreintegrator() {reset();}
+
+        void reset();
+
+        /**
+        * Adds one sample.
+        * @param[in]    gyro        rad/s
+        * @param[in]    accel       m/s^2
+        * @param[in]    dt          s, the sample period
+        */
+        void addSample(const float gyro[3], const float accel[3], float dt);
+
+        uint16_t getSampleCount() const {return sampleCount;}
+
+        /**
+        * Hands out what has been integrated since the last call and starts a new interval.
+        * @param[in]    sampleTimeUs        time stamp of the newest sample.
+        */
+        ImuIncrement_t take(uint32_t sampleTimeUs);
+
+    private:
+        Vec3 alpha;                 // sum of the delta angles
+        Vec3 beta;                  // coning correction
+        Vec3 velocity;              // sum of the delta velocities
+        Vec3 sculling;              // sculling correction
+        Vec3 lastDeltaAngle;
+        Vec3 lastDeltaVelocity;
+        float deltaTime;
+        uint16_t sampleCount;
+};
+
+/**
+* Feeds the whole frames of a FIFO burst to the integrator, oldest first. A partial frame at the end is ignored, the
+* FIFO count register only ever reports whole frames unless the FIFO overflowed.
+* @param[in]    bytes           the burst as read from FIFO_R_W.
+* @param[in]    length          number of bytes in the burst.
+* @param[in]    samplePeriod    s, the output data rate period of the IMU.
+* @return                       the number of frames integrated.
+*/
+size_t ImuFifo_Integrate(const uint8_t *bytes, size_t length, const ImuFifoScale_t &scale, float samplePeriod,
+                         ImuPreintegrator &integrator);
+
+#endif
@@ -0,0 +1,60 @@
+/**
+ * The frames exchanged with the safety chip, as the rest of the autopilot sees them.
+ *
+ * Each direction is a seqlock topic (see SeqlockTopic.hpp) with a single writer:
+ *  - commands  the Interchip_Set functions of Interchip_A.h publish them and the interchip task takes a snapshot
+ *              for every packet it sends. All of them must be called from the same task, the attitude task.
+ *  - received  the interchip task publishes every packet that passed its check, and Interchip_GetPWM and
+ *              Interchip_GetAutonomousLevel take snapshots of it from any task.
+ *  - stats     the interchip task publishes the link statistics after every transfer, and Interchip_GetLinkStats
+ *              takes snapshots of them from any task.
+ * Neither side ever blocks, and a snapshot always holds a whole frame.
+ *
+ * This file is the interface between those and the interchip task in Interchip_A.c.
+ */
+
+#ifndef INTERCHIP_FRAMES_H
+#define INTERCHIP_FRAMES_H
+
+#include "Interchip.h"
+#include "InterchipStats.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+/**
+* Copies the last committed commands into the packet about to be sent, all but its sequence number and CRC.
+* @param[in,out]    packet      left as it was if no commands were committed yet or the snapshot failed, so that the
+*                               previous commands go out again.
+* @return                       1 if the packet was updated.
+*/
+uint8_t InterchipFrames_TakeCommands(Interchip_AtoS_Packet *packet);
+
+/**
+* Makes a packet received from the safety chip the one the getters read. Only ever called from the interchip task.
+*/
+void InterchipFrames_PublishReceived(const Interchip_StoA_Packet *packet);
+
+/**
+* Makes a copy of the link statistics the one Interchip_GetLinkStats reads. Only ever called from the interchip task.
+*/
+void InterchipFrames_PublishStats(const InterchipLinkStats_t *stats);
+
+/**
+* Called after every commit of commands, from the committing task. Implemented by Interchip_A.c to wake the interchip
+* task.
+*/
+void Interchip_OnFrameCommitted(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,94 @@
+/**
+ * The autopilot end of the interchip link: the double buffers the SPI DMA works from and the framing around them.
+ *
+ * Each direction has two statically allocated packets. Transmit: the setters write to the back packet while the front
+ * one is on the wire; InterchipLink_PrepareTransfer seals the back packet, makes it the front one, and carries its
+ * contents over to the new back packet so that channels nobody sets keep their values. Receive: the DMA fills one
+ * packet while the other holds the last one that passed its check; InterchipLink_CompleteTransfer checks the filled
+ * packet and only then makes it the latest.
+ *
+ * The link keeps the statistics of InterchipStats.h as it goes, and fills in the fields of the outgoing packets that
+ * they need.
+ *
+ * Nothing here locks, the caller serialises the setters against InterchipLink_PrepareTransfer and the readers against
+ * InterchipLink_CompleteTransfer. The transfer itself never touches a buffer the caller can see.
+ */
+
+#ifndef INTERCHIP_LINK_H
+#define INTERCHIP_LINK_H
+
+#include "Interchip.h"
+#include "InterchipFraming.h"
+#include "InterchipStats.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+typedef enum {
+	INTERCHIP_FRAME_OK = 0,
+	INTERCHIP_FRAME_CRC_ERROR,      // dropped, the previous packet stays the latest
+	INTERCHIP_FRAME_REPEATED,       // the same sequence number as the latest, the other end has not sent anything new
+} InterchipFrameStatus_t;
+
+typedef struct {
+	Interchip_AtoS_Packet tx[2];
+	Interchip_StoA_Packet rx[2];
+
+	uint8_t txBack;                 // the packet the setters write to, the other one is on the wire
+	uint8_t rxLatest;               // the last packet that passed its check, the other one is being received into
+	uint8_t hasReceived;
+
+	uint16_t txSequence;
+	InterchipCrc_t crc;
+
+	InterchipStats_t stats;
+} InterchipLink_t;
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+/**
+* Zeroes both directions.
+* @param[in]    crc     HAL_CRC_Calculate behind an InterchipCrc_t on the target, InterchipFraming_SoftwareCrc on the host.
+*/
+void InterchipLink_Init(InterchipLink_t *link, InterchipCrc_t crc);
+
+// The packet to write the next frame into, valid until the next InterchipLink_PrepareTransfer
+Interchip_AtoS_Packet *InterchipLink_GetTxPacket(InterchipLink_t *link);
+
+/**
+* Seals the back transmit packet and swaps the buffers of both directions over for the next transfer.
+* @param[in]    nowUs               when the transfer starts.
+* @param[out]   txData, rxData      where the transfer reads and writes INTERCHIP_PACKET_SIZE bytes, untouched by the
+*                                   link until the next InterchipLink_CompleteTransfer.
+*/
+void InterchipLink_PrepareTransfer(InterchipLink_t *link, uint32_t nowUs, uint8_t **txData, uint8_t **rxData);
+
+/**
+* Checks what the last transfer received.
+* @param[in]    nowUs       when the transfer ended.
+* @return       INTERCHIP_FRAME_OK if the packet is now the one InterchipLink_GetLatestRx returns.
+*/
+InterchipFrameStatus_t InterchipLink_CompleteTransfer(InterchipLink_t *link, uint32_t nowUs);
+
+// Instead of InterchipLink_CompleteTransfer, when the transfer did not complete
+void InterchipLink_FailTransfer(InterchipLink_t *link);
+
+// The last packet that passed its check, all zeroes until one has
+const Interchip_StoA_Packet *InterchipLink_GetLatestRx(const InterchipLink_t *link);
+
+const InterchipLinkStats_t *InterchipLink_GetStats(const InterchipLink_t *link);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
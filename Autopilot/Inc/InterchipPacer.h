@@ -0,0 +1,64 @@
+/**
+ * Decides when the interchip task starts a transfer, so that it can sleep until something happens instead of polling.
+ *
+ * The task is woken by events: a frame committed by the attitude pipeline, or the end of the transfer on the wire. A
+ * transfer starts as soon as a committed frame is waiting and nothing is on the wire, but never sooner than
+ * minIntervalUs after the previous one, so that a burst of commits goes out as one transfer. With no frames at all
+ * the link still exchanges a packet every keepAliveUs, so the safety chip keeps hearing from the autopilot.
+ *
+ * Pure logic on a microsecond clock, the caller waits and reads the time.
+ */
+
+#ifndef INTERCHIP_PACER_H
+#define INTERCHIP_PACER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define INTERCHIP_EVENT_FRAME           0x1u    // a frame was committed to the transmit buffer
+#define INTERCHIP_EVENT_TRANSFER_DONE   0x2u    // the transfer ended, successfully or not
+
+typedef struct {
+	uint32_t minIntervalUs;
+	uint32_t keepAliveUs;
+
+	uint32_t lastStartUs;
+	uint8_t hasStarted;
+	uint8_t framePending;
+	uint8_t inFlight;
+} InterchipPacer_t;
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+/**
+* @param[in]    minIntervalUs   the least time between the starts of two transfers.
+* @param[in]    keepAliveUs     the most time between the starts of two transfers, at least minIntervalUs.
+*/
+void InterchipPacer_Init(InterchipPacer_t *pacer, uint32_t minIntervalUs, uint32_t keepAliveUs);
+
+// events is any combination of the INTERCHIP_EVENT_ bits
+void InterchipPacer_OnEvents(InterchipPacer_t *pacer, uint32_t events);
+
+/**
+* To be called whenever the task wakes up, on an event or because the last wait timed out.
+* @param[in]    nowUs       TimeStamp_GetMicroseconds().
+* @param[out]   waitUs      the longest the task may sleep before calling again, unless an event comes first.
+* @return                   1 if a transfer should start now, it is then counted as on the wire until
+*                           INTERCHIP_EVENT_TRANSFER_DONE.
+*/
+uint8_t InterchipPacer_Poll(InterchipPacer_t *pacer, uint32_t nowUs, uint32_t *waitUs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,10 +1,60 @@
-#include "stm32f7xx_hal.h"
+#ifndef INTERCHIP_A_H
+#define INTERCHIP_A_H
+
+#include <stdint.h>
 #include "Interchip.h"
+#include "InterchipStats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A frame goes out as soon as it is committed, but transfers start at least INTERCHIP_MIN_INTERVAL_US apart, and
+// one starts every INTERCHIP_KEEP_ALIVE_US even without new frames (see InterchipPacer.h)
+#define INTERCHIP_MIN_INTERVAL_US 1000
+#define INTERCHIP_KEEP_ALIVE_US 20000
 
-#define INTERCHIP_TRANSMIT_DELAY 5
+#define INTERCHIP_PWM_CHANNELS 12
 
+/**
+* Interchip task entry point, started by freertos.c. Sleeps until a frame is committed or a transfer ends.
+*/
 void Interchip_Run(void const *argument);
-int16_t *Interchip_GetPWM(void);
+/**
+* Takes a snapshot of the PWM values the safety chip last sent, without blocking. Safe from any task.
+* @param[out]		data 			INTERCHIP_PWM_CHANNELS values, all from the same packet.
+* @return							1 if data was written, 0 if no packet has passed its check yet.
+*/
+uint8_t Interchip_GetPWM(int16_t *data);
+
+/*
+* The setters publish a whole frame of commands each time and wake the interchip task to send it (see
+* InterchipFrames.h). They never block, and must all be called from the same task.
+*/
 void Interchip_SetPWM(int16_t *data);
+
+/**
+* Publishes a frame of PWM values and the sample time stamp in one go.
+* @param[in]		data 			INTERCHIP_PWM_CHANNELS values, only those in dirtyMask are read.
+* @param[in]		dirtyMask 		bit i set to copy channel i.
+* @param[in]		sampleTimeUs	TimeStamp_GetMicroseconds() of the IMU sample the frame was computed from.
+*/
+void Interchip_SetFrame(const int16_t *data, uint32_t dirtyMask, uint32_t sampleTimeUs);
+
+// 0 until a packet has passed its check
 uint16_t Interchip_GetAutonomousLevel(void);
-void Interchip_SetAutonomousLevel(uint16_t data);
\ No newline at end of file
+void Interchip_SetAutonomousLevel(uint16_t data);
+void Interchip_SetSampleTime(uint32_t sampleTimeUs);
+
+/**
+* Takes a snapshot of the statistics of the link, for telemetry. Safe from any task.
+* @param[out]		stats 			as InterchipStats_Init leaves them until the first transfer has ended.
+* @return							1 if a transfer has ended since start up.
+*/
+uint8_t Interchip_GetLinkStats(InterchipLinkStats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,160 @@
+/**
+ * Several PID loops that run together, kept as structure of arrays: one array per gain, limit and state, with an
+ * element per axis.
+ *
+ * PIDBank<N>::execute runs every axis in one pass with the same arithmetic as PIDController::execute, so an axis
+ * gives exactly the outputs a PIDController with its gains would. The choices PIDController makes with branches
+ * (measured or finite difference derivative, the integral and output clamps) are selects on per axis masks here,
+ * with nothing to short circuit, so the compiler can use conditional moves and min/max for them.
+ */
+
+#ifndef PID_BANK_HPP
+#define PID_BANK_HPP
+
+#include <cstdint>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define PID_BANK_ALL_AXES 0xFFFFFFFFu
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+template <int N>
+class PIDBank
+{
+	static_assert(N > 0 && N <= 32, "an axis mask is 32 bits");
+
+	public:
+		// Every axis starts with zero gains and outputs 0 until configured with setAxis
+		PIDBank();
+
+		/**
+		* Sets the gains and limits of one axis, see PIDController::PIDController. The axis' state is kept.
+		* @param[in]	axis 	0 to N - 1.
+		*/
+		void setAxis(int axis, float _kp, float _ki, float _kd, float _i_max, float _min_output, float _max_output);
+
+		// Clears the integrals and the history of every axis
+		void reset();
+
+		/**
+		* Executes the PID computation of the axes in axes, see PIDController::execute. The other axes keep their
+		* state and their output is left as it is.
+		* @param[in]	desired 	N points we wish to reach.
+		* @param[in]	actual 		N current points.
+		* @param[in]	actualRate 	N measured derivatives, NaN where an axis computes its own. nullptr when none is
+		*							measured.
+		* @param[out]	output		N results.
+		* @param[in]	axes		bit i set to run axis i.
+		*/
+		void execute(const float desired[N], const float actual[N], const float actualRate[N], float output[N],
+					 uint32_t axes = PID_BANK_ALL_AXES);
+
+	private:
+		template <bool HAVE_RATES>
+		void executeAxes(const float desired[N], const float actual[N], const float actualRate[N], float output[N],
+						 uint32_t axes);
+
+		float kp[N], ki[N], kd[N];
+		float i_max[N];
+		float min_output[N], max_output[N];
+
+		float integral[N];
+		float historicalValue0[N], historicalValue1[N], historicalValue2[N];
+};
+
+template <int N>
+PIDBank<N>::PIDBank()
+{
+	for (int axis = 0; axis < N; axis++)
+	{
+		setAxis(axis, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+	}
+
+	reset();
+}
+
+template <int N>
+void PIDBank<N>::setAxis(int axis, float _kp, float _ki, float _kd, float _i_max, float _min_output, float _max_output)
+{
+	kp[axis] = _kp;
+	ki[axis] = _ki;
+	kd[axis] = _kd;
+
+	i_max[axis] = _i_max;
+	min_output[axis] = _min_output;
+	max_output[axis] = _max_output;
+}
+
+template <int N>
+void PIDBank<N>::reset()
+{
+	for (int axis = 0; axis < N; axis++)
+	{
+		integral[axis] = 0.0f;
+		historicalValue0[axis] = 0.0f;
+		historicalValue1[axis] = 0.0f;
+		historicalValue2[axis] = 0.0f;
+	}
+}
+
+template <int N>
+void PIDBank<N>::execute(const float desired[N], const float actual[N], const float actualRate[N], float output[N],
+						 uint32_t axes)
+{
+	// The one branch of the pass, on whether there are measured rates at all
+	if (actualRate != nullptr)
+	{
+		executeAxes<true>(desired, actual, actualRate, output, axes);
+	}
+	else
+	{
+		executeAxes<false>(desired, actual, actual, output, axes);
+	}
+}
+
+template <int N>
+template <bool HAVE_RATES>
+void PIDBank<N>::executeAxes(const float desired[N], const float actual[N], const float actualRate[N], float output[N],
+							 uint32_t axes)
+{
+	for (int axis = 0; axis < N; axis++)
+	{
+		const bool active = (axes >> axis) & 1u;
+		const float rate = actualRate[axis];
+
+		// A NaN is the only value that differs from itself, the same test as std::isnan in PIDController
+		const bool measured = HAVE_RATES && (rate == rate);
+
+		float error = desired[axis] - actual[axis];
+
+		// avoid integral windup, in PIDController's order so that a negative i_max clamps the same way
+		float accumulated = integral[axis] + error;
+		float clamped = (accumulated > i_max[axis]) ? i_max[axis] : accumulated;
+		clamped = (accumulated < -i_max[axis]) ? -i_max[axis] : clamped;
+
+		// The history only moves on the axes that compute their derivative
+		float history0 = measured ? historicalValue0[axis] : actual[axis];
+		float history1 = measured ? historicalValue1[axis] : historicalValue0[axis];
+		float history2 = measured ? historicalValue2[axis] : historicalValue1[axis];
+
+		// Finite difference approximation gets rid of noise much better than first order derivative computation
+		float derivative = measured ? rate : ((3 * history0) - (4 * history1) + (history2));
+
+		float ret = ((kp[axis] * error) + (ki[axis] * clamped) - (kd[axis] * derivative));
+		float limited = (ret > max_output[axis]) ? max_output[axis] : ret;
+		limited = (ret < min_output[axis]) ? min_output[axis] : limited;
+
+		integral[axis] = active ? clamped : integral[axis];
+		historicalValue0[axis] = active ? history0 : historicalValue0[axis];
+		historicalValue1[axis] = active ? history1 : historicalValue1[axis];
+		historicalValue2[axis] = active ? history2 : historicalValue2[axis];
+		output[axis] = active ? limited : output[axis];
+	}
+}
+
+#endif
@@ -0,0 +1,29 @@
+/**
+ * Free running microsecond time base used to stamp sensor samples and measure how old they are further down the line.
+ * The counter wraps every ~71 minutes, so only ever compare stamps by subtracting them as uint32_t.
+ */
+
+#ifndef TIMESTAMP_H
+#define TIMESTAMP_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+* Starts the time base. Must be called once before any stamp is taken.
+*/
+void TimeStamp_Init(void);
+
+/**
+* @return microseconds since TimeStamp_Init was called, modulo 2^32.
+*/
+uint32_t TimeStamp_GetMicroseconds(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
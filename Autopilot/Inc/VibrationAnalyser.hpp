@@ -0,0 +1,128 @@
+/**
+ * Streaming spectrum analysis of the gyro, to find the vibration peaks the notch filters should sit on.
+ *
+ * Every axis keeps the last VIBRATION_FFT_SIZE samples. Every hopSamples samples one axis (in turn) is Hann windowed
+ * and goes through a real FFT, computed as a complex FFT of half the size. The dominant peaks between minHz and
+ * maxHz are then picked from the magnitudes.
+ *
+ * The analysis is spread over the control cycles: step() does at most workPerStep units of work, where a unit is one
+ * windowed input pair, one radix 2 butterfly, one spectrum bin or one bin of the peak search, each a handful of
+ * multiply-adds. That bounds the cost of a cycle no matter where the analysis is. One analysis takes about 6 * N / 2
+ * units, and has to finish within a hop for every hop to be used.
+ */
+
+#ifndef VIBRATION_ANALYSER_HPP
+#define VIBRATION_ANALYSER_HPP
+
+#include <stdint.h>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define VIBRATION_FFT_SIZE 128              // real samples, a power of 2
+#define VIBRATION_FFT_HALF (VIBRATION_FFT_SIZE / 2)
+#define VIBRATION_FFT_STAGES 6              // log2(VIBRATION_FFT_HALF)
+#define VIBRATION_AXES 3
+#define VIBRATION_PEAKS 2                   // tracked per axis
+
+#define VIBRATION_PEAK_TO_MEAN 3.0f         // a peak's magnitude is at least this many times the band's mean
+
+struct VibrationAnalyserConfig_t
+{
+    float sampleRateHz;
+    float minHz;                // band the peaks are searched in
+    float maxHz;
+    int workPerStep;            // units, see above, at least 1
+    int hopSamples;             // between the starts of two analyses
+    float trackingGain;         // in (0, 1], how far a tracked peak moves towards a new measurement of it
+};
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+VibrationAnalyserConfig_t VibrationAnalyser_DefaultConfig(float sampleRateHz);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+class VibrationAnalyser
+{
+    public:
+        explicit VibrationAnalyser(const VibrationAnalyserConfig_t &_config);
+
+        // Also resets, the history no longer matches the band
+        void configure(const VibrationAnalyserConfig_t &_config);
+        const VibrationAnalyserConfig_t& getConfig() const {return config;}
+
+        // Forgets the history and the peaks
+        void reset();
+
+        // One sample of each axis, in any unit
+        void addSample(const float gyro[VIBRATION_AXES]);
+
+        /**
+        * Advances the analysis by at most workPerStep units.
+        * @return   the axis whose peaks this step updated, -1 if none.
+        */
+        int step();
+
+        /**
+        * Tracked peaks of an axis in Hz, ascending, 0 for a slot without a peak.
+        */
+        const float* getPeaks(int axis) const {return peaksHz[axis];}
+
+        int getLastStepWork() const {return lastStepWork;}
+        uint32_t getAnalysisCount() const {return analysisCount;}
+
+    private:
+        enum Phase_t {PHASE_IDLE, PHASE_WINDOW, PHASE_BUTTERFLY, PHASE_SPECTRUM, PHASE_PEAKS};
+
+        bool startAnalysis();
+        void windowPair(int n);
+        void butterfly(int stage, int index);
+        void spectrumBin(int k);
+        void searchBin(int k);
+        void finishAnalysis();
+
+        VibrationAnalyserConfig_t config;
+        int firstBin;
+        int lastBin;
+
+        // Input
+        float history[VIBRATION_AXES][VIBRATION_FFT_SIZE];
+        int writeIndex;
+        uint32_t samplesSeen;
+        int samplesSinceStart;
+
+        // Analysis in progress
+        Phase_t phase;
+        int axis;
+        int nextAxis;
+        int snapshotIndex;
+        int stage;
+        int cursor;
+        float bandSum;
+        int candidateBin[VIBRATION_PEAKS];
+
+        float re[VIBRATION_FFT_HALF];
+        float im[VIBRATION_FFT_HALF];
+        float magnitude[VIBRATION_FFT_HALF + 1];
+
+        // Tables, filled once
+        float window[VIBRATION_FFT_SIZE];
+        float twiddleCos[VIBRATION_FFT_HALF / 2];      // exp(-2 pi i k / (N / 2))
+        float twiddleSin[VIBRATION_FFT_HALF / 2];
+        float splitCos[VIBRATION_FFT_HALF + 1];        // exp(-2 pi i k / N)
+        float splitSin[VIBRATION_FFT_HALF + 1];
+        uint8_t bitReversed[VIBRATION_FFT_HALF];
+
+        // Output
+        float peaksHz[VIBRATION_AXES][VIBRATION_PEAKS];
+        int lastStepWork;
+        uint32_t analysisCount;
+};
+
+#endif
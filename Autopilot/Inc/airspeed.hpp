@@ -55,7 +55,7 @@ class airspeed {
  * Derived classes
  **********************************************************************************************************************/
 
-class dummyairspeed: public airspeed{
+class dummyairspeed final : public airspeed{
     public:
         /**
          *  Triggers interrupt for new airspeed measurement - stores 
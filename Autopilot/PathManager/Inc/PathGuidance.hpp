@@ -0,0 +1,80 @@
+/**
+ * The outer guidance loop: runs the waypoint manager and AutoSteer at a fraction of the attitude rate and publishes
+ * the resulting roll, pitch, rudder and airspeed setpoint for the attitude manager.
+ *
+ * Where the path is going changes slowly compared to the attitude of the aircraft, so there is no point in working it
+ * out every attitude cycle. PathGuidance::execute is called once per attitude cycle and only does any work every
+ * PATH_TO_ATTITUDE_RATE_RATIO calls. The attitude manager interpolates between the setpoints it publishes, see
+ * SetpointInterpolator.hpp.
+ */
+
+#ifndef PATH_GUIDANCE_HPP
+#define PATH_GUIDANCE_HPP
+
+#include <stdint.h>
+
+#include "waypointManager.hpp"
+#include "GetFromPathManager.hpp"
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+struct PathGuidanceInput_t
+{
+    _WaypointManager_Data_In position;  // current coordinates, altitude and heading
+    float accY;                         // Y axis accelerometer reading from the IMU, for turn coordination
+};
+
+enum _PathGuidanceStatus {PATH_GUIDANCE_SKIPPED = 0, PATH_GUIDANCE_UPDATED, PATH_GUIDANCE_NO_INPUT, PATH_GUIDANCE_WAYPOINT_ERROR};
+
+// Where the position comes from
+class PathGuidanceInputSource
+{
+    public:
+        /**
+        * @param[out]   input       receives the latest position, heading and acceleration.
+        * @return                   false if there is no position fix.
+        */
+        virtual bool getInput(PathGuidanceInput_t &input) = 0;
+};
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+class PathGuidance
+{
+    public:
+        /**
+        * @param[in]    _waypoints      the flight path, initialised by the caller.
+        * @param[in]    _inputSource    where the position comes from.
+        * @param[in]    _rateRatio      attitude cycles per update.
+        */
+        PathGuidance(WaypointManager &_waypoints, PathGuidanceInputSource &_inputSource, uint32_t _rateRatio = PATH_TO_ATTITUDE_RATE_RATIO);
+
+        /**
+        * Call once per attitude cycle. The first call and every _rateRatio-th one after it read the position, run the
+        * waypoint manager and AutoSteer and publish the setpoint on PathSetpointTopic. The others return straight away.
+        * Nothing is published when an update fails, the attitude manager then holds the last setpoint.
+        * @param[in]    timeUs      the current time, stamped on the setpoint.
+        * @return                   PATH_GUIDANCE_SKIPPED on the calls that do nothing, the outcome of the update otherwise.
+        */
+        _PathGuidanceStatus execute(uint32_t timeUs);
+
+        uint32_t getUpdateCount() const {return updates;}
+
+    private:
+        PathGuidance(const PathGuidance& other);
+        PathGuidance& operator =(const PathGuidance& other);
+
+        _PathGuidanceStatus update(uint32_t timeUs);
+
+        WaypointManager &waypoints;
+        PathGuidanceInputSource &inputSource;
+        uint32_t rateRatio;
+        uint32_t cyclesUntilUpdate;
+        uint32_t updates;
+};
+
+#endif
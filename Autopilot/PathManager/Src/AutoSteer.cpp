@@ -3,7 +3,7 @@
  */
 
 #include "AutoSteer.hpp"
-#include "PID.hpp"
+#include "PIDBank.hpp"
 
 #include <cmath>
 
@@ -18,14 +18,24 @@
 
 #define DEG_TO_RAD(angleInDegrees) ((angleInDegrees) * M_PI / 180.0)
 
+// Axes of the PID bank
+#define BANK_AXIS 0
+#define RUDDER_AXIS 1
+#define PITCH_AXIS 2
+#define NUM_AXES 3
+
+#define COORDINATED_TURN_AXES ((1u << BANK_AXIS) | (1u << RUDDER_AXIS))
+#define ALTITUDE_AXES (1u << PITCH_AXIS)
+
 /***********************************************************************************************************************
  * Variables
  **********************************************************************************************************************/
 
-static PIDController bankPid{1, 0, 0, 0, -MAX_BANK_ANGLE, MAX_BANK_ANGLE}; // PID gains need to be tuned
-static PIDController rudderPid{1, 0, 0, 0, -100, 100}; // PID gains need to be tuned
+static PIDBank<NUM_AXES> CreatePids(void);
+
+static PIDBank<NUM_AXES> pids = CreatePids(); // none of them measure their derivative
 
-static PIDController pitchPid{1, 0, 0, 0, -MAX_PITCH_ANGLE, MAX_PITCH_ANGLE}; // PID gains need to be tuned
+static float pidOutputs[NUM_AXES];
 
 static const float RUDDER_SCALING_FACTOR = 0.8f; // should be experimentally determined
 
@@ -47,13 +57,20 @@ void AutoSteer_Init(void)
 void AutoSteer_ComputeCoordinatedTurn(CoordinatedTurnInput_t *Input, CoordinatedTurnAttitudeManagerCommands_t *AttManCommands)
 {
 
-    float bankAngle = bankPid.execute(Input->desiredHeading, Input->currentHeading);
+    // when accY is 0, the turn is coordinated
+    const float desired[NUM_AXES] = {Input->desiredHeading, 0.0f, 0.0f};
+    const float actual[NUM_AXES] = {Input->currentHeading, Input->accY, 0.0f};
+
+    pids.execute(desired, actual, nullptr, pidOutputs, COORDINATED_TURN_AXES);
+
+    float bankAngle = pidOutputs[BANK_AXIS];
 
     float rudderSetPoint = GetRudderPercent(bankAngle);
 
-    float rudderCorrection = -1.0f * rudderPid.execute(0.0f, Input->accY);  // when accY is 0, the turn is coordinated. The multiplication by -1 comes from the way the axis is defined on the accelerometer.
+    float rudderCorrection = -1.0f * pidOutputs[RUDDER_AXIS];  // The multiplication by -1 comes from the way the axis is defined on the accelerometer.
 
-    float rudderPercent = rudderSetPoint + rudderCorrection;
+    // Past full deflection the attitude manager rejects the command, the rudder can do no more than 100 % anyway
+    float rudderPercent = fmaxf(-100.0f, fminf(100.0f, rudderSetPoint + rudderCorrection));
 
     AttManCommands->requiredRoll = DEG_TO_RAD(bankAngle);
     AttManCommands->requiredRudderPosition = rudderPercent;
@@ -62,7 +79,12 @@ void AutoSteer_ComputeCoordinatedTurn(CoordinatedTurnInput_t *Input, Coordinated
 
 void AutoSteer_ComputeAltitudeAndAirspeed(AltitudeAirspeedInput_t *Input, AltitudeAirspeedCommands_t *AttManCommands)
 {
-    float pitchAngle = pitchPid.execute(Input->desiredAltitude, Input->currentAltitude);
+    const float desired[NUM_AXES] = {0.0f, 0.0f, Input->desiredAltitude};
+    const float actual[NUM_AXES] = {0.0f, 0.0f, Input->currentAltitude};
+
+    pids.execute(desired, actual, nullptr, pidOutputs, ALTITUDE_AXES);
+
+    float pitchAngle = pidOutputs[PITCH_AXIS];
 
     AttManCommands->requiredPitch = DEG_TO_RAD(pitchAngle);
     AttManCommands->requiredAirspeed = CRUISING_SPEED;      // a simple constant to start with. As things get more complex, circumstances will demand variable airspeeds.
@@ -70,7 +92,20 @@ void AutoSteer_ComputeAltitudeAndAirspeed(AltitudeAirspeedInput_t *Input, Altitu
 }
 
 
+// bankAngle in degrees, as the bank PID gives it
 static float GetRudderPercent(float bankAngle)
 {
-    return ((RUDDER_SCALING_FACTOR * bankAngle) / (M_PI / 2.0f)) * 100.0f;   // very simple for now. Experiments may give us a better formula. The PID will fix any discrepancy though
+    return ((RUDDER_SCALING_FACTOR * DEG_TO_RAD(bankAngle)) / (M_PI / 2.0f)) * 100.0f;   // very simple for now. Experiments may give us a better formula. The PID will fix any discrepancy though
+}
+
+static PIDBank<NUM_AXES> CreatePids(void)
+{
+    PIDBank<NUM_AXES> bank;
+
+    // PID gains need to be tuned
+    bank.setAxis(BANK_AXIS, 1, 0, 0, 0, -MAX_BANK_ANGLE, MAX_BANK_ANGLE);
+    bank.setAxis(RUDDER_AXIS, 1, 0, 0, 0, -100, 100);
+    bank.setAxis(PITCH_AXIS, 1, 0, 0, 0, -MAX_PITCH_ANGLE, MAX_PITCH_ANGLE);
+
+    return bank;
 }
@@ -0,0 +1,97 @@
+#include "PathGuidance.hpp"
+#include "AutoSteer.hpp"
+#include "AttitudeDataBus.hpp"
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+static float GetUnwrappedHeading(float currentHeading, float desiredHeading);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+PathGuidance::PathGuidance(WaypointManager &_waypoints, PathGuidanceInputSource &_inputSource, uint32_t _rateRatio) : waypoints(_waypoints), inputSource(_inputSource)
+{
+    rateRatio = (_rateRatio > 0) ? _rateRatio : 1;
+    cyclesUntilUpdate = 0;
+    updates = 0;
+}
+
+_PathGuidanceStatus PathGuidance::execute(uint32_t timeUs)
+{
+    if (cyclesUntilUpdate > 0)
+    {
+        cyclesUntilUpdate--;
+        return PATH_GUIDANCE_SKIPPED;
+    }
+
+    // A failed update waits for its next slot like any other, so the path manager never takes more than its share
+    cyclesUntilUpdate = rateRatio - 1;
+
+    return update(timeUs);
+}
+
+_PathGuidanceStatus PathGuidance::update(uint32_t timeUs)
+{
+    PathGuidanceInput_t input;
+
+    if ( ! inputSource.getInput(input))
+    {
+        return PATH_GUIDANCE_NO_INPUT;
+    }
+
+    _WaypointManager_Data_Out directions;
+
+    if (waypoints.get_next_directions(input.position, &directions) != WAYPOINT_SUCCESS)
+    {
+        return PATH_GUIDANCE_WAYPOINT_ERROR;
+    }
+
+    CoordinatedTurnInput_t turnInput;
+    turnInput.currentHeading = (float) input.position.heading;
+    turnInput.desiredHeading = GetUnwrappedHeading(turnInput.currentHeading, (float) directions.desiredHeading);
+    turnInput.accY = input.accY;
+
+    AltitudeAirspeedInput_t altitudeInput;
+    altitudeInput.currentAltitude = (float) input.position.altitude;
+    altitudeInput.desiredAltitude = (float) directions.desiredAltitude;
+
+    CoordinatedTurnAttitudeManagerCommands_t turnCommands;
+    AltitudeAirspeedCommands_t altitudeCommands;
+
+    AutoSteer_ComputeCoordinatedTurn(&turnInput, &turnCommands);
+    AutoSteer_ComputeAltitudeAndAirspeed(&altitudeInput, &altitudeCommands);
+
+    PathSetpoint_t setpoint;
+    setpoint.roll = turnCommands.requiredRoll;
+    setpoint.pitch = altitudeCommands.requiredPitch;
+    setpoint.rudder = turnCommands.requiredRudderPosition;
+    setpoint.airspeed = altitudeCommands.requiredAirspeed;
+    setpoint.timeUs = timeUs;
+
+    PathSetpointTopic.publish(setpoint);
+    updates++;
+
+    return PATH_GUIDANCE_UPDATED;
+}
+
+// The desired heading moved by a multiple of 360 degrees to within 180 degrees of the current one, so that AutoSteer
+// always turns the short way round
+static float GetUnwrappedHeading(float currentHeading, float desiredHeading)
+{
+    float difference = desiredHeading - currentHeading;
+
+    while (difference > 180.0f)
+    {
+        difference -= 360.0f;
+    }
+
+    while (difference <= -180.0f)
+    {
+        difference += 360.0f;
+    }
+
+    return currentHeading + difference;
+}
@@ -6,6 +6,8 @@
  */
 
 #include "waypointManager.hpp"
+#include "LinearAlgebra.hpp"
+#include "FastMath.hpp"
 
 // Values for orbitPathStatus parameter of WaypointManager
 #define LINE_FOLLOWING 0
@@ -474,7 +476,7 @@ void WaypointManager::follow_waypoints(_PathData * currentWaypoint, float* posit
 
     // Gets the unit vectors representing the direction towards the target waypoint
     float waypointDirection[3];
-    float norm = sqrt(pow(targetCoordinates[0] - waypointPosition[0],2) + pow(targetCoordinates[1] - waypointPosition[1],2) + pow(targetCoordinates[2] - waypointPosition[2],2));
+    float norm = distance(Vec3::fromArray(targetCoordinates), Vec3::fromArray(waypointPosition));
     waypointDirection[0] = (targetCoordinates[0] - waypointPosition[0])/norm;
     waypointDirection[1] = (targetCoordinates[1] - waypointPosition[1])/norm;
     waypointDirection[2] = (targetCoordinates[2] - waypointPosition[2])/norm;
@@ -485,7 +487,7 @@ void WaypointManager::follow_waypoints(_PathData * currentWaypoint, float* posit
 
     // Gets the unit vectors representing the direction vector from the target waypoint to the waypoint after the target waypoint 
     float nextWaypointDirection[3];
-    float norm2 = sqrt(pow(waypointAfterTargetCoordinates[0] - targetCoordinates[0],2) + pow(waypointAfterTargetCoordinates[1] - targetCoordinates[1],2) + pow(waypointAfterTargetCoordinates[2] - targetCoordinates[2],2));
+    float norm2 = distance(Vec3::fromArray(waypointAfterTargetCoordinates), Vec3::fromArray(targetCoordinates));
     nextWaypointDirection[0] = (waypointAfterTargetCoordinates[0] - targetCoordinates[0])/norm2;
     nextWaypointDirection[1] = (waypointAfterTargetCoordinates[1] - targetCoordinates[1])/norm2;
     nextWaypointDirection[2] = (waypointAfterTargetCoordinates[2] - targetCoordinates[2])/norm2;
@@ -501,7 +503,7 @@ void WaypointManager::follow_waypoints(_PathData * currentWaypoint, float* posit
     halfPlane[2] = targetCoordinates[2] - tangentFactor * waypointDirection[2];
 
     // Calculates distance to next waypoint
-    float distanceToWaypoint = sqrt(pow(targetCoordinates[0] - position[0],2) + pow(targetCoordinates[1] - position[1],2) + pow(targetCoordinates[2] - position[2],2));
+    float distanceToWaypoint = distance(Vec3::fromArray(targetCoordinates), Vec3::fromArray(position));
     distanceToNextWaypoint = distanceToWaypoint; 
 
     // Checks if plane is orbiting or flying in a straight line
@@ -535,7 +537,7 @@ void WaypointManager::follow_waypoints(_PathData * currentWaypoint, float* posit
         turnDirection = waypointDirection[0] * nextWaypointDirection[1] - waypointDirection[1] * nextWaypointDirection[0]>0?1:-1;
         
         // Since the Earth is not flat *waits for the uproar to die down* we need to do some fancy geometry. Introducing!!!!!!!!!! EUCLIDIAN GEOMETRY! (translation: I have no idea what this line does but it should work)
-        float euclideanWaypointDirection = sqrt(pow(nextWaypointDirection[0] - waypointDirection[0],2) + pow(nextWaypointDirection[1] - waypointDirection[1],2) + pow(nextWaypointDirection[2] - waypointDirection[2],2)) * ((nextWaypointDirection[0] - waypointDirection[0]) < 0?-1:1) * ((nextWaypointDirection[1] - waypointDirection[1]) < 0?-1:1) * ((nextWaypointDirection[2] - waypointDirection[2]) < 0?-1:1);
+        float euclideanWaypointDirection = distance(Vec3::fromArray(nextWaypointDirection), Vec3::fromArray(waypointDirection)) * ((nextWaypointDirection[0] - waypointDirection[0]) < 0?-1:1) * ((nextWaypointDirection[1] - waypointDirection[1]) < 0?-1:1) * ((nextWaypointDirection[2] - waypointDirection[2]) < 0?-1:1);
 
         // Determines coordinates of the turn center
         turnCenter[0] = targetCoordinates[0] + (tangentFactor * (nextWaypointDirection[0] - waypointDirection[0])/euclideanWaypointDirection);
@@ -593,13 +595,13 @@ void WaypointManager::follow_line_segment(_PathData * currentWaypoint, float* po
 
     // Direction to next waypoint
     float waypointDirection[3];
-    float norm = sqrt(pow(targetCoordinates[0] - waypointPosition[0],2) + pow(targetCoordinates[1] - waypointPosition[1],2) + pow(targetCoordinates[2] - waypointPosition[2],2));
+    float norm = distance(Vec3::fromArray(targetCoordinates), Vec3::fromArray(waypointPosition));
     waypointDirection[0] = (targetCoordinates[0] - waypointPosition[0])/norm;
     waypointDirection[1] = (targetCoordinates[1] - waypointPosition[1])/norm;
     waypointDirection[2] = (targetCoordinates[2] - waypointPosition[2])/norm;
 
     // Calculates distance to next waypoint
-    float distanceToWaypoint = sqrt(pow(targetCoordinates[0] - position[0],2) + pow(targetCoordinates[1] - position[1],2) + pow(targetCoordinates[2] - position[2],2));
+    float distanceToWaypoint = distance(Vec3::fromArray(targetCoordinates), Vec3::fromArray(position));
     distanceToNextWaypoint = distanceToWaypoint; // Stores distance to next waypoint :))
 
     // std::cout << "Here1.1 --> " << waypointDirection[0] << " " << waypointDirection[1] << " " << waypointDirection[2] << std::endl;
@@ -625,13 +627,13 @@ void WaypointManager::follow_last_line_segment(_PathData * currentWaypoint, floa
 
     // Direction between waypoints
     float waypointDirection[3];
-    float norm = sqrt(pow(targetCoordinates[0] - waypointPosition[0],2) + pow(targetCoordinates[1] - waypointPosition[1],2) + pow(targetCoordinates[2] - waypointPosition[2],2));
+    float norm = distance(Vec3::fromArray(targetCoordinates), Vec3::fromArray(waypointPosition));
     waypointDirection[0] = (targetCoordinates[0] - waypointPosition[0])/norm;
     waypointDirection[1] = (targetCoordinates[1] - waypointPosition[1])/norm;
     waypointDirection[2] = (targetCoordinates[2] - waypointPosition[2])/norm;
 
     // Calculates distance to next waypoint
-    float distanceToWaypoint = sqrt(pow(targetCoordinates[0] - position[0],2) + pow(targetCoordinates[1] - position[1],2) + pow(targetCoordinates[2] - position[2],2));
+    float distanceToWaypoint = distance(Vec3::fromArray(targetCoordinates), Vec3::fromArray(position));
     distanceToNextWaypoint = distanceToWaypoint; // Stores distance to next waypoint :))
 
     // If dot product positive, then wait for commands
@@ -653,8 +655,8 @@ void WaypointManager::follow_orbit(float* position, float heading) {
     heading = deg2rad(90 - heading);
 
     // Distance from centre of circle
-    float orbitDistance = sqrt(pow(position[0] - turnCenter[0],2) + pow(position[1] - turnCenter[1],2));
-    float courseAngle = atan2(position[1] - turnCenter[1], position[0] - turnCenter[0]); // (y,x) format
+    float orbitDistance = distance(Vec2::fromArray(position), Vec2::fromArray(turnCenter));
+    float courseAngle = FastMath_Atan2(position[1] - turnCenter[1], position[0] - turnCenter[0]); // (y,x) format
 
     // Normalizes angles
     // First gets the angle between 0 and 2 pi
@@ -669,7 +671,7 @@ void WaypointManager::follow_orbit(float* position, float heading) {
     }
 
     // Desired heading
-    int calcHeading = round(90 - rad2deg(courseAngle + turnDirection * (PI/2 + atan(k_gain[ORBIT_FOLLOW] * (orbitDistance - turnRadius)/turnRadius)))); //Heading in degrees (magnetic)
+    int calcHeading = round(90 - rad2deg(courseAngle + turnDirection * (PI/2 + FastMath_Atan2(k_gain[ORBIT_FOLLOW] * (orbitDistance - turnRadius)/turnRadius, 1.0f)))); //Heading in degrees (magnetic)
     
     // Normalizes heading (keeps it between 0.0 and 259.9999)
     if (calcHeading >= 360.0) {
@@ -687,7 +689,7 @@ void WaypointManager::follow_orbit(float* position, float heading) {
 
 void WaypointManager::follow_straight_path(float* waypointDirection, float* targetWaypoint, float* position, float heading) {
     heading = deg2rad(90 - heading);//90 - heading = magnetic heading to cartesian heading
-    float courseAngle = atan2(waypointDirection[1], waypointDirection[0]); // (y,x) format
+    float courseAngle = FastMath_Atan2(waypointDirection[1], waypointDirection[0]); // (y,x) format
     
     // Normalizes angles
     // First gets the angle between 0 and 2 pi
@@ -702,8 +704,8 @@ void WaypointManager::follow_straight_path(float* waypointDirection, float* targ
     }
 
     // Calculates desired heading
-    float pathError = -sin(courseAngle) * (position[0] - targetWaypoint[0]) + cos(courseAngle) * (position[1] - targetWaypoint[1]);
-    int calcHeading = 90 - rad2deg(courseAngle - MAX_PATH_APPROACH_ANGLE * 2/PI * atan(k_gain[PATH_FOLLOW] * pathError)); //Heading in degrees (magnetic) 
+    float pathError = -FastMath_Sin(courseAngle) * (position[0] - targetWaypoint[0]) + FastMath_Cos(courseAngle) * (position[1] - targetWaypoint[1]);
+    int calcHeading = 90 - rad2deg(courseAngle - MAX_PATH_APPROACH_ANGLE * 2/PI * FastMath_Atan2(k_gain[PATH_FOLLOW] * pathError, 1.0f)); //Heading in degrees (magnetic) 
     
     // Normalizes heading (keeps it between 0.0 and 259.9999)
     if (calcHeading >= 360.0) {
@@ -0,0 +1,67 @@
+/**
+ * Batched Madgwick filters, see MadgwickBatch.hpp. The kernel itself is in MadgwickKernel.hpp.
+ */
+
+#include "MadgwickBatch.hpp"
+#include "MadgwickKernel.hpp"
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+MadgwickBatch::MadgwickBatch(int _count, float beta) : count(_count), useVectorKernel(hasVectorKernel()),
+    q0(_count), q1(_count), q2(_count), q3(_count), betag(_count, beta)
+{
+    reset();
+}
+
+void MadgwickBatch::reset()
+{
+    for (int i = 0; i < count; i++)
+    {
+        q0[i] = 1.0f;
+        q1[i] = 0.0f;
+        q2[i] = 0.0f;
+        q3[i] = 0.0f;
+    }
+}
+
+MadgwickQuaternion_t MadgwickBatch::getQuaternion(int filter) const
+{
+    MadgwickQuaternion_t q = {q0[filter], q1[filter], q2[filter], q3[filter]};
+    return q;
+}
+
+bool MadgwickBatch::hasVectorKernel()
+{
+#ifdef FARM_AVX2
+    // Built in, but the tests may run on a CPU without it
+    static const bool cpuHasAvx2 = __builtin_cpu_supports("avx2");
+    return cpuHasAvx2;
+#else
+    return false;
+#endif
+}
+
+void MadgwickBatch::update(const MadgwickBatchSamples_t &samples, float dt)
+{
+    const bool withMagnetometer = (samples.mx != nullptr);
+    int i = 0;
+
+#ifdef FARM_AVX2
+    if (useVectorKernel)
+    {
+        i = MadgwickBatch_UpdateAvx2(count, q0.data(), q1.data(), q2.data(), q3.data(), betag.data(), samples, dt);
+    }
+#endif
+
+    for ( ; i < count; i++)
+    {
+        Madgwick_Step(q0[i], q1[i], q2[i], q3[i], samples.gx[i], samples.gy[i], samples.gz[i],
+                      samples.ax[i], samples.ay[i], samples.az[i],
+                      withMagnetometer ? samples.mx[i] : 0.0f,
+                      withMagnetometer ? samples.my[i] : 0.0f,
+                      withMagnetometer ? samples.mz[i] : 0.0f,
+                      betag[i], dt);
+    }
+}
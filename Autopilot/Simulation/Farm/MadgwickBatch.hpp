@@ -0,0 +1,76 @@
+/**
+ * Many independent Madgwick filters advanced together, for simulation farms that sweep filter gains or sensor noise
+ * over thousands of flights at once. Host only, it is never built for the autopilot.
+ *
+ * The filter states are kept as structure of arrays, one array per quaternion component, and every update advances
+ * all of them by one sample. When built with AVX2 (FARM_AVX2 in CMakeLists.txt) and running on a CPU that has it, eight
+ * filters go through each pass of the kernel. The filters left over at the end, and everything elsewhere, go one at a
+ * time.
+ *
+ * Both paths run the same arithmetic in the same order as MadgwickFilter::update and MadgwickFilter::updateIMU, with
+ * the branches turned into per lane selects. Without FMA contraction the outputs match MadgwickFilter's to the bit;
+ * the tests only rely on them matching to within rounding.
+ */
+
+#ifndef MADGWICK_BATCH_HPP
+#define MADGWICK_BATCH_HPP
+
+#include "MadgwickAHRS.h"
+
+#include <vector>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define MADGWICK_BATCH_LANES 8      // filters per pass of the vector kernel
+
+/**
+* One sample for each filter of the batch, every array holds size() values. The magnetometer arrays are null for the
+* IMU only update, a filter whose magnetometer reads all zero gets the IMU only update too, as in MadgwickFilter.
+*/
+struct MadgwickBatchSamples_t
+{
+    const float *gx, *gy, *gz;      // rad/s
+    const float *ax, *ay, *az;      // any unit
+    const float *mx, *my, *mz;      // any unit, or null
+};
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+class MadgwickBatch
+{
+    public:
+        // count filters at the identity quaternion, all with the same gain
+        explicit MadgwickBatch(int count, float beta = MADGWICK_BETA_DEFAULT);
+
+        int size() const {return count;}
+
+        // Back to the identity quaternion, the gains are kept
+        void reset();
+
+        void setBeta(int filter, float beta) {betag[filter] = beta;}
+        float getBeta(int filter) const {return betag[filter];}
+
+        // Advances every filter by one sample, integrated over dt seconds
+        void update(const MadgwickBatchSamples_t &samples, float dt);
+
+        MadgwickQuaternion_t getQuaternion(int filter) const;
+
+        // True when the vector kernel was built in, see FARM_AVX2, and the CPU has AVX2
+        static bool hasVectorKernel();
+
+        // Runs every filter through the scalar kernel, for comparing the two. On by default when built in.
+        void setVectorKernel(bool enable) {useVectorKernel = enable && hasVectorKernel();}
+
+    private:
+        int count;
+        bool useVectorKernel;
+
+        std::vector<float> q0, q1, q2, q3;
+        std::vector<float> betag;
+};
+
+#endif
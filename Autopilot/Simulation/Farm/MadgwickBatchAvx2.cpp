@@ -0,0 +1,93 @@
+/**
+ * The AVX2 path of MadgwickBatch, the only file built with -mavx2 (FARM_AVX2 in CMakeLists.txt). MadgwickBatch only
+ * calls into it once the CPU has been checked, see MadgwickBatch::hasVectorKernel.
+ */
+
+#ifdef FARM_AVX2
+
+#include "MadgwickKernel.hpp"
+
+#include <immintrin.h>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+// Eight filters to a register. Only the exactly rounded operations are used, so each lane rounds as the scalar code.
+struct Lanes8
+{
+    __m256 v;
+
+    Lanes8() {}
+    Lanes8(float x) : v(_mm256_set1_ps(x)) {}
+    explicit Lanes8(__m256 x) : v(x) {}
+
+    Lanes8& operator+=(Lanes8 b) {v = _mm256_add_ps(v, b.v); return *this;}
+    Lanes8& operator-=(Lanes8 b) {v = _mm256_sub_ps(v, b.v); return *this;}
+    Lanes8& operator*=(Lanes8 b) {v = _mm256_mul_ps(v, b.v); return *this;}
+};
+
+struct Mask8
+{
+    __m256 m;
+};
+
+static inline Lanes8 operator+(Lanes8 a, Lanes8 b) {return Lanes8(_mm256_add_ps(a.v, b.v));}
+static inline Lanes8 operator-(Lanes8 a, Lanes8 b) {return Lanes8(_mm256_sub_ps(a.v, b.v));}
+static inline Lanes8 operator*(Lanes8 a, Lanes8 b) {return Lanes8(_mm256_mul_ps(a.v, b.v));}
+static inline Lanes8 operator-(Lanes8 a) {return Lanes8(_mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)));}
+
+static inline Mask8 AllZero(Lanes8 x, Lanes8 y, Lanes8 z)
+{
+    __m256 zero = _mm256_setzero_ps();
+    Mask8 mask = {_mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(x.v, zero, _CMP_EQ_OQ), _mm256_cmp_ps(y.v, zero, _CMP_EQ_OQ)),
+                                _mm256_cmp_ps(z.v, zero, _CMP_EQ_OQ))};
+    return mask;
+}
+
+static inline Mask8 IsPositive(Lanes8 x) {Mask8 mask = {_mm256_cmp_ps(x.v, _mm256_setzero_ps(), _CMP_GT_OQ)}; return mask;}
+static inline Mask8 Not(Mask8 mask) {Mask8 inverse = {_mm256_xor_ps(mask.m, _mm256_castsi256_ps(_mm256_set1_epi32(-1)))}; return inverse;}
+static inline Mask8 And(Mask8 a, Mask8 b) {Mask8 both = {_mm256_and_ps(a.m, b.m)}; return both;}
+static inline bool AnyOf(Mask8 mask) {return _mm256_movemask_ps(mask.m) != 0;}
+static inline Lanes8 Select(Mask8 mask, Lanes8 a, Lanes8 b) {return Lanes8(_mm256_blendv_ps(b.v, a.v, mask.m));}
+static inline Lanes8 Sqrt(Lanes8 x) {return Lanes8(_mm256_sqrt_ps(x.v));}
+static inline Lanes8 InvSqrt(Lanes8 x) {return Lanes8(_mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(x.v)));}
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+int MadgwickBatch_UpdateAvx2(int count, float *q0, float *q1, float *q2, float *q3, const float *betag,
+                             const MadgwickBatchSamples_t &samples, float dt)
+{
+    const bool withMagnetometer = (samples.mx != nullptr);
+    int i = 0;
+
+    const Lanes8 zero(0.0f);
+
+    for ( ; i + MADGWICK_BATCH_LANES <= count; i += MADGWICK_BATCH_LANES)
+    {
+        Lanes8 a(_mm256_loadu_ps(&q0[i]));
+        Lanes8 b(_mm256_loadu_ps(&q1[i]));
+        Lanes8 c(_mm256_loadu_ps(&q2[i]));
+        Lanes8 d(_mm256_loadu_ps(&q3[i]));
+
+        Madgwick_Step(a, b, c, d,
+                      Lanes8(_mm256_loadu_ps(&samples.gx[i])), Lanes8(_mm256_loadu_ps(&samples.gy[i])),
+                      Lanes8(_mm256_loadu_ps(&samples.gz[i])), Lanes8(_mm256_loadu_ps(&samples.ax[i])),
+                      Lanes8(_mm256_loadu_ps(&samples.ay[i])), Lanes8(_mm256_loadu_ps(&samples.az[i])),
+                      withMagnetometer ? Lanes8(_mm256_loadu_ps(&samples.mx[i])) : zero,
+                      withMagnetometer ? Lanes8(_mm256_loadu_ps(&samples.my[i])) : zero,
+                      withMagnetometer ? Lanes8(_mm256_loadu_ps(&samples.mz[i])) : zero,
+                      Lanes8(_mm256_loadu_ps(&betag[i])), Lanes8(dt));
+
+        _mm256_storeu_ps(&q0[i], a.v);
+        _mm256_storeu_ps(&q1[i], b.v);
+        _mm256_storeu_ps(&q2[i], c.v);
+        _mm256_storeu_ps(&q3[i], d.v);
+    }
+
+    return i;
+}
+
+#endif
@@ -0,0 +1,209 @@
+/**
+ * The kernel of MadgwickBatch, written once as a template over the type holding one value per filter: float for the
+ * scalar path in MadgwickBatch.cpp, Lanes8 for eight filters in an AVX2 register in MadgwickBatchAvx2.cpp. The branches
+ * of MadgwickFilter become masks, so a pass only computes the magnetometer or the IMU only gradient when at least one
+ * of its filters needs it.
+ *
+ * Everything here has internal linkage. MadgwickBatchAvx2.cpp is the only file built with -mavx2, none of its code may
+ * end up shared with the rest of the program, where it would run on CPUs without AVX2.
+ */
+
+#ifndef MADGWICK_KERNEL_HPP
+#define MADGWICK_KERNEL_HPP
+
+#include "MadgwickBatch.hpp"
+#include "FastMath.hpp"
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+// Lane operations for the scalar kernel, a lane mask is a bool
+
+static inline bool AllZero(float x, float y, float z) {return (x == 0.0f) && (y == 0.0f) && (z == 0.0f);}
+static inline bool IsPositive(float x) {return x > 0.0f;}
+static inline bool Not(bool mask) {return ! mask;}
+static inline bool And(bool a, bool b) {return a && b;}
+static inline bool AnyOf(bool mask) {return mask;}
+static inline float Select(bool mask, float a, float b) {return mask ? a : b;}
+static inline float Sqrt(float x) {return FastMath_Sqrt(x);}
+static inline float InvSqrt(float x) {return FastMath_InvSqrt(x);}
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+#ifdef FARM_AVX2
+
+/**
+* Runs the vector kernel over the filters in whole passes of MADGWICK_BATCH_LANES. Only call it where the CPU has AVX2.
+* @return   how many filters it advanced, the ones after that are left for the scalar kernel.
+*/
+int MadgwickBatch_UpdateAvx2(int count, float *q0, float *q1, float *q2, float *q3, const float *betag,
+                             const MadgwickBatchSamples_t &samples, float dt);
+
+#endif
+
+template <typename Lanes>
+static void Madgwick_Step(Lanes &q0, Lanes &q1, Lanes &q2, Lanes &q3, Lanes gx, Lanes gy, Lanes gz,
+                          Lanes ax, Lanes ay, Lanes az, Lanes mx, Lanes my, Lanes mz, Lanes beta, Lanes dt);
+
+template <typename Lanes>
+static void Madgwick_GradientIMU(Lanes q0, Lanes q1, Lanes q2, Lanes q3, Lanes ax, Lanes ay, Lanes az,
+                                 Lanes &s0, Lanes &s1, Lanes &s2, Lanes &s3);
+
+template <typename Lanes>
+static void Madgwick_GradientAHRS(Lanes q0, Lanes q1, Lanes q2, Lanes q3, Lanes ax, Lanes ay, Lanes az,
+                                  Lanes mx, Lanes my, Lanes mz, Lanes &s0, Lanes &s1, Lanes &s2, Lanes &s3);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+// MadgwickFilter::update, a magnetometer that reads all zero gives the IMU only update
+template <typename Lanes>
+static void Madgwick_Step(Lanes &q0, Lanes &q1, Lanes &q2, Lanes &q3, Lanes gx, Lanes gy, Lanes gz,
+                          Lanes ax, Lanes ay, Lanes az, Lanes mx, Lanes my, Lanes mz, Lanes beta, Lanes dt)
+{
+    // Rate of change of quaternion from gyroscope
+    Lanes qDot1 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
+    Lanes qDot2 = 0.5f * (q0 * gx + q2 * gz - q3 * gy);
+    Lanes qDot3 = 0.5f * (q0 * gy - q1 * gz + q3 * gx);
+    Lanes qDot4 = 0.5f * (q0 * gz + q1 * gy - q2 * gx);
+
+    // Feedback only where the accelerometer measurement is valid, the others keep the gyro rate
+    auto feedback = Not(AllZero(ax, ay, az));
+    auto magnetometer = Not(AllZero(mx, my, mz));
+
+    if (AnyOf(feedback))
+    {
+        // Normalise accelerometer measurement, the lanes without feedback normalise 1 instead of 0
+        Lanes recipNorm = InvSqrt(Select(feedback, ax * ax + ay * ay + az * az, 1.0f));
+        ax *= recipNorm;
+        ay *= recipNorm;
+        az *= recipNorm;
+
+        Lanes s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+
+        if (AnyOf(And(feedback, Not(magnetometer))))
+        {
+            Madgwick_GradientIMU(q0, q1, q2, q3, ax, ay, az, s0, s1, s2, s3);
+        }
+
+        if (AnyOf(And(feedback, magnetometer)))
+        {
+            Lanes t0, t1, t2, t3;
+
+            recipNorm = InvSqrt(Select(magnetometer, mx * mx + my * my + mz * mz, 1.0f));
+            mx *= recipNorm;
+            my *= recipNorm;
+            mz *= recipNorm;
+
+            Madgwick_GradientAHRS(q0, q1, q2, q3, ax, ay, az, mx, my, mz, t0, t1, t2, t3);
+
+            s0 = Select(magnetometer, t0, s0);
+            s1 = Select(magnetometer, t1, s1);
+            s2 = Select(magnetometer, t2, s2);
+            s3 = Select(magnetometer, t3, s3);
+        }
+
+        // normalise step magnitude, a zero step (at rest on the model) stays zero
+        recipNorm = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+        auto moving = IsPositive(recipNorm);
+        recipNorm = Select(moving, InvSqrt(Select(moving, recipNorm, 1.0f)), 0.0f);
+        s0 *= recipNorm;
+        s1 *= recipNorm;
+        s2 *= recipNorm;
+        s3 *= recipNorm;
+
+        // Apply feedback step
+        qDot1 = Select(feedback, qDot1 - beta * s0, qDot1);
+        qDot2 = Select(feedback, qDot2 - beta * s1, qDot2);
+        qDot3 = Select(feedback, qDot3 - beta * s2, qDot3);
+        qDot4 = Select(feedback, qDot4 - beta * s3, qDot4);
+    }
+
+    // Integrate rate of change of quaternion to yield quaternion
+    q0 += qDot1 * dt;
+    q1 += qDot2 * dt;
+    q2 += qDot3 * dt;
+    q3 += qDot4 * dt;
+
+    // Normalise quaternion
+    Lanes recipNorm = InvSqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    q0 *= recipNorm;
+    q1 *= recipNorm;
+    q2 *= recipNorm;
+    q3 *= recipNorm;
+}
+
+// Corrective step of MadgwickFilter::updateIMU, on a normalised accelerometer measurement
+template <typename Lanes>
+static void Madgwick_GradientIMU(Lanes q0, Lanes q1, Lanes q2, Lanes q3, Lanes ax, Lanes ay, Lanes az,
+                                 Lanes &s0, Lanes &s1, Lanes &s2, Lanes &s3)
+{
+    // Auxiliary variables to avoid repeated arithmetic
+    Lanes _2q0 = 2.0f * q0;
+    Lanes _2q1 = 2.0f * q1;
+    Lanes _2q2 = 2.0f * q2;
+    Lanes _2q3 = 2.0f * q3;
+    Lanes _4q0 = 4.0f * q0;
+    Lanes _4q1 = 4.0f * q1;
+    Lanes _4q2 = 4.0f * q2;
+    Lanes _8q1 = 8.0f * q1;
+    Lanes _8q2 = 8.0f * q2;
+    Lanes q0q0 = q0 * q0;
+    Lanes q1q1 = q1 * q1;
+    Lanes q2q2 = q2 * q2;
+    Lanes q3q3 = q3 * q3;
+
+    // Gradient decent algorithm corrective step
+    s0 = _4q0 * q2q2 + _2q2 * ax + _4q0 * q1q1 - _2q1 * ay;
+    s1 = _4q1 * q3q3 - _2q3 * ax + 4.0f * q0q0 * q1 - _2q0 * ay - _4q1 + _8q1 * q1q1 + _8q1 * q2q2 + _4q1 * az;
+    s2 = 4.0f * q0q0 * q2 + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2 + _8q2 * q1q1 + _8q2 * q2q2 + _4q2 * az;
+    s3 = 4.0f * q1q1 * q3 - _2q1 * ax + 4.0f * q2q2 * q3 - _2q2 * ay;
+}
+
+// Corrective step of MadgwickFilter::update, on normalised accelerometer and magnetometer measurements
+template <typename Lanes>
+static void Madgwick_GradientAHRS(Lanes q0, Lanes q1, Lanes q2, Lanes q3, Lanes ax, Lanes ay, Lanes az,
+                                  Lanes mx, Lanes my, Lanes mz, Lanes &s0, Lanes &s1, Lanes &s2, Lanes &s3)
+{
+    // Auxiliary variables to avoid repeated arithmetic
+    Lanes _2q0mx = 2.0f * q0 * mx;
+    Lanes _2q0my = 2.0f * q0 * my;
+    Lanes _2q0mz = 2.0f * q0 * mz;
+    Lanes _2q1mx = 2.0f * q1 * mx;
+    Lanes _2q0 = 2.0f * q0;
+    Lanes _2q1 = 2.0f * q1;
+    Lanes _2q2 = 2.0f * q2;
+    Lanes _2q3 = 2.0f * q3;
+    Lanes _2q0q2 = 2.0f * q0 * q2;
+    Lanes _2q2q3 = 2.0f * q2 * q3;
+    Lanes q0q0 = q0 * q0;
+    Lanes q0q1 = q0 * q1;
+    Lanes q0q2 = q0 * q2;
+    Lanes q0q3 = q0 * q3;
+    Lanes q1q1 = q1 * q1;
+    Lanes q1q2 = q1 * q2;
+    Lanes q1q3 = q1 * q3;
+    Lanes q2q2 = q2 * q2;
+    Lanes q2q3 = q2 * q3;
+    Lanes q3q3 = q3 * q3;
+
+    // Reference direction of Earth's magnetic field
+    Lanes hx = mx * q0q0 - _2q0my * q3 + _2q0mz * q2 + mx * q1q1 + _2q1 * my * q2 + _2q1 * mz * q3 - mx * q2q2 - mx * q3q3;
+    Lanes hy = _2q0mx * q3 + my * q0q0 - _2q0mz * q1 + _2q1mx * q2 - my * q1q1 + my * q2q2 + _2q2 * mz * q3 - my * q3q3;
+    Lanes _2bx = Sqrt(hx * hx + hy * hy);
+    Lanes _2bz = -_2q0mx * q2 + _2q0my * q1 + mz * q0q0 + _2q1mx * q3 - mz * q1q1 + _2q2 * my * q3 - mz * q2q2 + mz * q3q3;
+    Lanes _4bx = 2.0f * _2bx;
+    Lanes _4bz = 2.0f * _2bz;
+
+    // Gradient decent algorithm corrective step
+    s0 = -_2q2 * (2.0f * q1q3 - _2q0q2 - ax) + _2q1 * (2.0f * q0q1 + _2q2q3 - ay) - _2bz * q2 * (_2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx) + (-_2bx * q3 + _2bz * q1) * (_2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my) + _2bx * q2 * (_2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz);
+    s1 = _2q3 * (2.0f * q1q3 - _2q0q2 - ax) + _2q0 * (2.0f * q0q1 + _2q2q3 - ay) - 4.0f * q1 * (1.0f - 2.0f * q1q1 - 2.0f * q2q2 - az) + _2bz * q3 * (_2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx) + (_2bx * q2 + _2bz * q0) * (_2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my) + (_2bx * q3 - _4bz * q1) * (_2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz);
+    s2 = -_2q0 * (2.0f * q1q3 - _2q0q2 - ax) + _2q3 * (2.0f * q0q1 + _2q2q3 - ay) - 4.0f * q2 * (1.0f - 2.0f * q1q1 - 2.0f * q2q2 - az) + (-_4bx * q2 - _2bz * q0) * (_2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx) + (_2bx * q1 + _2bz * q3) * (_2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my) + (_2bx * q0 - _4bz * q2) * (_2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz);
+    s3 = _2q1 * (2.0f * q1q3 - _2q0q2 - ax) + _2q2 * (2.0f * q0q1 + _2q2q3 - ay) + (-_4bx * q3 + _2bz * q1) * (_2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx) + (-_2bx * q0 + _2bz * q2) * (_2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my) + _2bx * q1 * (_2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz);
+}
+
+#endif
@@ -0,0 +1,59 @@
+#include "AttitudeReplay.hpp"
+
+#include "GetFromPathManager.hpp"
+#include "fetchSensorMeasurementsMode.hpp"
+#include "SendInstructionsToSafety.hpp"
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+static const AttitudeFrame_t *currentFrame = nullptr;
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+void AttitudeReplay_SetFrame(const AttitudeFrame_t *Frame)
+{
+    currentFrame = Frame;
+}
+
+PMError_t PM_GetCommands(PMCommands *Commands)
+{
+    PMError_t errorStruct;
+
+    *Commands = currentFrame->commands;
+    errorStruct.errorCode = currentFrame->commandsErrorCode;
+
+    return errorStruct;
+}
+
+SensorError_t SensorMeasurements_GetResult(IMU *imusns, airspeed *airspeedsns, IMU_Data_t *imudata, Airspeed_Data_t *airspeeddata)
+{
+    (void) imusns;
+    (void) airspeedsns;
+
+    SensorError_t errorStruct;
+
+    *imudata = currentFrame->imu;
+    *airspeeddata = currentFrame->airspeed;
+    errorStruct.errorCode = currentFrame->sensorErrorCode;
+
+    return errorStruct;
+}
+
+// The replay reads the mixed channels straight off the data bus, so nothing has to go anywhere.
+void SendToSafety_Init(void) {}
+
+SendToSafety_error_t SendToSafety_Commit(const float *percent, int numChannels, uint32_t sampleTimeUs)
+{
+    (void) percent;
+    (void) numChannels;
+    (void) sampleTimeUs;
+
+    SendToSafety_error_t errorStruct;
+    errorStruct.errorCode = 0;
+
+    return errorStruct;
+}
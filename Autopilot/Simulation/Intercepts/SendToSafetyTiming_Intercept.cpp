@@ -0,0 +1,27 @@
+#include "SendInstructionsToSafety.hpp"
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+// The Simulink hooks replace SendToSafety_Execute, so a frame goes to them one channel at a time. They have no use for
+// the sample time stamp.
+SendToSafety_error_t SendToSafety_Commit(const float *percent, int numChannels, uint32_t sampleTimeUs)
+{
+    (void) sampleTimeUs;
+
+    SendToSafety_error_t error;
+    error.errorCode = 0;
+
+    for (int channel = 0; (channel < numChannels) && (error.errorCode == 0); channel++)
+    {
+        error = SendToSafety_Execute(channel, percent[channel]);
+    }
+
+    return error;
+}
+
+void SendToSafety_SetSampleTime(uint32_t sampleTimeUs)
+{
+    (void) sampleTimeUs;
+}
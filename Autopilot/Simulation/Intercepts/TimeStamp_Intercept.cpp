@@ -0,0 +1,22 @@
+#include "TimeStamp.h"
+
+#include <chrono>
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+// On the host the steady clock stands in for the DWT cycle counter.
+
+static std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+void TimeStamp_Init(void)
+{
+    startTime = std::chrono::steady_clock::now();
+}
+
+uint32_t TimeStamp_GetMicroseconds(void)
+{
+    std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - startTime;
+    return (uint32_t) std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
@@ -0,0 +1,20 @@
+/**
+ * Glue between the attitudeReplay driver and the intercepts that stand in for the attitude manager's inputs.
+ */
+
+#ifndef ATTITUDE_REPLAY_HPP
+#define ATTITUDE_REPLAY_HPP
+
+#include "AttitudeRecorder.hpp"
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+/**
+* Selects the frame whose inputs PM_GetCommands and SensorMeasurements_GetResult hand out until the next call.
+* @param[in]    Frame       the recorded frame. Must stay valid until the next call.
+*/
+void AttitudeReplay_SetFrame(const AttitudeFrame_t *Frame);
+
+#endif
@@ -0,0 +1,297 @@
+/**
+ * Replays a recording made with AttitudeRecorder through the attitude manager as fast as the host allows.
+ *
+ * Usage: attitudeReplay <recording> [-o <channels out>] [-r <reference channels>] [-t <tolerance>]
+ *
+ * The channel files hold NUM_MIXED_CHANNELS little endian floats per frame, in the order they were produced.
+ * When a reference is given, every frame is compared against it and the exit code is non zero if any channel
+ * differs by more than the tolerance. Without -t the output must be bit exact, with it the tolerance must be a
+ * positive number.
+ */
+
+#include "AttitudeReplay.hpp"
+#include "attitudeManager.hpp"
+#include "AttitudeDataBus.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+// A cycle is 6 states long, anything longer means the state machine is stuck
+#define MAX_STEPS_PER_FRAME 16
+
+struct ReplayOptions_t
+{
+    const char *recordingPath;
+    const char *outputPath;
+    const char *referencePath;
+    float tolerance;
+};
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+static bool parseArguments(int argc, char *argv[], ReplayOptions_t *options);
+static bool readFile(const char *path, vector<uint8_t> &contents);
+static bool loadRecording(const char *path, vector<AttitudeFrame_t> &frames);
+static int compareWithReference(const char *path, const vector<ChannelOut_t> &channels, float tolerance);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+int main(int argc, char *argv[])
+{
+    ReplayOptions_t options;
+
+    if ( ! parseArguments(argc, argv, &options))
+    {
+        fprintf(stderr, "Usage: %s <recording> [-o <channels out>] [-r <reference channels>] [-t <tolerance>]\n", argv[0]);
+        return 2;
+    }
+
+    vector<AttitudeFrame_t> frames;
+
+    if ( ! loadRecording(options.recordingPath, frames))
+    {
+        return 2;
+    }
+
+    vector<ChannelOut_t> channels;
+    channels.reserve(frames.size());
+
+    attitudeManager attMng;
+    bool failed = false;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        AttitudeReplay_SetFrame(&frames[i]);
+
+        int steps = 0;
+
+        do
+        {
+            attMng.execute();
+            steps++;
+        } while (attMng.getStatus() == IN_CYCLE && steps < MAX_STEPS_PER_FRAME);
+
+        if (attMng.getStatus() != COMPLETED_CYCLE)
+        {
+            fprintf(stderr, "Attitude manager left the cycle at frame %zu (status %d)\n", i, (int) attMng.getStatus());
+            failed = true;
+            break;
+        }
+
+        ChannelOut_t channelOut;
+        ChannelOutTopic.read(channelOut);
+        channels.push_back(channelOut);
+    }
+
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+    double seconds = elapsed.count();
+    printf("Replayed %zu of %zu frames in %.3f s (%.0f frames/s)\n", channels.size(), frames.size(), seconds,
+           seconds > 0 ? channels.size() / seconds : 0.0);
+
+    if (channels.size() > 1)
+    {
+        double recordedSeconds = frames[channels.size() - 1].imu.utcTime - frames[0].imu.utcTime;
+
+        if (recordedSeconds > 0 && seconds > 0)
+        {
+            printf("Recording spans %.3f s, %.1fx faster than realtime\n", recordedSeconds, recordedSeconds / seconds);
+        }
+    }
+
+    if (options.outputPath != nullptr)
+    {
+        FILE *output = fopen(options.outputPath, "wb");
+
+        if (output == nullptr || fwrite(channels.data(), sizeof(ChannelOut_t), channels.size(), output) != channels.size())
+        {
+            fprintf(stderr, "Could not write %s\n", options.outputPath);
+            failed = true;
+        }
+
+        if (output != nullptr)
+        {
+            fclose(output);
+        }
+    }
+
+    if (options.referencePath != nullptr && compareWithReference(options.referencePath, channels, options.tolerance) != 0)
+    {
+        failed = true;
+    }
+
+    return failed ? 1 : 0;
+}
+
+static bool parseArguments(int argc, char *argv[], ReplayOptions_t *options)
+{
+    options->recordingPath = nullptr;
+    options->outputPath = nullptr;
+    options->referencePath = nullptr;
+    options->tolerance = 0.0f;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = (i + 1 < argc);
+
+        if (strcmp(argv[i], "-o") == 0 && hasValue)
+        {
+            options->outputPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "-r") == 0 && hasValue)
+        {
+            options->referencePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "-t") == 0 && hasValue)
+        {
+            char *end;
+            options->tolerance = strtof(argv[++i], &end);
+
+            if (end == argv[i] || *end != '\0' || ! (options->tolerance > 0.0f) || ! isfinite(options->tolerance))
+            {
+                fprintf(stderr, "-t needs a positive tolerance, not %s\n", argv[i]);
+                return false;
+            }
+        }
+        else if (argv[i][0] != '-' && options->recordingPath == nullptr)
+        {
+            options->recordingPath = argv[i];
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return options->recordingPath != nullptr;
+}
+
+static bool readFile(const char *path, vector<uint8_t> &contents)
+{
+    FILE *file = fopen(path, "rb");
+
+    if (file == nullptr)
+    {
+        fprintf(stderr, "Could not open %s\n", path);
+        return false;
+    }
+
+    uint8_t chunk[4096];
+    size_t length;
+
+    while ((length = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        contents.insert(contents.end(), chunk, chunk + length);
+    }
+
+    fclose(file);
+
+    return true;
+}
+
+static bool loadRecording(const char *path, vector<AttitudeFrame_t> &frames)
+{
+    vector<uint8_t> contents;
+
+    if ( ! readFile(path, contents))
+    {
+        return false;
+    }
+
+    if (contents.size() < ATTITUDE_RECORDING_HEADER_SIZE || ! AttitudeRecorder_CheckHeader(contents.data()))
+    {
+        fprintf(stderr, "%s is not a recording this version can replay\n", path);
+        return false;
+    }
+
+    size_t payload = contents.size() - ATTITUDE_RECORDING_HEADER_SIZE;
+
+    if (payload % ATTITUDE_FRAME_SIZE != 0)
+    {
+        fprintf(stderr, "%s ends with a partial frame, it is ignored\n", path);
+    }
+
+    frames.resize(payload / ATTITUDE_FRAME_SIZE);
+
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        AttitudeFrame_Decode(&contents[ATTITUDE_RECORDING_HEADER_SIZE + i * ATTITUDE_FRAME_SIZE], &frames[i]);
+    }
+
+    return true;
+}
+
+static int compareWithReference(const char *path, const vector<ChannelOut_t> &channels, float tolerance)
+{
+    vector<uint8_t> contents;
+
+    if ( ! readFile(path, contents))
+    {
+        return 1;
+    }
+
+    size_t referenceFrames = contents.size() / sizeof(ChannelOut_t);
+    size_t compared = referenceFrames < channels.size() ? referenceFrames : channels.size();
+    size_t mismatches = 0;
+    size_t firstMismatch = 0;
+    float worstDifference = 0.0f;
+
+    for (size_t i = 0; i < compared; i++)
+    {
+        ChannelOut_t reference;
+        memcpy(&reference, &contents[i * sizeof(ChannelOut_t)], sizeof(ChannelOut_t));
+
+        bool frameMatches = true;
+
+        for (int channel = 0; channel < NUM_MIXED_CHANNELS; channel++)
+        {
+            float difference = fabsf(channels[i].channel[channel] - reference.channel[channel]);
+
+            // NaN never compares, so it is caught by the negated test
+            if ( ! (difference <= tolerance))
+            {
+                frameMatches = false;
+                worstDifference = (difference > worstDifference || difference != difference) ? difference : worstDifference;
+            }
+        }
+
+        if ( ! frameMatches)
+        {
+            firstMismatch = (mismatches == 0) ? i : firstMismatch;
+            mismatches++;
+        }
+    }
+
+    if (referenceFrames != channels.size())
+    {
+        fprintf(stderr, "Reference holds %zu frames, replay produced %zu\n", referenceFrames, channels.size());
+    }
+
+    if (mismatches != 0)
+    {
+        printf("%zu of %zu frames differ from the reference, first at frame %zu, worst difference %g\n",
+               mismatches, compared, firstMismatch, worstDifference);
+    }
+    else
+    {
+        printf("All %zu frames match the reference\n", compared);
+    }
+
+    return (mismatches != 0 || referenceFrames != channels.size()) ? 1 : 0;
+}
@@ -0,0 +1,79 @@
+#include "AttitudeTimerTick.h"
+#include "AttitudeTask.hpp"
+#include "AttitudeRecorder.hpp"
+#include "AttitudeRecordingRing.hpp"
+#include "TimeStamp.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "tim.h"
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+// TIM10 is prescaled to count microseconds, see MX_TIM10_Init
+#define TIMER_COUNTS_PER_SECOND 1000000UL
+
+// Wait a little over two periods before declaring the timer dead
+#define TICK_TIMEOUT_MS (3 * 1000 / ATTITUDE_TASK_RATE_HZ + 1)
+
+static TaskHandle_t volatile attitudeTaskHandle = NULL;
+static volatile uint32_t lastTickTimeUs = 0;
+
+class TimerTickSource : public AttitudeTickSource
+{
+    public:
+        uint32_t waitForTick()
+        {
+            // Every elapsed period adds one to the notification value, so anything above 1 means missed ticks
+            return ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TICK_TIMEOUT_MS));
+        }
+
+        uint32_t getTickTimeUs() {return lastTickTimeUs;}
+};
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+void Attitude_Run(void const *argument)
+{
+    (void) argument;
+
+    static TimerTickSource tickSource;
+    static AttitudeTask attitudeTask(tickSource, ATTITUDE_TASK_RATE_HZ);
+
+    attitudeTaskHandle = xTaskGetCurrentTaskHandle();
+
+    // Every cycle is recorded, telemetry takes the recording to the ground
+    AttitudeRecorder_Start(AttitudeRecordingRing_Sink, NULL);
+
+    __HAL_TIM_SET_AUTORELOAD(&htim10, TIMER_COUNTS_PER_SECOND / ATTITUDE_TASK_RATE_HZ - 1);
+    __HAL_TIM_SET_COUNTER(&htim10, 0);
+
+    if (HAL_TIM_Base_Start_IT(&htim10) != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    while (1)
+    {
+        attitudeTask.runOnce();
+    }
+}
+
+void AttitudeTimerTick_OnTimerElapsed(void)
+{
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+
+    if (attitudeTaskHandle == NULL)
+    {
+        return;
+    }
+
+    lastTickTimeUs = TimeStamp_GetMicroseconds();
+
+    vTaskNotifyGiveFromISR(attitudeTaskHandle, &higherPriorityTaskWoken);
+    portYIELD_FROM_ISR(higherPriorityTaskWoken);
+}
@@ -0,0 +1,80 @@
+/**
+ * Biquad coefficient design, see BiquadBank.hpp.
+ */
+
+#include "BiquadBank.hpp"
+
+#include <math.h>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define PI_F 3.14159265f
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+static bool isBelowNyquist(float frequencyHz, float sampleRateHz);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+BiquadCoefficients_t Biquad_PassThrough(void)
+{
+    BiquadCoefficients_t coefficients = {1.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    return coefficients;
+}
+
+BiquadCoefficients_t Biquad_LowPass(float cutoffHz, float sampleRateHz, float q)
+{
+    if ( ! isBelowNyquist(cutoffHz, sampleRateHz) || q <= 0.0f)
+    {
+        return Biquad_PassThrough();
+    }
+
+    float omega = 2.0f * PI_F * cutoffHz / sampleRateHz;
+    float cosOmega = cosf(omega);
+    float alpha = sinf(omega) / (2.0f * q);
+    float a0 = 1.0f + alpha;
+
+    BiquadCoefficients_t coefficients;
+
+    coefficients.b0 = 0.5f * (1.0f - cosOmega) / a0;
+    coefficients.b1 = (1.0f - cosOmega) / a0;
+    coefficients.b2 = coefficients.b0;
+    coefficients.a1 = -2.0f * cosOmega / a0;
+    coefficients.a2 = (1.0f - alpha) / a0;
+
+    return coefficients;
+}
+
+BiquadCoefficients_t Biquad_Notch(float centreHz, float sampleRateHz, float q)
+{
+    if ( ! isBelowNyquist(centreHz, sampleRateHz) || q <= 0.0f)
+    {
+        return Biquad_PassThrough();
+    }
+
+    float omega = 2.0f * PI_F * centreHz / sampleRateHz;
+    float cosOmega = cosf(omega);
+    float alpha = sinf(omega) / (2.0f * q);
+    float a0 = 1.0f + alpha;
+
+    BiquadCoefficients_t coefficients;
+
+    coefficients.b0 = 1.0f / a0;
+    coefficients.b1 = -2.0f * cosOmega / a0;
+    coefficients.b2 = coefficients.b0;
+    coefficients.a1 = coefficients.b1;
+    coefficients.a2 = (1.0f - alpha) / a0;
+
+    return coefficients;
+}
+
+static bool isBelowNyquist(float frequencyHz, float sampleRateHz)
+{
+    return frequencyHz > 0.0f && frequencyHz < 0.5f * sampleRateHz;
+}
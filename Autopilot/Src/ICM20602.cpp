@@ -0,0 +1,247 @@
+/**
+ * ICM-20602 driver, FIFO burst mode. See IMU.hpp.
+ */
+
+#include "IMU.hpp"
+
+#ifndef UNIT_TESTING
+#include "TimeStamp.h"
+#include "spi.h"
+#endif
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define SAMPLE_PERIOD (1.0f / ICM20602_SAMPLE_RATE_HZ)
+
+#ifndef UNIT_TESTING
+
+// SPI2 in mode 0 with 8 bit frames and IMU_CS as the chip select, so that it stays low through a whole burst. The
+// ICM-20602 takes register writes at up to 1 MHz and reads of the sensor and interrupt registers, the FIFO among
+// them, at up to 10 MHz: the board files set up the slow clock, 54 MHz / 64, and the driver switches to 54 MHz / 8
+// for everything but the writes.
+#define ICM20602_SPI hspi2
+#define SPI_PRESCALER_WRITE SPI_BAUDRATEPRESCALER_64
+#define SPI_PRESCALER_READ SPI_BAUDRATEPRESCALER_8
+#define SPI_TIMEOUT_MS 3                    // a burst of the whole FIFO takes 1.2 ms at the read clock
+
+// Registers
+#define REG_SMPLRT_DIV 0x19
+#define REG_CONFIG 0x1A
+#define REG_GYRO_CONFIG 0x1B
+#define REG_ACCEL_CONFIG 0x1C
+#define REG_FIFO_EN 0x23
+#define REG_INT_STATUS 0x3A
+#define REG_USER_CTRL 0x6A
+#define REG_PWR_MGMT_1 0x6B
+#define REG_FIFO_COUNTH 0x72
+#define REG_FIFO_R_W 0x74
+
+#define READ_BIT 0x80
+
+#define CONFIG_DLPF_176HZ 0x01              // with SMPLRT_DIV 0 this samples at 1 kHz
+#define GYRO_CONFIG_2000DPS 0x18
+#define ACCEL_CONFIG_16G 0x18
+#define FIFO_EN_ACCEL_AND_GYRO 0x18         // temperature comes along with them, see ICM20602_FIFO_FRAME_SIZE
+#define INT_STATUS_FIFO_OFLOW 0x10
+#define USER_CTRL_FIFO_EN 0x40
+#define USER_CTRL_I2C_IF_DIS 0x10           // SPI only, so that the bus traffic is never taken for I2C
+#define USER_CTRL_FIFO_RST 0x04
+#define PWR_MGMT_1_AUTO_CLOCK 0x01
+
+#endif
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+#ifndef UNIT_TESTING
+static bool setPrescaler(uint32_t prescaler);
+static bool transfer(uint8_t *tx, uint8_t *rx, size_t length);
+static bool writeRegister(uint8_t reg, uint8_t value);
+static bool readRegisters(uint8_t reg, uint8_t *data, size_t length);
+#endif
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+ICM20602::ICM20602() : scale(ImuFifo_Scale(ICM20602_ACCEL_RANGE_G, ICM20602_GYRO_RANGE_DPS)),
+    newestSampleTimeUs(0), status(0), configured(false)
+{
+    increment = integrator.take(0);
+}
+
+void ICM20602::IngestFifo(const uint8_t *bytes, size_t length, uint32_t countTimeUs)
+{
+    if (ImuFifo_Integrate(bytes, length, scale, SAMPLE_PERIOD, integrator) > 0)
+    {
+        newestSampleTimeUs = countTimeUs;
+    }
+}
+
+void ICM20602::GetResult(IMUData_t &Data)
+{
+    Data.magx = Data.magy = Data.magz = 0.0f;
+    Data.sensorStatus = status;
+    Data.utcTime = 0.0f;
+
+    if (integrator.getSampleCount() == 0)
+    {
+        // Nothing since the last call, the previous interval is reported again as old data
+        Data.isDataNew = false;
+    }
+    else
+    {
+        increment = integrator.take(newestSampleTimeUs);
+        Data.isDataNew = true;
+    }
+
+    float scaleToRate = (increment.deltaTime > 0.0f) ? 1.0f / increment.deltaTime : 0.0f;
+
+    Data.gyrx = increment.deltaAngle[0] * scaleToRate;
+    Data.gyry = increment.deltaAngle[1] * scaleToRate;
+    Data.gyrz = increment.deltaAngle[2] * scaleToRate;
+    Data.accx = increment.deltaVelocity[0] * scaleToRate;
+    Data.accy = increment.deltaVelocity[1] * scaleToRate;
+    Data.accz = increment.deltaVelocity[2] * scaleToRate;
+    Data.sampleTimeUs = increment.sampleTimeUs;
+    Data.deltaTime = increment.deltaTime;
+}
+
+#ifndef UNIT_TESTING
+
+void ICM20602::Init()
+{
+    bool ok = writeRegister(REG_PWR_MGMT_1, PWR_MGMT_1_AUTO_CLOCK);
+
+    ok = ok && writeRegister(REG_CONFIG, CONFIG_DLPF_176HZ);
+    ok = ok && writeRegister(REG_SMPLRT_DIV, 0);
+    ok = ok && writeRegister(REG_GYRO_CONFIG, GYRO_CONFIG_2000DPS);
+    ok = ok && writeRegister(REG_ACCEL_CONFIG, ACCEL_CONFIG_16G);
+    ok = ok && writeRegister(REG_FIFO_EN, FIFO_EN_ACCEL_AND_GYRO);
+    ok = ok && writeRegister(REG_USER_CTRL, USER_CTRL_FIFO_EN | USER_CTRL_I2C_IF_DIS | USER_CTRL_FIFO_RST);
+
+    integrator.reset();
+    status = ok ? 0 : -1;
+    configured = ok;
+}
+
+void ICM20602::Begin_Measuring()
+{
+    if ( ! configured)
+    {
+        Init();
+        return;
+    }
+
+    uint8_t interruptStatus;
+    uint8_t count[2];
+
+    if ( ! readRegisters(REG_INT_STATUS, &interruptStatus, 1))
+    {
+        status = -1;
+        return;
+    }
+
+    // Every frame counted was in the FIFO by now, the newest one at most a sample period before. The burst that
+    // follows can take over a millisecond, a stamp taken after it would make the samples look younger than they are.
+    uint32_t countTimeUs = TimeStamp_GetMicroseconds();
+
+    if ( ! readRegisters(REG_FIFO_COUNTH, count, 2))
+    {
+        status = -1;
+        return;
+    }
+
+    // After an overflow the frames are no longer aligned. The interval is dropped and the next one starts from an
+    // empty FIFO, this cycle's GetResult reports old data.
+    if (interruptStatus & INT_STATUS_FIFO_OFLOW)
+    {
+        status = writeRegister(REG_USER_CTRL, USER_CTRL_FIFO_EN | USER_CTRL_I2C_IF_DIS | USER_CTRL_FIFO_RST) ? 0 : -1;
+        integrator.reset();
+        return;
+    }
+
+    size_t length = ((size_t) count[0] << 8) | count[1];
+    length -= length % ICM20602_FIFO_FRAME_SIZE;
+
+    if (length > ICM20602_FIFO_SIZE)
+    {
+        length = ICM20602_FIFO_SIZE - ICM20602_FIFO_SIZE % ICM20602_FIFO_FRAME_SIZE;
+    }
+
+    static uint8_t burst[ICM20602_FIFO_SIZE];
+
+    if (length > 0 && ! readRegisters(REG_FIFO_R_W, burst, length))
+    {
+        status = -1;
+        return;
+    }
+
+    IngestFifo(burst, length, countTimeUs);
+    status = 0;
+}
+
+// Reconfigures the bus without going through its MSP init again, HAL_SPI_Init only does that from the reset state
+static bool setPrescaler(uint32_t prescaler)
+{
+    if (ICM20602_SPI.Init.BaudRatePrescaler == prescaler)
+    {
+        return true;
+    }
+
+    ICM20602_SPI.Init.BaudRatePrescaler = prescaler;
+
+    return HAL_SPI_Init(&ICM20602_SPI) == HAL_OK;
+}
+
+static bool transfer(uint8_t *tx, uint8_t *rx, size_t length)
+{
+    HAL_GPIO_WritePin(IMU_CS_GPIO_Port, IMU_CS_Pin, GPIO_PIN_RESET);
+    bool ok = HAL_SPI_TransmitReceive(&ICM20602_SPI, tx, rx, (uint16_t) length, SPI_TIMEOUT_MS) == HAL_OK;
+    HAL_GPIO_WritePin(IMU_CS_GPIO_Port, IMU_CS_Pin, GPIO_PIN_SET);
+
+    return ok;
+}
+
+// At the write clock, the bus is left at the read clock
+static bool writeRegister(uint8_t reg, uint8_t value)
+{
+    uint8_t tx[2] = {reg, value};
+    uint8_t rx[2];
+
+    bool ok = setPrescaler(SPI_PRESCALER_WRITE) && transfer(tx, rx, 2);
+
+    return setPrescaler(SPI_PRESCALER_READ) && ok;
+}
+
+// One transfer, the register address auto increments (FIFO_R_W does not, it pops the next byte)
+static bool readRegisters(uint8_t reg, uint8_t *data, size_t length)
+{
+    static uint8_t tx[ICM20602_FIFO_SIZE + 1];
+    static uint8_t rx[ICM20602_FIFO_SIZE + 1];
+
+    tx[0] = reg | READ_BIT;
+
+    if ( ! transfer(tx, rx, length + 1))
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < length; i++)
+    {
+        data[i] = rx[i + 1];
+    }
+
+    return true;
+}
+
+#else
+
+// The tests feed IngestFifo directly
+void ICM20602::Init() {}
+void ICM20602::Begin_Measuring() {}
+
+#endif
@@ -0,0 +1,128 @@
+/**
+ * IMU FIFO ingestion and pre-integration.
+ *
+ * The coning and sculling corrections are the recursive two sample forms (Savage, "Strapdown Inertial Navigation
+ * Integration Algorithm Design"), ie the rates are taken as varying linearly between samples:
+ *
+ *   beta     += 1/2 (alpha + dTheta_prev / 6) x dTheta
+ *   sculling += 1/2 ((alpha + dTheta_prev / 6) x dV + (v + dV_prev / 6) x dTheta)
+ *
+ * and over the interval   delta angle = alpha + beta,   delta velocity = v + 1/2 alpha x v + sculling.
+ */
+
+#include "ImuFifo.hpp"
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define ICM20602_LSB_PER_G_AT_2G 16384.0f
+#define ICM20602_LSB_PER_DPS_AT_250DPS 131.0f
+
+// Offsets of the values in a FIFO frame
+#define FRAME_ACCEL 0
+#define FRAME_GYRO 8
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+static int16_t readBigEndian(const uint8_t *bytes);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+ImuFifoScale_t ImuFifo_Scale(int accelRangeG, int gyroRangeDps)
+{
+    ImuFifoScale_t scale;
+
+    scale.accel = IMU_FIFO_GRAVITY * (float) accelRangeG / (2.0f * ICM20602_LSB_PER_G_AT_2G);
+    scale.gyro = IMU_FIFO_DEG_TO_RAD * (float) gyroRangeDps / (250.0f * ICM20602_LSB_PER_DPS_AT_250DPS);
+
+    return scale;
+}
+
+void ImuPreintegrator::reset()
+{
+    alpha = Vec3::zeros();
+    beta = Vec3::zeros();
+    velocity = Vec3::zeros();
+    sculling = Vec3::zeros();
+    lastDeltaAngle = Vec3::zeros();
+    lastDeltaVelocity = Vec3::zeros();
+    deltaTime = 0.0f;
+    sampleCount = 0;
+}
+
+void ImuPreintegrator::addSample(const float gyro[3], const float accel[3], float dt)
+{
+    Vec3 deltaAngle = Vec3::fromArray(gyro) * dt;
+    Vec3 deltaVelocity = Vec3::fromArray(accel) * dt;
+
+    Vec3 angleSoFar = alpha + lastDeltaAngle * (1.0f / 6.0f);
+    Vec3 velocitySoFar = velocity + lastDeltaVelocity * (1.0f / 6.0f);
+
+    beta += cross(angleSoFar, deltaAngle) * 0.5f;
+    sculling += (cross(angleSoFar, deltaVelocity) + cross(velocitySoFar, deltaAngle)) * 0.5f;
+
+    alpha += deltaAngle;
+    velocity += deltaVelocity;
+    lastDeltaAngle = deltaAngle;
+    lastDeltaVelocity = deltaVelocity;
+
+    deltaTime += dt;
+    sampleCount++;
+}
+
+ImuIncrement_t ImuPreintegrator::take(uint32_t sampleTimeUs)
+{
+    ImuIncrement_t increment;
+
+    // The velocity is rotated into the body at the start of the interval by the 1/2 alpha x v term
+    (alpha + beta).toArray(increment.deltaAngle);
+    (velocity + cross(alpha, velocity) * 0.5f + sculling).toArray(increment.deltaVelocity);
+
+    increment.deltaTime = deltaTime;
+    increment.sampleCount = sampleCount;
+    increment.sampleTimeUs = sampleTimeUs;
+
+    // The last sample carries over, the next interval continues from the same motion
+    alpha = Vec3::zeros();
+    beta = Vec3::zeros();
+    velocity = Vec3::zeros();
+    sculling = Vec3::zeros();
+    deltaTime = 0.0f;
+    sampleCount = 0;
+
+    return increment;
+}
+
+size_t ImuFifo_Integrate(const uint8_t *bytes, size_t length, const ImuFifoScale_t &scale, float samplePeriod,
+                         ImuPreintegrator &integrator)
+{
+    size_t frames = length / ICM20602_FIFO_FRAME_SIZE;
+
+    for (size_t frame = 0; frame < frames; frame++)
+    {
+        const uint8_t *data = bytes + frame * ICM20602_FIFO_FRAME_SIZE;
+
+        float accel[3];
+        float gyro[3];
+
+        for (int i = 0; i < 3; i++)
+        {
+            accel[i] = (float) readBigEndian(data + FRAME_ACCEL + 2 * i) * scale.accel;
+            gyro[i] = (float) readBigEndian(data + FRAME_GYRO + 2 * i) * scale.gyro;
+        }
+
+        integrator.addSample(gyro, accel, samplePeriod);
+    }
+
+    return frames;
+}
+
+static int16_t readBigEndian(const uint8_t *bytes)
+{
+    return (int16_t) (((uint16_t) bytes[0] << 8) | bytes[1]);
+}
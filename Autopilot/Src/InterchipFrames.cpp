@@ -0,0 +1,141 @@
+#include "InterchipFrames.h"
+#include "Interchip_A.h"
+#include "SeqlockTopic.hpp"
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+static SeqlockTopic<Interchip_AtoS_Packet> commandsTopic;
+static SeqlockTopic<Interchip_StoA_Packet> receivedTopic;
+static SeqlockTopic<InterchipLinkStats_t> statsTopic;
+
+// The committing task's own copy, so that a commit only has to carry what changed. Only that task touches it.
+static Interchip_AtoS_Packet commands;
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+static void PublishCommands(void);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+void Interchip_SetPWM(int16_t *data)
+{
+    for (uint8_t i = 0; i < INTERCHIP_PWM_CHANNELS; i++)
+    {
+        commands.PWM[i] = data[i];
+    }
+
+    PublishCommands();
+}
+
+void Interchip_SetFrame(const int16_t *data, uint32_t dirtyMask, uint32_t sampleTimeUs)
+{
+    for (uint8_t i = 0; i < INTERCHIP_PWM_CHANNELS; i++)
+    {
+        if (dirtyMask & (1u << i))
+        {
+            commands.PWM[i] = data[i];
+        }
+    }
+
+    commands.sample_time_us = sampleTimeUs;
+
+    PublishCommands();
+}
+
+void Interchip_SetAutonomousLevel(uint16_t data)
+{
+    commands.autonomous_level = data;
+
+    PublishCommands();
+}
+
+void Interchip_SetSampleTime(uint32_t sampleTimeUs)
+{
+    commands.sample_time_us = sampleTimeUs;
+
+    PublishCommands();
+}
+
+uint8_t Interchip_GetPWM(int16_t *data)
+{
+    Interchip_StoA_Packet packet;
+    uint32_t generation;
+
+    if ( ! receivedTopic.read(packet, &generation) || (generation == 0))
+    {
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < INTERCHIP_PWM_CHANNELS; i++)
+    {
+        data[i] = packet.PWM[i];
+    }
+
+    return 1;
+}
+
+uint16_t Interchip_GetAutonomousLevel(void)
+{
+    Interchip_StoA_Packet packet;
+
+    if ( ! receivedTopic.read(packet))
+    {
+        return 0;
+    }
+
+    return packet.autonomous_level;
+}
+
+uint8_t Interchip_GetLinkStats(InterchipLinkStats_t *stats)
+{
+    uint32_t generation;
+
+    if ( ! statsTopic.read(*stats, &generation) || (generation == 0))
+    {
+        InterchipStats_t empty;
+        InterchipStats_Init(&empty);
+        *stats = empty.counters;
+
+        return 0;
+    }
+
+    return 1;
+}
+
+uint8_t InterchipFrames_TakeCommands(Interchip_AtoS_Packet *packet)
+{
+    Interchip_AtoS_Packet snapshot;
+    uint32_t generation;
+
+    if ( ! commandsTopic.read(snapshot, &generation) || (generation == 0))
+    {
+        return 0;
+    }
+
+    // The sequence number and CRC that come with it are overwritten when the packet is sealed
+    *packet = snapshot;
+
+    return 1;
+}
+
+void InterchipFrames_PublishReceived(const Interchip_StoA_Packet *packet)
+{
+    receivedTopic.publish(*packet);
+}
+
+void InterchipFrames_PublishStats(const InterchipLinkStats_t *stats)
+{
+    statsTopic.publish(*stats);
+}
+
+static void PublishCommands(void)
+{
+    commandsTopic.publish(commands);
+    Interchip_OnFrameCommitted();
+}
@@ -0,0 +1,78 @@
+#include "InterchipLink.h"
+
+#include <string.h>
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+void InterchipLink_Init(InterchipLink_t *link, InterchipCrc_t crc)
+{
+	memset(link, 0, sizeof(*link));
+	link->crc = crc;
+
+	InterchipStats_Init(&link->stats);
+}
+
+Interchip_AtoS_Packet *InterchipLink_GetTxPacket(InterchipLink_t *link)
+{
+	return &link->tx[link->txBack];
+}
+
+void InterchipLink_PrepareTransfer(InterchipLink_t *link, uint32_t nowUs, uint8_t **txData, uint8_t **rxData)
+{
+	uint8_t front = link->txBack;
+	uint8_t back = front ^ 1u;
+
+	link->tx[front].ack_sequence = InterchipStats_GetAckSequence(&link->stats);
+	link->tx[front].crc_errors = (uint16_t) link->stats.counters.crcErrors;
+
+	InterchipFraming_Seal(&link->tx[front], link->txSequence, link->crc);
+	InterchipStats_OnSend(&link->stats, link->txSequence, nowUs);
+	link->txSequence++;
+
+	link->tx[back] = link->tx[front];
+	link->txBack = back;
+
+	*txData = (uint8_t *) &link->tx[front];
+	*rxData = (uint8_t *) &link->rx[link->rxLatest ^ 1u];
+}
+
+InterchipFrameStatus_t InterchipLink_CompleteTransfer(InterchipLink_t *link, uint32_t nowUs)
+{
+	uint8_t filled = link->rxLatest ^ 1u;
+	const Interchip_StoA_Packet *received = &link->rx[filled];
+
+	if ( ! InterchipFraming_Check(received, link->crc))
+	{
+		InterchipStats_OnCrcError(&link->stats);
+		return INTERCHIP_FRAME_CRC_ERROR;
+	}
+
+	InterchipStats_OnReceive(&link->stats, received->sequence, received->ack_sequence, received->crc_errors, nowUs);
+
+	if (link->hasReceived && (received->sequence == link->rx[link->rxLatest].sequence))
+	{
+		return INTERCHIP_FRAME_REPEATED;
+	}
+
+	link->rxLatest = filled;
+	link->hasReceived = 1;
+
+	return INTERCHIP_FRAME_OK;
+}
+
+void InterchipLink_FailTransfer(InterchipLink_t *link)
+{
+	InterchipStats_OnTransferFailed(&link->stats);
+}
+
+const Interchip_StoA_Packet *InterchipLink_GetLatestRx(const InterchipLink_t *link)
+{
+	return &link->rx[link->rxLatest];
+}
+
+const InterchipLinkStats_t *InterchipLink_GetStats(const InterchipLink_t *link)
+{
+	return &link->stats.counters;
+}
@@ -0,0 +1,65 @@
+#include "InterchipPacer.h"
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+void InterchipPacer_Init(InterchipPacer_t *pacer, uint32_t minIntervalUs, uint32_t keepAliveUs)
+{
+	pacer->minIntervalUs = minIntervalUs;
+	pacer->keepAliveUs = (keepAliveUs > minIntervalUs) ? keepAliveUs : minIntervalUs;
+
+	pacer->lastStartUs = 0;
+	pacer->hasStarted = 0;
+	pacer->framePending = 0;
+	pacer->inFlight = 0;
+}
+
+void InterchipPacer_OnEvents(InterchipPacer_t *pacer, uint32_t events)
+{
+	if (events & INTERCHIP_EVENT_FRAME)
+	{
+		pacer->framePending = 1;
+	}
+
+	if (events & INTERCHIP_EVENT_TRANSFER_DONE)
+	{
+		pacer->inFlight = 0;
+	}
+}
+
+uint8_t InterchipPacer_Poll(InterchipPacer_t *pacer, uint32_t nowUs, uint32_t *waitUs)
+{
+	// Only the end of the transfer can change anything, the keep alive interval doubles as a timeout for it
+	if (pacer->inFlight)
+	{
+		*waitUs = pacer->keepAliveUs;
+		return 0;
+	}
+
+	if (pacer->hasStarted)
+	{
+		// Unsigned, so that the time stamp wrapping around does not matter
+		uint32_t elapsedUs = nowUs - pacer->lastStartUs;
+
+		if ( ! pacer->framePending && (elapsedUs < pacer->keepAliveUs))
+		{
+			*waitUs = pacer->keepAliveUs - elapsedUs;
+			return 0;
+		}
+
+		if (elapsedUs < pacer->minIntervalUs)
+		{
+			*waitUs = pacer->minIntervalUs - elapsedUs;
+			return 0;
+		}
+	}
+
+	pacer->lastStartUs = nowUs;
+	pacer->hasStarted = 1;
+	pacer->framePending = 0;
+	pacer->inFlight = 1;
+
+	*waitUs = pacer->keepAliveUs;
+	return 1;
+}
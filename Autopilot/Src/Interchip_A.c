@@ -1,55 +1,132 @@
 #include "Interchip_A.h"
-#include "cmsis_os.h"
+#include "InterchipLink.h"
+#include "InterchipFrames.h"
+#include "InterchipPacer.h"
+#include "TimeStamp.h"
+#include "stm32f7xx_hal.h"
+#include "FreeRTOS.h"
+#include "task.h"
 #include "spi.h"
+#include "crc.h"
 
-static Interchip_AtoS_Packet *dataTX;
-static Interchip_StoA_Packet *dataRX;
-osMutexId Interchip_MutexHandle;
+typedef enum {
+  TRANSFER_IDLE = 0,
+  TRANSFER_IN_FLIGHT,
+  TRANSFER_DONE,
+  TRANSFER_FAILED,
+} TransferState_t;
+
+// Both directions double buffered, see InterchipLink.h. Only this task touches link, the other tasks go through the
+// topics of InterchipFrames.h.
+static InterchipLink_t link;
+static volatile TransferState_t transferState = TRANSFER_IDLE;
+static volatile uint32_t transferEndUs = 0;
+static TaskHandle_t volatile interchipTaskHandle = NULL;
+
+static uint32_t HardwareCrc(const uint8_t *data, uint32_t length);
+static uint32_t WaitForEvents(uint32_t timeoutUs);
+static void NotifyFromISR(uint32_t events);
+static void StartTransfer(void);
 
 void Interchip_Run(void const *argument) {
-  dataRX = malloc(sizeof(Interchip_StoA_Packet));
-  dataTX = malloc(sizeof(Interchip_AtoS_Packet));
+  static InterchipPacer_t pacer;
+  uint32_t waitUs = 0;
+
+  InterchipLink_Init(&link, HardwareCrc);
 
-  osMutexDef(Interchip_Mutex);
-  Interchip_MutexHandle = osMutexCreate(osMutex(Interchip_Mutex));
+  InterchipPacer_Init(&pacer, INTERCHIP_MIN_INTERVAL_US, INTERCHIP_KEEP_ALIVE_US);
+  interchipTaskHandle = xTaskGetCurrentTaskHandle();
 
   while (1) {
-    osMutexWait(Interchip_MutexHandle, 0);
+    uint32_t events = WaitForEvents(waitUs);
+
+    // Nothing for a whole keep alive interval with a transfer on the wire, the DMA is stuck
+    if ((events == 0) && (transferState == TRANSFER_IN_FLIGHT)) {
+      HAL_SPI_Abort(&hspi1);
+      transferState = TRANSFER_FAILED;
+      events |= INTERCHIP_EVENT_TRANSFER_DONE;
+    }
+
+    // What came in is checked and handed on straight away, not when the next transfer starts
+    if (transferState == TRANSFER_DONE) {
+      transferState = TRANSFER_IDLE;
 
-    HAL_StatusTypeDef transmit_status = HAL_SPI_TransmitReceive_IT(
-        &hspi1, (uint8_t *)dataTX, (uint8_t *)dataRX,
-        sizeof(Interchip_StoA_Packet) / sizeof(uint16_t));
+      if (InterchipLink_CompleteTransfer(&link, transferEndUs) == INTERCHIP_FRAME_OK) {
+        InterchipFrames_PublishReceived(InterchipLink_GetLatestRx(&link));
+      }
 
-    osMutexRelease(Interchip_MutexHandle);
+      InterchipFrames_PublishStats(InterchipLink_GetStats(&link));
+    } else if (transferState == TRANSFER_FAILED) {
+      transferState = TRANSFER_IDLE;
+      InterchipLink_FailTransfer(&link);
+      InterchipFrames_PublishStats(InterchipLink_GetStats(&link));
+    }
+
+    InterchipPacer_OnEvents(&pacer, events);
 
-    if (transmit_status != HAL_OK) {
-      Error_Handler();
+    if (InterchipPacer_Poll(&pacer, TimeStamp_GetMicroseconds(), &waitUs)) {
+      StartTransfer();
     }
-    osDelay(INTERCHIP_TRANSMIT_DELAY);
   }
 }
 
-// Public Functions to get and set data
+static void StartTransfer(void) {
+  uint8_t *txData;
+  uint8_t *rxData;
+
+  InterchipFrames_TakeCommands(InterchipLink_GetTxPacket(&link));
+  InterchipLink_PrepareTransfer(&link, TimeStamp_GetMicroseconds(), &txData, &rxData);
+
+  transferState = TRANSFER_IN_FLIGHT;
+
+  if (HAL_SPI_TransmitReceive_DMA(&hspi1, txData, rxData, INTERCHIP_PACKET_SIZE / sizeof(uint16_t)) != HAL_OK) {
+    Error_Handler();
+  }
+}
+
+// Sleeps until notified or for timeoutUs, rounded up to whole ticks
+static uint32_t WaitForEvents(uint32_t timeoutUs) {
+  uint32_t events = 0;
+  TickType_t timeoutTicks = (TickType_t)((timeoutUs * (uint64_t)configTICK_RATE_HZ + 999999u) / 1000000u);
+
+  xTaskNotifyWait(0, UINT32_MAX, &events, timeoutTicks);
 
-int16_t *Interchip_GetPWM(void) 
-{ 
-  return dataRX->PWM; 
+  return events;
+}
+
+void Interchip_OnFrameCommitted(void) {
+  if (interchipTaskHandle != NULL) {
+    xTaskNotify(interchipTaskHandle, INTERCHIP_EVENT_FRAME, eSetBits);
+  }
 }
 
+static void NotifyFromISR(uint32_t events) {
+  BaseType_t higherPriorityTaskWoken = pdFALSE;
 
-void Interchip_SetPWM(int16_t data[]) {
-  osMutexWait(Interchip_MutexHandle, 0);
-  for (uint8_t i = 0; i < 12; i++) {
-    dataTX->PWM[i] = data[i];
+  if (interchipTaskHandle == NULL) {
+    return;
   }
-  osMutexRelease(Interchip_MutexHandle);
+
+  xTaskNotifyFromISR(interchipTaskHandle, events, eSetBits, &higherPriorityTaskWoken);
+  portYIELD_FROM_ISR(higherPriorityTaskWoken);
 }
 
+// The CRC unit is only used from this task, so it needs no lock of its own
+static uint32_t HardwareCrc(const uint8_t *data, uint32_t length) {
+  return HAL_CRC_Calculate(&hcrc, (uint32_t *)data, length);
+}
 
-uint16_t Interchip_GetAutonomousLevel(void) { return dataRX->autonomous_level; }
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi) {
+  if (hspi == &hspi1) {
+    transferEndUs = TimeStamp_GetMicroseconds();
+    transferState = TRANSFER_DONE;
+    NotifyFromISR(INTERCHIP_EVENT_TRANSFER_DONE);
+  }
+}
 
-void Interchip_SetAutonomousLevel(uint16_t data) {
-  osMutexWait(Interchip_MutexHandle, 0);
-  dataTX->autonomous_level = data;
-  osMutexRelease(&Interchip_MutexHandle);
-}
\ No newline at end of file
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi) {
+  if (hspi == &hspi1) {
+    transferState = TRANSFER_FAILED;
+    NotifyFromISR(INTERCHIP_EVENT_TRANSFER_DONE);
+  }
+}
@@ -0,0 +1,46 @@
+#include "TimeStamp.h"
+#include "stm32f7xx_hal.h"
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define DWT_LAR_UNLOCK_KEY 0xC5ACCE55
+
+// The cycle counter wraps every 20 s at 216 MHz, so it is extended in software. Fine as long as the time base is
+// read at least once per wrap, which the attitude loop does many times over.
+static uint32_t lastCycles;
+static uint64_t extendedCycles;
+static uint32_t cyclesPerMicrosecond;
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+void TimeStamp_Init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->LAR = DWT_LAR_UNLOCK_KEY;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    lastCycles = 0;
+    extendedCycles = 0;
+    cyclesPerMicrosecond = SystemCoreClock / 1000000U;
+}
+
+uint32_t TimeStamp_GetMicroseconds(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint32_t cycles = DWT->CYCCNT;
+    extendedCycles += (uint32_t) (cycles - lastCycles);
+    lastCycles = cycles;
+
+    uint64_t now = extendedCycles;
+
+    __set_PRIMASK(primask);
+
+    return (uint32_t) (now / cyclesPerMicrosecond);
+}
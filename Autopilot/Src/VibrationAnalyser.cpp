@@ -0,0 +1,365 @@
+/**
+ * Streaming gyro spectrum analysis, see VibrationAnalyser.hpp.
+ *
+ * The N real samples x are packed into N / 2 complex ones, z[n] = x[2n] + i x[2n + 1], and Z is their FFT (radix 2,
+ * decimation in time, the input written in bit reversed order as it is windowed). The spectrum of x follows from
+ *
+ *   X[k] = (Z[k] + conj(Z[N/2 - k])) / 2 - i exp(-2 pi i k / N) (Z[k] - conj(Z[N/2 - k])) / 2,   k = 0 .. N/2
+ *
+ * The window reads the history oldest sample first while the newest samples keep overwriting the oldest. Windowing
+ * takes at least 2 samples per step against 1 new sample per cycle, so it always stays ahead of the overwriting.
+ */
+
+#include "VibrationAnalyser.hpp"
+
+#include <math.h>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define PI_F 3.14159265f
+
+#define DEFAULT_MIN_HZ 20.0f
+#define DEFAULT_MAX_FRACTION_OF_NYQUIST 0.9f
+#define DEFAULT_WORK_PER_STEP 32
+#define DEFAULT_HOP_SAMPLES (VIBRATION_FFT_SIZE / 4)
+#define DEFAULT_TRACKING_GAIN 0.5f
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+VibrationAnalyserConfig_t VibrationAnalyser_DefaultConfig(float sampleRateHz)
+{
+    VibrationAnalyserConfig_t config;
+
+    config.sampleRateHz = sampleRateHz;
+    config.minHz = DEFAULT_MIN_HZ;
+    config.maxHz = DEFAULT_MAX_FRACTION_OF_NYQUIST * 0.5f * sampleRateHz;
+    config.workPerStep = DEFAULT_WORK_PER_STEP;
+    config.hopSamples = DEFAULT_HOP_SAMPLES;
+    config.trackingGain = DEFAULT_TRACKING_GAIN;
+
+    return config;
+}
+
+VibrationAnalyser::VibrationAnalyser(const VibrationAnalyserConfig_t &_config)
+{
+    for (int n = 0; n < VIBRATION_FFT_SIZE; n++)
+    {
+        window[n] = 0.5f - 0.5f * cosf(2.0f * PI_F * n / VIBRATION_FFT_SIZE);
+    }
+
+    for (int k = 0; k < VIBRATION_FFT_HALF / 2; k++)
+    {
+        twiddleCos[k] = cosf(2.0f * PI_F * k / VIBRATION_FFT_HALF);
+        twiddleSin[k] = -sinf(2.0f * PI_F * k / VIBRATION_FFT_HALF);
+    }
+
+    for (int k = 0; k <= VIBRATION_FFT_HALF; k++)
+    {
+        splitCos[k] = cosf(2.0f * PI_F * k / VIBRATION_FFT_SIZE);
+        splitSin[k] = -sinf(2.0f * PI_F * k / VIBRATION_FFT_SIZE);
+    }
+
+    for (int n = 0; n < VIBRATION_FFT_HALF; n++)
+    {
+        int reversed = 0;
+
+        for (int bit = 0; bit < VIBRATION_FFT_STAGES; bit++)
+        {
+            reversed |= ((n >> bit) & 1) << (VIBRATION_FFT_STAGES - 1 - bit);
+        }
+
+        bitReversed[n] = (uint8_t) reversed;
+    }
+
+    configure(_config);
+}
+
+void VibrationAnalyser::configure(const VibrationAnalyserConfig_t &_config)
+{
+    config = _config;
+    config.workPerStep = (config.workPerStep < 1) ? 1 : config.workPerStep;
+
+    float binHz = config.sampleRateHz / VIBRATION_FFT_SIZE;
+
+    // The search looks at both neighbours of a bin, so the band stays clear of DC and Nyquist
+    firstBin = (int) ceilf(config.minHz / binHz);
+    lastBin = (int) floorf(config.maxHz / binHz);
+    firstBin = (firstBin < 1) ? 1 : firstBin;
+    lastBin = (lastBin > VIBRATION_FFT_HALF - 1) ? VIBRATION_FFT_HALF - 1 : lastBin;
+
+    reset();
+}
+
+void VibrationAnalyser::reset()
+{
+    for (int a = 0; a < VIBRATION_AXES; a++)
+    {
+        for (int n = 0; n < VIBRATION_FFT_SIZE; n++)
+        {
+            history[a][n] = 0.0f;
+        }
+
+        for (int p = 0; p < VIBRATION_PEAKS; p++)
+        {
+            peaksHz[a][p] = 0.0f;
+        }
+    }
+
+    writeIndex = 0;
+    samplesSeen = 0;
+    samplesSinceStart = 0;
+
+    phase = PHASE_IDLE;
+    axis = 0;
+    nextAxis = 0;
+    lastStepWork = 0;
+    analysisCount = 0;
+}
+
+void VibrationAnalyser::addSample(const float gyro[VIBRATION_AXES])
+{
+    for (int a = 0; a < VIBRATION_AXES; a++)
+    {
+        history[a][writeIndex] = gyro[a];
+    }
+
+    writeIndex = (writeIndex + 1) % VIBRATION_FFT_SIZE;
+    samplesSeen++;
+    samplesSinceStart++;
+}
+
+int VibrationAnalyser::step()
+{
+    int work = 0;
+    int updatedAxis = -1;
+
+    while (work < config.workPerStep)
+    {
+        if (phase == PHASE_IDLE)
+        {
+            if ( ! startAnalysis())
+            {
+                break;
+            }
+        }
+        else if (phase == PHASE_WINDOW)
+        {
+            windowPair(cursor++);
+
+            if (cursor == VIBRATION_FFT_HALF)
+            {
+                phase = PHASE_BUTTERFLY;
+                stage = 1;
+                cursor = 0;
+            }
+        }
+        else if (phase == PHASE_BUTTERFLY)
+        {
+            butterfly(stage, cursor++);
+
+            if (cursor == VIBRATION_FFT_HALF / 2)
+            {
+                cursor = 0;
+
+                if (++stage > VIBRATION_FFT_STAGES)
+                {
+                    phase = PHASE_SPECTRUM;
+                    bandSum = 0.0f;
+                }
+            }
+        }
+        else if (phase == PHASE_SPECTRUM)
+        {
+            spectrumBin(cursor++);
+
+            if (cursor > VIBRATION_FFT_HALF)
+            {
+                phase = PHASE_PEAKS;
+                cursor = firstBin;
+
+                for (int p = 0; p < VIBRATION_PEAKS; p++)
+                {
+                    candidateBin[p] = -1;
+                }
+            }
+        }
+        else
+        {
+            searchBin(cursor++);
+
+            if (cursor > lastBin)
+            {
+                finishAnalysis();
+                updatedAxis = axis;
+                phase = PHASE_IDLE;
+            }
+        }
+
+        work++;
+    }
+
+    lastStepWork = work;
+    return updatedAxis;
+}
+
+// Starting counts as a unit of work, so a step that only waits does none
+bool VibrationAnalyser::startAnalysis()
+{
+    if (samplesSeen < VIBRATION_FFT_SIZE || samplesSinceStart < config.hopSamples || firstBin > lastBin)
+    {
+        return false;
+    }
+
+    axis = nextAxis;
+    nextAxis = (nextAxis + 1) % VIBRATION_AXES;
+    snapshotIndex = writeIndex;
+    samplesSinceStart = 0;
+
+    phase = PHASE_WINDOW;
+    cursor = 0;
+
+    return true;
+}
+
+void VibrationAnalyser::windowPair(int n)
+{
+    int even = (snapshotIndex + 2 * n) % VIBRATION_FFT_SIZE;
+    int odd = (even + 1) % VIBRATION_FFT_SIZE;
+
+    re[bitReversed[n]] = history[axis][even] * window[2 * n];
+    im[bitReversed[n]] = history[axis][odd] * window[2 * n + 1];
+}
+
+void VibrationAnalyser::butterfly(int stageNumber, int index)
+{
+    int half = 1 << (stageNumber - 1);
+    int j = index & (half - 1);
+    int top = ((index >> (stageNumber - 1)) << stageNumber) + j;
+    int bottom = top + half;
+    int twiddle = j << (VIBRATION_FFT_STAGES - stageNumber);
+
+    float tRe = twiddleCos[twiddle] * re[bottom] - twiddleSin[twiddle] * im[bottom];
+    float tIm = twiddleCos[twiddle] * im[bottom] + twiddleSin[twiddle] * re[bottom];
+
+    re[bottom] = re[top] - tRe;
+    im[bottom] = im[top] - tIm;
+    re[top] += tRe;
+    im[top] += tIm;
+}
+
+void VibrationAnalyser::spectrumBin(int k)
+{
+    int forward = k % VIBRATION_FFT_HALF;
+    int mirrored = (VIBRATION_FFT_HALF - k) % VIBRATION_FFT_HALF;
+
+    // Z[k] and conj(Z[N/2 - k])
+    float aRe = re[forward];
+    float aIm = im[forward];
+    float bRe = re[mirrored];
+    float bIm = -im[mirrored];
+
+    float evenRe = 0.5f * (aRe + bRe);
+    float evenIm = 0.5f * (aIm + bIm);
+
+    // (Z[k] - conj(Z[N/2 - k])) / 2i
+    float oddRe = 0.5f * (aIm - bIm);
+    float oddIm = -0.5f * (aRe - bRe);
+
+    float xRe = evenRe + splitCos[k] * oddRe - splitSin[k] * oddIm;
+    float xIm = evenIm + splitCos[k] * oddIm + splitSin[k] * oddRe;
+
+    magnitude[k] = sqrtf(xRe * xRe + xIm * xIm);
+
+    if (k >= firstBin && k <= lastBin)
+    {
+        bandSum += magnitude[k];
+    }
+}
+
+// Keeps the VIBRATION_PEAKS largest local maxima, largest first
+void VibrationAnalyser::searchBin(int k)
+{
+    float threshold = VIBRATION_PEAK_TO_MEAN * bandSum / (float) (lastBin - firstBin + 1);
+
+    if (magnitude[k] <= threshold || magnitude[k] <= magnitude[k - 1] || magnitude[k] < magnitude[k + 1])
+    {
+        return;
+    }
+
+    for (int p = 0; p < VIBRATION_PEAKS; p++)
+    {
+        if (candidateBin[p] < 0 || magnitude[k] > magnitude[candidateBin[p]])
+        {
+            for (int q = VIBRATION_PEAKS - 1; q > p; q--)
+            {
+                candidateBin[q] = candidateBin[q - 1];
+            }
+
+            candidateBin[p] = k;
+            return;
+        }
+    }
+}
+
+void VibrationAnalyser::finishAnalysis()
+{
+    float binHz = config.sampleRateHz / VIBRATION_FFT_SIZE;
+    float measured[VIBRATION_PEAKS];
+
+    for (int p = 0; p < VIBRATION_PEAKS; p++)
+    {
+        int k = candidateBin[p];
+        measured[p] = 0.0f;
+
+        if (k < 0)
+        {
+            continue;
+        }
+
+        // Vertex of the parabola through the peak bin and its neighbours
+        float left = magnitude[k - 1];
+        float centre = magnitude[k];
+        float right = magnitude[k + 1];
+        float curvature = left - 2.0f * centre + right;
+        float offset = (curvature < 0.0f) ? 0.5f * (left - right) / curvature : 0.0f;
+
+        measured[p] = ((float) k + offset) * binHz;
+    }
+
+    // Ascending, with the empty slots last, so each slot keeps following the same peak
+    for (int p = 1; p < VIBRATION_PEAKS; p++)
+    {
+        for (int q = p; q > 0; q--)
+        {
+            bool outOfOrder = (measured[q - 1] == 0.0f && measured[q] > 0.0f) ||
+                              (measured[q] > 0.0f && measured[q] < measured[q - 1]);
+
+            if (outOfOrder)
+            {
+                float swap = measured[q];
+                measured[q] = measured[q - 1];
+                measured[q - 1] = swap;
+            }
+        }
+    }
+
+    for (int p = 0; p < VIBRATION_PEAKS; p++)
+    {
+        float &tracked = peaksHz[axis][p];
+
+        if (measured[p] == 0.0f || tracked == 0.0f)
+        {
+            tracked = measured[p];
+        }
+        else
+        {
+            tracked += config.trackingGain * (measured[p] - tracked);
+        }
+    }
+
+    analysisCount++;
+}
@@ -4,6 +4,11 @@
 
 #pragma once
 #include "telemetryStateManager.hpp"
+#include "InterchipStats.h"
+#include "LatencyTrace.hpp"
+#include "AttitudeRecordingRing.hpp"
+
+#define TELEMETRY_RECORDING_CHUNK_SIZE 256 //bytes of the attitude recording taken for every report
 
 class telemetryState;
 
@@ -22,6 +27,10 @@ class telemetryManager
         bool regularReport; //for convinience
         bool fatalFail = false; //any point in the states, set this variable to transition to failed state
         int cycleCounter = 0;
+        InterchipLinkStats_t interchipLink; //statistics of the link to the safety chip, loaded for every report
+        LatencySummary_t attitudeLatency; //age of the IMU sample at each attitude manager stage, loaded for every report
+        uint8_t attitudeRecording[TELEMETRY_RECORDING_CHUNK_SIZE]; //next piece of the attitude recording, sent with the report
+        size_t attitudeRecordingLength = 0;
         _Telemetry_Manager_Cycle_Status getStatus() {return status;}
     private:
         telemetryState* currentState; //state of the manager
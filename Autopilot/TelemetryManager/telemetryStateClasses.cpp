@@ -3,6 +3,7 @@
 */
 
 #include "telemetryStateClasses.hpp"
+#include "Interchip_A.h"
 
 void initialMode::execute(telemetryManager* telemetryMgr)
 {
@@ -119,6 +120,9 @@ telemetryState& analyzeDataMode::getInstance()
 void reportMode::execute(telemetryManager* telemetryMgr)
 {
     //form report based on the the variables dataValid, dataError, and cycleCounter
+    Interchip_GetLinkStats(&telemetryMgr -> interchipLink);
+    LatencyTrace_GetSummary(&telemetryMgr -> attitudeLatency);
+    telemetryMgr -> attitudeRecordingLength = AttitudeRecordingRing_Read(telemetryMgr -> attitudeRecording, TELEMETRY_RECORDING_CHUNK_SIZE);
     if(telemetryMgr -> dataValid)
     {
         telemetryMgr -> cycleCounter = 0;
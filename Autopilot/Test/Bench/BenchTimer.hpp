@@ -0,0 +1,62 @@
+/**
+ * Helpers shared by the host benchmarks in this directory.
+ *
+ * The benchmarks are built with the unit tests (see CMakeLists.txt) but go to tools/ rather than bin/, so they do not
+ * slow down the test run. Their numbers are for comparing alternatives on the same machine, not absolute figures
+ * for the autopilot.
+ */
+
+#ifndef BENCH_TIMER_HPP
+#define BENCH_TIMER_HPP
+
+#include <chrono>
+#include <cstdio>
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+// Stops the optimiser from dropping a computation whose result is otherwise unused
+template <typename T>
+inline void Bench_KeepAlive(const T &value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+/**
+* Runs body iterations times and returns the average time per iteration. The best of a few repetitions is kept to
+* filter out scheduling noise.
+* @param[in]    iterations  how many times body runs per repetition.
+* @param[in]    body        callable taking the iteration index.
+* @return                   nanoseconds per iteration.
+*/
+template <typename Body>
+double Bench_NanosecondsPerCall(long iterations, Body body)
+{
+    const int REPETITIONS = 5;
+    double best = 0.0;
+
+    for (int repetition = 0; repetition < REPETITIONS; repetition++)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        for (long i = 0; i < iterations; i++)
+        {
+            body(i);
+        }
+
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        double perCall = elapsed.count() / iterations;
+
+        best = (repetition == 0 || perCall < best) ? perCall : best;
+    }
+
+    return best;
+}
+
+inline void Bench_Report(const char *name, double nanoseconds)
+{
+    printf("%-48s %10.2f ns/call\n", name, nanoseconds);
+}
+
+#endif
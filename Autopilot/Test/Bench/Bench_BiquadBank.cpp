@@ -0,0 +1,143 @@
+/**
+ * Throughput of BiquadBank on the nine IMU channels, against the same cascades stored channel by channel (an array of
+ * structures, one filter object per channel), which is how the filters would be written without the bank.
+ *
+ * For each sample rate the time per second of filtering is printed as a share of the CPU, ie what the filters would
+ * cost if the measurement stage ran at that rate.
+ */
+
+#include "BenchTimer.hpp"
+#include "BiquadBank.hpp"
+
+#include <math.h>
+#include <stdio.h>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define ITERATIONS 20000000L
+#define CHANNELS 9
+#define TABLE_SIZE 1024
+
+static const float SAMPLE_RATES_HZ[] = {1000.0f, 2000.0f, 4000.0f, 8000.0f};
+
+// One channel, its sections one after the other
+template <int SECTIONS>
+struct ChannelCascade
+{
+    BiquadCoefficients_t c[SECTIONS];
+    float z1[SECTIONS];
+    float z2[SECTIONS];
+
+    float apply(float x)
+    {
+        for (int section = 0; section < SECTIONS; section++)
+        {
+            float y = c[section].b0 * x + z1[section];
+            z1[section] = c[section].b1 * x - c[section].a1 * y + z2[section];
+            z2[section] = c[section].b2 * x - c[section].a2 * y;
+            x = y;
+        }
+
+        return x;
+    }
+};
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+template <int SECTIONS>
+static void compare(const char *name);
+
+static BiquadCoefficients_t sectionCoefficients(int section, int channel);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+static float inputs[TABLE_SIZE][CHANNELS];
+
+int main(void)
+{
+    for (int i = 0; i < TABLE_SIZE; i++)
+    {
+        for (int channel = 0; channel < CHANNELS; channel++)
+        {
+            inputs[i][channel] = sinf(0.01f * i * (channel + 1)) + 0.1f * channel;
+        }
+    }
+
+    printf("%-48s %10s  %s\n", "nine channels", "", "CPU share at 1 / 2 / 4 / 8 kHz");
+
+    compare<1>("1 section (low pass)");
+    compare<2>("2 sections (low pass + notch)");
+    compare<4>("4 sections (low pass + 3 notches)");
+
+    return 0;
+}
+
+template <int SECTIONS>
+static void compare(const char *name)
+{
+    BiquadBank<CHANNELS, SECTIONS> bank;
+    ChannelCascade<SECTIONS> cascades[CHANNELS] = {};
+
+    for (int section = 0; section < SECTIONS; section++)
+    {
+        for (int channel = 0; channel < CHANNELS; channel++)
+        {
+            bank.setSection(section, channel, sectionCoefficients(section, channel));
+            cascades[channel].c[section] = sectionCoefficients(section, channel);
+        }
+    }
+
+    double structureOfArrays = Bench_NanosecondsPerCall(ITERATIONS / SECTIONS, [&](long i)
+    {
+        float output[CHANNELS];
+        bank.apply(inputs[i & (TABLE_SIZE - 1)], output);
+        Bench_KeepAlive(output);
+    });
+
+    double arrayOfStructures = Bench_NanosecondsPerCall(ITERATIONS / SECTIONS, [&](long i)
+    {
+        float output[CHANNELS];
+        const float *input = inputs[i & (TABLE_SIZE - 1)];
+
+        for (int channel = 0; channel < CHANNELS; channel++)
+        {
+            output[channel] = cascades[channel].apply(input[channel]);
+        }
+
+        Bench_KeepAlive(output);
+    });
+
+    const double timings[2] = {structureOfArrays, arrayOfStructures};
+    const char *layouts[2] = {"BiquadBank", "per channel"};
+
+    for (int layout = 0; layout < 2; layout++)
+    {
+        char label[96];
+        snprintf(label, sizeof(label), "%s, %s", name, layouts[layout]);
+
+        printf("%-48s %10.2f ns/call ", label, timings[layout]);
+
+        for (float rate : SAMPLE_RATES_HZ)
+        {
+            printf(" %6.3f%%", 100.0 * timings[layout] * 1e-9 * rate);
+        }
+
+        printf("\n");
+    }
+}
+
+static BiquadCoefficients_t sectionCoefficients(int section, int channel)
+{
+    if (section == 0)
+    {
+        return Biquad_LowPass(80.0f + channel, 1000.0f, BIQUAD_BUTTERWORTH_Q);
+    }
+
+    return Biquad_Notch(100.0f * section + channel, 1000.0f, 2.0f);
+}
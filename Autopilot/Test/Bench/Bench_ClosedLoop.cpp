@@ -0,0 +1,360 @@
+/**
+ * Closes the loop around PIDloopMode and OutputMixing_Execute with the linearised aircraft of LinearisedPlant.hpp, to
+ * measure what a controller change costs and what it does to the step responses in one run.
+ *
+ * Each attitude cycle publishes the plant's attitude on SFOutputTopic and the commands on PMCommandsTopic, runs
+ * PIDloopMode through the attitude manager, mixes its outputs and advances the plant by one attitude period. The
+ * commands are in the units the PIDs compare them with, those of SF_GetResult: degrees and m/s.
+ *
+ * For each step the loop first settles on the initial commands, then the commanded value of one axis steps. The rise
+ * time (10 % to 90 %), overshoot and 2 % settling time are relative to where the response ends up, the steady state
+ * error is against the command. The first three only describe the controller when the last is small. The exit code is
+ * non zero if an attitude response does not settle or ends up more than STEADY_STATE_BAND of the step away from the
+ * command, or if the attitude manager fails, so this can gate controller changes. The airspeed step is reported only:
+ * its loop is proportional with no throttle trim, so it droops to a fraction of any command.
+ */
+
+#include "BenchTimer.hpp"
+#include "LinearisedPlant.hpp"
+#include "attitudeManager.hpp"
+#include "attitudeStateClasses.hpp"
+#include "AttitudeDataBus.hpp"
+#include "OutputMixing.hpp"
+#include "TimeStamp.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define CYCLE_US (1000000UL / ATTITUDE_TASK_RATE_HZ)
+#define CYCLE_S (1.0 / ATTITUDE_TASK_RATE_HZ)
+
+#define SETTLE_S 60
+#define RESPONSE_S 120
+#define FINAL_VALUE_S 1             // the response ends up at its average over the last second
+#define SETTLING_BAND 0.02
+#define STEADY_STATE_BAND 0.05      // of the step
+
+#define THROUGHPUT_ITERATIONS 1000000L
+#define SQUARE_WAVE_HALF_PERIOD_CYCLES (10 * ATTITUDE_TASK_RATE_HZ)
+
+#define CRUISE_AIRSPEED 15.0f
+
+enum StepAxis_t {STEP_ROLL = 0, STEP_PITCH, STEP_AIRSPEED};
+
+struct StepScenario_t
+{
+    const char *name;
+    StepAxis_t axis;
+    float before, after;
+    bool gated;                 // whether the response decides the exit code
+};
+
+static const StepScenario_t SCENARIOS[] = {
+    {"roll 0 -> 20 deg", STEP_ROLL, 0.0f, 20.0f, true},
+    {"roll 0 -> -45 deg", STEP_ROLL, 0.0f, -45.0f, true},
+    {"pitch 0 -> 5 deg", STEP_PITCH, 0.0f, 5.0f, true},
+    {"airspeed 15 -> 18 m/s", STEP_AIRSPEED, CRUISE_AIRSPEED, 18.0f, false},
+};
+
+#define NUM_SCENARIOS ((int) (sizeof(SCENARIOS) / sizeof(SCENARIOS[0])))
+
+struct StepMetrics_t
+{
+    double riseTime;            // s, NAN if the response never got to 90 %
+    double overshoot;           // percent of the step
+    double settlingTime;        // s
+    double steadyStateError;    // command minus final value
+    bool settled;
+    bool onTarget;              // steady state error within STEADY_STATE_BAND
+};
+
+// What PM_GetCommands hands out and what TimeStamp_GetMicroseconds reads
+static PMCommands commands;
+static uint32_t simulatedTimeUs = 0;
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+static void setCommand(StepAxis_t axis, float value);
+static float getResponse(const LinearisedPlant &plant, StepAxis_t axis);
+static bool runController(attitudeManager &attMng, const LinearisedPlant &plant, float *channelOut);
+static bool runCycle(attitudeManager &attMng, LinearisedPlant &plant);
+static StepMetrics_t runStep(const StepScenario_t &scenario, bool *failed);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+int main(void)
+{
+    bool failed = false;
+
+    printf("%d s to settle, then %d s of response, at %d Hz\n", SETTLE_S, RESPONSE_S, ATTITUDE_TASK_RATE_HZ);
+    printf("%-24s %10s %10s %10s %10s\n", "step", "rise s", "over %", "settle s", "ss error");
+
+    for (int s = 0; s < NUM_SCENARIOS; s++)
+    {
+        StepMetrics_t metrics = runStep(SCENARIOS[s], &failed);
+
+        printf("%-24s %10.3f %10.1f %10.3f %10.3f%s%s%s\n", SCENARIOS[s].name, metrics.riseTime, metrics.overshoot,
+               metrics.settlingTime, metrics.steadyStateError, metrics.settled ? "" : "  did not settle",
+               metrics.onTarget ? "" : "  off target", SCENARIOS[s].gated ? "" : "  (not gated)");
+
+        if (SCENARIOS[s].gated)
+        {
+            failed = failed || ! metrics.settled || ! metrics.onTarget;
+        }
+    }
+
+    printf("\n");
+
+    // Square waves on every axis at once, so that the controller and the plant never sit still
+    attitudeManager attMng;
+    LinearisedPlant plant;
+    plant.trim(CRUISE_AIRSPEED);
+
+    double cycleNs = Bench_NanosecondsPerCall(THROUGHPUT_ITERATIONS, [&](long i) {
+        bool high = ((i / SQUARE_WAVE_HALF_PERIOD_CYCLES) % 2) == 1;
+
+        setCommand(STEP_ROLL, high ? 20.0f : -20.0f);
+        setCommand(STEP_PITCH, high ? 5.0f : 0.0f);
+        setCommand(STEP_AIRSPEED, high ? 18.0f : CRUISE_AIRSPEED);
+
+        failed = ! runCycle(attMng, plant) || failed;
+    });
+
+    double controllerNs = Bench_NanosecondsPerCall(THROUGHPUT_ITERATIONS, [&](long) {
+        float channelOut[NUM_MIXED_CHANNELS];
+        runController(attMng, plant, channelOut);
+        Bench_KeepAlive(channelOut);
+    });
+
+    // Kept moving on every axis, a state decaying towards zero would end up in denormals
+    double plantNs = Bench_NanosecondsPerCall(THROUGHPUT_ITERATIONS, [&](long i) {
+        bool high = ((i / SQUARE_WAVE_HALF_PERIOD_CYCLES) % 2) == 1;
+        plant.advance(high ? 10.0f : -10.0f, high ? 5.0f : -5.0f, high ? 60.0f : 40.0f, CYCLE_S);
+        Bench_KeepAlive(plant.getState());
+    });
+
+    Bench_Report("closed loop cycle", cycleNs);
+    Bench_Report("  PIDloopMode + OutputMixing_Execute", controllerNs);
+    Bench_Report("  plant, one attitude period", plantNs);
+
+    printf("%.0f loop iterations per second, %.0f simulated seconds per second\n", 1e9 / cycleNs, CYCLE_S * 1e9 / cycleNs);
+
+    return failed ? 1 : 0;
+}
+
+static void setCommand(StepAxis_t axis, float value)
+{
+    switch (axis)
+    {
+        case STEP_ROLL:
+            commands.roll = value;
+            break;
+        case STEP_PITCH:
+            commands.pitch = value;
+            break;
+        case STEP_AIRSPEED:
+            commands.airspeed = value;
+            break;
+    }
+}
+
+static float getResponse(const LinearisedPlant &plant, StepAxis_t axis)
+{
+    SFOutput_t measured;
+    plant.measure(measured, 0);
+
+    switch (axis)
+    {
+        case STEP_ROLL:
+            return measured.IMUroll;
+        case STEP_PITCH:
+            return measured.IMUpitch;
+        default:
+            return measured.Airspeed;
+    }
+}
+
+// Runs PIDloopMode on the plant's current attitude and mixes its outputs
+static bool runController(attitudeManager &attMng, const LinearisedPlant &plant, float *channelOut)
+{
+    SFOutput_t measured;
+    plant.measure(measured, simulatedTimeUs);
+
+    PMCommandsTopic.publish(commands);
+    SFOutputTopic.publish(measured);
+
+    attMng.setState(PIDloopMode::getInstance());
+    attMng.execute();
+
+    PID_Output_t pidOutput;
+
+    if ((attMng.getStatus() == FAILURE_MODE) || ! PIDOutputTopic.read(pidOutput))
+    {
+        return false;
+    }
+
+    return OutputMixing_Execute(&pidOutput, channelOut).errorCode == 0;
+}
+
+static bool runCycle(attitudeManager &attMng, LinearisedPlant &plant)
+{
+    float channelOut[NUM_MIXED_CHANNELS] = {0};
+
+    bool ok = runController(attMng, plant, channelOut);
+
+    plant.advance(channelOut[AILERON_OUT_CHANNEL], channelOut[ELEVATOR_OUT_CHANNEL], channelOut[THROTTLE_OUT_CHANNEL], CYCLE_S);
+    simulatedTimeUs += CYCLE_US;
+
+    return ok;
+}
+
+static StepMetrics_t runStep(const StepScenario_t &scenario, bool *failed)
+{
+    attitudeManager attMng;
+    LinearisedPlant plant;
+    plant.trim(CRUISE_AIRSPEED);
+
+    commands.roll = 0.0f;
+    commands.pitch = 0.0f;
+    commands.yaw = 0.0f;
+    commands.airspeed = CRUISE_AIRSPEED;
+    setCommand(scenario.axis, scenario.before);
+
+    for (int cycle = 0; cycle < SETTLE_S * ATTITUDE_TASK_RATE_HZ; cycle++)
+    {
+        *failed = ! runCycle(attMng, plant) || *failed;
+    }
+
+    const double initial = getResponse(plant, scenario.axis);
+    std::vector<double> response(RESPONSE_S * ATTITUDE_TASK_RATE_HZ);
+
+    setCommand(scenario.axis, scenario.after);
+
+    for (size_t cycle = 0; cycle < response.size(); cycle++)
+    {
+        *failed = ! runCycle(attMng, plant) || *failed;
+        response[cycle] = getResponse(plant, scenario.axis);
+    }
+
+    double final = 0.0;
+    const size_t finalCycles = FINAL_VALUE_S * ATTITUDE_TASK_RATE_HZ;
+
+    for (size_t cycle = response.size() - finalCycles; cycle < response.size(); cycle++)
+    {
+        final += response[cycle] / finalCycles;
+    }
+
+    const double span = final - initial;
+
+    StepMetrics_t metrics;
+    metrics.riseTime = NAN;
+    metrics.overshoot = 0.0;
+    metrics.settlingTime = 0.0;
+    metrics.steadyStateError = scenario.after - final;
+
+    double riseStart = NAN;
+    size_t lastOutsideBand = 0;
+    bool everOutsideBand = false;
+
+    for (size_t cycle = 0; cycle < response.size(); cycle++)
+    {
+        double fraction = (response[cycle] - initial) / span;
+        double time = (cycle + 1) * CYCLE_S;
+
+        if (isnan(riseStart) && fraction >= 0.1)
+        {
+            riseStart = time;
+        }
+
+        if (isnan(metrics.riseTime) && fraction >= 0.9)
+        {
+            metrics.riseTime = time - riseStart;
+        }
+
+        metrics.overshoot = fmax(metrics.overshoot, (fraction - 1.0) * 100.0);
+
+        if ( ! (fabs(fraction - 1.0) <= SETTLING_BAND))
+        {
+            lastOutsideBand = cycle;
+            everOutsideBand = true;
+        }
+    }
+
+    metrics.settlingTime = everOutsideBand ? (lastOutsideBand + 1) * CYCLE_S : 0.0;
+
+    // Still moving in the last quarter, or no response at all
+    metrics.settled = isfinite(final) && (fabs(span) > 1e-6) && (metrics.settlingTime < 0.75 * RESPONSE_S);
+
+    // Without an integral term a proportional loop droops, and rise time and overshoot are then about the wrong value
+    metrics.onTarget = fabs(metrics.steadyStateError) <= STEADY_STATE_BAND * fabs(scenario.after - scenario.before);
+
+    return metrics;
+}
+
+/***********************************************************************************************************************
+ * Attitude manager dependencies outside the loop
+ **********************************************************************************************************************/
+
+PMError_t PM_GetCommands(PMCommands *Commands)
+{
+    PMError_t errorStruct;
+
+    *Commands = commands;
+    errorStruct.errorCode = 0;
+
+    return errorStruct;
+}
+
+uint32_t TimeStamp_GetMicroseconds(void)
+{
+    return simulatedTimeUs;
+}
+
+// The loop starts at PIDloopMode, so the measurement, fusion and hand-off stages never run
+SensorError_t SensorMeasurements_GetResult(IMU *imusns, airspeed *airspeedsns, IMU_Data_t *imudata, Airspeed_Data_t *airspeeddata)
+{
+    (void) imusns;
+    (void) airspeedsns;
+    (void) imudata;
+    (void) airspeeddata;
+
+    SensorError_t errorStruct;
+    errorStruct.errorCode = -1;
+
+    return errorStruct;
+}
+
+SFError_t SF_GetResult(SFOutput_t *Output, IMU_Data_t *imudata, Airspeed_Data_t *airspeeddata)
+{
+    (void) Output;
+    (void) imudata;
+    (void) airspeeddata;
+
+    SFError_t errorStruct;
+    errorStruct.errorCode = -1;
+
+    return errorStruct;
+}
+
+void SendToSafety_Init(void) {}
+
+SendToSafety_error_t SendToSafety_Commit(const float *percent, int numChannels, uint32_t sampleTimeUs)
+{
+    (void) percent;
+    (void) numChannels;
+    (void) sampleTimeUs;
+
+    SendToSafety_error_t errorStruct;
+    errorStruct.errorCode = -1;
+
+    return errorStruct;
+}
@@ -0,0 +1,236 @@
+/**
+ * Accuracy and cost of the FastMath.hpp functions against libm.
+ *
+ * Each function is swept over its domain and compared with the double precision libm result rounded to float, which
+ * is what a correctly rounded single precision libm would return. The worst error is printed in radians (or relative
+ * for the roots) and in ulps of the reference. The cost per call is then timed for both the approximation and the
+ * single precision libm function on the same inputs.
+ */
+
+#include "BenchTimer.hpp"
+#include "FastMath.hpp"
+
+#include <math.h>
+#include <stdio.h>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define SWEEP_POINTS 2000000L
+#define ITERATIONS 20000000L
+#define TABLE_SIZE 1024
+
+typedef float (*SingleFunction)(float);
+typedef double (*ReferenceFunction)(double);
+
+typedef struct
+{
+    double absolute;        // or relative, see relative below
+    double ulps;
+    float worstInput;
+} SweepError_t;
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+static double ulpsBetween(float value, double reference);
+static SweepError_t sweep(SingleFunction fast, ReferenceFunction reference, float low, float high, bool relative);
+static SweepError_t sweepAtan2(void);
+static void report(const char *name, const SweepError_t &error, bool relative);
+static void timeSingle(const char *name, SingleFunction fast, SingleFunction libm, float low, float high);
+static void timeAtan2(void);
+
+static float fastAsin(float x) {return FastMath_Asin(x);}
+static float fastAcos(float x) {return FastMath_Acos(x);}
+static float fastSin(float x) {return FastMath_Sin(x);}
+static float fastCos(float x) {return FastMath_Cos(x);}
+static float fastSqrt(float x) {return FastMath_Sqrt(x);}
+static float fastInvSqrt(float x) {return FastMath_InvSqrt(x);}
+
+static float libmAsin(float x) {return asinf(x);}
+static float libmAcos(float x) {return acosf(x);}
+static float libmSin(float x) {return sinf(x);}
+static float libmCos(float x) {return cosf(x);}
+static float libmSqrt(float x) {return sqrtf(x);}
+static float libmInvSqrt(float x) {return 1.0f / sqrtf(x);}
+
+static double referenceInvSqrt(double x) {return 1.0 / sqrt(x);}
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+int main(void)
+{
+#ifdef FAST_MATH_USE_LIBM
+    printf("FAST_MATH_USE_LIBM is defined, both columns are libm\n\n");
+#endif
+
+    printf("%-48s %12s %10s %14s\n", "accuracy", "max error", "max ulps", "at");
+
+    report("atan2", sweepAtan2(), false);
+    report("asin [-1, 1]", sweep(fastAsin, asin, -1.0f, 1.0f, false), false);
+    report("acos [-1, 1]", sweep(fastAcos, acos, -1.0f, 1.0f, false), false);
+    report("sin [-2pi, 2pi]", sweep(fastSin, sin, -6.2831853f, 6.2831853f, false), false);
+    report("cos [-2pi, 2pi]", sweep(fastCos, cos, -6.2831853f, 6.2831853f, false), false);
+    report("sin [-1000, 1000]", sweep(fastSin, sin, -1000.0f, 1000.0f, false), false);
+    report("sqrt [1e-6, 1e6]", sweep(fastSqrt, sqrt, 1e-6f, 1e6f, true), true);
+    report("invSqrt [1e-6, 1e6]", sweep(fastInvSqrt, referenceInvSqrt, 1e-6f, 1e6f, true), true);
+
+    printf("\n");
+
+    timeAtan2();
+    timeSingle("asin", fastAsin, libmAsin, -1.0f, 1.0f);
+    timeSingle("acos", fastAcos, libmAcos, -1.0f, 1.0f);
+    timeSingle("sin", fastSin, libmSin, -6.2831853f, 6.2831853f);
+    timeSingle("cos", fastCos, libmCos, -6.2831853f, 6.2831853f);
+    timeSingle("sqrt", fastSqrt, libmSqrt, 1e-3f, 1e3f);
+    timeSingle("invSqrt", fastInvSqrt, libmInvSqrt, 1e-3f, 1e3f);
+
+    return 0;
+}
+
+// The error of value in units of the last place of the reference rounded to float
+static double ulpsBetween(float value, double reference)
+{
+    float rounded = fabsf((float) reference);
+    double ulp = (double) nextafterf(rounded, INFINITY) - (double) rounded;
+
+    if (rounded == 0.0f)
+    {
+        ulp = (double) nextafterf(0.0f, 1.0f);
+    }
+
+    return fabs((double) value - reference) / ulp;
+}
+
+static SweepError_t sweep(SingleFunction fast, ReferenceFunction reference, float low, float high, bool relative)
+{
+    SweepError_t worst = {0.0, 0.0, low};
+
+    // Geometric spacing for the roots, which span many binades, linear for the rest
+    bool geometric = relative;
+    double ratio = pow((double) high / low, 1.0 / (SWEEP_POINTS - 1));
+
+    for (long i = 0; i < SWEEP_POINTS; i++)
+    {
+        float x = geometric ? (float) (low * pow(ratio, (double) i))
+                            : (float) (low + (high - low) * (double) i / (SWEEP_POINTS - 1));
+
+        double expected = reference((double) x);
+        float value = fast(x);
+
+        double error = fabs((double) value - expected);
+        error = relative ? error / fabs(expected) : error;
+
+        if (error > worst.absolute)
+        {
+            worst.absolute = error;
+            worst.worstInput = x;
+        }
+
+        double ulps = ulpsBetween(value, expected);
+        worst.ulps = (ulps > worst.ulps) ? ulps : worst.ulps;
+    }
+
+    return worst;
+}
+
+// Directions all the way round, at a few radii
+static SweepError_t sweepAtan2(void)
+{
+    SweepError_t worst = {0.0, 0.0, 0.0f};
+    const float radii[] = {1e-3f, 1.0f, 1e4f};
+
+    for (float radius : radii)
+    {
+        for (long i = 0; i < SWEEP_POINTS; i++)
+        {
+            double direction = -M_PI + 2.0 * M_PI * (double) i / SWEEP_POINTS;
+            float y = (float) (radius * sin(direction));
+            float x = (float) (radius * cos(direction));
+
+            double expected = atan2((double) y, (double) x);
+            float value = FastMath_Atan2(y, x);
+
+            double error = fabs((double) value - expected);
+
+            if (error > worst.absolute)
+            {
+                worst.absolute = error;
+                worst.worstInput = (float) direction;
+            }
+
+            double ulps = ulpsBetween(value, expected);
+            worst.ulps = (ulps > worst.ulps) ? ulps : worst.ulps;
+        }
+    }
+
+    return worst;
+}
+
+static void report(const char *name, const SweepError_t &error, bool relative)
+{
+    printf("%-48s %12.3g %10.1f %14.6g%s\n", name, error.absolute, error.ulps, error.worstInput,
+           relative ? "  (relative)" : "");
+}
+
+static void timeSingle(const char *name, SingleFunction fast, SingleFunction libm, float low, float high)
+{
+    static float inputs[TABLE_SIZE];
+
+    for (int i = 0; i < TABLE_SIZE; i++)
+    {
+        inputs[i] = low + (high - low) * (float) i / (TABLE_SIZE - 1);
+    }
+
+    // Called through the pointers the compiler can still see, so both are inlined the same way at -O2
+    double fastTime = Bench_NanosecondsPerCall(ITERATIONS, [&](long i)
+    {
+        float value = fast(inputs[i & (TABLE_SIZE - 1)]);
+        Bench_KeepAlive(value);
+    });
+
+    double libmTime = Bench_NanosecondsPerCall(ITERATIONS, [&](long i)
+    {
+        float value = libm(inputs[i & (TABLE_SIZE - 1)]);
+        Bench_KeepAlive(value);
+    });
+
+    char label[64];
+
+    snprintf(label, sizeof(label), "%s, FastMath", name);
+    Bench_Report(label, fastTime);
+    snprintf(label, sizeof(label), "%s, libm", name);
+    Bench_Report(label, libmTime);
+}
+
+static void timeAtan2(void)
+{
+    static float ys[TABLE_SIZE];
+    static float xs[TABLE_SIZE];
+
+    for (int i = 0; i < TABLE_SIZE; i++)
+    {
+        double direction = -M_PI + 2.0 * M_PI * i / TABLE_SIZE;
+        ys[i] = (float) sin(direction);
+        xs[i] = (float) cos(direction);
+    }
+
+    double fastTime = Bench_NanosecondsPerCall(ITERATIONS, [&](long i)
+    {
+        float value = FastMath_Atan2(ys[i & (TABLE_SIZE - 1)], xs[i & (TABLE_SIZE - 1)]);
+        Bench_KeepAlive(value);
+    });
+
+    double libmTime = Bench_NanosecondsPerCall(ITERATIONS, [&](long i)
+    {
+        float value = atan2f(ys[i & (TABLE_SIZE - 1)], xs[i & (TABLE_SIZE - 1)]);
+        Bench_KeepAlive(value);
+    });
+
+    Bench_Report("atan2, FastMath", fastTime);
+    Bench_Report("atan2, libm", libmTime);
+}
@@ -0,0 +1,575 @@
+/**
+ * Cost of the PID and of the output mixing in float, in emulated float and in Q15 and Q31 fixed point.
+ *
+ * The safety controller is a Cortex-M0 without an FPU, where every float operation is a call into the software
+ * floating point library. SoftFloat stands in for that library on the host: IEEE single precision add, multiply and
+ * compare done with integer instructions, rounding to nearest even like the library does, and checked here to give
+ * the same bits as the hardware. The timings are host figures, in nanoseconds and in time stamp counter cycles; what
+ * carries over to the M0 is the ratio between the integer and the emulated float versions, and the number of float
+ * operations per call, each of which is a library call of some tens of cycles there.
+ */
+
+#include "BenchTimer.hpp"
+#include "PID.hpp"
+#include "OutputMixing.hpp"
+#include "FixedPID.hpp"
+#include "FixedOutputMixing.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define ITERATIONS 2000000L
+#define INPUTS 4093         // a prime, so the inputs do not line up with anything periodic in the code
+
+#define INPUT_FULL_SCALE 256.0f
+#define OUTPUT_FULL_SCALE 128.0f
+
+// IEEE single precision in integer arithmetic. Zeros, normal numbers and overflow to infinity; no NaNs and subnormals
+// flush to zero, which the PID and the mixer never produce from the inputs used here.
+struct SoftFloat
+{
+    uint32_t bits;
+
+    static long adds, multiplies, compares;
+
+    SoftFloat() : bits(0) {}
+    SoftFloat(float value) {memcpy(&bits, &value, sizeof(bits));}
+
+    float toFloat() const
+    {
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+};
+
+long SoftFloat::adds = 0;
+long SoftFloat::multiplies = 0;
+long SoftFloat::compares = 0;
+
+// The float operations of one call, counted through SoftFloat
+struct OperationCount_t
+{
+    double adds, multiplies, compares;
+};
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+static void makeInputs(void);
+static double tscCyclesPerNanosecond(void);
+
+static void measurePid(bool measuredRates);
+static void measureMixing(void);
+static void report(const char *name, double nanoseconds, const OperationCount_t *operations);
+
+/***********************************************************************************************************************
+ * Soft float
+ **********************************************************************************************************************/
+
+static uint32_t softRound(uint32_t sign, int exponent, uint32_t mantissa, uint32_t remainder, uint32_t half)
+{
+    if ((remainder > half) || ((remainder == half) && (mantissa & 1u)))
+    {
+        mantissa++;
+
+        if (mantissa == (1u << 24))
+        {
+            mantissa >>= 1;
+            exponent++;
+        }
+    }
+
+    if (exponent <= 0)
+    {
+        return sign;
+    }
+
+    if (exponent >= 255)
+    {
+        return sign | 0x7F800000u;
+    }
+
+    return sign | ((uint32_t) exponent << 23) | (mantissa & 0x7FFFFFu);
+}
+
+static SoftFloat operator+(SoftFloat a, SoftFloat b)
+{
+    SoftFloat::adds++;
+
+    if ((a.bits & 0x7FFFFFFFu) < (b.bits & 0x7FFFFFFFu))
+    {
+        SoftFloat larger = b;
+        b = a;
+        a = larger;
+    }
+
+    int exponentA = (a.bits >> 23) & 0xFF;
+    int exponentB = (b.bits >> 23) & 0xFF;
+
+    if (exponentB == 0)
+    {
+        return (exponentA == 0) ? SoftFloat(0.0f) : a;
+    }
+
+    // Three extra bits below the mantissa: guard, round and sticky
+    uint32_t mantissaA = ((a.bits & 0x7FFFFFu) | 0x800000u) << 3;
+    uint32_t mantissaB = ((b.bits & 0x7FFFFFu) | 0x800000u) << 3;
+    int shift = exponentA - exponentB;
+
+    if (shift > 26)
+    {
+        mantissaB = 1;
+    }
+    else if (shift > 0)
+    {
+        uint32_t sticky = (mantissaB & ((1u << shift) - 1)) != 0;
+        mantissaB = (mantissaB >> shift) | sticky;
+    }
+
+    uint32_t sign = a.bits & 0x80000000u;
+
+    if ((a.bits ^ b.bits) & 0x80000000u)
+    {
+        mantissaA -= mantissaB;
+
+        if (mantissaA == 0)
+        {
+            return SoftFloat(0.0f);
+        }
+
+        while (mantissaA < (1u << 26))
+        {
+            mantissaA <<= 1;
+            exponentA--;
+        }
+    }
+    else
+    {
+        mantissaA += mantissaB;
+
+        if (mantissaA >= (1u << 27))
+        {
+            mantissaA = (mantissaA >> 1) | (mantissaA & 1u);
+            exponentA++;
+        }
+    }
+
+    SoftFloat result;
+    result.bits = softRound(sign, exponentA, mantissaA >> 3, mantissaA & 7u, 4u);
+    return result;
+}
+
+static SoftFloat operator-(SoftFloat a)
+{
+    a.bits ^= 0x80000000u;
+    return a;
+}
+
+static SoftFloat operator-(SoftFloat a, SoftFloat b)
+{
+    return a + (-b);
+}
+
+static SoftFloat operator*(SoftFloat a, SoftFloat b)
+{
+    SoftFloat::multiplies++;
+
+    uint32_t sign = (a.bits ^ b.bits) & 0x80000000u;
+    int exponentA = (a.bits >> 23) & 0xFF;
+    int exponentB = (b.bits >> 23) & 0xFF;
+
+    if ((exponentA == 0) || (exponentB == 0))
+    {
+        SoftFloat zero;
+        zero.bits = sign;
+        return zero;
+    }
+
+    uint64_t product = (uint64_t) ((a.bits & 0x7FFFFFu) | 0x800000u) * ((b.bits & 0x7FFFFFu) | 0x800000u);
+    int exponent = exponentA + exponentB - 127;
+
+    // Leading bit to bit 47
+    if (product & (1ull << 47))
+    {
+        exponent++;
+    }
+    else
+    {
+        product <<= 1;
+    }
+
+    SoftFloat result;
+    result.bits = softRound(sign, exponent, (uint32_t) (product >> 24), (uint32_t) (product & 0xFFFFFFu), 0x800000u);
+    return result;
+}
+
+// Sign and magnitude to an integer of the same order, both zeros to 0
+static int32_t softOrder(SoftFloat a)
+{
+    int32_t magnitude = (int32_t) (a.bits & 0x7FFFFFFFu);
+    return (a.bits & 0x80000000u) ? -magnitude : magnitude;
+}
+
+static bool operator<(SoftFloat a, SoftFloat b)
+{
+    SoftFloat::compares++;
+    return softOrder(a) < softOrder(b);
+}
+
+static bool operator>(SoftFloat a, SoftFloat b)
+{
+    return b < a;
+}
+
+/***********************************************************************************************************************
+ * Float reference, templated so that it runs on float or SoftFloat
+ **********************************************************************************************************************/
+
+// PIDController::execute, with the two derivative cases split as SoftFloat has no NaN
+template <typename T>
+class ReferencePID
+{
+    public:
+        ReferencePID(float _kp, float _ki, float _kd, float _i_max, float _min_output, float _max_output)
+            : kp(_kp), ki(_ki), kd(_kd), i_max(_i_max), min_output(_min_output), max_output(_max_output),
+              integral(0.0f)
+        {
+            historicalValue[0] = historicalValue[1] = historicalValue[2] = T(0.0f);
+        }
+
+        T execute(T desired, T actual)
+        {
+            historicalValue[2] = historicalValue[1];
+            historicalValue[1] = historicalValue[0];
+            historicalValue[0] = actual;
+
+            return step(desired - actual, (T(3.0f) * historicalValue[0]) - (T(4.0f) * historicalValue[1]) + historicalValue[2]);
+        }
+
+        T execute(T desired, T actual, T actualRate)
+        {
+            return step(desired - actual, actualRate);
+        }
+
+    private:
+        T step(T error, T derivative)
+        {
+            integral = integral + error;
+
+            if (integral < -i_max)
+            {
+                integral = -i_max;
+            }
+            else if (integral > i_max)
+            {
+                integral = i_max;
+            }
+
+            T ret = ((kp * error) + (ki * integral) - (kd * derivative));
+
+            if (ret < min_output)
+            {
+                ret = min_output;
+            }
+            else if (ret > max_output)
+            {
+                ret = max_output;
+            }
+
+            return ret;
+        }
+
+        T kp, ki, kd;
+        T i_max;
+        T min_output, max_output;
+        T integral;
+        T historicalValue[3];
+};
+
+// OutputMixing_Execute for a conventional tail
+template <typename T>
+static int referenceMixing(const T input[4], T channelOut[NUM_MIXED_CHANNELS])
+{
+    const T HUNDRED(100.0f);
+    const T ZERO(0.0f);
+    int errorCode;
+
+    if ((input[0] < -HUNDRED) || (input[1] < -HUNDRED) || (input[2] < -HUNDRED) || (input[3] < ZERO))
+    {
+        errorCode = 1;
+    }
+    else if ((input[0] > HUNDRED) || (input[1] > HUNDRED) || (input[2] > HUNDRED) || (input[3] > HUNDRED))
+    {
+        errorCode = 2;
+    }
+    else
+    {
+        errorCode = 0;
+    }
+
+    channelOut[ELEVATOR_OUT_CHANNEL] = input[1];
+    channelOut[RUDDER_OUT_CHANNEL] = input[2];
+    channelOut[AILERON_OUT_CHANNEL] = input[0];
+    channelOut[THROTTLE_OUT_CHANNEL] = input[3];
+
+    for (int i = 0; i < NUM_MIXED_CHANNELS; i++)
+    {
+        if (channelOut[i] < -HUNDRED)
+        {
+            channelOut[i] = -HUNDRED;
+        }
+        else if (channelOut[i] > HUNDRED)
+        {
+            channelOut[i] = HUNDRED;
+        }
+    }
+
+    return errorCode;
+}
+
+/***********************************************************************************************************************
+ * Inputs
+ **********************************************************************************************************************/
+
+static float desiredInputs[INPUTS];
+static float actualInputs[INPUTS];
+static float rateInputs[INPUTS];
+static float percentInputs[INPUTS + 4];     // each call takes the next 4
+
+static SoftFloat softDesired[INPUTS], softActual[INPUTS], softRate[INPUTS], softPercent[INPUTS + 4];
+static q15_t q15Desired[INPUTS], q15Actual[INPUTS], q15Rate[INPUTS];
+static q31_t q31Desired[INPUTS], q31Actual[INPUTS], q31Rate[INPUTS];
+static FixedPID_Output_t<q15_t> q15Percent[INPUTS];
+static FixedPID_Output_t<q31_t> q31Percent[INPUTS];
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+int main(void)
+{
+    makeInputs();
+
+    measurePid(false);
+    measurePid(true);
+    measureMixing();
+
+    return 0;
+}
+
+static void makeInputs(void)
+{
+    uint32_t seed = 1;
+
+    for (int i = 0; i < INPUTS + 4; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        percentInputs[i] = (float) (seed >> 8) / (float) (1u << 15) - 256.0f;
+        percentInputs[i] = (percentInputs[i] > 127.0f) ? percentInputs[i] - 256.0f : percentInputs[i];
+        percentInputs[i] = (percentInputs[i] < -128.0f) ? percentInputs[i] + 128.0f : percentInputs[i];
+        softPercent[i] = percentInputs[i];
+    }
+
+    for (int i = 0; i < INPUTS; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        desiredInputs[i] = (float) (seed >> 8) / (float) (1u << 17) - 64.0f;
+        seed = seed * 1664525u + 1013904223u;
+        actualInputs[i] = (float) (seed >> 8) / (float) (1u << 17) - 64.0f;
+        seed = seed * 1664525u + 1013904223u;
+        rateInputs[i] = (float) (seed >> 8) / (float) (1u << 19) - 16.0f;
+
+        softDesired[i] = desiredInputs[i];
+        softActual[i] = actualInputs[i];
+        softRate[i] = rateInputs[i];
+
+        q15Desired[i] = FixedPoint_FromFloat<q15_t>(desiredInputs[i], INPUT_FULL_SCALE);
+        q15Actual[i] = FixedPoint_FromFloat<q15_t>(actualInputs[i], INPUT_FULL_SCALE);
+        q15Rate[i] = FixedPoint_FromFloat<q15_t>(rateInputs[i], INPUT_FULL_SCALE);
+        q31Desired[i] = FixedPoint_FromFloat<q31_t>(desiredInputs[i], INPUT_FULL_SCALE);
+        q31Actual[i] = FixedPoint_FromFloat<q31_t>(actualInputs[i], INPUT_FULL_SCALE);
+        q31Rate[i] = FixedPoint_FromFloat<q31_t>(rateInputs[i], INPUT_FULL_SCALE);
+
+        const float *percent = &percentInputs[i];
+        q15Percent[i] = {FixedPoint_FromFloat<q15_t>(percent[0], FIXED_MIXING_FULL_SCALE),
+                         FixedPoint_FromFloat<q15_t>(percent[1], FIXED_MIXING_FULL_SCALE),
+                         FixedPoint_FromFloat<q15_t>(percent[2], FIXED_MIXING_FULL_SCALE),
+                         FixedPoint_FromFloat<q15_t>(percent[3], FIXED_MIXING_FULL_SCALE)};
+        q31Percent[i] = {FixedPoint_FromFloat<q31_t>(percent[0], FIXED_MIXING_FULL_SCALE),
+                         FixedPoint_FromFloat<q31_t>(percent[1], FIXED_MIXING_FULL_SCALE),
+                         FixedPoint_FromFloat<q31_t>(percent[2], FIXED_MIXING_FULL_SCALE),
+                         FixedPoint_FromFloat<q31_t>(percent[3], FIXED_MIXING_FULL_SCALE)};
+    }
+}
+
+static double tscCyclesPerNanosecond(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    static double ratio = 0.0;
+
+    if (ratio == 0.0)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        uint64_t startCycles = __rdtsc();
+
+        while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(100))
+        {
+        }
+
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        ratio = (double) (__rdtsc() - startCycles) / elapsed.count();
+    }
+
+    return ratio;
+#else
+    return 0.0;
+#endif
+}
+
+// The float operations of one call of body, counted through SoftFloat
+template <typename Body>
+static OperationCount_t countOperations(Body body)
+{
+    const long CALLS = 10000;
+
+    SoftFloat::adds = SoftFloat::multiplies = SoftFloat::compares = 0;
+
+    for (long i = 0; i < CALLS; i++)
+    {
+        body(i);
+    }
+
+    OperationCount_t count = {(double) SoftFloat::adds / CALLS, (double) SoftFloat::multiplies / CALLS,
+                              (double) SoftFloat::compares / CALLS};
+    return count;
+}
+
+static void measurePid(bool measuredRates)
+{
+    const float GAINS[6] = {1.2f, 0.05f, 0.3f, 20.0f, -100.0f, 100.0f};
+
+    PIDController hardware(GAINS[0], GAINS[1], GAINS[2], GAINS[3], GAINS[4], GAINS[5]);
+    ReferencePID<SoftFloat> soft(GAINS[0], GAINS[1], GAINS[2], GAINS[3], GAINS[4], GAINS[5]);
+    FixedPIDController<q15_t> q15(GAINS[0], GAINS[1], GAINS[2], GAINS[3], GAINS[4], GAINS[5], INPUT_FULL_SCALE, OUTPUT_FULL_SCALE);
+    FixedPIDController<q31_t> q31(GAINS[0], GAINS[1], GAINS[2], GAINS[3], GAINS[4], GAINS[5], INPUT_FULL_SCALE, OUTPUT_FULL_SCALE);
+
+    // SoftFloat has to give the bits of the hardware before its timings mean anything
+    ReferencePID<SoftFloat> check(GAINS[0], GAINS[1], GAINS[2], GAINS[3], GAINS[4], GAINS[5]);
+    PIDController checkHardware(GAINS[0], GAINS[1], GAINS[2], GAINS[3], GAINS[4], GAINS[5]);
+    int mismatches = 0;
+
+    for (int i = 0; i < INPUTS; i++)
+    {
+        float expected = measuredRates ? checkHardware.execute(desiredInputs[i], actualInputs[i], rateInputs[i])
+                                       : checkHardware.execute(desiredInputs[i], actualInputs[i]);
+        SoftFloat result = measuredRates ? check.execute(softDesired[i], softActual[i], softRate[i])
+                                         : check.execute(softDesired[i], softActual[i]);
+
+        mismatches += (result.toFloat() != expected);
+    }
+
+    printf("PID, %s, soft float mismatches against the hardware: %d\n",
+           measuredRates ? "measured derivative" : "finite difference derivative", mismatches);
+
+    int position = 0;
+
+    auto softBody = [&](long) {
+        SoftFloat output = measuredRates ? soft.execute(softDesired[position], softActual[position], softRate[position])
+                                         : soft.execute(softDesired[position], softActual[position]);
+        position = (position + 1 == INPUTS) ? 0 : position + 1;
+        Bench_KeepAlive(output);
+    };
+
+    OperationCount_t operations = countOperations(softBody);
+
+    report("  float, hardware", Bench_NanosecondsPerCall(ITERATIONS, [&](long) {
+        float output = measuredRates ? hardware.execute(desiredInputs[position], actualInputs[position], rateInputs[position])
+                                     : hardware.execute(desiredInputs[position], actualInputs[position]);
+        position = (position + 1 == INPUTS) ? 0 : position + 1;
+        Bench_KeepAlive(output);
+    }), nullptr);
+
+    report("  float, emulated", Bench_NanosecondsPerCall(ITERATIONS, softBody), &operations);
+
+    report("  Q15", Bench_NanosecondsPerCall(ITERATIONS, [&](long) {
+        q15_t output = measuredRates ? q15.execute(q15Desired[position], q15Actual[position], q15Rate[position])
+                                     : q15.execute(q15Desired[position], q15Actual[position]);
+        position = (position + 1 == INPUTS) ? 0 : position + 1;
+        Bench_KeepAlive(output);
+    }), nullptr);
+
+    report("  Q31", Bench_NanosecondsPerCall(ITERATIONS, [&](long) {
+        q31_t output = measuredRates ? q31.execute(q31Desired[position], q31Actual[position], q31Rate[position])
+                                     : q31.execute(q31Desired[position], q31Actual[position]);
+        position = (position + 1 == INPUTS) ? 0 : position + 1;
+        Bench_KeepAlive(output);
+    }), nullptr);
+}
+
+static void measureMixing(void)
+{
+    printf("Output mixing\n");
+
+    int position = 0;
+
+    auto softBody = [&](long) {
+        SoftFloat output[NUM_MIXED_CHANNELS];
+        int errorCode = referenceMixing(&softPercent[position], output);
+        position = (position + 1 == INPUTS) ? 0 : position + 1;
+        Bench_KeepAlive(output);
+        Bench_KeepAlive(errorCode);
+    };
+
+    OperationCount_t operations = countOperations(softBody);
+
+    report("  float, hardware", Bench_NanosecondsPerCall(ITERATIONS, [&](long) {
+        const float *percent = &percentInputs[position];
+        PID_Output_t input = {percent[0], percent[1], percent[2], percent[3], 0};
+        float output[NUM_MIXED_CHANNELS];
+        OutputMixing_error_t error = OutputMixing_Execute(&input, output);
+        position = (position + 1 == INPUTS) ? 0 : position + 1;
+        Bench_KeepAlive(output);
+        Bench_KeepAlive(error);
+    }), nullptr);
+
+    report("  float, emulated", Bench_NanosecondsPerCall(ITERATIONS, softBody), &operations);
+
+    report("  Q15", Bench_NanosecondsPerCall(ITERATIONS, [&](long) {
+        q15_t output[NUM_MIXED_CHANNELS];
+        FixedOutputMixing_error_t error = FixedOutputMixing_Execute(&q15Percent[position], output);
+        position = (position + 1 == INPUTS) ? 0 : position + 1;
+        Bench_KeepAlive(output);
+        Bench_KeepAlive(error);
+    }), nullptr);
+
+    report("  Q31", Bench_NanosecondsPerCall(ITERATIONS, [&](long) {
+        q31_t output[NUM_MIXED_CHANNELS];
+        FixedOutputMixing_error_t error = FixedOutputMixing_Execute(&q31Percent[position], output);
+        position = (position + 1 == INPUTS) ? 0 : position + 1;
+        Bench_KeepAlive(output);
+        Bench_KeepAlive(error);
+    }), nullptr);
+}
+
+static void report(const char *name, double nanoseconds, const OperationCount_t *operations)
+{
+    printf("%-24s %8.2f ns/call %8.1f cycles/call", name, nanoseconds, nanoseconds * tscCyclesPerNanosecond());
+
+    if (operations != nullptr)
+    {
+        printf("   %.1f add, %.1f mul, %.1f cmp per call", operations->adds, operations->multiplies, operations->compares);
+    }
+
+    printf("\n");
+}
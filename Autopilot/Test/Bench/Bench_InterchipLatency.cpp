@@ -0,0 +1,100 @@
+/**
+ * Measures how long a frame committed by the attitude pipeline takes to get across the interchip link, with the
+ * polling loop the interchip task used to run and with the event driven one of InterchipPacer.h, on the simulated SPI
+ * of SimulatedInterchip.hpp.
+ *
+ * The phase between the attitude commits and the RTOS ticks is fixed on the target but unknown, so each loop is run
+ * over phases spread across a whole period and the latencies of all of them are pooled.
+ */
+
+#include "SimulatedInterchip.hpp"
+
+#include <algorithm>
+#include <stdio.h>
+#include <vector>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define SIMULATED_US 10000000ULL
+#define NUM_PHASES 50
+
+struct LatencySummary_t
+{
+    double meanUs;
+    uint32_t p50Us, p99Us, maxUs;
+    double transfersPerSecond;
+    double wakeUpsPerSecond;
+    int superseded;
+};
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+static LatencySummary_t runOverPhases(SimulatedInterchipLoop_t loop, SimulatedInterchipConfig_t config);
+static void report(const char *name, const LatencySummary_t &summary);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+int main(void)
+{
+    SimulatedInterchipConfig_t config = SimulatedInterchip_DefaultConfig();
+
+    printf("commit every %u us, %u us per transfer, %u us ticks, %d phases of %.0f s\n", config.commitPeriodUs,
+           config.transferUs, config.tickUs, NUM_PHASES, SIMULATED_US / 1e6);
+    printf("%-36s %9s %9s %9s %9s %11s %10s %10s\n", "loop", "mean us", "p50 us", "p99 us", "max us",
+           "transfers/s", "wakeups/s", "superseded");
+
+    report("polling, osDelay(5)", runOverPhases(SIMULATED_INTERCHIP_POLLING, config));
+    report("event driven", runOverPhases(SIMULATED_INTERCHIP_EVENT_DRIVEN, config));
+
+    // Commits far faster than the guard allows transfers, as SendToSafety_Execute does one channel at a time
+    SimulatedInterchipConfig_t burst = config;
+    burst.commitPeriodUs = 150;
+    burst.commitJitterUs = 50;
+
+    report("event driven, commit every 150 us", runOverPhases(SIMULATED_INTERCHIP_EVENT_DRIVEN, burst));
+
+    return 0;
+}
+
+static LatencySummary_t runOverPhases(SimulatedInterchipLoop_t loop, SimulatedInterchipConfig_t config)
+{
+    std::vector<uint32_t> latencies;
+    LatencySummary_t summary = {};
+
+    for (int phase = 0; phase < NUM_PHASES; phase++)
+    {
+        config.commitPhaseUs = phase * config.pollPeriodUs / NUM_PHASES;
+
+        SimulatedInterchipResult_t result = SimulatedInterchip_Run(loop, config, SIMULATED_US);
+
+        latencies.insert(latencies.end(), result.latenciesUs.begin(), result.latenciesUs.end());
+        summary.transfersPerSecond += result.transfers / (SIMULATED_US / 1e6) / NUM_PHASES;
+        summary.wakeUpsPerSecond += result.taskWakeUps / (SIMULATED_US / 1e6) / NUM_PHASES;
+        summary.superseded += result.superseded;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+
+    for (size_t i = 0; i < latencies.size(); i++)
+    {
+        summary.meanUs += (double) latencies[i] / latencies.size();
+    }
+
+    summary.p50Us = latencies[latencies.size() / 2];
+    summary.p99Us = latencies[latencies.size() * 99 / 100];
+    summary.maxUs = latencies.back();
+
+    return summary;
+}
+
+static void report(const char *name, const LatencySummary_t &summary)
+{
+    printf("%-36s %9.0f %9u %9u %9u %11.0f %10.0f %10d\n", name, summary.meanUs, summary.p50Us, summary.p99Us,
+           summary.maxUs, summary.transfersPerSecond, summary.wakeUpsPerSecond, summary.superseded);
+}
@@ -0,0 +1,295 @@
+/**
+ * Compares the LinearAlgebra.hpp types with the hand written scalar code they replace. Each pair computes the same
+ * thing from the same inputs, so any gap is overhead from the abstraction.
+ */
+
+#include "BenchTimer.hpp"
+#include "LinearAlgebra.hpp"
+
+#include <math.h>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define ITERATIONS 20000000L
+#define LARGE_ITERATIONS 200000L
+
+#define STATES 15
+
+// The inputs move with the iteration index so nothing can be folded at compile time
+static float varying(long i, float base)
+{
+    return base + (float) (i & 1023) * 1e-4f;
+}
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+static void crossAndNormalise(void);
+static void quaternionProduct(void);
+static void rotateVector(void);
+static void matrixProduct3(void);
+static void waypointDistance(void);
+static void covariancePropagation(void);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+int main(void)
+{
+    crossAndNormalise();
+    quaternionProduct();
+    rotateVector();
+    matrixProduct3();
+    waypointDistance();
+    covariancePropagation();
+
+    return 0;
+}
+
+static void crossAndNormalise(void)
+{
+    double scalar = Bench_NanosecondsPerCall(ITERATIONS, [&](long i)
+    {
+        float a[3] = {varying(i, 1.0f), 2.0f, 3.0f};
+        float b[3] = {-2.0f, varying(i, 0.5f), 4.0f};
+        float c[3];
+
+        c[0] = a[1] * b[2] - a[2] * b[1];
+        c[1] = a[2] * b[0] - a[0] * b[2];
+        c[2] = a[0] * b[1] - a[1] * b[0];
+
+        float recipNorm = 1.0f / sqrtf(c[0] * c[0] + c[1] * c[1] + c[2] * c[2]);
+        c[0] *= recipNorm;
+        c[1] *= recipNorm;
+        c[2] *= recipNorm;
+
+        Bench_KeepAlive(c);
+    });
+
+    double library = Bench_NanosecondsPerCall(ITERATIONS, [&](long i)
+    {
+        Vec3 a = {{varying(i, 1.0f), 2.0f, 3.0f}};
+        Vec3 b = {{-2.0f, varying(i, 0.5f), 4.0f}};
+
+        Vec3 c = normalized(cross(a, b));
+
+        Bench_KeepAlive(c);
+    });
+
+    Bench_Report("cross + normalise, scalar", scalar);
+    Bench_Report("cross + normalise, Vec3", library);
+}
+
+static void quaternionProduct(void)
+{
+    double scalar = Bench_NanosecondsPerCall(ITERATIONS, [&](long i)
+    {
+        float a[4] = {0.9f, varying(i, 0.1f), 0.2f, 0.3f};
+        float b[4] = {varying(i, 0.8f), 0.3f, -0.1f, 0.5f};
+        float r[4];
+
+        r[0] = a[0] * b[0] - a[1] * b[1] - a[2] * b[2] - a[3] * b[3];
+        r[1] = a[0] * b[1] + a[1] * b[0] + a[2] * b[3] - a[3] * b[2];
+        r[2] = a[0] * b[2] - a[1] * b[3] + a[2] * b[0] + a[3] * b[1];
+        r[3] = a[0] * b[3] + a[1] * b[2] - a[2] * b[1] + a[3] * b[0];
+
+        float recipNorm = 1.0f / sqrtf(r[0] * r[0] + r[1] * r[1] + r[2] * r[2] + r[3] * r[3]);
+
+        for (int k = 0; k < 4; k++)
+        {
+            r[k] *= recipNorm;
+        }
+
+        Bench_KeepAlive(r);
+    });
+
+    double library = Bench_NanosecondsPerCall(ITERATIONS, [&](long i)
+    {
+        Quat a = {0.9f, varying(i, 0.1f), 0.2f, 0.3f};
+        Quat b = {varying(i, 0.8f), 0.3f, -0.1f, 0.5f};
+
+        Quat r = (a * b).normalized();
+
+        Bench_KeepAlive(r);
+    });
+
+    Bench_Report("quaternion product + normalise, scalar", scalar);
+    Bench_Report("quaternion product + normalise, Quat", library);
+}
+
+static void rotateVector(void)
+{
+    double scalar = Bench_NanosecondsPerCall(ITERATIONS, [&](long i)
+    {
+        float q0 = 0.9f, q1 = varying(i, 0.1f), q2 = 0.2f, q3 = 0.3f;
+        float v[3] = {varying(i, 1.0f), 2.0f, -0.5f};
+        float r[3];
+
+        // The rotation matrix, one row at a time, as MadgwickAHRS and the path manager write it out
+        r[0] = (1.0f - 2.0f * (q2 * q2 + q3 * q3)) * v[0] + 2.0f * (q1 * q2 - q0 * q3) * v[1] + 2.0f * (q1 * q3 + q0 * q2) * v[2];
+        r[1] = 2.0f * (q1 * q2 + q0 * q3) * v[0] + (1.0f - 2.0f * (q1 * q1 + q3 * q3)) * v[1] + 2.0f * (q2 * q3 - q0 * q1) * v[2];
+        r[2] = 2.0f * (q1 * q3 - q0 * q2) * v[0] + 2.0f * (q2 * q3 + q0 * q1) * v[1] + (1.0f - 2.0f * (q1 * q1 + q2 * q2)) * v[2];
+
+        Bench_KeepAlive(r);
+    });
+
+    double matrix = Bench_NanosecondsPerCall(ITERATIONS, [&](long i)
+    {
+        Quat q = {0.9f, varying(i, 0.1f), 0.2f, 0.3f};
+        Vec3 v = {{varying(i, 1.0f), 2.0f, -0.5f}};
+
+        Vec3 r = q.toRotationMatrix() * v;
+
+        Bench_KeepAlive(r);
+    });
+
+    double direct = Bench_NanosecondsPerCall(ITERATIONS, [&](long i)
+    {
+        Quat q = {0.9f, varying(i, 0.1f), 0.2f, 0.3f};
+        Vec3 v = {{varying(i, 1.0f), 2.0f, -0.5f}};
+
+        Vec3 r = q.rotate(v);
+
+        Bench_KeepAlive(r);
+    });
+
+    Bench_Report("rotate vector, scalar matrix", scalar);
+    Bench_Report("rotate vector, Quat::toRotationMatrix * Vec3", matrix);
+    Bench_Report("rotate vector, Quat::rotate", direct);
+}
+
+static void matrixProduct3(void)
+{
+    double scalar = Bench_NanosecondsPerCall(ITERATIONS, [&](long i)
+    {
+        float a[3][3] = {{varying(i, 1.0f), 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}, {7.0f, 8.0f, 9.0f}};
+        float b[3][3] = {{0.5f, varying(i, 0.1f), 0.0f}, {0.2f, 1.0f, 0.3f}, {0.0f, 0.4f, 1.0f}};
+        float c[3][3];
+
+        for (int row = 0; row < 3; row++)
+        {
+            for (int col = 0; col < 3; col++)
+            {
+                c[row][col] = a[row][0] * b[0][col] + a[row][1] * b[1][col] + a[row][2] * b[2][col];
+            }
+        }
+
+        Bench_KeepAlive(c);
+    });
+
+    double library = Bench_NanosecondsPerCall(ITERATIONS, [&](long i)
+    {
+        Mat3 a = {{{varying(i, 1.0f), 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f}, {7.0f, 8.0f, 9.0f}}};
+        Mat3 b = {{{0.5f, varying(i, 0.1f), 0.0f}, {0.2f, 1.0f, 0.3f}, {0.0f, 0.4f, 1.0f}}};
+
+        Mat3 c = a * b;
+
+        Bench_KeepAlive(c);
+    });
+
+    Bench_Report("3x3 product, scalar", scalar);
+    Bench_Report("3x3 product, Mat3", library);
+}
+
+static void waypointDistance(void)
+{
+    // What waypointManager.cpp did before it used Vec3
+    double withPow = Bench_NanosecondsPerCall(ITERATIONS, [&](long i)
+    {
+        float a[3] = {varying(i, 100.0f), 250.0f, 30.0f};
+        float b[3] = {-20.0f, varying(i, 80.0f), 45.0f};
+
+        float d = sqrt(pow(a[0] - b[0], 2) + pow(a[1] - b[1], 2) + pow(a[2] - b[2], 2));
+
+        Bench_KeepAlive(d);
+    });
+
+    double library = Bench_NanosecondsPerCall(ITERATIONS, [&](long i)
+    {
+        float a[3] = {varying(i, 100.0f), 250.0f, 30.0f};
+        float b[3] = {-20.0f, varying(i, 80.0f), 45.0f};
+
+        float d = distance(Vec3::fromArray(a), Vec3::fromArray(b));
+
+        Bench_KeepAlive(d);
+    });
+
+    Bench_Report("waypoint distance, sqrt(pow(...))", withPow);
+    Bench_Report("waypoint distance, Vec3", library);
+}
+
+static void covariancePropagation(void)
+{
+    static float Fs[STATES][STATES];
+    static float Ps[STATES][STATES];
+    static float FPs[STATES][STATES];
+    static float results[STATES][STATES];
+
+    Mat<STATES, STATES> F = Mat<STATES, STATES>::identity();
+    Mat<STATES, STATES> P = Mat<STATES, STATES>::identity();
+
+    for (int row = 0; row < STATES; row++)
+    {
+        for (int col = 0; col < STATES; col++)
+        {
+            F(row, col) += (row < col) ? 0.005f : 0.0f;
+            Fs[row][col] = F(row, col);
+            Ps[row][col] = P(row, col);
+        }
+    }
+
+    // F * P * F^T written out with plain arrays
+    double scalar = Bench_NanosecondsPerCall(LARGE_ITERATIONS, [&](long i)
+    {
+        Fs[0][1] = varying(i, 0.005f);
+
+        for (int row = 0; row < STATES; row++)
+        {
+            for (int col = 0; col < STATES; col++)
+            {
+                FPs[row][col] = 0.0f;
+            }
+
+            for (int k = 0; k < STATES; k++)
+            {
+                for (int col = 0; col < STATES; col++)
+                {
+                    FPs[row][col] += Fs[row][k] * Ps[k][col];
+                }
+            }
+        }
+
+        for (int row = 0; row < STATES; row++)
+        {
+            for (int col = 0; col < STATES; col++)
+            {
+                float sum = 0.0f;
+
+                for (int k = 0; k < STATES; k++)
+                {
+                    sum += FPs[row][k] * Fs[col][k];
+                }
+
+                results[row][col] = sum;
+            }
+        }
+
+        Bench_KeepAlive(results);
+    });
+
+    double library = Bench_NanosecondsPerCall(LARGE_ITERATIONS, [&](long i)
+    {
+        F(0, 1) = varying(i, 0.005f);
+
+        Mat<STATES, STATES> result = multiplyTransposed(F * P, F);
+
+        Bench_KeepAlive(result);
+    });
+
+    Bench_Report("15x15 F * P * F^T, scalar", scalar);
+    Bench_Report("15x15 F * P * F^T, Mat", library);
+}
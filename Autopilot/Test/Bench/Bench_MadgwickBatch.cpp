@@ -0,0 +1,131 @@
+/**
+ * Throughput of the simulation farm's batched Madgwick filters, in filter updates per second on one core: one
+ * MadgwickFilter per simulated flight against the batch through its scalar and its vector kernel.
+ */
+
+#include "BenchTimer.hpp"
+#include "MadgwickBatch.hpp"
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define FILTERS 4096
+#define STEPS 200
+#define DT 0.005f
+
+struct FarmSamples
+{
+    std::vector<float> gx, gy, gz, ax, ay, az, mx, my, mz;
+};
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+static FarmSamples makeSamples(void);
+static void measure(const FarmSamples &samples, bool withMagnetometer);
+static void report(const char *name, double nanoseconds);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+int main(void)
+{
+    FarmSamples samples = makeSamples();
+
+    printf("%d filters, vector kernel %s\n", FILTERS, MadgwickBatch::hasVectorKernel() ? "built in" : "not built in");
+    printf("%-48s %10s %14s\n", "", "ns/update", "updates/s");
+
+    measure(samples, false);
+    measure(samples, true);
+
+    return 0;
+}
+
+// One sample per filter, each on its own motion. The same samples are fed at every step.
+static FarmSamples makeSamples(void)
+{
+    FarmSamples samples;
+
+    for (int f = 0; f < FILTERS; f++)
+    {
+        samples.gx.push_back(0.4f * sinf(0.37f * f));
+        samples.gy.push_back(0.3f * cosf(0.11f * f));
+        samples.gz.push_back(0.1f);
+        samples.ax.push_back(2.0f * sinf(0.05f * f));
+        samples.ay.push_back(1.5f * cosf(0.07f * f));
+        samples.az.push_back(9.81f);
+        samples.mx.push_back(0.3f * cosf(0.02f * f));
+        samples.my.push_back(0.2f);
+        samples.mz.push_back(-0.4f);
+    }
+
+    return samples;
+}
+
+static void measure(const FarmSamples &samples, bool withMagnetometer)
+{
+    std::vector<MadgwickFilter> filters(FILTERS);
+    MadgwickBatch batch(FILTERS);
+
+    MadgwickBatchSamples_t view = {
+        samples.gx.data(), samples.gy.data(), samples.gz.data(),
+        samples.ax.data(), samples.ay.data(), samples.az.data(),
+        withMagnetometer ? samples.mx.data() : nullptr,
+        withMagnetometer ? samples.my.data() : nullptr,
+        withMagnetometer ? samples.mz.data() : nullptr
+    };
+
+    printf("%s\n", withMagnetometer ? "with magnetometer" : "IMU only");
+
+    double scalar = Bench_NanosecondsPerCall(STEPS, [&](long) {
+        for (int f = 0; f < FILTERS; f++)
+        {
+            if (withMagnetometer)
+            {
+                filters[f].update(view.gx[f], view.gy[f], view.gz[f], view.ax[f], view.ay[f], view.az[f],
+                                  view.mx[f], view.my[f], view.mz[f], DT);
+            }
+            else
+            {
+                filters[f].updateIMU(view.gx[f], view.gy[f], view.gz[f], view.ax[f], view.ay[f], view.az[f], DT);
+            }
+        }
+
+        Bench_KeepAlive(filters[0]);
+    });
+
+    report("  MadgwickFilter per flight", scalar / FILTERS);
+
+    batch.setVectorKernel(false);
+
+    double batchScalar = Bench_NanosecondsPerCall(STEPS, [&](long) {
+        batch.update(view, DT);
+        Bench_KeepAlive(batch);
+    });
+
+    report("  MadgwickBatch, scalar kernel", batchScalar / FILTERS);
+
+    if (MadgwickBatch::hasVectorKernel())
+    {
+        batch.setVectorKernel(true);
+
+        double batchVector = Bench_NanosecondsPerCall(STEPS, [&](long) {
+            batch.update(view, DT);
+            Bench_KeepAlive(batch);
+        });
+
+        report("  MadgwickBatch, vector kernel", batchVector / FILTERS);
+    }
+}
+
+static void report(const char *name, double nanoseconds)
+{
+    printf("%-48s %10.2f %14.3g\n", name, nanoseconds, 1e9 / nanoseconds);
+}
@@ -0,0 +1,135 @@
+/**
+ * Cost of the table driven mixer for each preset and for a full 12 channel table, next to the hard coded
+ * conventional tail mixing that OutputMixing_Execute did before the mixer.
+ */
+
+#include "BenchTimer.hpp"
+#include "Mixer.hpp"
+#include "OutputMixing.hpp"
+
+#include <stdint.h>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define ITERATIONS 5000000L
+#define INPUTS 4093         // a prime, so the inputs do not line up with anything periodic in the code
+
+static PID_Output_t pidOutputs[INPUTS];
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+static void makeInputs(void);
+static void hardCodedConventional(const PID_Output_t *PidOutput, float *channelOut);
+static void measure(const char *name, const MixerConfig_t *config);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+int main(void)
+{
+    makeInputs();
+
+    int position = 0;
+
+    Bench_Report("hard coded conventional tail", Bench_NanosecondsPerCall(ITERATIONS, [&](long) {
+        float channelOut[NUM_MIXED_CHANNELS];
+        hardCodedConventional(&pidOutputs[position], channelOut);
+        position = (position + 1 == INPUTS) ? 0 : position + 1;
+        Bench_KeepAlive(channelOut);
+    }));
+
+    Bench_Report("OutputMixing_Execute", Bench_NanosecondsPerCall(ITERATIONS, [&](long) {
+        float channelOut[NUM_MIXED_CHANNELS];
+        OutputMixing_error_t error = OutputMixing_Execute(&pidOutputs[position], channelOut);
+        position = (position + 1 == INPUTS) ? 0 : position + 1;
+        Bench_KeepAlive(channelOut);
+        Bench_KeepAlive(error);
+    }));
+
+    measure("Mixer_Execute, conventional", Mixer_GetPreset(MIXER_PRESET_CONVENTIONAL));
+    measure("Mixer_Execute, V tail", Mixer_GetPreset(MIXER_PRESET_V_TAIL));
+    measure("Mixer_Execute, flying wing", Mixer_GetPreset(MIXER_PRESET_FLYING_WING));
+    measure("Mixer_Execute, quad X", Mixer_GetPreset(MIXER_PRESET_QUAD_X));
+
+    // Every channel uses every input, the worst case for a table
+    MixerConfig_t full = {};
+    full.numChannels = MIXER_MAX_CHANNELS;
+
+    for (int channel = 0; channel < MIXER_MAX_CHANNELS; channel++)
+    {
+        for (int input = 0; input < MIXER_NUM_INPUTS; input++)
+        {
+            full.weights[channel][input] = 0.1f * (channel + 1) - 0.05f * input;
+        }
+
+        full.trim[channel] = 0.5f * channel;
+        full.minOutput[channel] = -100.0f;
+        full.maxOutput[channel] = 100.0f;
+        full.reversed[channel] = (channel % 3) == 0;
+    }
+
+    measure("Mixer_Execute, 12 channels", &full);
+
+    return 0;
+}
+
+static void makeInputs(void)
+{
+    uint32_t seed = 1;
+
+    for (int i = 0; i < INPUTS; i++)
+    {
+        float values[4];
+
+        for (int input = 0; input < 4; input++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            values[input] = (float) (seed >> 8) / (float) (1u << 15) - 256.0f;
+        }
+
+        pidOutputs[i].rollPercent = values[0];
+        pidOutputs[i].pitchPercent = values[1];
+        pidOutputs[i].yawPercent = values[2];
+        pidOutputs[i].throttlePercent = 0.5f * values[3] + 128.0f;
+        pidOutputs[i].sampleTimeUs = i;
+    }
+}
+
+// What OutputMixing_Execute did for a conventional tail before the mixer, without the range check
+static void hardCodedConventional(const PID_Output_t *PidOutput, float *channelOut)
+{
+    channelOut[ELEVATOR_OUT_CHANNEL] = PidOutput->pitchPercent;
+    channelOut[RUDDER_OUT_CHANNEL] = PidOutput->yawPercent;
+    channelOut[AILERON_OUT_CHANNEL] = PidOutput->rollPercent;
+    channelOut[THROTTLE_OUT_CHANNEL] = PidOutput->throttlePercent;
+
+    for (int i = 0; i < 4; i++)
+    {
+        if (channelOut[i] < -100.0f)
+        {
+            channelOut[i] = -100.0f;
+        }
+        else if (channelOut[i] > 100.0f)
+        {
+            channelOut[i] = 100.0f;
+        }
+    }
+}
+
+static void measure(const char *name, const MixerConfig_t *config)
+{
+    int position = 0;
+
+    Bench_Report(name, Bench_NanosecondsPerCall(ITERATIONS, [&](long) {
+        float channelOut[MIXER_MAX_CHANNELS];
+        Mixer_error_t error = Mixer_Execute(config, &pidOutputs[position], channelOut);
+        position = (position + 1 == INPUTS) ? 0 : position + 1;
+        Bench_KeepAlive(channelOut);
+        Bench_KeepAlive(error);
+    }));
+}
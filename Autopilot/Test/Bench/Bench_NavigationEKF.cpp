@@ -0,0 +1,89 @@
+/**
+ * Cost of the NavigationEKF steps. Its accuracy against Madgwick on synthetic flights is in sensorFusionBench.
+ */
+
+#include "BenchTimer.hpp"
+#include "SensorFusion.hpp"
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define ITERATIONS 200000L
+
+#define START_LATITUDE 43.47
+#define START_LONGITUDE -80.54
+#define START_ALTITUDE 300.0
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+static void benchmarkSteps(void);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+int main(void)
+{
+    benchmarkSteps();
+
+    return 0;
+}
+
+
+
+static void benchmarkSteps(void)
+{
+    NavigationEKF ekf;
+    ekf.alignToGravity(0.0f, 0.0f, 9.81f);
+
+    GpsData_t gps = {};
+    gps.latitude = START_LATITUDE;
+    gps.longitude = START_LONGITUDE;
+    gps.altitude = (int) START_ALTITUDE;
+    gps.sensorStatus = 1;
+    gps.dataIsNew = true;
+
+    AltimeterData_t altimeter = {};
+    altimeter.altitude = START_ALTITUDE;
+    altimeter.isDataNew = true;
+
+    // Settle the covariance first so every update is accepted
+    for (int i = 0; i < 2000; i++)
+    {
+        ekf.predict(0.001f, 0.0f, 0.0f, 0.0f, 0.0f, 9.81f, 0.005f);
+        ekf.updateGravity(0.0f, 0.0f, 9.81f, 0.0f);
+        ekf.updateGps(gps);
+        ekf.updateAltimeter(altimeter);
+    }
+
+    printf("NavigationEKF, %d states\n", EKF_NUM_STATES);
+
+    Bench_Report("predict", Bench_NanosecondsPerCall(ITERATIONS, [&](long) {
+        ekf.predict(0.001f, 0.0f, 0.0f, 0.0f, 0.0f, 9.81f, 0.005f);
+    }));
+
+    Bench_Report("update gravity (3 scalars)", Bench_NanosecondsPerCall(ITERATIONS, [&](long) {
+        Bench_KeepAlive(ekf.updateGravity(0.0f, 0.0f, 9.81f, 0.0f));
+    }));
+
+    Bench_Report("update GPS (5 scalars)", Bench_NanosecondsPerCall(ITERATIONS, [&](long) {
+        Bench_KeepAlive(ekf.updateGps(gps));
+    }));
+
+    Bench_Report("update altimeter (1 scalar)", Bench_NanosecondsPerCall(ITERATIONS, [&](long) {
+        Bench_KeepAlive(ekf.updateAltimeter(altimeter));
+    }));
+
+    Bench_Report("update airspeed (1 scalar)", Bench_NanosecondsPerCall(ITERATIONS, [&](long) {
+        Bench_KeepAlive(ekf.updateAirspeed(20.0f));
+    }));
+
+    MadgwickFilter madgwick;
+
+    Bench_Report("Madgwick updateIMU, for reference", Bench_NanosecondsPerCall(ITERATIONS * 10, [&](long) {
+        madgwick.updateIMU(0.001f, 0.0f, 0.0f, 0.0f, 0.0f, 9.81f, 0.005f);
+    }));
+}
@@ -0,0 +1,151 @@
+/**
+ * Cost of a PIDBank pass against one PIDController::execute per axis, for the axes of PIDloopMode and for larger banks.
+ *
+ * The inputs change on every call. In the mixed case the measured rates are a mix of values and NaN, so the branches of
+ * PIDController see no pattern. The PIDloopMode case is the pattern of the attitude loop, roll and pitch with measured
+ * rates and the airspeed without, which the branch predictor learns.
+ */
+
+#include "BenchTimer.hpp"
+#include "PID.hpp"
+#include "PIDBank.hpp"
+
+#include <cmath>
+#include <stdint.h>
+#include <vector>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define ITERATIONS 2000000L
+#define INPUTS 4093         // a prime, so the sequence each axis sees is too long for the branch predictor to learn
+#define MAX_AXES 8
+
+// Each call takes the next N inputs, running on past INPUTS rather than wrapping within a call
+static float desiredInputs[INPUTS + MAX_AXES];
+static float actualInputs[INPUTS + MAX_AXES];
+static float rateInputs[INPUTS + MAX_AXES];
+static float measuredRateInputs[INPUTS + MAX_AXES];
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+static void makeInputs(void);
+
+template <int N>
+static void measure(void);
+static void measurePIDloopMode(void);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+int main(void)
+{
+    makeInputs();
+
+    measurePIDloopMode();
+    measure<3>();
+    measure<4>();
+    measure<MAX_AXES>();
+
+    return 0;
+}
+
+static void makeInputs(void)
+{
+    uint32_t seed = 1;
+
+    for (int i = 0; i < INPUTS + MAX_AXES; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        desiredInputs[i] = (float) (seed >> 8) / (float) (1u << 18) - 32.0f;
+        seed = seed * 1664525u + 1013904223u;
+        actualInputs[i] = (float) (seed >> 8) / (float) (1u << 18) - 32.0f;
+        seed = seed * 1664525u + 1013904223u;
+        measuredRateInputs[i] = (float) (seed >> 8) / (float) (1u << 20) - 8.0f;
+        rateInputs[i] = ((seed >> 28) < 5) ? std::nanf("") : measuredRateInputs[i];
+    }
+}
+
+template <int N>
+static void measure(void)
+{
+    std::vector<PIDController> controllers;
+    PIDBank<N> bank;
+
+    for (int axis = 0; axis < N; axis++)
+    {
+        controllers.push_back(PIDController(1.0f + axis, 0.1f, 0.5f, 20.0f, -100.0f, 100.0f));
+        bank.setAxis(axis, 1.0f + axis, 0.1f, 0.5f, 20.0f, -100.0f, 100.0f);
+    }
+
+    printf("%d axes, mixed measured and computed derivatives\n", N);
+
+    int position = 0;
+
+    Bench_Report("  PIDController::execute per axis", Bench_NanosecondsPerCall(ITERATIONS, [&](long) {
+        float output[N];
+
+        for (int axis = 0; axis < N; axis++)
+        {
+            int input = position + axis;
+            output[axis] = controllers[axis].execute(desiredInputs[input], actualInputs[input], rateInputs[input]);
+        }
+
+        position += N;
+        position -= (position >= INPUTS) ? INPUTS : 0;
+        Bench_KeepAlive(output);
+    }));
+
+    Bench_Report("  PIDBank::execute", Bench_NanosecondsPerCall(ITERATIONS, [&](long) {
+        float output[N];
+
+        bank.execute(&desiredInputs[position], &actualInputs[position], &rateInputs[position], output);
+
+        position += N;
+        position -= (position >= INPUTS) ? INPUTS : 0;
+        Bench_KeepAlive(output);
+    }));
+}
+
+static void measurePIDloopMode(void)
+{
+    PIDController rollPid{1, 0, 0, 0, -100, 100};
+    PIDController pitchPid{1, 0, 0, 0, -100, 100};
+    PIDController airspeedPid{1, 0, 0, 0, 0, 100};
+
+    PIDBank<3> bank;
+    bank.setAxis(0, 1, 0, 0, 0, -100, 100);
+    bank.setAxis(1, 1, 0, 0, 0, -100, 100);
+    bank.setAxis(2, 1, 0, 0, 0, 0, 100);
+
+    printf("PIDloopMode, roll and pitch measured, airspeed computed\n");
+
+    int position = 0;
+
+    Bench_Report("  PIDController::execute per axis", Bench_NanosecondsPerCall(ITERATIONS, [&](long) {
+        float output[3];
+
+        output[0] = rollPid.execute(desiredInputs[position], actualInputs[position], measuredRateInputs[position]);
+        output[1] = pitchPid.execute(desiredInputs[position + 1], actualInputs[position + 1], measuredRateInputs[position + 1]);
+        output[2] = airspeedPid.execute(desiredInputs[position + 2], actualInputs[position + 2]);
+
+        position += 3;
+        position -= (position >= INPUTS) ? INPUTS : 0;
+        Bench_KeepAlive(output);
+    }));
+
+    Bench_Report("  PIDBank::execute", Bench_NanosecondsPerCall(ITERATIONS, [&](long) {
+        const float rates[3] = {measuredRateInputs[position], measuredRateInputs[position + 1], std::nanf("")};
+        float output[3];
+
+        bank.execute(&desiredInputs[position], &actualInputs[position], rates, output);
+
+        position += 3;
+        position -= (position >= INPUTS) ? INPUTS : 0;
+        Bench_KeepAlive(output);
+    }));
+}
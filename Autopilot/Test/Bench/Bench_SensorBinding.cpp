@@ -0,0 +1,80 @@
+/**
+ * Compares fetching the sensor data through the IMU/airspeed base classes (SensorMeasurements_GetResult) with the
+ * compile time binding used by flight code (SensorMeasurements_Fetch on final driver classes).
+ */
+
+#include "BenchTimer.hpp"
+#include "fetchSensorMeasurementsMode.hpp"
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define ITERATIONS 20000000L
+
+// Cheap stand-ins for real drivers, so the call overhead is not hidden behind bus transfers
+class BenchIMU final : public IMU
+{
+    public:
+        void Begin_Measuring() {}
+        void GetResult(IMUData_t &Data)
+        {
+            counter++;
+
+            Data.magx = Data.magy = Data.magz = 0.0f;
+            Data.accx = Data.accy = 0.0f;
+            Data.accz = 9.81f;
+            Data.gyrx = (float) counter;
+            Data.gyry = Data.gyrz = 0.0f;
+            Data.isDataNew = true;
+            Data.sensorStatus = 0;
+            Data.utcTime = 0.0f;
+            Data.sampleTimeUs = counter;
+        }
+
+        uint32_t counter = 0;
+};
+
+class BenchAirspeed final : public airspeed
+{
+    public:
+        void Begin_Measuring() {}
+        void GetResult(airspeedData_t &Data)
+        {
+            Data.airspeed = 20.0;
+            Data.sensorStatus = 0;
+            Data.isDataNew = true;
+            Data.utcTime = 0.0f;
+        }
+};
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+int main(void)
+{
+    BenchIMU imu;
+    BenchAirspeed airspeedSensor;
+    IMU_Data_t imudata;
+    Airspeed_Data_t airspeeddata;
+
+    double dynamicBinding = Bench_NanosecondsPerCall(ITERATIONS, [&](long)
+    {
+        SensorError_t error = DynamicSensorBinding<BenchIMU, BenchAirspeed>::fetch(imu, airspeedSensor, &imudata, &airspeeddata);
+        Bench_KeepAlive(error);
+        Bench_KeepAlive(imudata);
+    });
+
+    double staticBinding = Bench_NanosecondsPerCall(ITERATIONS, [&](long)
+    {
+        SensorError_t error = StaticSensorBinding<BenchIMU, BenchAirspeed>::fetch(imu, airspeedSensor, &imudata, &airspeeddata);
+        Bench_KeepAlive(error);
+        Bench_KeepAlive(imudata);
+    });
+
+    Bench_Report("dynamic binding (SensorMeasurements_GetResult)", dynamicBinding);
+    Bench_Report("static binding (SensorMeasurements_Fetch)", staticBinding);
+
+    return 0;
+}
@@ -0,0 +1,181 @@
+/**
+ * Accuracy against CPU time of the sensor fusion engines and their configurations, on the synthetic flights of
+ * SyntheticFlight.hpp.
+ *
+ * Every configuration runs through SF_GetResultFrom on the same samples, so the errors are those of the SFOutput_t the
+ * PIDs would see. The time per update is of the whole fusion step, including the IMU pre-filtering where a
+ * configuration has it, and is the fastest of a few runs over the flight.
+ */
+
+#include "BenchTimer.hpp"
+#include "SensorFusion.hpp"
+#include "ImuFilter.hpp"
+#include "SyntheticFlight.hpp"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define DURATION_S 60
+#define SETTLING_S 5        // errors before this are not counted
+#define REPETITIONS 5
+
+struct FusionConfig_t
+{
+    const char *name;
+    SFEngine_t engine;
+    float beta;             // Madgwick gain
+    bool imuFilter;         // ImuFilter in front, as in the measurement stage
+    bool aided;             // GPS and barometer to the EKF
+};
+
+static const FusionConfig_t CONFIGS[] = {
+    {"Madgwick, beta 0.033", SF_ENGINE_MADGWICK, 0.033f, false, false},
+    {"Madgwick, beta 0.1", SF_ENGINE_MADGWICK, 0.1f, false, false},
+    {"Madgwick, beta 0.3", SF_ENGINE_MADGWICK, 0.3f, false, false},
+    {"Madgwick, beta 0.1, ImuFilter", SF_ENGINE_MADGWICK, 0.1f, true, false},
+    {"EKF, IMU + airspeed", SF_ENGINE_EKF, 0.0f, false, false},
+    {"EKF, IMU + airspeed, ImuFilter", SF_ENGINE_EKF, 0.0f, true, false},
+    {"EKF, GPS + baro + airspeed", SF_ENGINE_EKF, 0.0f, false, true},
+};
+
+#define NUM_CONFIGS ((int) (sizeof(CONFIGS) / sizeof(CONFIGS[0])))
+
+struct FusionResult_t
+{
+    double tiltRms, tiltMax;            // deg
+    double headingRms, headingMax;      // deg
+    double microsecondsPerUpdate;
+};
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+static std::vector<SyntheticSample_t> generate(SyntheticTrajectory_t trajectory);
+static FusionResult_t run(const FusionConfig_t &config, const std::vector<SyntheticSample_t> &samples);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+int main(void)
+{
+    SyntheticFlightConfig_t flightConfig = SyntheticFlight_DefaultConfig();
+
+    printf("%d s at %.0f Hz, errors after %d s settling, deg\n", DURATION_S, flightConfig.rateHz, SETTLING_S);
+    printf("%-18s %-32s %9s %9s %9s %9s %11s\n", "flight", "fusion", "tilt rms", "tilt max", "hdg rms", "hdg max",
+           "us/update");
+
+    for (int trajectory = 0; trajectory < SYNTHETIC_NUM_TRAJECTORIES; trajectory++)
+    {
+        std::vector<SyntheticSample_t> samples = generate((SyntheticTrajectory_t) trajectory);
+
+        for (int c = 0; c < NUM_CONFIGS; c++)
+        {
+            FusionResult_t result = run(CONFIGS[c], samples);
+
+            printf("%-18s %-32s %9.2f %9.2f %9.2f %9.2f %11.3f\n",
+                   (c == 0) ? SyntheticFlight_Name((SyntheticTrajectory_t) trajectory) : "", CONFIGS[c].name,
+                   result.tiltRms, result.tiltMax, result.headingRms, result.headingMax, result.microsecondsPerUpdate);
+        }
+
+        printf("\n");
+    }
+
+    return 0;
+}
+
+static std::vector<SyntheticSample_t> generate(SyntheticTrajectory_t trajectory)
+{
+    SyntheticFlightConfig_t config = SyntheticFlight_DefaultConfig();
+    SyntheticFlight flight(trajectory, config);
+
+    std::vector<SyntheticSample_t> samples(DURATION_S * (int) config.rateHz);
+
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        flight.next(samples[i]);
+    }
+
+    return samples;
+}
+
+static FusionResult_t run(const FusionConfig_t &config, const std::vector<SyntheticSample_t> &samples)
+{
+    std::vector<SFOutput_t> outputs(samples.size());
+    double fastest = 0.0;
+
+    for (int repetition = 0; repetition < REPETITIONS; repetition++)
+    {
+        // SF_GetResultFrom and the ImuFilter change the samples they are given
+        std::vector<SyntheticSample_t> inputs = samples;
+
+        MadgwickFilter madgwick(SyntheticFlight_DefaultConfig().rateHz, config.beta);
+        NavigationEKF ekf;
+        ImuFilter imuFilter;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        for (size_t i = 0; i < inputs.size(); i++)
+        {
+            SyntheticSample_t &sample = inputs[i];
+
+            if (config.imuFilter)
+            {
+                imuFilter.apply(sample.imu);
+            }
+
+            if (config.engine == SF_ENGINE_EKF)
+            {
+                SF_GetResultFrom(ekf, &outputs[i], &sample.imu, &sample.airspeed,
+                                 (config.aided && sample.gpsIsNew) ? &sample.gps : nullptr,
+                                 (config.aided && sample.altimeterIsNew) ? &sample.altimeter : nullptr);
+            }
+            else
+            {
+                SF_GetResultFrom(madgwick, &outputs[i], &sample.imu, &sample.airspeed);
+            }
+        }
+
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        double perUpdate = elapsed.count() / inputs.size();
+
+        Bench_KeepAlive(outputs.back());
+
+        fastest = (repetition == 0 || perUpdate < fastest) ? perUpdate : fastest;
+    }
+
+    FusionResult_t result = {};
+    double tiltSum = 0.0;
+    double headingSum = 0.0;
+    int counted = 0;
+
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        if (samples[i].truth.time < SETTLING_S)
+        {
+            continue;
+        }
+
+        double tilt = SyntheticFlight_TiltError(samples[i].truth, outputs[i]);
+        double heading = fabs(SyntheticFlight_HeadingError(samples[i].truth, outputs[i]));
+
+        tiltSum += tilt * tilt;
+        headingSum += heading * heading;
+        result.tiltMax = (tilt > result.tiltMax) ? tilt : result.tiltMax;
+        result.headingMax = (heading > result.headingMax) ? heading : result.headingMax;
+        counted++;
+    }
+
+    result.tiltRms = sqrt(tiltSum / counted);
+    result.headingRms = sqrt(headingSum / counted);
+    result.microsecondsPerUpdate = fastest;
+
+    return result;
+}
@@ -0,0 +1,90 @@
+/**
+ * Cost per control cycle of VibrationAnalyser: the worst and the average step at the default budget, against doing a
+ * whole analysis in the cycle its window fills.
+ *
+ * The input is the same on every repetition, so each cycle does the same work every time. Keeping the fastest of the
+ * repetitions for each cycle takes the preemptions by the host out of the worst case.
+ */
+
+#include "BenchTimer.hpp"
+#include "VibrationAnalyser.hpp"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define SAMPLE_RATE_HZ 200.0f
+#define CYCLES 20000
+#define REPETITIONS 5
+#define PI_F 3.14159265f
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+static void measure(const char *name, int workPerStep);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+int main(void)
+{
+    printf("%-48s %10s %10s %12s\n", "per cycle", "mean ns", "worst ns", "analyses");
+
+    measure("default budget", VibrationAnalyser_DefaultConfig(SAMPLE_RATE_HZ).workPerStep);
+    measure("budget of 8", 8);
+    measure("whole analysis in one cycle", 100000);
+
+    return 0;
+}
+
+static void measure(const char *name, int workPerStep)
+{
+    VibrationAnalyserConfig_t config = VibrationAnalyser_DefaultConfig(SAMPLE_RATE_HZ);
+    config.workPerStep = workPerStep;
+
+    static double fastest[CYCLES];
+    uint32_t analyses = 0;
+
+    for (int repetition = 0; repetition < REPETITIONS; repetition++)
+    {
+        VibrationAnalyser analyser(config);
+
+        for (int i = 0; i < CYCLES; i++)
+        {
+            float gyro[VIBRATION_AXES] = {
+                sinf(2.0f * PI_F * 47.0f * i / SAMPLE_RATE_HZ),
+                sinf(2.0f * PI_F * 63.0f * i / SAMPLE_RATE_HZ),
+                0.1f * sinf(0.37f * i)
+            };
+
+            analyser.addSample(gyro);
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            int axis = analyser.step();
+            std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+            Bench_KeepAlive(axis);
+
+            fastest[i] = (repetition == 0 || elapsed.count() < fastest[i]) ? elapsed.count() : fastest[i];
+        }
+
+        analyses = analyser.getAnalysisCount();
+    }
+
+    double total = 0.0;
+    double worst = 0.0;
+
+    for (int i = 0; i < CYCLES; i++)
+    {
+        total += fastest[i];
+        worst = (fastest[i] > worst) ? fastest[i] : worst;
+    }
+
+    printf("%-48s %10.1f %10.1f %12u\n", name, total / CYCLES, worst, (unsigned) analyses);
+}
@@ -0,0 +1,139 @@
+/**
+ * A fixed wing aircraft linearised about level cruise, for closing the loop around the attitude controller on the host.
+ *
+ * The three axes are decoupled except through gravity:
+ *  - roll      rolling moment from the aileron against roll damping, the roll angle integrating the roll rate
+ *  - pitch     the short period: angle of attack and pitch rate driven by the elevator, the pitch angle integrating
+ *              the pitch rate
+ *  - airspeed  thrust from the throttle against a drag proportional to airspeed, and gravity along the flight path
+ *
+ * Each actuator follows its command with a first order lag. The state is integrated with semi implicit Euler steps
+ * of PLANT_STEP_S. The measurements are in the units SF_GetResult produces: degrees, degrees per second and m/s.
+ */
+
+#ifndef LINEARISED_PLANT_HPP
+#define LINEARISED_PLANT_HPP
+
+#include "SensorFusion.hpp"
+
+#include <math.h>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define PLANT_GRAVITY 9.80665
+#define PLANT_RAD_TO_DEG (180.0 / 3.14159265358979)
+#define PLANT_STEP_S 0.001
+
+struct LinearisedPlantConfig_t
+{
+    double rollDamping;         // 1/s
+    double aileronPower;        // rad/s^2 per percent of aileron
+
+    double alphaDecay;          // 1/s, lift bringing the angle of attack back
+    double pitchDamping;        // 1/s
+    double pitchStiffness;      // 1/s^2, per radian of angle of attack
+    double elevatorPower;       // rad/s^2 per percent of elevator
+
+    double dragDecay;           // 1/s
+    double thrustPower;         // m/s^2 per percent of throttle
+
+    double servoTimeConstant;   // s
+};
+
+struct LinearisedPlantState_t
+{
+    double roll, rollRate;                  // rad, rad/s
+    double alpha, pitch, pitchRate;         // rad, rad, rad/s
+    double airspeed;                        // m/s
+    double aileron, elevator, throttle;     // percent, where the actuators are
+};
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+// A small electric trainer: 3 rad/s of roll rate and 30 m/s of airspeed at full deflection and throttle
+inline LinearisedPlantConfig_t LinearisedPlant_DefaultConfig()
+{
+    LinearisedPlantConfig_t config = {
+        8.0, 0.25,
+        2.0, 4.0, 20.0, 0.3,
+        0.1, 0.03,
+        0.03
+    };
+
+    return config;
+}
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+class LinearisedPlant
+{
+    public:
+        explicit LinearisedPlant(const LinearisedPlantConfig_t &_config = LinearisedPlant_DefaultConfig()) : config(_config), state() {}
+
+        // Level flight at the given airspeed, with the throttle that holds it
+        void trim(double airspeed)
+        {
+            state = LinearisedPlantState_t();
+            state.airspeed = airspeed;
+            state.throttle = airspeed * config.dragDecay / config.thrustPower;
+        }
+
+        /**
+        * Moves the actuators towards the commands and the aircraft with them, for duration seconds.
+        * @param[in]    aileron, elevator, throttle     percent, as mixed for the channels.
+        * @param[in]    duration                        s, rounded to a whole number of PLANT_STEP_S.
+        */
+        void advance(float aileron, float elevator, float throttle, double duration)
+        {
+            int steps = (int) (duration / PLANT_STEP_S + 0.5);
+            double servoGain = PLANT_STEP_S / (config.servoTimeConstant + PLANT_STEP_S);
+
+            for (int i = 0; i < steps; i++)
+            {
+                state.aileron += (aileron - state.aileron) * servoGain;
+                state.elevator += (elevator - state.elevator) * servoGain;
+                state.throttle += (throttle - state.throttle) * servoGain;
+
+                state.rollRate += (config.aileronPower * state.aileron - config.rollDamping * state.rollRate) * PLANT_STEP_S;
+                state.roll += state.rollRate * PLANT_STEP_S;
+
+                state.pitchRate += (config.elevatorPower * state.elevator - config.pitchDamping * state.pitchRate
+                                    - config.pitchStiffness * state.alpha) * PLANT_STEP_S;
+                state.alpha += (state.pitchRate - config.alphaDecay * state.alpha) * PLANT_STEP_S;
+                state.pitch += state.pitchRate * PLANT_STEP_S;
+
+                state.airspeed += (config.thrustPower * state.throttle - config.dragDecay * state.airspeed
+                                   - PLANT_GRAVITY * (state.pitch - state.alpha)) * PLANT_STEP_S;
+            }
+        }
+
+        /**
+        * @param[out]   output      the attitude, rates and airspeed as sensor fusion would give them, without errors.
+        * @param[in]    timeUs      stamped on the output.
+        */
+        void measure(SFOutput_t &output, uint32_t timeUs) const
+        {
+            output.IMUroll = (float) (state.roll * PLANT_RAD_TO_DEG);
+            output.IMUpitch = (float) (state.pitch * PLANT_RAD_TO_DEG);
+            output.IMUyaw = 0.0f;
+            output.IMUrollrate = (float) (state.rollRate * PLANT_RAD_TO_DEG);
+            output.IMUpitchrate = (float) (state.pitchRate * PLANT_RAD_TO_DEG);
+            output.IMUyawrate = 0.0f;
+            output.Airspeed = (float) state.airspeed;
+            output.sampleTimeUs = timeUs;
+        }
+
+        const LinearisedPlantState_t& getState() const {return state;}
+
+    private:
+        LinearisedPlantConfig_t config;
+        LinearisedPlantState_t state;
+};
+
+#endif
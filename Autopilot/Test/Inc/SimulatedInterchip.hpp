@@ -0,0 +1,193 @@
+/**
+ * A discrete event simulation of the autopilot end of the interchip link, for measuring on the host how long a frame
+ * committed by the attitude pipeline takes to get to the safety chip.
+ *
+ * The attitude pipeline commits a frame every commitPeriodUs, up to commitJitterUs late. The interchip task runs in
+ * zero time whenever it wakes, and its timed waits end on RTOS ticks as they do on the target. The simulated SPI takes
+ * transferUs per packet and carries the last frame committed before the transfer started. Two task loops:
+ *  - polling       the task wakes every pollPeriodUs and starts a transfer if none is on the wire
+ *  - event driven  the task sleeps on the events of InterchipPacer.h, as Interchip_Run does
+ */
+
+#ifndef SIMULATED_INTERCHIP_HPP
+#define SIMULATED_INTERCHIP_HPP
+
+#include "InterchipPacer.h"
+#include "Interchip_A.h"
+
+#include <stdint.h>
+#include <vector>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+enum SimulatedInterchipLoop_t {SIMULATED_INTERCHIP_POLLING = 0, SIMULATED_INTERCHIP_EVENT_DRIVEN};
+
+struct SimulatedInterchipConfig_t
+{
+    uint32_t commitPeriodUs;        // 0 for no commits at all
+    uint32_t commitPhaseUs;         // of the first commit against the RTOS ticks
+    uint32_t commitJitterUs;
+    uint32_t transferUs;            // one packet on the wire
+    uint32_t tickUs;
+    uint32_t pollPeriodUs;          // the osDelay of the polling loop
+    uint32_t minIntervalUs;         // of the pacer
+    uint32_t keepAliveUs;
+};
+
+struct SimulatedInterchipResult_t
+{
+    std::vector<uint32_t> latenciesUs;  // from each commit to the end of the transfer that carried it
+    int commits;
+    int superseded;                     // frames overwritten by the next commit before they went out
+    int transfers;
+    int taskWakeUps;
+    uint32_t minStartSpacingUs;         // between the starts of two transfers
+};
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+// The attitude task at 200 Hz, and 36 byte packets on SPI1 at 108 MHz / 64
+inline SimulatedInterchipConfig_t SimulatedInterchip_DefaultConfig()
+{
+    SimulatedInterchipConfig_t config = {
+        5000, 0, 200,
+        171, 1000,
+        5000, INTERCHIP_MIN_INTERVAL_US, INTERCHIP_KEEP_ALIVE_US
+    };
+
+    return config;
+}
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+inline SimulatedInterchipResult_t SimulatedInterchip_Run(SimulatedInterchipLoop_t loop, const SimulatedInterchipConfig_t &config, uint64_t durationUs)
+{
+    const uint64_t NEVER = UINT64_MAX;
+
+    SimulatedInterchipResult_t result;
+    result.commits = 0;
+    result.superseded = 0;
+    result.transfers = 0;
+    result.taskWakeUps = 0;
+    result.minStartSpacingUs = UINT32_MAX;
+
+    InterchipPacer_t pacer;
+    InterchipPacer_Init(&pacer, config.minIntervalUs, config.keepAliveUs);
+
+    uint32_t jitterState = 12345;
+    uint64_t commitIndex = 0;
+    uint64_t nextCommitUs = (config.commitPeriodUs > 0) ? config.commitPhaseUs : NEVER;
+    uint64_t transferEndUs = NEVER;
+    uint64_t taskWakeUs = 0;
+    uint64_t lastStartUs = NEVER;
+    uint32_t events = 0;
+
+    bool hasPending = false, wireHasFrame = false;
+    uint64_t pendingCommitUs = 0, wireCommitUs = 0;
+
+    // Timed waits end on the tick interrupt, after the requested time rounded up to whole ticks
+    auto tickAfter = [&](uint64_t nowUs, uint64_t waitUs) {
+        uint64_t ticks = (waitUs + config.tickUs - 1) / config.tickUs;
+        return (nowUs / config.tickUs + ticks) * config.tickUs;
+    };
+
+    auto startTransfer = [&](uint64_t nowUs) {
+        wireHasFrame = hasPending;
+        wireCommitUs = pendingCommitUs;
+        hasPending = false;
+
+        if (lastStartUs != NEVER)
+        {
+            uint64_t spacing = nowUs - lastStartUs;
+            result.minStartSpacingUs = (spacing < result.minStartSpacingUs) ? (uint32_t) spacing : result.minStartSpacingUs;
+        }
+
+        lastStartUs = nowUs;
+        transferEndUs = nowUs + config.transferUs;
+        result.transfers++;
+    };
+
+    while (true)
+    {
+        uint64_t nowUs = transferEndUs;
+        nowUs = (nextCommitUs < nowUs) ? nextCommitUs : nowUs;
+        nowUs = (taskWakeUs < nowUs) ? taskWakeUs : nowUs;
+
+        if (nowUs >= durationUs)
+        {
+            break;
+        }
+
+        if (nowUs == transferEndUs)
+        {
+            if (wireHasFrame)
+            {
+                result.latenciesUs.push_back((uint32_t) (nowUs - wireCommitUs));
+            }
+
+            transferEndUs = NEVER;
+
+            if (loop == SIMULATED_INTERCHIP_EVENT_DRIVEN)
+            {
+                events |= INTERCHIP_EVENT_TRANSFER_DONE;
+                taskWakeUs = nowUs;
+            }
+        }
+        else if (nowUs == nextCommitUs)
+        {
+            result.superseded += hasPending ? 1 : 0;
+            result.commits++;
+            hasPending = true;
+            pendingCommitUs = nowUs;
+
+            commitIndex++;
+            jitterState = jitterState * 1103515245u + 12345u;
+            nextCommitUs = config.commitPhaseUs + commitIndex * config.commitPeriodUs
+                           + (config.commitJitterUs > 0 ? (jitterState >> 8) % config.commitJitterUs : 0);
+
+            if (loop == SIMULATED_INTERCHIP_EVENT_DRIVEN)
+            {
+                events |= INTERCHIP_EVENT_FRAME;
+                taskWakeUs = nowUs;
+            }
+        }
+        else
+        {
+            result.taskWakeUps++;
+
+            if (loop == SIMULATED_INTERCHIP_POLLING)
+            {
+                if (transferEndUs == NEVER)
+                {
+                    startTransfer(nowUs);
+                }
+
+                taskWakeUs = tickAfter(nowUs, config.pollPeriodUs);
+            }
+            else
+            {
+                uint32_t waitUs;
+
+                InterchipPacer_OnEvents(&pacer, events);
+                events = 0;
+
+                if (InterchipPacer_Poll(&pacer, (uint32_t) nowUs, &waitUs))
+                {
+                    startTransfer(nowUs);
+                }
+
+                taskWakeUs = tickAfter(nowUs, waitUs);
+            }
+        }
+    }
+
+    return result;
+}
+
+#endif
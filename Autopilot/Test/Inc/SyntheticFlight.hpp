@@ -0,0 +1,382 @@
+/**
+ * Synthetic sensor streams along known attitude trajectories, for measuring sensor fusion against the truth.
+ *
+ * Each trajectory is an analytic attitude in time, flown at a constant airspeed with the velocity along the nose
+ * (no angle of attack or sideslip). The IMU samples are derived from the true attitude and velocity: the gyro is the
+ * body rate between consecutive attitudes, the accelerometer the specific force in the body frame. Constant biases and
+ * white noise are added to both, and noise to the airspeed. GPS and barometer readings come at a fraction of the rate.
+ *
+ * The noise is a reproducible sequence from the seed, so two runs of the same flight see the same samples.
+ */
+
+#ifndef SYNTHETIC_FLIGHT_HPP
+#define SYNTHETIC_FLIGHT_HPP
+
+#include "SensorFusion.hpp"
+
+#include <math.h>
+#include <stdint.h>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define SYNTHETIC_GRAVITY 9.80665
+#define SYNTHETIC_PI 3.14159265358979
+#define SYNTHETIC_DEG_TO_RAD (SYNTHETIC_PI / 180.0)
+#define SYNTHETIC_EARTH_RADIUS 6371000.0
+
+#define SYNTHETIC_CRUISE_SPEED 20.0     // m/s
+#define SYNTHETIC_START_LATITUDE 43.47
+#define SYNTHETIC_START_LONGITUDE -80.54
+#define SYNTHETIC_START_ALTITUDE 300.0
+
+enum SyntheticTrajectory_t
+{
+    SYNTHETIC_LEVEL_CRUISE = 0,
+    SYNTHETIC_ROLL_DOUBLETS,            // +-30 degrees at 0.2 Hz, heading held
+    SYNTHETIC_COORDINATED_TURN,         // straight for 10 s, then a 30 degree banked turn
+    SYNTHETIC_CLIMB,                    // 10 degree climb from 10 s to 40 s
+    SYNTHETIC_AILERON_ROLLS,            // a full roll in 4 s, every 15 s from 10 s
+    SYNTHETIC_NUM_TRAJECTORIES
+};
+
+struct SyntheticFlightConfig_t
+{
+    float rateHz;                       // IMU and airspeed samples
+
+    float gyroNoise;                    // rad/s per sample
+    float gyroBias[3];
+    float accelNoise;                   // m/s^2 per sample
+    float accelBias[3];
+    float airspeedNoise;                // m/s
+
+    int gpsDivider;                     // a GPS fix every gpsDivider samples, 0 for none
+    float gpsNoise;                     // m
+    float gpsSpeedNoise;                // m/s
+    int altimeterDivider;               // 0 for none
+    float altimeterNoise;               // m
+
+    uint32_t seed;
+};
+
+struct SyntheticTruth_t
+{
+    double time;                        // s
+    double roll, pitch, yaw;            // rad, yaw positive to the left as the filters have it
+    double quaternion[4];               // earth (north west up) to body
+    double velocity[3];                 // m/s, north west up
+    double position[3];                 // m
+};
+
+struct SyntheticSample_t
+{
+    SyntheticTruth_t truth;
+
+    IMU_Data_t imu;
+    Airspeed_Data_t airspeed;
+
+    bool gpsIsNew;
+    GpsData_t gps;
+    bool altimeterIsNew;
+    AltimeterData_t altimeter;
+};
+
+/***********************************************************************************************************************
+ * Prototypes
+ **********************************************************************************************************************/
+
+// 200 Hz, the noise and biases of the attitude benchmarks, GPS at 5 Hz and the barometer at 10 Hz
+inline SyntheticFlightConfig_t SyntheticFlight_DefaultConfig()
+{
+    SyntheticFlightConfig_t config = {
+        200.0f,
+        0.003f, {0.01f, -0.008f, 0.005f},
+        0.05f, {0.05f, -0.05f, 0.1f},
+        0.5f,
+        40, 1.5f, 0.1f,
+        20, 0.5f,
+        12345u
+    };
+
+    return config;
+}
+
+inline const char* SyntheticFlight_Name(SyntheticTrajectory_t trajectory)
+{
+    static const char *NAMES[SYNTHETIC_NUM_TRAJECTORIES] = {
+        "level cruise", "roll doublets", "coordinated turn", "climb", "aileron rolls"
+    };
+
+    return (trajectory < SYNTHETIC_NUM_TRAJECTORIES) ? NAMES[trajectory] : "";
+}
+
+/**
+* Angle between the true and the estimated direction of gravity, that is the roll and pitch error together without
+* the singularities of the Euler angles.
+* @param[in]    truth       from the sample the output was computed from.
+* @param[in]    output      of SF_GetResult or SF_GetResultFrom, in degrees.
+* @return                   degrees.
+*/
+inline double SyntheticFlight_TiltError(const SyntheticTruth_t &truth, const SFOutput_t &output);
+
+// Heading error in degrees, in [-180, 180]
+inline double SyntheticFlight_HeadingError(const SyntheticTruth_t &truth, const SFOutput_t &output);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+class SyntheticFlight
+{
+    public:
+        explicit SyntheticFlight(SyntheticTrajectory_t _trajectory,
+                                 const SyntheticFlightConfig_t &_config = SyntheticFlight_DefaultConfig());
+
+        // Advances the flight by one sample period and returns the truth and the measurements at the new time
+        void next(SyntheticSample_t &sample);
+
+        // White noise of the given standard deviation from the flight's sequence
+        float gaussian(float sigma);
+
+        static void eulerToQuaternion(double roll, double pitch, double yaw, double q[4]);
+        static void rotateToBody(const double q[4], const double earth[3], double body[3]);
+
+    private:
+        void advanceTruth(double dt);
+        static double smoothStep(double t, double start, double duration);
+
+        SyntheticTrajectory_t trajectory;
+        SyntheticFlightConfig_t config;
+        uint32_t noiseState;
+        long sampleCount;
+        SyntheticTruth_t truth;
+};
+
+inline SyntheticFlight::SyntheticFlight(SyntheticTrajectory_t _trajectory, const SyntheticFlightConfig_t &_config) :
+    trajectory(_trajectory), config(_config), noiseState(_config.seed), sampleCount(0), truth()
+{
+    truth.position[2] = SYNTHETIC_START_ALTITUDE;
+    advanceTruth(0.0);
+}
+
+inline float SyntheticFlight::gaussian(float sigma)
+{
+    double sum = 0.0;
+
+    // Sum of uniforms, close enough to normal for this
+    for (int i = 0; i < 12; i++)
+    {
+        noiseState = noiseState * 1664525u + 1013904223u;
+        sum += (double) noiseState / 4294967296.0;
+    }
+
+    return (float) ((sum - 6.0) * sigma);
+}
+
+inline void SyntheticFlight::next(SyntheticSample_t &sample)
+{
+    const double dt = 1.0 / config.rateHz;
+
+    const SyntheticTruth_t previous = truth;
+
+    sampleCount++;
+    truth.time = sampleCount * dt;
+    advanceTruth(dt);
+
+    // Body rate that takes the previous attitude to this one, from conj(previous) * current
+    const double *from = previous.quaternion;
+    const double *to = truth.quaternion;
+
+    double w = from[0] * to[0] + from[1] * to[1] + from[2] * to[2] + from[3] * to[3];
+    double sign = (w < 0) ? -1.0 : 1.0;
+    double rate[3] = {
+        2.0 * sign * (from[0] * to[1] - from[1] * to[0] - from[2] * to[3] + from[3] * to[2]) / dt,
+        2.0 * sign * (from[0] * to[2] + from[1] * to[3] - from[2] * to[0] - from[3] * to[1]) / dt,
+        2.0 * sign * (from[0] * to[3] - from[1] * to[2] + from[2] * to[1] - from[3] * to[0]) / dt
+    };
+
+    // Specific force, the acceleration plus the reaction to gravity
+    double acceleration[3];
+
+    for (int i = 0; i < 3; i++)
+    {
+        acceleration[i] = (truth.velocity[i] - previous.velocity[i]) / dt;
+    }
+
+    acceleration[2] += SYNTHETIC_GRAVITY;
+
+    double specificForce[3];
+    rotateToBody(truth.quaternion, acceleration, specificForce);
+
+    sample.truth = truth;
+
+    sample.imu = IMU_Data_t();
+    sample.imu.gyrx = (float) rate[0] + config.gyroBias[0] + gaussian(config.gyroNoise);
+    sample.imu.gyry = (float) rate[1] + config.gyroBias[1] + gaussian(config.gyroNoise);
+    sample.imu.gyrz = (float) rate[2] + config.gyroBias[2] + gaussian(config.gyroNoise);
+    sample.imu.accx = (float) specificForce[0] + config.accelBias[0] + gaussian(config.accelNoise);
+    sample.imu.accy = (float) specificForce[1] + config.accelBias[1] + gaussian(config.accelNoise);
+    sample.imu.accz = (float) specificForce[2] + config.accelBias[2] + gaussian(config.accelNoise);
+    sample.imu.isDataNew = true;
+    sample.imu.sensorStatus = 0;
+    sample.imu.sampleTimeUs = (uint32_t) (truth.time * 1e6);
+    sample.imu.deltaTime = (float) dt;
+
+    sample.airspeed = Airspeed_Data_t();
+    sample.airspeed.airspeed = SYNTHETIC_CRUISE_SPEED + gaussian(config.airspeedNoise);
+    sample.airspeed.isDataNew = true;
+    sample.airspeed.sensorStatus = 0;
+
+    sample.gps = GpsData_t();
+    sample.gpsIsNew = (config.gpsDivider > 0) && (sampleCount % config.gpsDivider == 0);
+
+    if (sample.gpsIsNew)
+    {
+        double north = truth.position[0] + gaussian(config.gpsNoise);
+        double west = truth.position[1] + gaussian(config.gpsNoise);
+        double heading = -truth.yaw / SYNTHETIC_DEG_TO_RAD;
+
+        heading = fmod(heading, 360.0);
+        heading = (heading < 0) ? heading + 360.0 : heading;
+
+        sample.gps.latitude = SYNTHETIC_START_LATITUDE + north / SYNTHETIC_EARTH_RADIUS / SYNTHETIC_DEG_TO_RAD;
+        sample.gps.longitude = SYNTHETIC_START_LONGITUDE
+                               - west / (SYNTHETIC_EARTH_RADIUS * cos(SYNTHETIC_START_LATITUDE * SYNTHETIC_DEG_TO_RAD)) / SYNTHETIC_DEG_TO_RAD;
+        sample.gps.altitude = (int) lround(truth.position[2]);
+        sample.gps.groundSpeed = (float) sqrt(truth.velocity[0] * truth.velocity[0] + truth.velocity[1] * truth.velocity[1])
+                                 + gaussian(config.gpsSpeedNoise);
+        sample.gps.heading = (int16_t) lround(heading);
+        sample.gps.sensorStatus = 1;
+        sample.gps.dataIsNew = true;
+    }
+
+    sample.altimeter = AltimeterData_t();
+    sample.altimeterIsNew = (config.altimeterDivider > 0) && (sampleCount % config.altimeterDivider == 0);
+
+    if (sample.altimeterIsNew)
+    {
+        sample.altimeter.altitude = (float) truth.position[2] + gaussian(config.altimeterNoise);
+        sample.altimeter.isDataNew = true;
+        sample.altimeter.status = 0;
+    }
+}
+
+// 0 before start, 1 after start + duration, a half cosine in between
+inline double SyntheticFlight::smoothStep(double t, double start, double duration)
+{
+    return (t < start) ? 0.0 : (t < start + duration) ? 0.5 * (1.0 - cos(SYNTHETIC_PI * (t - start) / duration)) : 1.0;
+}
+
+inline void SyntheticFlight::advanceTruth(double dt)
+{
+    const double t = truth.time;
+    double flightPath = 0.0;
+
+    truth.roll = 0.0;
+    truth.pitch = 0.0;
+
+    switch (trajectory)
+    {
+        case SYNTHETIC_ROLL_DOUBLETS:
+            truth.roll = 30.0 * SYNTHETIC_DEG_TO_RAD * sin(2.0 * SYNTHETIC_PI * 0.2 * t);
+            break;
+
+        case SYNTHETIC_COORDINATED_TURN:
+            truth.roll = 30.0 * SYNTHETIC_DEG_TO_RAD * smoothStep(t, 10.0, 2.0);
+
+            // Banking right turns right, which is a negative yaw rate with z up
+            truth.yaw -= SYNTHETIC_GRAVITY * tan(truth.roll) / SYNTHETIC_CRUISE_SPEED * dt;
+            break;
+
+        case SYNTHETIC_CLIMB:
+            truth.pitch = 10.0 * SYNTHETIC_DEG_TO_RAD * (smoothStep(t, 10.0, 2.0) - smoothStep(t, 40.0, 2.0));
+            flightPath = truth.pitch;
+            break;
+
+        case SYNTHETIC_AILERON_ROLLS:
+        {
+            double sinceFirst = t - 10.0;
+            double intoRoll = (sinceFirst < 0.0) ? -1.0 : fmod(sinceFirst, 15.0);
+
+            truth.roll = 2.0 * SYNTHETIC_PI * smoothStep(intoRoll, 0.0, 4.0);
+            truth.roll = (truth.roll > SYNTHETIC_PI) ? truth.roll - 2.0 * SYNTHETIC_PI : truth.roll;
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    eulerToQuaternion(truth.roll, truth.pitch, truth.yaw, truth.quaternion);
+
+    truth.velocity[0] = SYNTHETIC_CRUISE_SPEED * cos(flightPath) * cos(truth.yaw);
+    truth.velocity[1] = SYNTHETIC_CRUISE_SPEED * cos(flightPath) * sin(truth.yaw);
+    truth.velocity[2] = SYNTHETIC_CRUISE_SPEED * sin(flightPath);
+
+    for (int i = 0; i < 3; i++)
+    {
+        truth.position[i] += truth.velocity[i] * dt;
+    }
+}
+
+inline void SyntheticFlight::eulerToQuaternion(double roll, double pitch, double yaw, double q[4])
+{
+    double cr = cos(0.5 * roll), sr = sin(0.5 * roll);
+    double cp = cos(0.5 * pitch), sp = sin(0.5 * pitch);
+    double cy = cos(0.5 * yaw), sy = sin(0.5 * yaw);
+
+    q[0] = cr * cp * cy + sr * sp * sy;
+    q[1] = sr * cp * cy - cr * sp * sy;
+    q[2] = cr * sp * cy + sr * cp * sy;
+    q[3] = cr * cp * sy - sr * sp * cy;
+}
+
+// Earth to body: v_body = R^T v_earth
+inline void SyntheticFlight::rotateToBody(const double q[4], const double earth[3], double body[3])
+{
+    double q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+
+    double R[3][3] = {
+        {1 - 2 * (q2 * q2 + q3 * q3), 2 * (q1 * q2 - q0 * q3), 2 * (q1 * q3 + q0 * q2)},
+        {2 * (q1 * q2 + q0 * q3), 1 - 2 * (q1 * q1 + q3 * q3), 2 * (q2 * q3 - q0 * q1)},
+        {2 * (q1 * q3 - q0 * q2), 2 * (q2 * q3 + q0 * q1), 1 - 2 * (q1 * q1 + q2 * q2)}};
+
+    for (int i = 0; i < 3; i++)
+    {
+        body[i] = R[0][i] * earth[0] + R[1][i] * earth[1] + R[2][i] * earth[2];
+    }
+}
+
+inline double SyntheticFlight_TiltError(const SyntheticTruth_t &truth, const SFOutput_t &output)
+{
+    // SFOutput_t yaw is offset by 180 degrees, it does not change the direction of gravity but keeps the quaternion
+    // the same as the filter's
+    double estimate[4];
+    SyntheticFlight::eulerToQuaternion(output.IMUroll * SYNTHETIC_DEG_TO_RAD, output.IMUpitch * SYNTHETIC_DEG_TO_RAD,
+                                       (output.IMUyaw - 180.0) * SYNTHETIC_DEG_TO_RAD, estimate);
+
+    const double up[3] = {0.0, 0.0, 1.0};
+    double trueUp[3];
+    double estimatedUp[3];
+
+    SyntheticFlight::rotateToBody(truth.quaternion, up, trueUp);
+    SyntheticFlight::rotateToBody(estimate, up, estimatedUp);
+
+    double cosine = trueUp[0] * estimatedUp[0] + trueUp[1] * estimatedUp[1] + trueUp[2] * estimatedUp[2];
+    cosine = (cosine > 1.0) ? 1.0 : (cosine < -1.0) ? -1.0 : cosine;
+
+    return acos(cosine) / SYNTHETIC_DEG_TO_RAD;
+}
+
+inline double SyntheticFlight_HeadingError(const SyntheticTruth_t &truth, const SFOutput_t &output)
+{
+    double difference = fmod(output.IMUyaw - 180.0 - truth.yaw / SYNTHETIC_DEG_TO_RAD, 360.0);
+
+    difference = (difference > 180.0) ? difference - 360.0 : difference;
+    difference = (difference < -180.0) ? difference + 360.0 : difference;
+
+    return difference;
+}
+
+#endif
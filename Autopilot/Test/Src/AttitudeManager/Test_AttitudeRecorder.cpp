@@ -0,0 +1,168 @@
+/*
+* Tests for the recorder that captures the attitude manager's inputs for replay.
+*/
+
+#include <gtest/gtest.h>
+
+#include "AttitudeRecorder.hpp"
+
+#include <string.h>
+#include <vector>
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+static AttitudeFrame_t makeFrame(float seed)
+{
+    AttitudeFrame_t frame;
+    memset(&frame, 0, sizeof(frame));
+
+    frame.commands.roll = seed;
+    frame.commands.pitch = -seed;
+    frame.commands.yaw = seed * 0.5f;
+    frame.commands.airspeed = 60.0f + seed;
+    frame.commandsErrorCode = 0;
+
+    frame.imu.magx = seed + 1.0f;
+    frame.imu.magy = seed + 2.0f;
+    frame.imu.magz = seed + 3.0f;
+    frame.imu.accx = seed * 0.1f;
+    frame.imu.accy = seed * 0.2f;
+    frame.imu.accz = -9.81f;
+    frame.imu.gyrx = seed * 0.01f;
+    frame.imu.gyry = seed * 0.02f;
+    frame.imu.gyrz = seed * 0.03f;
+    frame.imu.isDataNew = true;
+    frame.imu.sensorStatus = -1;
+    frame.imu.utcTime = seed * 1000.0f;
+    frame.imu.sampleTimeUs = 4000000000u + (uint32_t) seed;
+    frame.imu.deltaTime = 0.005f + seed * 1e-6f;
+
+    frame.airspeed.airspeed = 17.123456789012345; // needs all of the double's precision
+    frame.airspeed.sensorStatus = 1;
+    frame.airspeed.isDataNew = false;
+    frame.airspeed.utcTime = seed * 1000.0f + 1.0f;
+    frame.sensorErrorCode = -1;
+
+    return frame;
+}
+
+static void expectFramesEqual(const AttitudeFrame_t &expected, const AttitudeFrame_t &actual)
+{
+    EXPECT_EQ(expected.commands.roll, actual.commands.roll);
+    EXPECT_EQ(expected.commands.pitch, actual.commands.pitch);
+    EXPECT_EQ(expected.commands.yaw, actual.commands.yaw);
+    EXPECT_EQ(expected.commands.airspeed, actual.commands.airspeed);
+    EXPECT_EQ(expected.commandsErrorCode, actual.commandsErrorCode);
+
+    EXPECT_EQ(expected.imu.magx, actual.imu.magx);
+    EXPECT_EQ(expected.imu.magy, actual.imu.magy);
+    EXPECT_EQ(expected.imu.magz, actual.imu.magz);
+    EXPECT_EQ(expected.imu.accx, actual.imu.accx);
+    EXPECT_EQ(expected.imu.accy, actual.imu.accy);
+    EXPECT_EQ(expected.imu.accz, actual.imu.accz);
+    EXPECT_EQ(expected.imu.gyrx, actual.imu.gyrx);
+    EXPECT_EQ(expected.imu.gyry, actual.imu.gyry);
+    EXPECT_EQ(expected.imu.gyrz, actual.imu.gyrz);
+    EXPECT_EQ(expected.imu.isDataNew, actual.imu.isDataNew);
+    EXPECT_EQ(expected.imu.sensorStatus, actual.imu.sensorStatus);
+    EXPECT_EQ(expected.imu.utcTime, actual.imu.utcTime);
+    EXPECT_EQ(expected.imu.sampleTimeUs, actual.imu.sampleTimeUs);
+    EXPECT_EQ(expected.imu.deltaTime, actual.imu.deltaTime);
+
+    EXPECT_EQ(expected.airspeed.airspeed, actual.airspeed.airspeed);
+    EXPECT_EQ(expected.airspeed.sensorStatus, actual.airspeed.sensorStatus);
+    EXPECT_EQ(expected.airspeed.isDataNew, actual.airspeed.isDataNew);
+    EXPECT_EQ(expected.airspeed.utcTime, actual.airspeed.utcTime);
+    EXPECT_EQ(expected.sensorErrorCode, actual.sensorErrorCode);
+}
+
+static void collectBytes(const uint8_t *data, size_t length, void *context)
+{
+    vector<uint8_t> *recording = static_cast<vector<uint8_t> *>(context);
+    recording->insert(recording->end(), data, data + length);
+}
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(AttitudeRecorder, FrameSurvivesEncodeDecode) {
+
+   	/***********************SETUP***********************/
+
+	AttitudeFrame_t original = makeFrame(3.25f);
+	AttitudeFrame_t decoded;
+	uint8_t buffer[ATTITUDE_FRAME_SIZE];
+
+	/********************STEPTHROUGH********************/
+
+	size_t length = AttitudeFrame_Encode(&original, buffer);
+	AttitudeFrame_Decode(buffer, &decoded);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(length, (size_t) ATTITUDE_FRAME_SIZE);
+	expectFramesEqual(original, decoded);
+}
+
+TEST(AttitudeRecorder, RejectsForeignHeader) {
+
+   	/***********************SETUP***********************/
+
+	uint8_t header[ATTITUDE_RECORDING_HEADER_SIZE];
+
+	/********************STEPTHROUGH********************/
+
+	size_t length = AttitudeRecorder_EncodeHeader(header);
+	bool ownHeaderOk = AttitudeRecorder_CheckHeader(header);
+
+	header[0] ^= 0xFF;
+	bool corruptedHeaderOk = AttitudeRecorder_CheckHeader(header);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(length, (size_t) ATTITUDE_RECORDING_HEADER_SIZE);
+	EXPECT_TRUE(ownHeaderOk);
+	EXPECT_FALSE(corruptedHeaderOk);
+}
+
+TEST(AttitudeRecorder, EmitsOneFramePerCycleOnlyWhileRecording) {
+
+   	/***********************SETUP***********************/
+
+	vector<uint8_t> recording;
+	AttitudeFrame_t cycles[2] = {makeFrame(1.0f), makeFrame(2.0f)};
+	AttitudeFrame_t ignored = makeFrame(9.0f);
+
+	/********************STEPTHROUGH********************/
+
+	AttitudeRecorder_Start(collectBytes, &recording);
+
+	for (int i = 0; i < 2; i++)
+	{
+		AttitudeRecorder_RecordCommands(&cycles[i].commands, cycles[i].commandsErrorCode);
+		AttitudeRecorder_RecordSensors(&cycles[i].imu, &cycles[i].airspeed, cycles[i].sensorErrorCode);
+	}
+
+	AttitudeRecorder_Stop();
+
+	AttitudeRecorder_RecordCommands(&ignored.commands, ignored.commandsErrorCode);
+	AttitudeRecorder_RecordSensors(&ignored.imu, &ignored.airspeed, ignored.sensorErrorCode);
+
+	/**********************ASSERTS**********************/
+
+	ASSERT_EQ(recording.size(), (size_t) (ATTITUDE_RECORDING_HEADER_SIZE + 2 * ATTITUDE_FRAME_SIZE));
+	EXPECT_TRUE(AttitudeRecorder_CheckHeader(recording.data()));
+
+	for (int i = 0; i < 2; i++)
+	{
+		AttitudeFrame_t decoded;
+		AttitudeFrame_Decode(&recording[ATTITUDE_RECORDING_HEADER_SIZE + i * ATTITUDE_FRAME_SIZE], &decoded);
+		expectFramesEqual(cycles[i], decoded);
+	}
+}
@@ -0,0 +1,171 @@
+/*
+* Tests for the RAM ring the autopilot records the attitude manager's inputs into.
+*/
+
+#include <gtest/gtest.h>
+
+#include "AttitudeRecorder.hpp"
+#include "AttitudeRecordingRing.hpp"
+
+#include <string.h>
+#include <vector>
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define SMALL_CHUNK_SIZE 37 // does not divide a frame, so the chunks split frames
+
+static AttitudeFrame_t makeFrame(float seed)
+{
+	AttitudeFrame_t frame;
+	memset(&frame, 0, sizeof(frame));
+
+	frame.commands.roll = seed;
+	frame.commands.airspeed = 15.0f + seed;
+	frame.imu.gyrx = seed * 0.01f;
+	frame.imu.accz = -9.81f;
+	frame.imu.isDataNew = true;
+	frame.imu.sampleTimeUs = (uint32_t) (seed * 5000.0f);
+	frame.airspeed.airspeed = 15.0 + seed;
+	frame.airspeed.isDataNew = true;
+
+	return frame;
+}
+
+static void recordCycle(const AttitudeFrame_t &frame)
+{
+	AttitudeRecorder_RecordCommands(&frame.commands, frame.commandsErrorCode);
+	AttitudeRecorder_RecordSensors(&frame.imu, &frame.airspeed, frame.sensorErrorCode);
+}
+
+// What the ground station does with the chunks telemetry sends down
+static vector<uint8_t> drainInChunks(size_t chunkSize)
+{
+	vector<uint8_t> received;
+	vector<uint8_t> chunk(chunkSize);
+	size_t length;
+
+	while ((length = AttitudeRecordingRing_Read(chunk.data(), chunk.size())) > 0)
+	{
+		received.insert(received.end(), chunk.begin(), chunk.begin() + length);
+	}
+
+	return received;
+}
+
+class AttitudeRecordingRingTest : public ::testing::Test
+{
+	public:
+
+		virtual void SetUp()
+		{
+			AttitudeRecordingRing_Reset();
+		}
+
+		virtual void TearDown()
+		{
+			AttitudeRecorder_Stop();
+		}
+};
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST_F(AttitudeRecordingRingTest, ChunksAppendBackIntoTheRecording) {
+
+   	/***********************SETUP***********************/
+
+	const int numFrames = 3 * ATTITUDE_RECORDING_RING_SIZE / ATTITUDE_FRAME_SIZE; // the ring wraps around twice
+	vector<uint8_t> received;
+
+	/********************STEPTHROUGH********************/
+
+	AttitudeRecorder_Start(AttitudeRecordingRing_Sink, nullptr);
+
+	for (int i = 0; i < numFrames; i++)
+	{
+		recordCycle(makeFrame((float) i));
+
+		// Telemetry keeps up, a few frames at a time
+		if (i % 8 == 7)
+		{
+			vector<uint8_t> chunk = drainInChunks(SMALL_CHUNK_SIZE);
+			received.insert(received.end(), chunk.begin(), chunk.end());
+		}
+	}
+
+	vector<uint8_t> rest = drainInChunks(SMALL_CHUNK_SIZE);
+	received.insert(received.end(), rest.begin(), rest.end());
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(AttitudeRecordingRing_GetDropped(), 0u);
+	ASSERT_EQ(received.size(), (size_t) (ATTITUDE_RECORDING_HEADER_SIZE + numFrames * ATTITUDE_FRAME_SIZE));
+	EXPECT_TRUE(AttitudeRecorder_CheckHeader(received.data()));
+
+	for (int i = 0; i < numFrames; i++)
+	{
+		AttitudeFrame_t decoded;
+		AttitudeFrame_Decode(&received[ATTITUDE_RECORDING_HEADER_SIZE + i * ATTITUDE_FRAME_SIZE], &decoded);
+
+		EXPECT_EQ(decoded.commands.roll, (float) i);
+		EXPECT_EQ(decoded.imu.sampleTimeUs, (uint32_t) (i * 5000.0f));
+	}
+}
+
+TEST_F(AttitudeRecordingRingTest, FullRingDropsWholeFrames) {
+
+   	/***********************SETUP***********************/
+
+	const int fits = (ATTITUDE_RECORDING_RING_SIZE - ATTITUDE_RECORDING_HEADER_SIZE) / ATTITUDE_FRAME_SIZE;
+
+	/********************STEPTHROUGH********************/
+
+	AttitudeRecorder_Start(AttitudeRecordingRing_Sink, nullptr);
+
+	// Nothing is read while these go in
+	for (int i = 0; i < fits + 5; i++)
+	{
+		recordCycle(makeFrame((float) i));
+	}
+
+	vector<uint8_t> received = drainInChunks(ATTITUDE_RECORDING_RING_SIZE);
+
+	// Once there is room again, frames go in as before
+	recordCycle(makeFrame(1000.0f));
+	vector<uint8_t> afterwards = drainInChunks(ATTITUDE_RECORDING_RING_SIZE);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(AttitudeRecordingRing_GetDropped(), 5u);
+	ASSERT_EQ(received.size(), (size_t) (ATTITUDE_RECORDING_HEADER_SIZE + fits * ATTITUDE_FRAME_SIZE));
+
+	AttitudeFrame_t last;
+	AttitudeFrame_Decode(&received[ATTITUDE_RECORDING_HEADER_SIZE + (fits - 1) * ATTITUDE_FRAME_SIZE], &last);
+	EXPECT_EQ(last.commands.roll, (float) (fits - 1));
+
+	ASSERT_EQ(afterwards.size(), (size_t) ATTITUDE_FRAME_SIZE);
+	AttitudeFrame_Decode(afterwards.data(), &last);
+	EXPECT_EQ(last.commands.roll, 1000.0f);
+}
+
+TEST_F(AttitudeRecordingRingTest, EmptyRingReadsNothing) {
+
+   	/***********************SETUP***********************/
+
+	uint8_t buffer[SMALL_CHUNK_SIZE];
+
+	/********************STEPTHROUGH********************/
+
+	size_t length = AttitudeRecordingRing_Read(buffer, sizeof(buffer));
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(length, 0u);
+	EXPECT_EQ(AttitudeRecordingRing_GetDropped(), 0u);
+}
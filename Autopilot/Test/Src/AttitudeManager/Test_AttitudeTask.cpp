@@ -0,0 +1,183 @@
+/*
+* Tests for the fixed rate attitude task, run against a simulated tick source.
+* The attitude manager's modules are the fakes of Test_Fsm.cpp, which complete a cycle without errors by default.
+*/
+
+#include "fff.h"
+#include <gtest/gtest.h>
+
+#include "AttitudeTask.hpp"
+#include "AttitudeDataBus.hpp"
+#include "TimeStamp.h"
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+DECLARE_FAKE_VALUE_FUNC(uint32_t, TimeStamp_GetMicroseconds);
+
+#define TEST_RATE_HZ 200
+#define TEST_PERIOD_US (1000000 / TEST_RATE_HZ)
+#define WORK_PER_TIMESTAMP_US 10 // every time stamp taken during a cycle moves the simulated clock on by this much
+
+// Each call to TimeStamp_GetMicroseconds is treated as a bit of work being done
+static uint32_t simulatedNowUs;
+
+static uint32_t TimeStamp_GetMicroseconds_AdvancesSimulatedClock(void)
+{
+    uint32_t now = simulatedNowUs;
+    simulatedNowUs += WORK_PER_TIMESTAMP_US;
+    return now;
+}
+
+// Ticks every period. The task is woken up latencyUs after the tick and is told that ticksPerWake ticks have passed.
+class SimulatedTickSource : public AttitudeTickSource
+{
+    public:
+        SimulatedTickSource() : tickTimeUs(0), latencyUs(0), ticksPerWake(1) {}
+
+        uint32_t waitForTick()
+        {
+            if (ticksPerWake == 0)
+            {
+                return 0;
+            }
+
+            tickTimeUs += ticksPerWake * TEST_PERIOD_US;
+            simulatedNowUs = tickTimeUs + latencyUs;
+
+            return ticksPerWake;
+        }
+
+        uint32_t getTickTimeUs() {return tickTimeUs;}
+
+        uint32_t tickTimeUs;
+        uint32_t latencyUs;
+        uint32_t ticksPerWake;
+};
+
+class AttitudeTaskTiming : public ::testing::Test
+{
+    public:
+
+        virtual void SetUp()
+        {
+            RESET_FAKE(TimeStamp_GetMicroseconds);
+            TimeStamp_GetMicroseconds_fake.custom_fake = TimeStamp_GetMicroseconds_AdvancesSimulatedClock;
+            simulatedNowUs = 0;
+        }
+
+        virtual void TearDown()
+        {
+            FFF_RESET_HISTORY();
+        }
+};
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST_F(AttitudeTaskTiming, RunsOneFullCyclePerTickAndRecordsJitter) {
+
+   	/***********************SETUP***********************/
+
+	SimulatedTickSource tickSource;
+	AttitudeTask task(tickSource, TEST_RATE_HZ);
+
+	uint32_t latencies[3] = {20, 5, 40};
+
+	/********************STEPTHROUGH********************/
+
+	for (int i = 0; i < 3; i++)
+	{
+		tickSource.latencyUs = latencies[i];
+		task.runOnce();
+	}
+
+	AttitudeTaskStats_t published;
+	bool readOk = AttitudeTaskStatsTopic.read(published);
+
+	/**********************ASSERTS**********************/
+
+	const AttitudeTaskStats_t &stats = task.getStats();
+
+	EXPECT_EQ(stats.periodUs, (uint32_t) TEST_PERIOD_US);
+	EXPECT_EQ(stats.cycles, 3u);
+	EXPECT_EQ(stats.missedTicks, 0u);
+	EXPECT_EQ(stats.overruns, 0u);
+	EXPECT_EQ(stats.lastJitterUs, 40u);
+	EXPECT_EQ(stats.maxJitterUs, 40u);
+	EXPECT_GT(stats.lastCycleUs, stats.lastJitterUs);
+	EXPECT_FALSE(stats.inFailureMode);
+	EXPECT_EQ(task.getAttitudeManager().getStatus(), COMPLETED_CYCLE);
+
+	EXPECT_EQ(task.getJitterHistogram().getWindowSize(), 3u);
+	EXPECT_EQ(task.getJitterHistogram().max(), 45u); // upper edge of the 40 us bin
+
+	EXPECT_TRUE(readOk);
+	EXPECT_EQ(published.cycles, 3u);
+}
+
+TEST_F(AttitudeTaskTiming, CountsTicksThatWereNeverServiced) {
+
+   	/***********************SETUP***********************/
+
+	SimulatedTickSource tickSource;
+	AttitudeTask task(tickSource, TEST_RATE_HZ);
+
+	/********************STEPTHROUGH********************/
+
+	task.runOnce();
+
+	tickSource.ticksPerWake = 3;
+	task.runOnce();
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(task.getStats().cycles, 2u);
+	EXPECT_EQ(task.getStats().missedTicks, 2u);
+}
+
+TEST_F(AttitudeTaskTiming, CycleEndingAfterTheNextTickIsAnOverrun) {
+
+   	/***********************SETUP***********************/
+
+	SimulatedTickSource tickSource;
+	AttitudeTask task(tickSource, TEST_RATE_HZ);
+
+	/********************STEPTHROUGH********************/
+
+	task.runOnce();
+
+	tickSource.latencyUs = TEST_PERIOD_US - WORK_PER_TIMESTAMP_US; // starts so late that the cycle's own work pushes it over
+	task.runOnce();
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(task.getStats().cycles, 2u);
+	EXPECT_EQ(task.getStats().overruns, 1u);
+	EXPECT_GT(task.getStats().maxCycleUs, (uint32_t) TEST_PERIOD_US);
+}
+
+TEST_F(AttitudeTaskTiming, MissingTickIsReportedAsTimeout) {
+
+   	/***********************SETUP***********************/
+
+	SimulatedTickSource tickSource;
+	AttitudeTask task(tickSource, TEST_RATE_HZ);
+
+	tickSource.ticksPerWake = 0;
+
+	/********************STEPTHROUGH********************/
+
+	bool ran = task.runOnce();
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_FALSE(ran);
+	EXPECT_EQ(task.getStats().cycles, 0u);
+	EXPECT_EQ(task.getStats().timeouts, 1u);
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include "OutputMixing.hpp"
+#include "FixedOutputMixing.hpp"
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+/**
+* Sweeps every input of the mixers from -128 to 127 percent in steps of 0.75 percent, the other inputs taking values
+* on both sides of the limits, and counts the steps where the fixed point mixer disagrees with OutputMixing_Execute.
+*/
+template <typename Q>
+static int countMismatches(void)
+{
+	const float OTHERS[] = {-101.0f, -100.0f, -3.5f, 0.0f, 42.25f, 100.0f, 101.0f};
+	const int NUM_OTHERS = sizeof(OTHERS) / sizeof(OTHERS[0]);
+	int mismatches = 0;
+
+	for (int input = 0; input < 4; input++)
+	{
+		for (float sweep = -128.0f; sweep < 127.0f; sweep += 0.75f)
+		{
+			for (int other = 0; other < NUM_OTHERS; other++)
+			{
+				float values[4] = {OTHERS[other], OTHERS[(other + 2) % NUM_OTHERS], OTHERS[(other + 4) % NUM_OTHERS], OTHERS[(other + 1) % NUM_OTHERS]};
+				values[input] = sweep;
+
+				PID_Output_t floatInput;
+				floatInput.rollPercent = values[0];
+				floatInput.pitchPercent = values[1];
+				floatInput.yawPercent = values[2];
+				floatInput.throttlePercent = values[3];
+
+				FixedPID_Output_t<Q> fixedInput;
+				fixedInput.rollPercent = FixedPoint_FromFloat<Q>(values[0], FIXED_MIXING_FULL_SCALE);
+				fixedInput.pitchPercent = FixedPoint_FromFloat<Q>(values[1], FIXED_MIXING_FULL_SCALE);
+				fixedInput.yawPercent = FixedPoint_FromFloat<Q>(values[2], FIXED_MIXING_FULL_SCALE);
+				fixedInput.throttlePercent = FixedPoint_FromFloat<Q>(values[3], FIXED_MIXING_FULL_SCALE);
+
+				float floatOutput[NUM_MIXED_CHANNELS];
+				Q fixedOutput[NUM_MIXED_CHANNELS];
+
+				OutputMixing_error_t floatError = OutputMixing_Execute(&floatInput, floatOutput);
+				FixedOutputMixing_error_t fixedError = FixedOutputMixing_Execute(&fixedInput, fixedOutput);
+
+				mismatches += (floatError.errorCode != fixedError.errorCode);
+
+				for (int channel = 0; channel < NUM_MIXED_CHANNELS; channel++)
+				{
+					mismatches += (FixedPoint_ToFloat<Q>(fixedOutput[channel], FIXED_MIXING_FULL_SCALE) != floatOutput[channel]);
+				}
+			}
+		}
+	}
+
+	return mismatches;
+}
+
+/***********************************************************************************************************************
+ * Fixed Point Output Mixing Module Tests
+ **********************************************************************************************************************/
+
+TEST(AttitudeManager_FixedOutputMixing, Q15MatchesTheFloatMixer) {
+
+   	/***********************SETUP***********************/
+	/********************STEPTHROUGH********************/
+
+	int mismatches = countMismatches<q15_t>();
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(mismatches, 0);
+}
+
+TEST(AttitudeManager_FixedOutputMixing, Q31MatchesTheFloatMixer) {
+
+   	/***********************SETUP***********************/
+	/********************STEPTHROUGH********************/
+
+	int mismatches = countMismatches<q31_t>();
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(mismatches, 0);
+}
+
+TEST(AttitudeManager_FixedOutputMixing, OutOfRangeInputsSaturateAtTheLimits) {
+
+   	/***********************SETUP***********************/
+
+	FixedPID_Output_t<q15_t> input;
+	input.rollPercent = FixedPoint_FromFloat<q15_t>(-120.0f, FIXED_MIXING_FULL_SCALE);
+	input.pitchPercent = FixedPoint_FromFloat<q15_t>(120.0f, FIXED_MIXING_FULL_SCALE);
+	input.yawPercent = 0;
+	input.throttlePercent = FixedPoint_FromFloat<q15_t>(50.0f, FIXED_MIXING_FULL_SCALE);
+
+	q15_t output[NUM_MIXED_CHANNELS];
+
+	/********************STEPTHROUGH********************/
+
+	FixedOutputMixing_error_t error = FixedOutputMixing_Execute(&input, output);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(error.errorCode, 1);
+	EXPECT_EQ(FixedPoint_ToFloat<q15_t>(output[AILERON_OUT_CHANNEL], FIXED_MIXING_FULL_SCALE), -100.0f);
+	EXPECT_EQ(FixedPoint_ToFloat<q15_t>(output[ELEVATOR_OUT_CHANNEL], FIXED_MIXING_FULL_SCALE), 100.0f);
+	EXPECT_EQ(FixedPoint_ToFloat<q15_t>(output[THROTTLE_OUT_CHANNEL], FIXED_MIXING_FULL_SCALE), 50.0f);
+}
@@ -5,6 +5,7 @@
 
 #include "fff.h"
 #include <gtest/gtest.h>
+#include <gmock/gmock.h>
 
 #include "attitudeManager.hpp"
 #include "attitudeStateClasses.hpp"
@@ -15,6 +16,7 @@
 #include "SensorFusion.hpp"
 #include "OutputMixing.hpp"
 #include "SendInstructionsToSafety.hpp"
+#include "TimeStamp.h"
 
 #include <string.h>
 
@@ -30,7 +32,8 @@ FAKE_VALUE_FUNC(SFError_t, SF_GetResult, SFOutput_t *, IMU_Data_t *, Airspeed_Da
 FAKE_VALUE_FUNC(SensorError_t, SensorMeasurements_GetResult, IMU *, airspeed *, IMU_Data_t *, Airspeed_Data_t *);
 FAKE_VOID_FUNC(SendToSafety_Init);
 FAKE_VALUE_FUNC(OutputMixing_error_t, OutputMixing_Execute, PID_Output_t * , float * );
-FAKE_VALUE_FUNC(SendToSafety_error_t, SendToSafety_Execute, int, int);
+FAKE_VALUE_FUNC(SendToSafety_error_t, SendToSafety_Commit, const float *, int, uint32_t);
+FAKE_VALUE_FUNC(uint32_t, TimeStamp_GetMicroseconds);
 
 /***********************************************************************************************************************
  * Definitions
@@ -38,6 +41,8 @@ FAKE_VALUE_FUNC(SendToSafety_error_t, SendToSafety_Execute, int, int);
 
 #define ARBITRARY_FLOAT 46.5f
 
+#define ARBITRARY_SAMPLE_TIME_US 4294967000u // close enough to the wrap around for the trace to cross it
+
 /***********************************************************************************************************************
  * Test Fixtures
  **********************************************************************************************************************/
@@ -53,7 +58,7 @@ class AttitudeManagerFSM : public ::testing::Test
 			RESET_FAKE(SensorMeasurements_GetResult);
 			RESET_FAKE(SendToSafety_Init);
 			RESET_FAKE(OutputMixing_Execute);
-			RESET_FAKE(SendToSafety_Execute);
+			RESET_FAKE(SendToSafety_Commit);
 		}
 
 		virtual void TearDown()
@@ -74,7 +79,7 @@ class AttitudeManagerDataHandoff : public ::testing::Test
 			RESET_FAKE(SensorMeasurements_GetResult);
 			RESET_FAKE(SendToSafety_Init);
 			RESET_FAKE(OutputMixing_Execute);
-			RESET_FAKE(SendToSafety_Execute);
+			RESET_FAKE(SendToSafety_Commit);
 		}
 
 		virtual void TearDown()
@@ -103,6 +108,59 @@ static OutputMixing_error_t OutputMixing_Execute_GivesChannelOutCustom(PID_Outpu
 	return dummyError;
 }
 
+static PMError_t PM_GetCommands_GivesArbitraryCommands(PMCommands *Commands)
+{
+	PMError_t dummyError = {0};
+
+	Commands->roll = ARBITRARY_FLOAT;
+	Commands->pitch = -ARBITRARY_FLOAT;
+	Commands->yaw = 0.0f;
+	Commands->airspeed = 2.0f * ARBITRARY_FLOAT;
+
+	return dummyError;
+}
+
+static SensorError_t SensorMeasurements_GetResult_GivesStampedSample(IMU *imusns, airspeed *airspeedsns, IMU_Data_t *imudata, Airspeed_Data_t *airspeeddata)
+{
+	SensorError_t dummyError = {0};
+
+	(void) imusns;
+	(void) airspeedsns;
+
+	memset(imudata, 0, sizeof(*imudata));
+	memset(airspeeddata, 0, sizeof(*airspeeddata));
+	imudata->sampleTimeUs = ARBITRARY_SAMPLE_TIME_US;
+
+	return dummyError;
+}
+
+static MockIMU *fetchedImu = nullptr;
+
+static SensorError_t SensorMeasurements_GetResult_RecordsImu(IMU *imusns, airspeed *airspeedsns, IMU_Data_t *imudata, Airspeed_Data_t *airspeeddata)
+{
+	SensorError_t dummyError = {0};
+
+	(void) airspeedsns;
+	(void) imudata;
+	(void) airspeeddata;
+
+	fetchedImu = static_cast<MockIMU *>(imusns);
+
+	return dummyError;
+}
+
+static SFError_t SF_GetResult_ForwardsSampleTime(SFOutput_t *Output, IMU_Data_t *imudata, Airspeed_Data_t *airspeeddata)
+{
+	SFError_t dummyError = {0};
+
+	(void) airspeeddata;
+
+	memset(Output, 0, sizeof(*Output));
+	Output->sampleTimeUs = imudata->sampleTimeUs;
+
+	return dummyError;
+}
+
 /***********************************************************************************************************************
  * State Transition Tests (make sure the correct states are reached given some set of circumstances)
  **********************************************************************************************************************/
@@ -197,7 +255,43 @@ TEST(AttitudeManagerFSM, IfFetchSensorMeasurementsSuccessTransitionToSensorFusio
 
 }
 
-TEST(AttitudeManagerFSM, IfFetchSensorMeasurementsFailsTransitionToFailure) {
+TEST(AttitudeManagerFSM, FetchSensorMeasurementsHasTheImuMeasureEveryCycle) {
+
+   	/***********************SETUP***********************/
+
+	RESET_FAKE(SensorMeasurements_GetResult);
+
+	attitudeManager attMng;
+
+	/********************DEPENDENCIES*******************/
+
+	SensorMeasurements_GetResult_fake.custom_fake = SensorMeasurements_GetResult_RecordsImu;
+
+	// The first cycle only finds out which driver the state owns
+	attMng.setState(fetchSensorMeasurementsMode::getInstance());
+	attMng.execute();
+	ASSERT_NE(fetchedImu, nullptr);
+
+	EXPECT_CALL(*fetchedImu, Begin_Measuring()).Times(2);
+
+	/********************STEPTHROUGH********************/
+
+	for (int cycle = 0; cycle < 2; cycle++)
+	{
+		attMng.setState(fetchSensorMeasurementsMode::getInstance());
+		attMng.execute();
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_TRUE(::testing::Mock::VerifyAndClearExpectations(fetchedImu));
+	EXPECT_EQ(SensorMeasurements_GetResult_fake.call_count, 3u);
+	EXPECT_EQ(*(attMng.getCurrentState()), sensorFusionMode::getInstance());
+
+	RESET_FAKE(SensorMeasurements_GetResult);
+}
+
+TEST(AttitudeManagerFSM, IfFetchSensorMeasurementsHasOldDataSkipTheRestOfTheCycle) {
 
    	/***********************SETUP***********************/
 
@@ -217,6 +311,31 @@ TEST(AttitudeManagerFSM, IfFetchSensorMeasurementsFailsTransitionToFailure) {
 
 	/**********************ASSERTS**********************/
 
+	EXPECT_EQ(*(attMng.getCurrentState()), fetchInstructionsMode::getInstance());
+	EXPECT_EQ(attMng.getStatus(), COMPLETED_CYCLE);
+
+}
+
+TEST(AttitudeManagerFSM, IfFetchSensorMeasurementsFailsTransitionToFailure) {
+
+   	/***********************SETUP***********************/
+
+	attitudeManager attMng;
+
+	SensorError_t error;
+	error.errorCode = -1;
+
+	/********************DEPENDENCIES*******************/
+
+	SensorMeasurements_GetResult_fake.return_val = error;
+
+	/********************STEPTHROUGH********************/
+
+	attMng.setState(fetchSensorMeasurementsMode::getInstance());
+	attMng.execute();
+
+	/**********************ASSERTS**********************/
+
 	EXPECT_EQ(*(attMng.getCurrentState()), FatalFailureMode::getInstance());
 	EXPECT_EQ(attMng.getStatus(), FAILURE_MODE);
 
@@ -293,7 +412,7 @@ TEST(AttitudeManagerFSM, IfPIDLoopModeSuccessTransitionToOutputMixing) {
 
 }
 
-TEST(AttitudeManagerFSM, IfPIDLoopModeFailsTransitionToFailed) {
+TEST(AttitudeManagerFSM, PIDLoopModeTakesYawFromTheFetchedCommands) {
 
    	/***********************SETUP***********************/
 
@@ -301,8 +420,19 @@ TEST(AttitudeManagerFSM, IfPIDLoopModeFailsTransitionToFailed) {
 	PMError_t error;
 	error.errorCode = -1;
 
+	PMCommands fetched = {0.0f, 0.0f, ARBITRARY_FLOAT, 0.0f};
+	SFOutput_t fused;
+	memset(&fused, 0, sizeof(fused));
+
+	PMCommandsTopic.publish(fetched);
+	SFOutputTopic.publish(fused);
+
+	PID_Output_t pidOutput;
+
 	/********************DEPENDENCIES*******************/
 
+	// The path manager has moved on since the fetch, PIDloopMode must not look again
+	RESET_FAKE(PM_GetCommands);
 	PM_GetCommands_fake.return_val = error;
 
 	/********************STEPTHROUGH********************/
@@ -310,10 +440,14 @@ TEST(AttitudeManagerFSM, IfPIDLoopModeFailsTransitionToFailed) {
 	attMng.setState(PIDloopMode::getInstance());
 	attMng.execute();
 
+	PIDOutputTopic.read(pidOutput);
+
 	/**********************ASSERTS**********************/
 
-	EXPECT_EQ(*(attMng.getCurrentState()), FatalFailureMode::getInstance());
-	EXPECT_EQ(attMng.getStatus(), FAILURE_MODE);
+	EXPECT_EQ(PM_GetCommands_fake.call_count, 0u);
+	EXPECT_EQ(pidOutput.yawPercent, ARBITRARY_FLOAT);
+	EXPECT_EQ(*(attMng.getCurrentState()), OutputMixingMode::getInstance());
+	EXPECT_EQ(attMng.getStatus(), IN_CYCLE);
 
 }
 
@@ -375,7 +509,7 @@ TEST(AttitudeManagerFSM, IfSendToSafetySucceedsTransitionToFetchInstructions) {
 
 	/********************DEPENDENCIES*******************/
 
-	SendToSafety_Execute_fake.return_val = SendToSafetyNoError;
+	SendToSafety_Commit_fake.return_val = SendToSafetyNoError;
 
 	/********************STEPTHROUGH********************/
 
@@ -399,7 +533,7 @@ TEST(AttitudeManagerFSM, IfSendToSafetyFailsTransitionToFailed) {
 
 	/********************DEPENDENCIES*******************/
 
-	SendToSafety_Execute_fake.return_val = SendToSafetyError;
+	SendToSafety_Commit_fake.return_val = SendToSafetyError;
 
 	/********************STEPTHROUGH********************/
 
@@ -445,3 +579,99 @@ TEST(AttitudeManagerDataHandoff, CorrectDataIsFedFromOutputMixingToSendToSafety)
 
 }
 
+TEST(AttitudeManagerDataHandoff, FetchInstructionsPublishesCommandsOnTheBus) {
+
+   	/***********************SETUP***********************/
+
+	RESET_FAKE(PM_GetCommands);
+
+	attitudeManager attMng;
+
+	uint32_t generationBefore = PMCommandsTopic.getGeneration();
+
+	PMCommands published;
+	uint32_t generationAfter;
+
+	/********************DEPENDENCIES*******************/
+
+	PM_GetCommands_fake.custom_fake = PM_GetCommands_GivesArbitraryCommands;
+
+	/********************STEPTHROUGH********************/
+
+	attMng.setState(fetchInstructionsMode::getInstance());
+	attMng.execute();
+
+	bool readOk = PMCommandsTopic.read(published, &generationAfter);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_TRUE(readOk);
+	EXPECT_EQ(generationAfter, generationBefore + 1);
+	EXPECT_EQ(published.roll, ARBITRARY_FLOAT);
+	EXPECT_EQ(published.pitch, -ARBITRARY_FLOAT);
+	EXPECT_EQ(published.airspeed, 2.0f * ARBITRARY_FLOAT);
+}
+
+TEST(AttitudeManagerDataHandoff, SampleTimeReachesSafetyAndEveryStageIsTraced) {
+
+   	/***********************SETUP***********************/
+
+	RESET_FAKE(PM_GetCommands);
+	RESET_FAKE(SF_GetResult);
+	RESET_FAKE(SensorMeasurements_GetResult);
+	RESET_FAKE(OutputMixing_Execute);
+	RESET_FAKE(SendToSafety_Commit);
+	RESET_FAKE(TimeStamp_GetMicroseconds);
+
+	LatencyTrace_Reset();
+
+	attitudeManager attMng;
+
+	// What the time base reads when fusion, PID, mixing and the hand-off are done, the last two after the wrap around
+	uint32_t stageTimes[NUM_LATENCY_STAGES] = {ARBITRARY_SAMPLE_TIME_US + 100, ARBITRARY_SAMPLE_TIME_US + 150, 104, 304};
+	uint32_t expectedAges[NUM_LATENCY_STAGES] = {100, 150, 400, 600};
+
+	LatencySummary_t summary;
+	uint32_t summaryGeneration = LatencySummaryTopic.getGeneration();
+
+	/********************DEPENDENCIES*******************/
+
+	SensorMeasurements_GetResult_fake.custom_fake = SensorMeasurements_GetResult_GivesStampedSample;
+	SF_GetResult_fake.custom_fake = SF_GetResult_ForwardsSampleTime;
+
+	/********************STEPTHROUGH********************/
+
+	for (int cycle = 0; cycle < LATENCY_SUMMARY_PERIOD; cycle++)
+	{
+		SET_RETURN_SEQ(TimeStamp_GetMicroseconds, stageTimes, NUM_LATENCY_STAGES);
+		TimeStamp_GetMicroseconds_fake.return_val_seq_idx = 0;
+
+		attMng.setState(fetchInstructionsMode::getInstance());
+
+		do
+		{
+			attMng.execute();
+		} while (attMng.getStatus() == IN_CYCLE);
+	}
+
+	bool readOk = LatencyTrace_GetSummary(&summary);
+
+	/**********************ASSERTS**********************/
+
+	ASSERT_EQ(attMng.getStatus(), COMPLETED_CYCLE);
+	EXPECT_EQ(SendToSafety_Commit_fake.arg2_val, ARBITRARY_SAMPLE_TIME_US);
+
+	for (int stage = 0; stage < NUM_LATENCY_STAGES; stage++)
+	{
+		const LatencyHistogram &histogram = LatencyTrace_GetHistogram((_LatencyStage) stage);
+
+		EXPECT_EQ(histogram.getLatest(), expectedAges[stage]);
+		EXPECT_EQ(histogram.getWindowSize(), (size_t) LATENCY_SUMMARY_PERIOD);
+	}
+
+	EXPECT_TRUE(readOk);
+	EXPECT_EQ(LatencySummaryTopic.getGeneration(), summaryGeneration + 1);
+	EXPECT_EQ(summary.cycles, (uint32_t) LATENCY_SUMMARY_PERIOD);
+	EXPECT_EQ(summary.latestUs[LATENCY_STAGE_HANDOFF], 600u);
+	EXPECT_EQ(summary.p50Us[LATENCY_STAGE_HANDOFF], 650u); // upper edge of the 600 us bin
+}
@@ -0,0 +1,159 @@
+/*
+* Tests for the IMU pre-filtering in the measurement stage
+*/
+
+#include <gtest/gtest.h>
+
+#include "ImuFilter.hpp"
+
+#include <math.h>
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define PI_F 3.14159265f
+
+static IMU_Data_t makeImuSample(float gyro, float accel, float mag, bool isDataNew)
+{
+	IMU_Data_t imu = {};
+
+	imu.gyrx = imu.gyry = imu.gyrz = gyro;
+	imu.accx = imu.accy = imu.accz = accel;
+	imu.magx = imu.magy = imu.magz = mag;
+	imu.isDataNew = isDataNew;
+
+	return imu;
+}
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(ImuFilter, FirstSamplePassesThroughUnchanged) {
+
+   	/***********************SETUP***********************/
+
+	ImuFilter filter;
+	IMU_Data_t imu = makeImuSample(0.1f, 9.81f, 0.4f, true);
+	imu.sampleTimeUs = 1234;
+
+	/********************STEPTHROUGH********************/
+
+	filter.apply(imu);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_NEAR(imu.gyrx, 0.1f, 1e-5f);
+	EXPECT_NEAR(imu.accz, 9.81f, 1e-4f);
+	EXPECT_NEAR(imu.magy, 0.4f, 1e-5f);
+	EXPECT_EQ(imu.sampleTimeUs, 1234u);
+}
+
+TEST(ImuFilter, NotchTakesOutTheVibrationOnGyroAndAccelerometer) {
+
+   	/***********************SETUP***********************/
+
+	ImuFilterConfig_t config = ImuFilter_DefaultConfig();
+	config.notchHz = 40.0f;
+	config.gyroCutoffHz = 0.0f;
+	config.accelCutoffHz = 0.0f;
+
+	ImuFilter filter(config);
+
+	float gyroAmplitude = 0.0f;
+	float accelAmplitude = 0.0f;
+	float magAmplitude = 0.0f;
+
+	/********************STEPTHROUGH********************/
+
+	for (int i = 0; i < 1000; i++)
+	{
+		float vibration = sinf(2.0f * PI_F * config.notchHz * i / config.sampleRateHz);
+		IMU_Data_t imu = makeImuSample(vibration, 9.81f + vibration, vibration, true);
+
+		filter.apply(imu);
+
+		if (i >= 500)
+		{
+			gyroAmplitude = fmaxf(gyroAmplitude, fabsf(imu.gyrx));
+			accelAmplitude = fmaxf(accelAmplitude, fabsf(imu.accy - 9.81f));
+			magAmplitude = fmaxf(magAmplitude, fabsf(imu.magz));
+		}
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_LT(gyroAmplitude, 0.02f);
+	EXPECT_LT(accelAmplitude, 0.02f);
+
+	// The magnetometer only has its low pass, 40 Hz is well above it
+	EXPECT_LT(magAmplitude, 0.2f);
+	EXPECT_GT(magAmplitude, gyroAmplitude);
+}
+
+TEST(ImuFilter, OldSamplesAreNotFilteredTwice) {
+
+   	/***********************SETUP***********************/
+
+	ImuFilter filter;
+	IMU_Data_t first = makeImuSample(0.0f, 0.0f, 0.0f, true);
+	IMU_Data_t step = makeImuSample(1.0f, 1.0f, 1.0f, true);
+	IMU_Data_t repeated = makeImuSample(1.0f, 1.0f, 1.0f, false);
+
+	/********************STEPTHROUGH********************/
+
+	filter.apply(first);
+	filter.apply(step);
+	filter.apply(repeated);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(repeated.gyrx, step.gyrx);
+	EXPECT_EQ(repeated.accz, step.accz);
+	EXPECT_LT(step.gyrx, 1.0f);
+}
+
+TEST(ImuFilter, DynamicNotchesFollowTheVibration) {
+
+   	/***********************SETUP***********************/
+
+	ImuFilterConfig_t config = ImuFilter_DefaultConfig();
+	config.gyroCutoffHz = 0.0f;
+	config.accelCutoffHz = 0.0f;
+
+	ImuFilter tracking(config);
+
+	config.dynamicNotch = false;
+	ImuFilter fixed(config);
+
+	float trackingAmplitude = 0.0f;
+	float fixedAmplitude = 0.0f;
+
+	/********************STEPTHROUGH********************/
+
+	for (int i = 0; i < 3000; i++)
+	{
+		float vibration = sinf(2.0f * PI_F * 57.0f * i / config.sampleRateHz);
+		IMU_Data_t first = makeImuSample(vibration, 9.81f, 0.0f, true);
+		IMU_Data_t second = first;
+
+		tracking.apply(first);
+		fixed.apply(second);
+
+		if (i >= 2000)
+		{
+			trackingAmplitude = fmaxf(trackingAmplitude, fabsf(first.gyry));
+			fixedAmplitude = fmaxf(fixedAmplitude, fabsf(second.gyry));
+		}
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_NEAR(tracking.getDynamicNotches(1)[0], 57.0f, 0.5f);
+	EXPECT_GT(fixedAmplitude, 0.9f);
+	EXPECT_LT(trackingAmplitude, 0.05f);
+}
@@ -0,0 +1,174 @@
+/*
+* Tests for the batched Madgwick filters of the simulation farm, against MadgwickFilter
+*/
+
+#include <gtest/gtest.h>
+
+#include "MadgwickBatch.hpp"
+
+#include <math.h>
+#include <vector>
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define FILTERS 37          // four passes of the vector kernel and five filters left over
+#define STEPS 2000
+#define DT 0.005f
+#define TOLERANCE 1e-6f
+
+// Samples for every filter at one step, each filter flies its own motion. Some filters have no magnetometer and some
+// lose the accelerometer now and then, to go through every branch of MadgwickFilter.
+struct BatchSamples
+{
+	vector<float> gx, gy, gz, ax, ay, az, mx, my, mz;
+
+	BatchSamples() : gx(FILTERS), gy(FILTERS), gz(FILTERS), ax(FILTERS), ay(FILTERS), az(FILTERS),
+		mx(FILTERS), my(FILTERS), mz(FILTERS) {}
+
+	void generate(int step)
+	{
+		for (int f = 0; f < FILTERS; f++)
+		{
+			float t = step * DT;
+			bool accelDropout = (f % 3 == 0) && (step % 97 == 0);
+			bool noMagnetometer = (f % 5 == 0);
+
+			gx[f] = 0.4f * sinf(1.3f * t + f);
+			gy[f] = 0.3f * cosf(0.7f * t + 0.5f * f);
+			gz[f] = 0.1f * sinf(0.2f * t);
+			ax[f] = accelDropout ? 0.0f : 2.0f * sinf(0.9f * t + f);
+			ay[f] = accelDropout ? 0.0f : 1.5f * cosf(1.1f * t);
+			az[f] = accelDropout ? 0.0f : 9.81f;
+			mx[f] = noMagnetometer ? 0.0f : 0.3f * cosf(0.05f * f + 0.1f * t);
+			my[f] = noMagnetometer ? 0.0f : 0.2f;
+			mz[f] = noMagnetometer ? 0.0f : -0.4f;
+		}
+	}
+
+	MadgwickBatchSamples_t view(bool withMagnetometer) const
+	{
+		MadgwickBatchSamples_t samples = {
+			gx.data(), gy.data(), gz.data(), ax.data(), ay.data(), az.data(),
+			withMagnetometer ? mx.data() : nullptr, withMagnetometer ? my.data() : nullptr,
+			withMagnetometer ? mz.data() : nullptr
+		};
+
+		return samples;
+	}
+};
+
+// Runs the batch, through the kernel asked for, next to one MadgwickFilter per filter and returns the largest
+// difference between their quaternions over the whole run
+static float largestDifference(bool vectorKernel, bool withMagnetometer)
+{
+	MadgwickBatch batch(FILTERS);
+	vector<MadgwickFilter> filters(FILTERS);
+	BatchSamples samples;
+	float largest = 0.0f;
+
+	batch.setVectorKernel(vectorKernel);
+
+	for (int f = 0; f < FILTERS; f++)
+	{
+		float beta = 0.02f + 0.01f * f;
+
+		batch.setBeta(f, beta);
+		filters[f].setBeta(beta);
+	}
+
+	for (int step = 0; step < STEPS; step++)
+	{
+		samples.generate(step);
+		batch.update(samples.view(withMagnetometer), DT);
+
+		for (int f = 0; f < FILTERS; f++)
+		{
+			if (withMagnetometer)
+			{
+				filters[f].update(samples.gx[f], samples.gy[f], samples.gz[f], samples.ax[f], samples.ay[f],
+					samples.az[f], samples.mx[f], samples.my[f], samples.mz[f], DT);
+			}
+			else
+			{
+				filters[f].updateIMU(samples.gx[f], samples.gy[f], samples.gz[f], samples.ax[f], samples.ay[f],
+					samples.az[f], DT);
+			}
+
+			MadgwickQuaternion_t expected = filters[f].getQuaternion();
+			MadgwickQuaternion_t actual = batch.getQuaternion(f);
+
+			largest = fmaxf(largest, fabsf(expected.q0 - actual.q0));
+			largest = fmaxf(largest, fabsf(expected.q1 - actual.q1));
+			largest = fmaxf(largest, fabsf(expected.q2 - actual.q2));
+			largest = fmaxf(largest, fabsf(expected.q3 - actual.q3));
+		}
+	}
+
+	return largest;
+}
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(MadgwickBatch, MatchesTheScalarFiltersWithMagnetometer) {
+
+   	/***********************SETUP***********************/
+
+	/********************STEPTHROUGH********************/
+
+	float vectorDifference = largestDifference(true, true);
+	float scalarDifference = largestDifference(false, true);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_LE(vectorDifference, TOLERANCE);
+	EXPECT_LE(scalarDifference, TOLERANCE);
+}
+
+TEST(MadgwickBatch, MatchesTheScalarFiltersWithoutMagnetometer) {
+
+   	/***********************SETUP***********************/
+
+	/********************STEPTHROUGH********************/
+
+	float vectorDifference = largestDifference(true, false);
+	float scalarDifference = largestDifference(false, false);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_LE(vectorDifference, TOLERANCE);
+	EXPECT_LE(scalarDifference, TOLERANCE);
+}
+
+TEST(MadgwickBatch, ResetKeepsTheGains) {
+
+   	/***********************SETUP***********************/
+
+	MadgwickBatch batch(FILTERS, 0.05f);
+	BatchSamples samples;
+	samples.generate(10);
+
+	batch.setBeta(3, 0.2f);
+	batch.update(samples.view(true), DT);
+
+	/********************STEPTHROUGH********************/
+
+	batch.reset();
+
+	/**********************ASSERTS**********************/
+
+	MadgwickQuaternion_t q = batch.getQuaternion(FILTERS - 1);
+
+	EXPECT_EQ(q.q0, 1.0f);
+	EXPECT_EQ(q.q1, 0.0f);
+	EXPECT_EQ(q.q2, 0.0f);
+	EXPECT_EQ(q.q3, 0.0f);
+	EXPECT_EQ(batch.getBeta(3), 0.2f);
+	EXPECT_EQ(batch.getBeta(4), 0.05f);
+}
@@ -0,0 +1,250 @@
+/*
+* Tests for the Madgwick filter instances
+*/
+
+#include <gtest/gtest.h>
+
+#include "MadgwickAHRS.h"
+#include "SensorFusion.hpp"
+#include "AttitudeTask.hpp"
+
+#include <math.h>
+#include <string>
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define GRAVITY 9.81f
+
+static void expectQuaternionsEqual(const MadgwickQuaternion_t &expected, const MadgwickQuaternion_t &actual)
+{
+	EXPECT_EQ(expected.q0, actual.q0);
+	EXPECT_EQ(expected.q1, actual.q1);
+	EXPECT_EQ(expected.q2, actual.q2);
+	EXPECT_EQ(expected.q3, actual.q3);
+}
+
+static IMU_Data_t makeLevelSample(float rollRate)
+{
+	IMU_Data_t imu = {};
+
+	imu.gyrx = rollRate;
+	imu.accz = GRAVITY;
+	imu.magx = 0.0f;
+	imu.magy = 0.0f;
+	imu.magz = 0.0f;
+	imu.isDataNew = true;
+	imu.sensorStatus = 0;
+
+	return imu;
+}
+
+// Rolls at a constant rate for two seconds, sampled at loopRateHz, and returns the roll error at the end in deg.
+// The accelerometer sees gravity rotating with the true attitude.
+static float rollErrorAfterConstantRoll(float loopRateHz, bool useSampleTimes)
+{
+	const float rollRate = 0.5f;  // rad/s
+	const float duration = 2.0f;  // s
+
+	MadgwickFilter filter;
+	int samples = (int) (duration * loopRateHz);
+	float trueRoll = 0.0f;
+
+	for (int i = 1; i <= samples; i++)
+	{
+		uint32_t sampleTimeUs = (uint32_t) (i * 1000000.0 / loopRateHz);
+		trueRoll = rollRate * sampleTimeUs * 1e-6f;
+
+		float dt = useSampleTimes ? filter.getTimeStep(sampleTimeUs) : 1.0f / filter.getSampleFrequency();
+		filter.updateIMU(rollRate, 0.0f, 0.0f, 0.0f, GRAVITY * sinf(trueRoll), GRAVITY * cosf(trueRoll), dt);
+	}
+
+	MadgwickQuaternion_t q = filter.getQuaternion();
+	float estimatedRoll = atan2f(2.0f * (q.q0 * q.q1 + q.q2 * q.q3), 1.0f - 2.0f * (q.q1 * q.q1 + q.q2 * q.q2));
+
+	return fabsf(estimatedRoll - trueRoll) * 57.29578f;
+}
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(MadgwickFilter, TwoInstancesDivergeIndependently) {
+
+   	/***********************SETUP***********************/
+
+	MadgwickFilter rolling;
+	MadgwickFilter still;
+
+	/********************STEPTHROUGH********************/
+
+	for (int i = 0; i < 100; i++)
+	{
+		rolling.updateIMU(0.5f, 0.0f, 0.0f, 0.0f, 0.0f, GRAVITY);
+		still.updateIMU(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, GRAVITY);
+	}
+
+	/**********************ASSERTS**********************/
+
+	// Only the magnitude of the still filter's quaternion moves, by the error of the fast inverse square root
+	EXPECT_EQ(still.getQuaternion().q1, 0.0f);
+	EXPECT_EQ(still.getQuaternion().q2, 0.0f);
+	EXPECT_EQ(still.getQuaternion().q3, 0.0f);
+	EXPECT_GT(rolling.getQuaternion().q1, 0.01f);
+	EXPECT_NE(rolling.getQuaternionRate().q1, 0.0f);
+	EXPECT_EQ(still.getQuaternionRate().q1, 0.0f);
+}
+
+TEST(MadgwickFilter, GainOnlyAffectsItsOwnInstance) {
+
+   	/***********************SETUP***********************/
+
+	MadgwickFilter slow(ATTITUDE_TASK_RATE_HZ, 0.01f);
+	MadgwickFilter fast(ATTITUDE_TASK_RATE_HZ, 1.0f);
+
+	/********************STEPTHROUGH********************/
+
+	// Both start level while the accelerometer says the aircraft is rolled, the higher gain converges quicker
+	for (int i = 0; i < 50; i++)
+	{
+		slow.updateIMU(0.0f, 0.0f, 0.0f, 0.0f, GRAVITY * 0.5f, GRAVITY * 0.866f);
+		fast.updateIMU(0.0f, 0.0f, 0.0f, 0.0f, GRAVITY * 0.5f, GRAVITY * 0.866f);
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(slow.getBeta(), 0.01f);
+	EXPECT_EQ(fast.getBeta(), 1.0f);
+	EXPECT_GT(fabsf(fast.getQuaternion().q1), 10.0f * fabsf(slow.getQuaternion().q1));
+}
+
+TEST(MadgwickFilter, CFunctionsRunTheDefaultInstance) {
+
+   	/***********************SETUP***********************/
+
+	MadgwickFilter reference;
+	MadgwickAHRS_GetDefaultFilter().reset();
+
+	float q0, q1, q2, q3;
+
+	/********************STEPTHROUGH********************/
+
+	for (int i = 0; i < 20; i++)
+	{
+		reference.update(0.1f, -0.2f, 0.3f, 0.5f, 0.1f, GRAVITY, 0.3f, 0.0f, 0.4f);
+		MadgwickAHRSupdate(0.1f, -0.2f, 0.3f, 0.5f, 0.1f, GRAVITY, 0.3f, 0.0f, 0.4f);
+	}
+
+	MadgwickAHRSgetQuaternion(&q0, &q1, &q2, &q3);
+
+	/**********************ASSERTS**********************/
+
+	MadgwickQuaternion_t expected = reference.getQuaternion();
+	MadgwickQuaternion_t actual = {q0, q1, q2, q3};
+
+	expectQuaternionsEqual(expected, actual);
+	expectQuaternionsEqual(expected, MadgwickAHRS_GetDefaultFilter().getQuaternion());
+}
+
+TEST(MadgwickFilter, SensorFusionRunsTheFilterItIsGiven) {
+
+   	/***********************SETUP***********************/
+
+	MadgwickFilter primary;
+	MadgwickFilter shadow;
+
+	MadgwickAHRS_GetDefaultFilter().reset();
+	MadgwickQuaternion_t defaultBefore = MadgwickAHRS_GetDefaultFilter().getQuaternion();
+
+	Airspeed_Data_t airspeed = {};
+	airspeed.isDataNew = true;
+	airspeed.sensorStatus = 0;
+
+	SFOutput_t primaryOutput;
+	SFOutput_t shadowOutput;
+
+	/********************STEPTHROUGH********************/
+
+	for (int i = 0; i < 100; i++)
+	{
+		IMU_Data_t rolling = makeLevelSample(0.5f);
+		IMU_Data_t still = makeLevelSample(0.0f);
+
+		SF_GetResultFrom(primary, &primaryOutput, &rolling, &airspeed);
+		SF_GetResultFrom(shadow, &shadowOutput, &still, &airspeed);
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_GT(primaryOutput.IMUroll, 1.0f);
+	EXPECT_EQ(shadowOutput.IMUroll, 0.0f);
+	expectQuaternionsEqual(defaultBefore, MadgwickAHRS_GetDefaultFilter().getQuaternion());
+}
+
+TEST(MadgwickFilter, TimeStepFollowsSampleTimesWithinLimits) {
+
+   	/***********************SETUP***********************/
+
+	MadgwickFilter filter;
+	MadgwickFilter wrapping;
+	const float nominal = 1.0f / ATTITUDE_TASK_RATE_HZ;
+
+	/********************STEPTHROUGH********************/
+
+	float first = filter.getTimeStep(1000000u);
+	float regular = filter.getTimeStep(1005000u);
+	float repeated = filter.getTimeStep(1005000u);
+	float tooShort = filter.getTimeStep(1005010u);
+	float tooLong = filter.getTimeStep(1105010u);
+	float gap = filter.getTimeStep(2105010u);
+
+	wrapping.getTimeStep(UINT32_MAX - 999u);
+	float acrossWrap = wrapping.getTimeStep(1000u);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(first, nominal);
+	EXPECT_FLOAT_EQ(regular, 0.005f);
+	EXPECT_EQ(repeated, nominal);
+	EXPECT_EQ(tooShort, MADGWICK_MIN_DT);
+	EXPECT_EQ(tooLong, MADGWICK_MAX_DT);
+	EXPECT_EQ(gap, nominal);
+	EXPECT_FLOAT_EQ(acrossWrap, 0.002f);
+	EXPECT_EQ(filter.getGapCount(), 1u);
+}
+
+TEST(MadgwickFilter, SampleTimesKeepTheEstimateAcrossLoopRates) {
+
+   	/***********************SETUP***********************/
+
+	const float loopRates[] = {20.0f, 50.0f, 100.0f, 200.0f, 512.0f, 1000.0f};
+	const int numRates = sizeof(loopRates) / sizeof(loopRates[0]);
+
+	float timedError[numRates];
+	float fixedError[numRates];
+
+	/********************STEPTHROUGH********************/
+
+	for (int i = 0; i < numRates; i++)
+	{
+		timedError[i] = rollErrorAfterConstantRoll(loopRates[i], true);
+		fixedError[i] = rollErrorAfterConstantRoll(loopRates[i], false);
+	}
+
+	/**********************ASSERTS**********************/
+
+	for (int i = 0; i < numRates; i++)
+	{
+		// Mostly the first order integration error, which grows with the step
+		EXPECT_LT(timedError[i], 2.0f) << "at " << loopRates[i] << " Hz";
+		RecordProperty("RollErrorDeg" + to_string((int) loopRates[i]) + "Hz", to_string(timedError[i]) + " timed, " + to_string(fixedError[i]) + " fixed");
+	}
+
+	// The fixed nominal step is only right at ATTITUDE_TASK_RATE_HZ, at 512 Hz it already integrates far too much
+	EXPECT_LT(fixedError[3], 1.0f);
+	EXPECT_GT(fixedError[4], 10.0f);
+}
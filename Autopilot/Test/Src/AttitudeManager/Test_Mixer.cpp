@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+
+#include "Mixer.hpp"
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+static PID_Output_t makePidOutput(float roll, float pitch, float yaw, float throttle)
+{
+	PID_Output_t pidOutput;
+	pidOutput.rollPercent = roll;
+	pidOutput.pitchPercent = pitch;
+	pidOutput.yawPercent = yaw;
+	pidOutput.throttlePercent = throttle;
+	pidOutput.sampleTimeUs = 0;
+
+	return pidOutput;
+}
+
+/***********************************************************************************************************************
+ * Mixer Module Tests
+ **********************************************************************************************************************/
+
+TEST(AttitudeManager_Mixer, ConventionalPresetPassesEachAxisToItsChannel) {
+
+   	/***********************SETUP***********************/
+
+	PID_Output_t pidOutput = makePidOutput(10.0f, -20.0f, 30.0f, 40.0f);
+	float channelOut[MIXER_MAX_CHANNELS];
+
+	/********************STEPTHROUGH********************/
+
+	Mixer_error_t error = Mixer_Execute(Mixer_GetPreset(MIXER_PRESET_CONVENTIONAL), &pidOutput, channelOut);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(error.errorCode, 0);
+	EXPECT_EQ(channelOut[ELEVATOR_OUT_CHANNEL], -20.0f);
+	EXPECT_EQ(channelOut[RUDDER_OUT_CHANNEL], 30.0f);
+	EXPECT_EQ(channelOut[AILERON_OUT_CHANNEL], 10.0f);
+	EXPECT_EQ(channelOut[THROTTLE_OUT_CHANNEL], 40.0f);
+}
+
+TEST(AttitudeManager_Mixer, VTailPresetMixesPitchAndYawOnTheRuddervators) {
+
+   	/***********************SETUP***********************/
+
+	const MixerConfig_t *vTail = Mixer_GetPreset(MIXER_PRESET_V_TAIL);
+	PID_Output_t pitchUp = makePidOutput(0.0f, 40.0f, 0.0f, 50.0f);
+	PID_Output_t yawRight = makePidOutput(0.0f, 0.0f, 40.0f, 50.0f);
+	PID_Output_t fullPitchAndYaw = makePidOutput(0.0f, 100.0f, 100.0f, 50.0f);
+
+	float pitchOut[MIXER_MAX_CHANNELS], yawOut[MIXER_MAX_CHANNELS], fullOut[MIXER_MAX_CHANNELS];
+
+	/********************STEPTHROUGH********************/
+
+	Mixer_Execute(vTail, &pitchUp, pitchOut);
+	Mixer_Execute(vTail, &yawRight, yawOut);
+	Mixer_Execute(vTail, &fullPitchAndYaw, fullOut);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(vTail->numChannels, 4);
+
+	// Pitch moves the ruddervators apart, yaw together
+	EXPECT_EQ(pitchOut[0], -30.0f);
+	EXPECT_EQ(pitchOut[1], 30.0f);
+	EXPECT_EQ(yawOut[0], 30.0f);
+	EXPECT_EQ(yawOut[1], 30.0f);
+
+	EXPECT_EQ(fullOut[0], 0.0f);
+	EXPECT_EQ(fullOut[1], 100.0f);
+	EXPECT_EQ(fullOut[3], 50.0f);
+}
+
+TEST(AttitudeManager_Mixer, FlyingWingPresetMixesPitchAndRollOnTheElevons) {
+
+   	/***********************SETUP***********************/
+
+	const MixerConfig_t *wing = Mixer_GetPreset(MIXER_PRESET_FLYING_WING);
+	PID_Output_t pitchUp = makePidOutput(0.0f, 60.0f, 0.0f, 30.0f);
+	PID_Output_t rollRight = makePidOutput(60.0f, 0.0f, 25.0f, 30.0f);
+
+	float pitchOut[MIXER_MAX_CHANNELS], rollOut[MIXER_MAX_CHANNELS];
+
+	/********************STEPTHROUGH********************/
+
+	Mixer_Execute(wing, &pitchUp, pitchOut);
+	Mixer_Execute(wing, &rollRight, rollOut);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(wing->numChannels, 3);
+
+	EXPECT_EQ(pitchOut[0], 30.0f);
+	EXPECT_EQ(pitchOut[1], 30.0f);
+	EXPECT_EQ(pitchOut[2], 30.0f);
+
+	// A wing has no rudder, so the yaw command does nothing
+	EXPECT_EQ(rollOut[0], 30.0f);
+	EXPECT_EQ(rollOut[1], -30.0f);
+	EXPECT_EQ(rollOut[2], 30.0f);
+}
+
+TEST(AttitudeManager_Mixer, QuadXPresetControlsAttitudeWithDifferentialThrust) {
+
+   	/***********************SETUP***********************/
+
+	const MixerConfig_t *quad = Mixer_GetPreset(MIXER_PRESET_QUAD_X);
+	PID_Output_t hover = makePidOutput(0.0f, 0.0f, 0.0f, 50.0f);
+	PID_Output_t rollRight = makePidOutput(20.0f, 0.0f, 0.0f, 50.0f);
+	PID_Output_t pitchUp = makePidOutput(0.0f, 20.0f, 0.0f, 50.0f);
+	PID_Output_t yawRight = makePidOutput(0.0f, 0.0f, 20.0f, 50.0f);
+	PID_Output_t idleRoll = makePidOutput(100.0f, 0.0f, 0.0f, 10.0f);
+
+	float hoverOut[MIXER_MAX_CHANNELS], rollOut[MIXER_MAX_CHANNELS], pitchOut[MIXER_MAX_CHANNELS];
+	float yawOut[MIXER_MAX_CHANNELS], idleOut[MIXER_MAX_CHANNELS];
+
+	/********************STEPTHROUGH********************/
+
+	Mixer_Execute(quad, &hover, hoverOut);
+	Mixer_Execute(quad, &rollRight, rollOut);
+	Mixer_Execute(quad, &pitchUp, pitchOut);
+	Mixer_Execute(quad, &yawRight, yawOut);
+	Mixer_Execute(quad, &idleRoll, idleOut);
+
+	/**********************ASSERTS**********************/
+
+	// front left, front right, rear right, rear left
+	for (int motor = 0; motor < 4; motor++)
+	{
+		EXPECT_EQ(hoverOut[motor], 50.0f);
+	}
+
+	EXPECT_EQ(rollOut[0], 60.0f);
+	EXPECT_EQ(rollOut[1], 40.0f);
+	EXPECT_EQ(rollOut[2], 40.0f);
+	EXPECT_EQ(rollOut[3], 60.0f);
+
+	EXPECT_EQ(pitchOut[0], 60.0f);
+	EXPECT_EQ(pitchOut[1], 60.0f);
+	EXPECT_EQ(pitchOut[2], 40.0f);
+	EXPECT_EQ(pitchOut[3], 40.0f);
+
+	// The front right and rear left propellers turn anticlockwise
+	EXPECT_EQ(yawOut[0], 40.0f);
+	EXPECT_EQ(yawOut[1], 60.0f);
+	EXPECT_EQ(yawOut[2], 40.0f);
+	EXPECT_EQ(yawOut[3], 60.0f);
+
+	// Motors never run backwards
+	EXPECT_EQ(idleOut[0], 60.0f);
+	EXPECT_EQ(idleOut[1], 0.0f);
+	EXPECT_EQ(idleOut[2], 0.0f);
+	EXPECT_EQ(idleOut[3], 60.0f);
+}
+
+TEST(AttitudeManager_Mixer, RuntimeTableAppliesReversalTrimAndLimitsPerChannel) {
+
+   	/***********************SETUP***********************/
+
+	MixerConfig_t config = {};
+	config.numChannels = MIXER_MAX_CHANNELS;
+
+	// Every channel follows the roll, channel i with a trim of i and limits of +-(50 + i), odd channels reversed
+	for (int channel = 0; channel < MIXER_MAX_CHANNELS; channel++)
+	{
+		config.weights[channel][MIXER_ROLL] = 1.0f;
+		config.trim[channel] = (float) channel;
+		config.minOutput[channel] = -50.0f - channel;
+		config.maxOutput[channel] = 50.0f + channel;
+		config.reversed[channel] = (channel % 2) == 1;
+	}
+
+	PID_Output_t small = makePidOutput(10.0f, 0.0f, 0.0f, 0.0f);
+	PID_Output_t large = makePidOutput(100.0f, 0.0f, 0.0f, 0.0f);
+
+	float smallOut[MIXER_MAX_CHANNELS], largeOut[MIXER_MAX_CHANNELS];
+
+	/********************STEPTHROUGH********************/
+
+	Mixer_error_t error = Mixer_Execute(&config, &small, smallOut);
+	Mixer_Execute(&config, &large, largeOut);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(error.errorCode, 0);
+
+	for (int channel = 0; channel < MIXER_MAX_CHANNELS; channel++)
+	{
+		bool reversed = (channel % 2) == 1;
+
+		EXPECT_EQ(smallOut[channel], (reversed ? -10.0f : 10.0f) + channel);
+		EXPECT_EQ(largeOut[channel], reversed ? -50.0f - channel : 50.0f + channel);
+	}
+}
+
+TEST(AttitudeManager_Mixer, TooManyChannelsReturnsError1AndWritesNothing) {
+
+   	/***********************SETUP***********************/
+
+	MixerConfig_t config = *Mixer_GetPreset(MIXER_PRESET_CONVENTIONAL);
+	config.numChannels = MIXER_MAX_CHANNELS + 1;
+
+	PID_Output_t pidOutput = makePidOutput(10.0f, 10.0f, 10.0f, 10.0f);
+	float channelOut[MIXER_MAX_CHANNELS + 1] = {};
+
+	/********************STEPTHROUGH********************/
+
+	Mixer_error_t error = Mixer_Execute(&config, &pidOutput, channelOut);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(error.errorCode, 1);
+	EXPECT_EQ(channelOut[0], 0.0f);
+	EXPECT_EQ(Mixer_GetPreset(MIXER_NUM_PRESETS), nullptr);
+}
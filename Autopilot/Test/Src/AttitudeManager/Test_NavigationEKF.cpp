@@ -0,0 +1,253 @@
+/*
+* Tests for the error state EKF sensor fusion engine
+*/
+
+#include <gtest/gtest.h>
+
+#include "NavigationEKF.hpp"
+#include "SensorFusion.hpp"
+
+#include <math.h>
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define DT 0.005f
+
+static IMU_Data_t makeImuSample(float gx, float gy, float gz, float ax, float ay, float az, uint32_t sampleTimeUs)
+{
+	IMU_Data_t imu = {};
+
+	imu.gyrx = gx;
+	imu.gyry = gy;
+	imu.gyrz = gz;
+	imu.accx = ax;
+	imu.accy = ay;
+	imu.accz = az;
+	imu.isDataNew = true;
+	imu.sensorStatus = 0;
+	imu.sampleTimeUs = sampleTimeUs;
+
+	return imu;
+}
+
+static GpsData_t makeFix(long double latitude, long double longitude, int altitude)
+{
+	GpsData_t gps = {};
+
+	gps.latitude = latitude;
+	gps.longitude = longitude;
+	gps.altitude = altitude;
+	gps.sensorStatus = 1;
+	gps.dataIsNew = true;
+
+	return gps;
+}
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(NavigationEKF, FirstSampleLevelsTheFilter) {
+
+   	/***********************SETUP***********************/
+
+	NavigationEKF ekf;
+	SFOutput_t output;
+
+	Airspeed_Data_t airspeed = {};
+	airspeed.isDataNew = true;
+
+	// Rolled 20 degrees
+	float roll = 20.0f * 0.017453293f;
+	IMU_Data_t imu = makeImuSample(0.0f, 0.0f, 0.0f, 0.0f, EKF_GRAVITY * sinf(roll), EKF_GRAVITY * cosf(roll), 1000);
+
+	/********************STEPTHROUGH********************/
+
+	bool alignedBefore = ekf.isAligned();
+	SFError_t error = SF_GetResultFrom(ekf, &output, &imu, &airspeed, nullptr, nullptr);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_FALSE(alignedBefore);
+	EXPECT_TRUE(ekf.isAligned());
+	EXPECT_EQ(error.errorCode, 0);
+	EXPECT_NEAR(output.IMUroll, 20.0f, 0.01f);
+	EXPECT_NEAR(output.IMUpitch, 0.0f, 0.01f);
+	EXPECT_EQ(output.sampleTimeUs, 1000u);
+}
+
+TEST(NavigationEKF, LearnsTheGyroBiasAtRest) {
+
+   	/***********************SETUP***********************/
+
+	NavigationEKF ekf;
+	ekf.alignToGravity(0.0f, 0.0f, EKF_GRAVITY);
+
+	const float biasX = 0.01f;
+	const float biasY = -0.02f;
+
+	/********************STEPTHROUGH********************/
+
+	// A minute at rest
+	for (int i = 0; i < 12000; i++)
+	{
+		ekf.predict(biasX, biasY, 0.0f, 0.0f, 0.0f, EKF_GRAVITY, DT);
+		ekf.updateGravity(0.0f, 0.0f, EKF_GRAVITY, 0.0f);
+	}
+
+	float rates[3];
+	ekf.getBodyRates(rates);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_NEAR(ekf.getState().gyroBias[0], biasX, 0.001f);
+	EXPECT_NEAR(ekf.getState().gyroBias[1], biasY, 0.001f);
+	EXPECT_NEAR(rates[0], 0.0f, 0.001f);
+	EXPECT_NEAR(rates[1], 0.0f, 0.001f);
+
+	// Still level
+	EXPECT_NEAR(ekf.getState().quaternion[0], 1.0f, 1e-4f);
+}
+
+TEST(NavigationEKF, GpsSetsTheOriginAndCorrectsPosition) {
+
+   	/***********************SETUP***********************/
+
+	NavigationEKF ekf;
+	ekf.alignToGravity(0.0f, 0.0f, EKF_GRAVITY);
+
+	GpsData_t origin = makeFix(43.47L, -80.54L, 300);
+
+	// 4 m north and 3 m east of the origin, inside the innovation gate
+	GpsData_t moved = makeFix(43.47L + 4.0L / 6371000.0L * 57.29577951308232L,
+	                          -80.54L + 3.0L / (6371000.0L * cosl(43.47L / 57.29577951308232L)) * 57.29577951308232L, 302);
+
+	/********************STEPTHROUGH********************/
+
+	int acceptedAtOrigin = ekf.updateGps(origin);
+
+	// Ten seconds of 5 Hz fixes
+	for (int i = 0; i < 2000; i++)
+	{
+		ekf.predict(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, EKF_GRAVITY, DT);
+		ekf.updateGravity(0.0f, 0.0f, EKF_GRAVITY, 0.0f);
+
+		if (i % 40 == 0)
+		{
+			ekf.updateGps(moved);
+		}
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(acceptedAtOrigin, 5);
+	EXPECT_NEAR(ekf.getState().position[0], 4.0f, 0.5f);
+	EXPECT_NEAR(ekf.getState().position[1], -3.0f, 0.5f);
+	EXPECT_NEAR(ekf.getState().position[2], 302.0f, 0.5f);
+}
+
+TEST(NavigationEKF, OutliersAreRejected) {
+
+   	/***********************SETUP***********************/
+
+	NavigationEKF ekf;
+	ekf.alignToGravity(0.0f, 0.0f, EKF_GRAVITY);
+
+	for (int i = 0; i < 50; i++)
+	{
+		ekf.updateAltitude(300.0f);
+	}
+
+	float altitudeBefore = ekf.getState().position[2];
+	uint32_t rejectedBefore = ekf.getRejectedCount();
+
+	/********************STEPTHROUGH********************/
+
+	int accepted = ekf.updateAltitude(1300.0f);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(accepted, 0);
+	EXPECT_EQ(ekf.getRejectedCount(), rejectedBefore + 1);
+	EXPECT_EQ(ekf.getState().position[2], altitudeBefore);
+}
+
+TEST(NavigationEKF, CovarianceStaysSymmetricWithPositiveVariances) {
+
+   	/***********************SETUP***********************/
+
+	NavigationEKF ekf;
+	ekf.alignToGravity(0.0f, 0.0f, EKF_GRAVITY);
+
+	GpsData_t gps = makeFix(43.47L, -80.54L, 300);
+
+	/********************STEPTHROUGH********************/
+
+	for (int i = 0; i < 4000; i++)
+	{
+		float t = i * DT;
+		ekf.predict(0.3f * sinf(t), 0.1f * cosf(t), 0.05f, 0.2f, 0.1f, EKF_GRAVITY, DT);
+		ekf.updateGravity(0.2f, 0.1f, EKF_GRAVITY, 15.0f);
+
+		if (i % 40 == 0)
+		{
+			ekf.updateGps(gps);
+			ekf.updateAltitude(300.0f);
+		}
+	}
+
+	/**********************ASSERTS**********************/
+
+	const NavigationEKF::Covariance &P = ekf.getCovariance();
+
+	for (int i = 0; i < EKF_NUM_STATES; i++)
+	{
+		EXPECT_GT(P(i, i), 0.0f) << "state " << i;
+
+		for (int j = 0; j < EKF_NUM_STATES; j++)
+		{
+			EXPECT_EQ(P(i, j), P(j, i)) << "at " << i << ", " << j;
+		}
+	}
+}
+
+TEST(NavigationEKF, SelectedEngineRunsBehindSFGetResult) {
+
+   	/***********************SETUP***********************/
+
+	Airspeed_Data_t airspeed = {};
+	airspeed.isDataNew = true;
+
+	SFOutput_t ekfOutput;
+	SFOutput_t madgwickOutput;
+
+	/********************STEPTHROUGH********************/
+
+	SF_SelectEngine(SF_ENGINE_EKF);
+	SFEngine_t selected = SF_GetEngine();
+
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		IMU_Data_t imu = makeImuSample(0.5f, 0.0f, 0.0f, 0.0f, 0.0f, EKF_GRAVITY, 5000 * i);
+		SF_GetResult(&ekfOutput, &imu, &airspeed);
+	}
+
+	SF_SelectEngine(SF_ENGINE_MADGWICK);
+
+	IMU_Data_t imu = makeImuSample(0.5f, 0.0f, 0.0f, 0.0f, 0.0f, EKF_GRAVITY, 15000);
+	SF_GetResult(&madgwickOutput, &imu, &airspeed);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(selected, SF_ENGINE_EKF);
+	EXPECT_EQ(SF_GetEngine(), SF_ENGINE_MADGWICK);
+
+	// The EKF reports the gyro, Madgwick the derivative of its quaternion
+	EXPECT_NEAR(ekfOutput.IMUrollrate, 0.5f * 57.29578f, 0.5f);
+	EXPECT_GT(fabsf(madgwickOutput.IMUrollrate - ekfOutput.IMUrollrate), 1.0f);
+}
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include "fff.h"
+
+#include "SendInstructionsToSafety.hpp"
+#include "Interchip_A.h"
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Test Fixtures
+ **********************************************************************************************************************/
+
+// Each of the interchip setters takes the interchip mutex exactly once
+FAKE_VOID_FUNC(Interchip_SetPWM, int16_t *);
+FAKE_VOID_FUNC(Interchip_SetFrame, const int16_t *, uint32_t, uint32_t);
+FAKE_VOID_FUNC(Interchip_SetSampleTime, uint32_t);
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define ARBITRARY_SAMPLE_TIME_US 123456u
+
+static int lockAcquisitions(void)
+{
+	return Interchip_SetPWM_fake.call_count + Interchip_SetFrame_fake.call_count + Interchip_SetSampleTime_fake.call_count;
+}
+
+class AttitudeManager_SendToSafety : public ::testing::Test
+{
+	public:
+
+		virtual void SetUp()
+		{
+			SendToSafety_Init();
+
+			// The hand-off that clears the initial frame
+			const float zeros[INTERCHIP_PWM_CHANNELS] = {0};
+			SendToSafety_Commit(zeros, INTERCHIP_PWM_CHANNELS, 0);
+
+			RESET_FAKE(Interchip_SetPWM);
+			RESET_FAKE(Interchip_SetFrame);
+			RESET_FAKE(Interchip_SetSampleTime);
+			FFF_RESET_HISTORY();
+		}
+};
+
+/***********************************************************************************************************************
+ * Send To Safety Module Tests
+ **********************************************************************************************************************/
+
+TEST_F(AttitudeManager_SendToSafety, CommitTakesTheLockOncePerFrame) {
+
+   	/***********************SETUP***********************/
+
+	const float frame[4] = {10.0f, -20.0f, 30.0f, 40.0f};
+
+	/********************STEPTHROUGH********************/
+
+	SendToSafety_error_t error = SendToSafety_Commit(frame, 4, ARBITRARY_SAMPLE_TIME_US);
+	int commitLocks = lockAcquisitions();
+
+	// The same frame one channel at a time, as the attitude manager used to send it
+	for (int channel = 0; channel < 4; channel++)
+	{
+		SendToSafety_Execute(channel, frame[channel] + 1.0f);
+	}
+	SendToSafety_SetSampleTime(ARBITRARY_SAMPLE_TIME_US);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(error.errorCode, 0);
+	EXPECT_EQ(commitLocks, 1);
+	EXPECT_EQ(lockAcquisitions() - commitLocks, 5);
+
+	EXPECT_EQ(Interchip_SetFrame_fake.arg1_history[0], 0xFu);
+	EXPECT_EQ(Interchip_SetFrame_fake.arg2_history[0], ARBITRARY_SAMPLE_TIME_US);
+}
+
+TEST_F(AttitudeManager_SendToSafety, UnchangedFrameSkipsTheHandOff) {
+
+   	/***********************SETUP***********************/
+
+	const float frame[4] = {10.0f, -20.0f, 30.0f, 40.0f};
+
+	// Different before the truncation to whole percents only
+	const float sameAfterTruncation[4] = {10.75f, -20.5f, 30.25f, 40.0f};
+
+	/********************STEPTHROUGH********************/
+
+	SendToSafety_Commit(frame, 4, ARBITRARY_SAMPLE_TIME_US);
+	SendToSafety_Commit(frame, 4, ARBITRARY_SAMPLE_TIME_US + 1);
+	SendToSafety_error_t error = SendToSafety_Commit(sameAfterTruncation, 4, ARBITRARY_SAMPLE_TIME_US + 2);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(error.errorCode, 0);
+	EXPECT_EQ(lockAcquisitions(), 1);
+}
+
+TEST_F(AttitudeManager_SendToSafety, OnlyChangedChannelsAreMarkedDirty) {
+
+   	/***********************SETUP***********************/
+
+	const float first[4] = {10.0f, -20.0f, 30.0f, 40.0f};
+	const float second[4] = {10.0f, -20.0f, 35.0f, 40.0f};
+
+	/********************STEPTHROUGH********************/
+
+	SendToSafety_Commit(first, 4, ARBITRARY_SAMPLE_TIME_US);
+	SendToSafety_Commit(second, 4, ARBITRARY_SAMPLE_TIME_US + 1);
+
+	/**********************ASSERTS**********************/
+
+	ASSERT_EQ(Interchip_SetFrame_fake.call_count, 2u);
+	EXPECT_EQ(Interchip_SetFrame_fake.arg1_history[1], 0x4u);
+	EXPECT_EQ(Interchip_SetFrame_fake.arg2_history[1], ARBITRARY_SAMPLE_TIME_US + 1);
+	EXPECT_EQ(Interchip_SetFrame_fake.arg0_val[2], 35);
+	EXPECT_EQ(Interchip_SetFrame_fake.arg0_val[1], -20);
+}
+
+TEST_F(AttitudeManager_SendToSafety, InitSendsEveryChannelAgain) {
+
+   	/***********************SETUP***********************/
+
+	const float zeros[INTERCHIP_PWM_CHANNELS] = {0};
+
+	/********************STEPTHROUGH********************/
+
+	SendToSafety_Init();
+	SendToSafety_Commit(zeros, INTERCHIP_PWM_CHANNELS, ARBITRARY_SAMPLE_TIME_US);
+
+	/**********************ASSERTS**********************/
+
+	ASSERT_EQ(Interchip_SetFrame_fake.call_count, 1u);
+	EXPECT_EQ(Interchip_SetFrame_fake.arg1_val, 0xFFFu);
+}
+
+TEST_F(AttitudeManager_SendToSafety, TooManyChannelsReturnsError1) {
+
+   	/***********************SETUP***********************/
+
+	const float frame[INTERCHIP_PWM_CHANNELS + 1] = {0};
+
+	/********************STEPTHROUGH********************/
+
+	SendToSafety_error_t error = SendToSafety_Commit(frame, INTERCHIP_PWM_CHANNELS + 1, ARBITRARY_SAMPLE_TIME_US);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(error.errorCode, 1);
+	EXPECT_EQ(lockAcquisitions(), 0);
+}
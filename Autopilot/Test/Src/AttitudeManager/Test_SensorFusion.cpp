@@ -11,6 +11,7 @@
 #include "airspeed_Mock.hpp"
 #include "IMU_Mock.hpp"
 #include "SensorFusion.hpp"
+#include "SyntheticFlight.hpp"
 #include "fetchSensorMeasurementsMode.hpp"
 
 #include <math.h>
@@ -20,6 +21,7 @@ using namespace std;
 using ::testing::Test;
 using ::testing::_;
 using ::testing::SetArgReferee;
+using ::testing::DoAll;
 
 /***********************************************************************************************************************
  * Mocks
@@ -33,6 +35,61 @@ airspeedData_t airspeedTestData;
 IMU_Data_t IMUAttitudeTestData;
 Airspeed_Data_t AirspeedAttitudeTestData;
 
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define SYNTHETIC_DURATION_S 30
+#define SYNTHETIC_SETTLING_S 5
+
+struct TiltErrors_t
+{
+	double rms, max;	// deg
+};
+
+// Flies the trajectory through SF_GetResultFrom on the given engine, with GPS and barometer to the EKF
+static TiltErrors_t tiltErrorsOnSyntheticFlight(SyntheticTrajectory_t trajectory, SFEngine_t engine)
+{
+	SyntheticFlightConfig_t config = SyntheticFlight_DefaultConfig();
+	SyntheticFlight flight(trajectory, config);
+	MadgwickFilter madgwick(config.rateHz);
+	NavigationEKF ekf;
+
+	TiltErrors_t errors = {0.0, 0.0};
+	int counted = 0;
+
+	for (int i = 0; i < SYNTHETIC_DURATION_S * (int) config.rateHz; i++)
+	{
+		SyntheticSample_t sample;
+		SFOutput_t output;
+
+		flight.next(sample);
+
+		if (engine == SF_ENGINE_EKF)
+		{
+			SF_GetResultFrom(ekf, &output, &sample.imu, &sample.airspeed, sample.gpsIsNew ? &sample.gps : nullptr,
+				sample.altimeterIsNew ? &sample.altimeter : nullptr);
+		}
+		else
+		{
+			SF_GetResultFrom(madgwick, &output, &sample.imu, &sample.airspeed);
+		}
+
+		if (sample.truth.time >= SYNTHETIC_SETTLING_S)
+		{
+			double tilt = SyntheticFlight_TiltError(sample.truth, output);
+
+			errors.rms += tilt * tilt;
+			errors.max = (tilt > errors.max) ? tilt : errors.max;
+			counted++;
+		}
+	}
+
+	errors.rms = sqrt(errors.rms / counted);
+
+	return errors;
+}
+
 /***********************************************************************************************************************
  * Tests
  **********************************************************************************************************************/
@@ -174,3 +231,105 @@ TEST(SensorFusion, OldDataReturns1) {
 	EXPECT_EQ(error.errorCode, 1);
 }
 
+
+TEST(SensorFusion, SampleTimeIsCarriedFromTheDriverToTheOutput) {
+
+   	/***********************SETUP***********************/
+	MockIMU imumock;
+	MockAirspeed airspeedmock;
+
+	IMUData_t stampedIMUData = {};
+	airspeedData_t freshAirspeedData = {};
+
+	stampedIMUData.isDataNew = 1;
+	stampedIMUData.accz = 1;
+	stampedIMUData.sampleTimeUs = 123456789u;
+	freshAirspeedData.isDataNew = 1;
+
+	IMU_Data_t imuData;
+	Airspeed_Data_t airspeedData;
+	SFOutput_t output;
+
+	/********************DEPENDENCIES*******************/
+
+	EXPECT_CALL(imumock, GetResult(_))
+		.WillOnce(DoAll(SetArgReferee<0>(stampedIMUData)));
+
+	EXPECT_CALL(airspeedmock, GetResult(_))
+		.WillOnce(DoAll(SetArgReferee<0>(freshAirspeedData)));
+
+	/********************STEPTHROUGH********************/
+
+	SensorError_t fetchMeasurementsError = SensorMeasurements_GetResult(&imumock, &airspeedmock, &imuData, &airspeedData);
+	SFError_t error = SF_GetResult(&output, &imuData, &airspeedData);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(fetchMeasurementsError.errorCode, 0);
+	EXPECT_EQ(error.errorCode, 0);
+	EXPECT_EQ(imuData.sampleTimeUs, 123456789u);
+	EXPECT_EQ(output.sampleTimeUs, 123456789u);
+}
+
+TEST(SensorFusion, MadgwickIntegratesOverTheIntervalTheDriverReports) {
+
+   	/***********************SETUP***********************/
+
+	MadgwickFilter filter;
+
+	IMU_Data_t imuData = {};
+	Airspeed_Data_t airspeedData = {};
+	SFOutput_t output;
+
+	const float rollRate = 1.0f;		// rad/s
+	const float deltaTime = 0.005f;		// s
+
+	imuData.gyrx = rollRate;
+	imuData.isDataNew = true;
+	imuData.deltaTime = deltaTime;
+	airspeedData.isDataNew = true;
+
+	/********************STEPTHROUGH********************/
+
+	// The second stamp comes 20 ms after the first, late by three cycles, the driver still only covers 5 ms
+	imuData.sampleTimeUs = 1000000u;
+	SF_GetResultFrom(filter, &output, &imuData, &airspeedData);
+	float firstRoll = output.IMUroll;
+
+	imuData.sampleTimeUs = 1020000u;
+	SF_GetResultFrom(filter, &output, &imuData, &airspeedData);
+	float secondRoll = output.IMUroll;
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_NEAR(firstRoll, rollRate * deltaTime * 57.29578f, 0.01f);
+	EXPECT_NEAR(secondRoll - firstRoll, rollRate * deltaTime * 57.29578f, 0.01f);
+}
+
+TEST(SensorFusion, MadgwickFollowsRollDoubletsOnASyntheticFlight) {
+
+   	/***********************SETUP***********************/
+
+	/********************STEPTHROUGH********************/
+
+	TiltErrors_t errors = tiltErrorsOnSyntheticFlight(SYNTHETIC_ROLL_DOUBLETS, SF_ENGINE_MADGWICK);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_LT(errors.rms, 1.0);
+	EXPECT_LT(errors.max, 2.0);
+}
+
+TEST(SensorFusion, EkfHoldsTheTiltThroughACoordinatedTurn) {
+
+   	/***********************SETUP***********************/
+
+	/********************STEPTHROUGH********************/
+
+	TiltErrors_t errors = tiltErrorsOnSyntheticFlight(SYNTHETIC_COORDINATED_TURN, SF_ENGINE_EKF);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_LT(errors.rms, 1.0);
+	EXPECT_LT(errors.max, 2.0);
+}
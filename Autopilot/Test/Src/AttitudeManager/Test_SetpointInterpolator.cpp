@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include "SetpointInterpolator.hpp"
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define PERIOD_US 50000u
+#define START_US 1000000u
+
+static const PMCommands INITIAL = {0.0f, 0.0f, 0.0f, 15.0f};
+
+static PathSetpoint_t makeSetpoint(float roll, float pitch, float rudder, float airspeed, uint32_t timeUs)
+{
+	PathSetpoint_t setpoint;
+	setpoint.roll = roll;
+	setpoint.pitch = pitch;
+	setpoint.rudder = rudder;
+	setpoint.airspeed = airspeed;
+	setpoint.timeUs = timeUs;
+
+	return setpoint;
+}
+
+/***********************************************************************************************************************
+ * Setpoint Interpolator Tests
+ **********************************************************************************************************************/
+
+TEST(AttitudeManager_SetpointInterpolator, HoldsTheInitialCommandsUntilTheFirstSetpoint) {
+
+   	/***********************SETUP***********************/
+
+	SetpointInterpolator interpolator(PERIOD_US, INITIAL);
+	PMCommands commands;
+
+	/********************STEPTHROUGH********************/
+
+	interpolator.getCommands(START_US, commands);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(commands.roll, 0.0f);
+	EXPECT_EQ(commands.pitch, 0.0f);
+	EXPECT_EQ(commands.yaw, 0.0f);
+	EXPECT_EQ(commands.airspeed, 15.0f);
+}
+
+TEST(AttitudeManager_SetpointInterpolator, RampsLinearlyToTheSetpointOverOnePeriod) {
+
+   	/***********************SETUP***********************/
+
+	SetpointInterpolator interpolator(PERIOD_US, INITIAL);
+	PMCommands atStart, halfway, atEnd, after;
+
+	/********************STEPTHROUGH********************/
+
+	interpolator.setTarget(makeSetpoint(0.4f, -0.2f, 20.0f, 17.0f, START_US), START_US);
+
+	interpolator.getCommands(START_US, atStart);
+	interpolator.getCommands(START_US + PERIOD_US / 2, halfway);
+	interpolator.getCommands(START_US + PERIOD_US, atEnd);
+	interpolator.getCommands(START_US + 3 * PERIOD_US, after);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(atStart.roll, 0.0f);
+	EXPECT_EQ(atStart.airspeed, 15.0f);
+
+	EXPECT_FLOAT_EQ(halfway.roll, 0.2f);
+	EXPECT_FLOAT_EQ(halfway.pitch, -0.1f);
+	EXPECT_FLOAT_EQ(halfway.yaw, 10.0f);
+	EXPECT_FLOAT_EQ(halfway.airspeed, 16.0f);
+
+	EXPECT_EQ(atEnd.roll, 0.4f);
+	EXPECT_EQ(atEnd.yaw, 20.0f);
+	EXPECT_EQ(after.pitch, -0.2f);
+	EXPECT_EQ(after.airspeed, 17.0f);
+}
+
+TEST(AttitudeManager_SetpointInterpolator, EarlySetpointStartsFromTheCurrentCommands) {
+
+   	/***********************SETUP***********************/
+
+	SetpointInterpolator interpolator(PERIOD_US, INITIAL);
+	PMCommands before, at, halfway;
+
+	const uint32_t earlyUs = START_US + PERIOD_US / 4;
+
+	/********************STEPTHROUGH********************/
+
+	interpolator.setTarget(makeSetpoint(0.4f, 0.0f, 0.0f, 15.0f, START_US), START_US);
+	interpolator.getCommands(earlyUs, before);
+
+	// Back the other way before the first ramp is done
+	interpolator.setTarget(makeSetpoint(-0.4f, 0.0f, 0.0f, 15.0f, earlyUs), earlyUs);
+	interpolator.getCommands(earlyUs, at);
+	interpolator.getCommands(earlyUs + PERIOD_US / 4, halfway);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_FLOAT_EQ(before.roll, 0.1f);
+	EXPECT_EQ(at.roll, before.roll);
+
+	// Stamped a quarter period apart, so the ramp is stretched to the shortest allowed, half a period
+	EXPECT_FLOAT_EQ(halfway.roll, -0.15f);
+}
+
+TEST(AttitudeManager_SetpointInterpolator, RampLengthFollowsTheSetpointStamps) {
+
+   	/***********************SETUP***********************/
+
+	SetpointInterpolator interpolator(PERIOD_US, INITIAL);
+	PMCommands slowHalfway, stalledHalfway;
+
+	uint32_t nowUs = START_US;
+
+	/********************STEPTHROUGH********************/
+
+	interpolator.setTarget(makeSetpoint(0.0f, 0.0f, 0.0f, 15.0f, nowUs), nowUs);
+
+	// The path manager fell to half its rate
+	nowUs += 2 * PERIOD_US;
+	interpolator.setTarget(makeSetpoint(1.0f, 0.0f, 0.0f, 15.0f, nowUs), nowUs);
+	interpolator.getCommands(nowUs + PERIOD_US, slowHalfway);
+
+	// Then stalled for a long time, which does not stretch the ramp past two periods
+	nowUs += 10 * PERIOD_US;
+	interpolator.setTarget(makeSetpoint(0.0f, 0.0f, 0.0f, 15.0f, nowUs), nowUs);
+	interpolator.getCommands(nowUs + PERIOD_US, stalledHalfway);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_FLOAT_EQ(slowHalfway.roll, 0.5f);
+	EXPECT_FLOAT_EQ(stalledHalfway.roll, 0.5f);
+}
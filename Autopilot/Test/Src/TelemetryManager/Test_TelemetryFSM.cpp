@@ -3,14 +3,46 @@
 */
 
 #include <gtest/gtest.h>
+#include "fff.h"
 
 #include "telemetryManager.hpp"
 #include "telemetryStateClasses.hpp"
+#include "Interchip_A.h"
+#include "LatencyTrace.hpp"
 
 
 using namespace std; 
 using ::testing::Test;
 
+FAKE_VALUE_FUNC(uint8_t, Interchip_GetLinkStats, InterchipLinkStats_t *);
+FAKE_VALUE_FUNC(bool, LatencyTrace_GetSummary, LatencySummary_t *);
+FAKE_VALUE_FUNC(size_t, AttitudeRecordingRing_Read, uint8_t *, size_t);
+
+static uint8_t linkStatsWithCrcErrors(InterchipLinkStats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->transfers = 100;
+    stats->crcErrors = 3;
+    return 1;
+}
+
+static size_t recordingBytesUpToTheChunkSize(uint8_t *buffer, size_t maxLength)
+{
+    for (size_t i = 0; i < maxLength; i++)
+    {
+        buffer[i] = (uint8_t) i;
+    }
+    return maxLength;
+}
+
+static bool latencySummaryAfterOneSummaryPeriod(LatencySummary_t *summary)
+{
+    memset(summary, 0, sizeof(*summary));
+    summary->p99Us[LATENCY_STAGE_HANDOFF] = 1500;
+    summary->cycles = LATENCY_SUMMARY_PERIOD;
+    return true;
+}
+
 TEST(TelemetryManagerFSM, InitialStateIsInitialMode){
     /***SETUP***/
     telemetryManager telemetryMng;
@@ -278,3 +310,46 @@ TEST(TelemetryManagerFSM, failToFail){
     /***ASSERTS***/
     EXPECT_EQ(*(telemetryMng.getCurrentState()), failureMode::getInstance());
 }
+
+TEST(TelemetryManagerFSM, reportLoadsInterchipLinkStats){
+    /***SETUP***/
+    RESET_FAKE(Interchip_GetLinkStats);
+    Interchip_GetLinkStats_fake.custom_fake = linkStatsWithCrcErrors;
+    telemetryManager telemetryMng;
+    telemetryMng.setState(reportMode::getInstance());
+    /***STEPTHROUGH***/
+    telemetryMng.execute();
+    /***ASSERTS***/
+    EXPECT_EQ(Interchip_GetLinkStats_fake.call_count, 1u);
+    EXPECT_EQ(telemetryMng.interchipLink.transfers, 100u);
+    EXPECT_EQ(telemetryMng.interchipLink.crcErrors, 3u);
+}
+
+TEST(TelemetryManagerFSM, reportLoadsAttitudeLatencySummary){
+    /***SETUP***/
+    RESET_FAKE(LatencyTrace_GetSummary);
+    LatencyTrace_GetSummary_fake.custom_fake = latencySummaryAfterOneSummaryPeriod;
+    telemetryManager telemetryMng;
+    telemetryMng.setState(reportMode::getInstance());
+    /***STEPTHROUGH***/
+    telemetryMng.execute();
+    /***ASSERTS***/
+    EXPECT_EQ(LatencyTrace_GetSummary_fake.call_count, 1u);
+    EXPECT_EQ(telemetryMng.attitudeLatency.p99Us[LATENCY_STAGE_HANDOFF], 1500u);
+    EXPECT_EQ(telemetryMng.attitudeLatency.cycles, (uint32_t) LATENCY_SUMMARY_PERIOD);
+}
+
+TEST(TelemetryManagerFSM, reportLoadsAttitudeRecordingChunk){
+    /***SETUP***/
+    RESET_FAKE(AttitudeRecordingRing_Read);
+    AttitudeRecordingRing_Read_fake.custom_fake = recordingBytesUpToTheChunkSize;
+    telemetryManager telemetryMng;
+    telemetryMng.setState(reportMode::getInstance());
+    /***STEPTHROUGH***/
+    telemetryMng.execute();
+    /***ASSERTS***/
+    EXPECT_EQ(AttitudeRecordingRing_Read_fake.call_count, 1u);
+    EXPECT_EQ(AttitudeRecordingRing_Read_fake.arg1_val, (size_t) TELEMETRY_RECORDING_CHUNK_SIZE);
+    EXPECT_EQ(telemetryMng.attitudeRecordingLength, (size_t) TELEMETRY_RECORDING_CHUNK_SIZE);
+    EXPECT_EQ(telemetryMng.attitudeRecording[TELEMETRY_RECORDING_CHUNK_SIZE - 1], (uint8_t) (TELEMETRY_RECORDING_CHUNK_SIZE - 1));
+}
@@ -0,0 +1,217 @@
+/*
+* Tests for the biquad filter bank and its coefficient design.
+*/
+
+#include <gtest/gtest.h>
+
+#include "BiquadBank.hpp"
+
+#include <math.h>
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define SAMPLE_RATE_HZ 1000.0f
+#define SETTLING_SAMPLES 2000
+#define MEASURED_SAMPLES 1000
+#define PI_F 3.14159265f
+
+typedef BiquadBank<1, 1> SingleBiquad;
+
+// Runs a unit sine through the filter and returns the output amplitude once it has settled
+template <typename Bank>
+static float steadyAmplitude(Bank &bank, float frequencyHz)
+{
+	float amplitude = 0.0f;
+
+	for (int i = 0; i < SETTLING_SAMPLES + MEASURED_SAMPLES; i++)
+	{
+		float input[Bank::channels()];
+		float output[Bank::channels()];
+
+		for (int channel = 0; channel < Bank::channels(); channel++)
+		{
+			input[channel] = sinf(2.0f * PI_F * frequencyHz * i / SAMPLE_RATE_HZ);
+		}
+
+		bank.apply(input, output);
+
+		if (i >= SETTLING_SAMPLES)
+		{
+			amplitude = fmaxf(amplitude, fabsf(output[0]));
+		}
+	}
+
+	return amplitude;
+}
+
+// Direct form I, one channel at a time, for comparison
+struct ReferenceBiquad
+{
+	BiquadCoefficients_t c;
+	float x1, x2, y1, y2;
+
+	float step(float x)
+	{
+		float y = c.b0 * x + c.b1 * x1 + c.b2 * x2 - c.a1 * y1 - c.a2 * y2;
+
+		x2 = x1;
+		x1 = x;
+		y2 = y1;
+		y1 = y;
+
+		return y;
+	}
+};
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(BiquadBank, LowPassFollowsTheButterworthResponse) {
+
+   	/***********************SETUP***********************/
+
+	SingleBiquad atCutoff;
+	SingleBiquad wellAbove;
+	SingleBiquad wellBelow;
+
+	BiquadCoefficients_t lowPass = Biquad_LowPass(50.0f, SAMPLE_RATE_HZ, BIQUAD_BUTTERWORTH_Q);
+
+	atCutoff.setSection(0, lowPass);
+	wellAbove.setSection(0, lowPass);
+	wellBelow.setSection(0, lowPass);
+
+	/********************STEPTHROUGH********************/
+
+	float gainAtCutoff = steadyAmplitude(atCutoff, 50.0f);
+	float gainWellAbove = steadyAmplitude(wellAbove, 200.0f);
+	float gainWellBelow = steadyAmplitude(wellBelow, 5.0f);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_NEAR(gainAtCutoff, 0.7071f, 0.01f);
+	EXPECT_LT(gainWellAbove, 1.0f / 16.0f);          // 12 dB per octave
+	EXPECT_NEAR(gainWellBelow, 1.0f, 0.01f);
+	EXPECT_NEAR((lowPass.b0 + lowPass.b1 + lowPass.b2) / (1.0f + lowPass.a1 + lowPass.a2), 1.0f, 1e-5f);
+}
+
+TEST(BiquadBank, NotchRemovesItsCentreOnly) {
+
+   	/***********************SETUP***********************/
+
+	SingleBiquad atCentre;
+	SingleBiquad octaveAbove;
+
+	BiquadCoefficients_t notch = Biquad_Notch(80.0f, SAMPLE_RATE_HZ, 2.0f);
+
+	atCentre.setSection(0, notch);
+	octaveAbove.setSection(0, notch);
+
+	/********************STEPTHROUGH********************/
+
+	float gainAtCentre = steadyAmplitude(atCentre, 80.0f);
+	float gainOctaveAbove = steadyAmplitude(octaveAbove, 160.0f);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_LT(gainAtCentre, 0.01f);
+	EXPECT_GT(gainOctaveAbove, 0.9f);
+}
+
+TEST(BiquadBank, ChannelsRunTheirOwnCascades) {
+
+   	/***********************SETUP***********************/
+
+	const int CHANNELS = 9;
+	const int SECTIONS = 2;
+
+	BiquadBank<CHANNELS, SECTIONS> bank;
+	ReferenceBiquad reference[SECTIONS][CHANNELS] = {};
+
+	for (int channel = 0; channel < CHANNELS; channel++)
+	{
+		BiquadCoefficients_t lowPass = Biquad_LowPass(20.0f + 10.0f * channel, SAMPLE_RATE_HZ, BIQUAD_BUTTERWORTH_Q);
+		BiquadCoefficients_t notch = Biquad_Notch(100.0f + 25.0f * channel, SAMPLE_RATE_HZ, 3.0f);
+
+		bank.setSection(0, channel, lowPass);
+		bank.setSection(1, channel, notch);
+		reference[0][channel].c = lowPass;
+		reference[1][channel].c = notch;
+	}
+
+	float worst = 0.0f;
+
+	/********************STEPTHROUGH********************/
+
+	for (int i = 0; i < 500; i++)
+	{
+		float input[CHANNELS];
+		float output[CHANNELS];
+
+		for (int channel = 0; channel < CHANNELS; channel++)
+		{
+			input[channel] = sinf(0.05f * i * (channel + 1)) + 0.3f * cosf(0.7f * i) + channel;
+		}
+
+		bank.apply(input, output);
+
+		for (int channel = 0; channel < CHANNELS; channel++)
+		{
+			float expected = reference[1][channel].step(reference[0][channel].step(input[channel]));
+			worst = fmaxf(worst, fabsf(output[channel] - expected));
+		}
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_LT(worst, 1e-4f);
+}
+
+TEST(BiquadBank, PrimingStartsAtTheSteadyState) {
+
+   	/***********************SETUP***********************/
+
+	BiquadBank<2, 2> primed;
+	BiquadBank<2, 2> cold;
+
+	primed.setSection(0, Biquad_LowPass(10.0f, SAMPLE_RATE_HZ, BIQUAD_BUTTERWORTH_Q));
+	primed.setSection(1, Biquad_Notch(60.0f, SAMPLE_RATE_HZ, 2.0f));
+	cold.setSection(0, Biquad_LowPass(10.0f, SAMPLE_RATE_HZ, BIQUAD_BUTTERWORTH_Q));
+	cold.setSection(1, Biquad_Notch(60.0f, SAMPLE_RATE_HZ, 2.0f));
+
+	const float input[2] = {9.81f, -3.0f};
+	float primedOutput[2];
+	float coldOutput[2];
+
+	/********************STEPTHROUGH********************/
+
+	primed.prime(input);
+	primed.apply(input, primedOutput);
+	cold.apply(input, coldOutput);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_NEAR(primedOutput[0], input[0], 1e-4f);
+	EXPECT_NEAR(primedOutput[1], input[1], 1e-4f);
+	EXPECT_LT(fabsf(coldOutput[0]), 0.1f);
+}
+
+TEST(BiquadBank, FrequenciesOutsideTheBandPassThrough) {
+
+   	/***********************SETUP***********************/
+
+	BiquadCoefficients_t off = Biquad_LowPass(0.0f, SAMPLE_RATE_HZ, BIQUAD_BUTTERWORTH_Q);
+	BiquadCoefficients_t aboveNyquist = Biquad_Notch(600.0f, SAMPLE_RATE_HZ, 2.0f);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(off.b0, 1.0f);
+	EXPECT_EQ(off.a1, 0.0f);
+	EXPECT_EQ(aboveNyquist.b0, 1.0f);
+	EXPECT_EQ(aboveNyquist.b2, 0.0f);
+}
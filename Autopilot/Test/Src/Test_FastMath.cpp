@@ -0,0 +1,147 @@
+/*
+* Tests for the fast math approximations. They hold each function to the error documented in FastMath.hpp over its
+* domain, Bench_FastMath.cpp has the finer sweep and the timings.
+*/
+
+#include <gtest/gtest.h>
+
+#include "FastMath.hpp"
+
+#include <math.h>
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define SWEEP_POINTS 100000
+
+#define ANGLE_TOLERANCE 3.5e-7              // rad, the worst documented for the angle functions
+#define RELATIVE_TOLERANCE 2e-7
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(FastMath, Atan2StaysWithinItsErrorAllTheWayRound) {
+
+   	/***********************SETUP***********************/
+
+	double worst = 0.0;
+
+	/********************STEPTHROUGH********************/
+
+	for (int i = 0; i < SWEEP_POINTS; i++)
+	{
+		double direction = -M_PI + 2.0 * M_PI * i / SWEEP_POINTS;
+		float y = (float) (3.0 * sin(direction));
+		float x = (float) (3.0 * cos(direction));
+
+		double error = fabs(FastMath_Atan2(y, x) - atan2((double) y, (double) x));
+		worst = (error > worst) ? error : worst;
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_LT(worst, ANGLE_TOLERANCE);
+
+	// The axes and the quadrants
+	EXPECT_EQ(FastMath_Atan2(0.0f, 0.0f), 0.0f);
+	EXPECT_EQ(FastMath_Atan2(0.0f, 1.0f), 0.0f);
+	EXPECT_NEAR(FastMath_Atan2(1.0f, 0.0f), M_PI / 2, ANGLE_TOLERANCE);
+	EXPECT_NEAR(FastMath_Atan2(-1.0f, 0.0f), -M_PI / 2, ANGLE_TOLERANCE);
+	EXPECT_NEAR(FastMath_Atan2(0.0f, -1.0f), M_PI, ANGLE_TOLERANCE);
+	EXPECT_NEAR(FastMath_Atan2(-1.0f, -1.0f), -3 * M_PI / 4, ANGLE_TOLERANCE);
+}
+
+TEST(FastMath, AsinAndAcosStayWithinTheirErrorOnTheWholeDomain) {
+
+   	/***********************SETUP***********************/
+
+	double worstAsin = 0.0;
+	double worstAcos = 0.0;
+	double worstSmallAsin = 0.0;
+
+	/********************STEPTHROUGH********************/
+
+	for (int i = 0; i <= SWEEP_POINTS; i++)
+	{
+		float x = (float) (-1.0 + 2.0 * i / SWEEP_POINTS);
+
+		double asinError = fabs(FastMath_Asin(x) - asin((double) x));
+		double acosError = fabs(FastMath_Acos(x) - acos((double) x));
+
+		worstAsin = (asinError > worstAsin) ? asinError : worstAsin;
+		worstAcos = (acosError > worstAcos) ? acosError : worstAcos;
+
+		// Relative near 0, where a small absolute error can still be a large one
+		float small = x * 1e-3f;
+		double smallError = fabs(FastMath_Asin(small) - asin((double) small)) / fmax(fabs((double) small), 1e-30);
+		worstSmallAsin = (smallError > worstSmallAsin) ? smallError : worstSmallAsin;
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_LT(worstAsin, ANGLE_TOLERANCE);
+	EXPECT_LT(worstAcos, ANGLE_TOLERANCE);
+	EXPECT_LT(worstSmallAsin, RELATIVE_TOLERANCE);
+
+	EXPECT_NEAR(FastMath_Asin(1.0f), M_PI / 2, ANGLE_TOLERANCE);
+	EXPECT_NEAR(FastMath_Asin(-1.0f), -M_PI / 2, ANGLE_TOLERANCE);
+	EXPECT_NEAR(FastMath_Acos(-1.0f), M_PI, ANGLE_TOLERANCE);
+	EXPECT_EQ(FastMath_Acos(1.0f), 0.0f);
+}
+
+TEST(FastMath, SinAndCosStayWithinTheirErrorOverManyTurns) {
+
+   	/***********************SETUP***********************/
+
+	double worst = 0.0;
+
+	/********************STEPTHROUGH********************/
+
+	for (int i = 0; i <= SWEEP_POINTS; i++)
+	{
+		float x = (float) (-100.0 + 200.0 * i / SWEEP_POINTS);
+
+		double sinError = fabs(FastMath_Sin(x) - sin((double) x));
+		double cosError = fabs(FastMath_Cos(x) - cos((double) x));
+
+		worst = (sinError > worst) ? sinError : worst;
+		worst = (cosError > worst) ? cosError : worst;
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_LT(worst, 1.5e-7);
+	EXPECT_EQ(FastMath_Sin(0.0f), 0.0f);
+	EXPECT_EQ(FastMath_Cos(0.0f), 1.0f);
+}
+
+TEST(FastMath, RootsAreCorrectlyScaled) {
+
+   	/***********************SETUP***********************/
+
+	double worst = 0.0;
+
+	/********************STEPTHROUGH********************/
+
+	for (int i = 0; i <= SWEEP_POINTS; i++)
+	{
+		float x = (float) pow(10.0, -6.0 + 12.0 * i / SWEEP_POINTS);
+
+		double sqrtError = fabs(FastMath_Sqrt(x) - sqrt((double) x)) / sqrt((double) x);
+		double invSqrtError = fabs(FastMath_InvSqrt(x) - 1.0 / sqrt((double) x)) * sqrt((double) x);
+
+		worst = (sqrtError > worst) ? sqrtError : worst;
+		worst = (invSqrtError > worst) ? invSqrtError : worst;
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_LT(worst, RELATIVE_TOLERANCE);
+	EXPECT_EQ(FastMath_Sqrt(4.0f), 2.0f);
+	EXPECT_EQ(FastMath_InvSqrt(0.25f), 2.0f);
+}
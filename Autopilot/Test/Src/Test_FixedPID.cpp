@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+
+#include "PID.hpp"
+#include "FixedPID.hpp"
+
+#include <cmath>
+#include <stdint.h>
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define AXES 4
+#define STEPS 5000
+
+// Powers of two, so the limits in GAINS are exact in both formats and both versions clamp at the same values
+#define INPUT_FULL_SCALE 256.0f     // degrees
+#define OUTPUT_FULL_SCALE 128.0f    // percent
+
+// Gains and limits of each axis, as the PIDController constructor takes them. The last axis has a negative i_max.
+static const float GAINS[AXES][6] = {
+	{1.2f, 0.05f, 0.3f, 20.0f, -100.0f, 100.0f},
+	{0.8f, 0.1f, 0.0f, 5.0f, -30.0f, 30.0f},
+	{2.0f, 0.0f, 1.5f, 0.0f, 0.0f, 100.0f},
+	{0.5f, 0.2f, 0.7f, -3.0f, -10.0f, 50.0f},
+};
+
+// Largest output error against the float version, in percent, over a run of runAgainstFloat
+struct FixedPIDRun_t
+{
+	float maxError;
+	int saturationMismatches;
+};
+
+// Uniform in [-1, 1], reproducible
+static float noise(uint32_t &seed)
+{
+	seed = seed * 1664525u + 1013904223u;
+	return (float) (seed >> 8) / (float) (1u << 23) - 1.0f;
+}
+
+/**
+* Runs every axis of GAINS on the same inputs through PIDController and FixedPIDController<Q>. The float version gets
+* the quantised inputs, so the differences are those of the fixed point arithmetic. A saturation mismatch is a step
+* where one version is at a limit and the other is further from it than margin.
+*/
+template <typename Q>
+static FixedPIDRun_t runAgainstFloat(bool measuredRates, float margin)
+{
+	FixedPIDRun_t run = {0.0f, 0};
+	uint32_t seed = 3;
+
+	for (int axis = 0; axis < AXES; axis++)
+	{
+		const float *g = GAINS[axis];
+		PIDController reference(g[0], g[1], g[2], g[3], g[4], g[5]);
+		FixedPIDController<Q> fixed(g[0], g[1], g[2], g[3], g[4], g[5], INPUT_FULL_SCALE, OUTPUT_FULL_SCALE);
+
+		for (int step = 0; step < STEPS; step++)
+		{
+			// Large enough steps to saturate the outputs and the integrals
+			Q desired = FixedPoint_FromFloat<Q>(40.0f * noise(seed), INPUT_FULL_SCALE);
+			Q actual = FixedPoint_FromFloat<Q>(40.0f * noise(seed), INPUT_FULL_SCALE);
+			Q rate = FixedPoint_FromFloat<Q>(10.0f * noise(seed), INPUT_FULL_SCALE);
+
+			float expected;
+			Q output;
+
+			if (measuredRates)
+			{
+				expected = reference.execute(FixedPoint_ToFloat<Q>(desired, INPUT_FULL_SCALE),
+											 FixedPoint_ToFloat<Q>(actual, INPUT_FULL_SCALE),
+											 FixedPoint_ToFloat<Q>(rate, INPUT_FULL_SCALE));
+				output = fixed.execute(desired, actual, rate);
+			}
+			else
+			{
+				expected = reference.execute(FixedPoint_ToFloat<Q>(desired, INPUT_FULL_SCALE),
+											 FixedPoint_ToFloat<Q>(actual, INPUT_FULL_SCALE));
+				output = fixed.execute(desired, actual);
+			}
+
+			float result = FixedPoint_ToFloat<Q>(output, OUTPUT_FULL_SCALE);
+			float error = fabsf(result - expected);
+
+			bool expectedAtLimit = (expected == g[4]) || (expected == g[5]);
+			bool resultAtLimit = (result == g[4]) || (result == g[5]);
+
+			run.maxError = (error > run.maxError) ? error : run.maxError;
+			run.saturationMismatches += (expectedAtLimit != resultAtLimit) && (error > margin);
+		}
+	}
+
+	return run;
+}
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(FixedPID, OutputCannotBeLargerThanMaxOutput) {
+
+   	/***********************SETUP***********************/
+
+	FixedPIDController<q15_t> pid(1, 0, 0, 0, 0, 100, INPUT_FULL_SCALE, OUTPUT_FULL_SCALE);
+
+	/********************STEPTHROUGH********************/
+
+	q15_t output = pid.execute(32767, -32768);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(FixedPoint_ToFloat<q15_t>(output, OUTPUT_FULL_SCALE), 100.0f);
+}
+
+TEST(FixedPID, OutputCannotBeSmallerThanMinOutput) {
+
+   	/***********************SETUP***********************/
+
+	FixedPIDController<q31_t> pid(1, 0, 0, 0, -100, 0, INPUT_FULL_SCALE, OUTPUT_FULL_SCALE);
+
+	/********************STEPTHROUGH********************/
+
+	q31_t output = pid.execute(INT32_MIN, INT32_MAX);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(FixedPoint_ToFloat<q31_t>(output, OUTPUT_FULL_SCALE), -100.0f);
+}
+
+TEST(FixedPID, Q15StaysCloseToTheFloatVersion) {
+
+   	/***********************SETUP***********************/
+
+	// The gains keep 12 significant bits, so a derivative term of a few hundred percent is off by a few hundredths. Half
+	// a microsecond of the safety controller's PWM outputs, which span 1100 us.
+	const float BOUND = 0.05f;
+
+	/********************STEPTHROUGH********************/
+
+	FixedPIDRun_t computed = runAgainstFloat<q15_t>(false, BOUND);
+	FixedPIDRun_t measured = runAgainstFloat<q15_t>(true, BOUND);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_LT(computed.maxError, BOUND);
+	EXPECT_LT(measured.maxError, BOUND);
+	EXPECT_EQ(computed.saturationMismatches, 0);
+	EXPECT_EQ(measured.saturationMismatches, 0);
+}
+
+TEST(FixedPID, Q31StaysCloseToTheFloatVersion) {
+
+   	/***********************SETUP***********************/
+
+	// Within the rounding of the float version itself
+	const float BOUND = 2e-4f;
+
+	/********************STEPTHROUGH********************/
+
+	FixedPIDRun_t computed = runAgainstFloat<q31_t>(false, BOUND);
+	FixedPIDRun_t measured = runAgainstFloat<q31_t>(true, BOUND);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_LT(computed.maxError, BOUND);
+	EXPECT_LT(measured.maxError, BOUND);
+	EXPECT_EQ(computed.saturationMismatches, 0);
+	EXPECT_EQ(measured.saturationMismatches, 0);
+}
@@ -0,0 +1,329 @@
+/*
+* Tests for the IMU FIFO ingestion and the coning and sculling pre-integration.
+*/
+
+#include <gtest/gtest.h>
+
+#include "ImuFifo.hpp"
+#include "IMU.hpp"
+#include "LinearAlgebra.hpp"
+
+#include <math.h>
+#include <vector>
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define SAMPLE_PERIOD 0.001f
+#define SAMPLES_PER_INTERVAL 10
+#define SUBSTEPS 200                // of the reference integration, per sample
+#define PI_F 3.14159265f
+
+// A frame as the ICM-20602 pushes it, raw counts
+static void appendFrame(vector<uint8_t> &fifo, const int16_t accel[3], const int16_t gyro[3])
+{
+	int16_t values[7] = {accel[0], accel[1], accel[2], 0, gyro[0], gyro[1], gyro[2]};
+
+	for (int i = 0; i < 7; i++)
+	{
+		fifo.push_back((uint8_t) ((uint16_t) values[i] >> 8));
+		fifo.push_back((uint8_t) (values[i] & 0xFF));
+	}
+}
+
+// Coning: the body x and y rates oscillate a quarter period apart, which turns the body about z
+static Vec3 coningRate(float t, float amplitude, float frequency)
+{
+	float omega = 2.0f * PI_F * frequency;
+	Vec3 rate = {{amplitude * omega * cosf(omega * t), amplitude * omega * sinf(omega * t), 0.0f}};
+	return rate;
+}
+
+// Sculling: rolling back and forth while accelerating sideways in phase, which adds up along z
+static Vec3 scullingRate(float t, float amplitude, float frequency)
+{
+	float omega = 2.0f * PI_F * frequency;
+	Vec3 rate = {{amplitude * omega * cosf(omega * t), 0.0f, 0.0f}};
+	return rate;
+}
+
+static Vec3 scullingForce(float t, float frequency)
+{
+	float omega = 2.0f * PI_F * frequency;
+	Vec3 force = {{0.0f, 5.0f * cosf(omega * t), 0.0f}};
+	return force;
+}
+
+// Rotation vector of a unit quaternion
+static Vec3 rotationVector(const Quat &q)
+{
+	Vec3 axis = q.vector();
+	float halfAngle = atan2f(norm(axis), q.w);
+	float length = norm(axis);
+
+	return (length > 0.0f) ? axis * (2.0f * halfAngle / length) : axis;
+}
+
+/**
+ * Integrates the given rates and specific force finely over one interval and also feeds the integrator the sample
+ * averages, as an IMU with its own anti alias filtering would deliver them.
+ * @param[out]  trueAngle, trueVelocity     what the interval really did, in the body at its start.
+ */
+template <typename RateFn, typename ForceFn>
+static void simulateInterval(RateFn rateAt, ForceFn forceAt, ImuPreintegrator &integrator, Vec3 &trueAngle,
+                             Vec3 &trueVelocity)
+{
+	Quat attitude = Quat::identity();
+	trueVelocity = Vec3::zeros();
+
+	float fine = SAMPLE_PERIOD / SUBSTEPS;
+
+	for (int sample = 0; sample < SAMPLES_PER_INTERVAL; sample++)
+	{
+		Vec3 rateSum = Vec3::zeros();
+		Vec3 forceSum = Vec3::zeros();
+
+		for (int step = 0; step < SUBSTEPS; step++)
+		{
+			float t = (sample * SUBSTEPS + step + 0.5f) * fine;
+			Vec3 rate = rateAt(t);
+			Vec3 force = forceAt(t);
+
+			// Midpoint, the force is applied at the attitude half way through the step
+			Quat halfway = (attitude * Quat::fromRotationVector(rate * (0.5f * fine))).normalized();
+			trueVelocity += halfway.rotate(force) * fine;
+			attitude = (attitude * Quat::fromRotationVector(rate * fine)).normalized();
+
+			rateSum += rate;
+			forceSum += force;
+		}
+
+		Vec3 rate = rateSum / (float) SUBSTEPS;
+		Vec3 force = forceSum / (float) SUBSTEPS;
+
+		integrator.addSample(rate.v, force.v, SAMPLE_PERIOD);
+	}
+
+	trueAngle = rotationVector(attitude);
+}
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(ImuFifo, ParsesWholeBigEndianFrames) {
+
+   	/***********************SETUP***********************/
+
+	ImuFifoScale_t scale = ImuFifo_Scale(16, 2000);
+	ImuPreintegrator integrator;
+
+	// 1 g up, -1 g forward and 10 deg/s about x, -20 deg/s about z at 16 g and 2000 deg/s
+	const int16_t accel[3] = {-2048, 0, 2048};
+	const int16_t gyro[3] = {164, 0, -328};
+
+	vector<uint8_t> fifo;
+
+	for (int i = 0; i < 3; i++)
+	{
+		appendFrame(fifo, accel, gyro);
+	}
+
+	// The start of a fourth frame that has not been written completely
+	fifo.insert(fifo.end(), 5, 0x7F);
+
+	/********************STEPTHROUGH********************/
+
+	size_t frames = ImuFifo_Integrate(fifo.data(), fifo.size(), scale, SAMPLE_PERIOD, integrator);
+	ImuIncrement_t increment = integrator.take(1234);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(frames, 3u);
+	EXPECT_EQ(increment.sampleCount, 3);
+	EXPECT_EQ(increment.sampleTimeUs, 1234u);
+	EXPECT_NEAR(increment.deltaTime, 3 * SAMPLE_PERIOD, 1e-7f);
+
+	EXPECT_NEAR(increment.deltaVelocity[0] / increment.deltaTime, -IMU_FIFO_GRAVITY, 0.01f);
+	EXPECT_NEAR(increment.deltaVelocity[2] / increment.deltaTime, IMU_FIFO_GRAVITY, 0.01f);
+	EXPECT_NEAR(increment.deltaAngle[0] / increment.deltaTime, 10.0f * IMU_FIFO_DEG_TO_RAD, 1e-3f);
+	EXPECT_NEAR(increment.deltaAngle[2] / increment.deltaTime, -20.0f * IMU_FIFO_DEG_TO_RAD, 1e-3f);
+
+	// Taking starts a new interval
+	EXPECT_EQ(integrator.getSampleCount(), 0);
+}
+
+TEST(ImuFifo, ResetDropsTheIntervalAndTheCarriedSample) {
+
+   	/***********************SETUP***********************/
+
+	ImuPreintegrator integrator;
+
+	const float rate[3] = {0.3f, -0.2f, 1.1f};
+	const float force[3] = {0.0f, 0.0f, IMU_FIFO_GRAVITY};
+	const float still[3] = {0.0f, 0.0f, 0.0f};
+
+	/********************STEPTHROUGH********************/
+
+	for (int i = 0; i < SAMPLES_PER_INTERVAL; i++)
+	{
+		integrator.addSample(rate, force, SAMPLE_PERIOD);
+	}
+
+	integrator.reset();
+	integrator.addSample(still, still, SAMPLE_PERIOD);
+
+	ImuIncrement_t increment = integrator.take(0);
+
+	/**********************ASSERTS**********************/
+
+	// Any corrections left over from before the reset would show up against a still sample
+	for (int i = 0; i < 3; i++)
+	{
+		EXPECT_EQ(increment.deltaAngle[i], 0.0f);
+		EXPECT_EQ(increment.deltaVelocity[i], 0.0f);
+	}
+
+	EXPECT_EQ(increment.sampleCount, 1);
+	EXPECT_FLOAT_EQ(increment.deltaTime, SAMPLE_PERIOD);
+}
+
+TEST(ImuFifo, ConstantRotationNeedsNoCorrection) {
+
+   	/***********************SETUP***********************/
+
+	ImuPreintegrator integrator;
+
+	const float rate[3] = {0.3f, -0.2f, 1.1f};
+	const float force[3] = {0.0f, 0.0f, IMU_FIFO_GRAVITY};
+
+	/********************STEPTHROUGH********************/
+
+	for (int i = 0; i < SAMPLES_PER_INTERVAL; i++)
+	{
+		integrator.addSample(rate, force, SAMPLE_PERIOD);
+	}
+
+	ImuIncrement_t increment = integrator.take(0);
+
+	/**********************ASSERTS**********************/
+
+	for (int i = 0; i < 3; i++)
+	{
+		EXPECT_NEAR(increment.deltaAngle[i], rate[i] * SAMPLES_PER_INTERVAL * SAMPLE_PERIOD, 1e-6f);
+	}
+}
+
+TEST(ImuFifo, ConingCorrectionFollowsTheTrueRotation) {
+
+   	/***********************SETUP***********************/
+
+	ImuPreintegrator integrator;
+	Vec3 trueAngle;
+	Vec3 trueVelocity;
+
+	// 3 degrees of coning at 20 Hz
+	const float amplitude = 0.05f;
+	const float frequency = 20.0f;
+
+	/********************STEPTHROUGH********************/
+
+	simulateInterval([&](float t) {return coningRate(t, amplitude, frequency);},
+	                 [&](float) {return Vec3::zeros();},
+	                 integrator, trueAngle, trueVelocity);
+
+	ImuIncrement_t increment = integrator.take(0);
+
+	Vec3 compensated = Vec3::fromArray(increment.deltaAngle);
+
+	// What summing the samples gives, without the coning term. The summed z rate is 0.
+	Vec3 summed = compensated;
+	summed[2] = 0.0f;
+
+	float compensatedError = distance(compensated, trueAngle);
+	float summedError = distance(summed, trueAngle);
+
+	/**********************ASSERTS**********************/
+
+	// The body turns about z even though it never measures a z rate
+	EXPECT_GT(fabsf(trueAngle[2]), 1e-4f);
+	EXPECT_LT(compensatedError, 0.05f * summedError);
+}
+
+TEST(ImuFifo, ScullingCorrectionFollowsTheTrueVelocity) {
+
+   	/***********************SETUP***********************/
+
+	ImuPreintegrator integrator;
+	Vec3 trueAngle;
+	Vec3 trueVelocity;
+
+	const float amplitude = 0.05f;
+	const float frequency = 20.0f;
+
+	/********************STEPTHROUGH********************/
+
+	simulateInterval([&](float t) {return scullingRate(t, amplitude, frequency);},
+	                 [&](float t) {return scullingForce(t, frequency);},
+	                 integrator, trueAngle, trueVelocity);
+
+	ImuIncrement_t increment = integrator.take(0);
+
+	Vec3 compensated = Vec3::fromArray(increment.deltaVelocity);
+
+	// The force only ever acts along body y, a plain sum has nothing on z
+	float compensatedError = fabsf(compensated[2] - trueVelocity[2]);
+	float summedError = fabsf(trueVelocity[2]);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_GT(summedError, 1e-4f);
+	EXPECT_LT(compensatedError, 0.05f * summedError);
+	EXPECT_NEAR(compensated[1], trueVelocity[1], 1e-4f);
+}
+
+TEST(ImuFifo, DriverReportsTheIntervalAsMeanRates) {
+
+   	/***********************SETUP***********************/
+
+	ICM20602 imu;
+	IMUData_t data;
+
+	const int16_t accel[3] = {0, 0, 2048};
+	const int16_t gyro[3] = {164, 0, 0};
+
+	vector<uint8_t> fifo;
+
+	for (int i = 0; i < 8; i++)
+	{
+		appendFrame(fifo, accel, gyro);
+	}
+
+	/********************STEPTHROUGH********************/
+
+	imu.IngestFifo(fifo.data(), fifo.size(), 5000);
+	imu.GetResult(data);
+
+	bool firstIsNew = data.isDataNew;
+	float firstRate = data.gyrx;
+
+	// Nothing arrives before the next read
+	imu.GetResult(data);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_TRUE(firstIsNew);
+	EXPECT_NEAR(firstRate, 10.0f * IMU_FIFO_DEG_TO_RAD, 1e-3f);
+	EXPECT_EQ(imu.GetIncrement().sampleCount, 8);
+
+	EXPECT_FALSE(data.isDataNew);
+	EXPECT_EQ(data.sensorStatus, 0);
+	EXPECT_EQ(data.sampleTimeUs, 5000u);
+	EXPECT_FLOAT_EQ(data.deltaTime, 8.0f / ICM20602_SAMPLE_RATE_HZ);
+	EXPECT_NEAR(data.accz, IMU_FIFO_GRAVITY, 0.01f);
+	EXPECT_EQ(data.magx, 0.0f);
+}
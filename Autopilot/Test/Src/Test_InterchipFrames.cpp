@@ -0,0 +1,208 @@
+/*
+* Tests for the seqlock topics between the interchip task and the rest of the autopilot, in both directions.
+*/
+
+#include <gtest/gtest.h>
+
+#include "Interchip_A.h"
+#include "InterchipFrames.h"
+
+#include <atomic>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define STRESS_NUM_FRAMES 200000
+#define STRESS_NUM_READERS 2
+
+static atomic<uint32_t> commitNotifications(0);
+
+// Interchip_A.c wakes the interchip task here
+void Interchip_OnFrameCommitted(void)
+{
+	commitNotifications++;
+}
+
+// Every channel of frame n holds n, so a frame put together from two commits has channels that disagree
+static bool isWholeFrame(const int16_t *pwm, uint32_t n)
+{
+	for (int i = 0; i < INTERCHIP_PWM_CHANNELS; i++)
+	{
+		if (pwm[i] != (int16_t) n)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void fill(int16_t *pwm, uint32_t n)
+{
+	for (int i = 0; i < INTERCHIP_PWM_CHANNELS; i++)
+	{
+		pwm[i] = (int16_t) n;
+	}
+}
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(InterchipFrames, CommitOnlyChangesTheDirtyChannels) {
+
+   	/***********************SETUP***********************/
+
+	int16_t all[INTERCHIP_PWM_CHANNELS];
+	int16_t changed[INTERCHIP_PWM_CHANNELS];
+
+	fill(all, 7);
+	fill(changed, 50);
+
+	Interchip_AtoS_Packet packet;
+	memset(&packet, 0, sizeof(packet));
+
+	uint32_t notificationsBefore = commitNotifications.load();
+
+	/********************STEPTHROUGH********************/
+
+	Interchip_SetPWM(all);
+	Interchip_SetFrame(changed, 0x5u, 1234u);
+	Interchip_SetAutonomousLevel(2);
+
+	uint8_t taken = InterchipFrames_TakeCommands(&packet);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(taken, 1);
+
+	EXPECT_EQ(packet.PWM[0], 50);
+	EXPECT_EQ(packet.PWM[1], 7);
+	EXPECT_EQ(packet.PWM[2], 50);
+	EXPECT_EQ(packet.PWM[11], 7);
+	EXPECT_EQ(packet.sample_time_us, 1234u);
+	EXPECT_EQ(packet.autonomous_level, 2);
+
+	EXPECT_EQ(commitNotifications.load(), notificationsBefore + 3);
+}
+
+TEST(InterchipFrames, ReceivedPacketIsReadAsAWhole) {
+
+   	/***********************SETUP***********************/
+
+	Interchip_StoA_Packet packet;
+	memset(&packet, 0, sizeof(packet));
+	fill(packet.PWM, 321);
+	packet.autonomous_level = 3;
+
+	int16_t pwm[INTERCHIP_PWM_CHANNELS];
+
+	/********************STEPTHROUGH********************/
+
+	InterchipFrames_PublishReceived(&packet);
+
+	// Later packets do not reach into a snapshot already taken
+	uint8_t read = Interchip_GetPWM(pwm);
+
+	packet.PWM[0] = 0;
+	InterchipFrames_PublishReceived(&packet);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(read, 1);
+	EXPECT_TRUE(isWholeFrame(pwm, 321));
+	EXPECT_EQ(Interchip_GetAutonomousLevel(), 3);
+}
+
+TEST(InterchipFrames, ConcurrentSnapshotsAreNeverTornInEitherDirection) {
+
+   	/***********************SETUP***********************/
+
+	atomic<bool> writersDone(false);
+	atomic<uint32_t> tornCommands(0), tornReceived(0);
+	atomic<uint32_t> commandReads(0), receivedReads(0);
+
+	// Whatever the other tests committed is not a whole frame by the rule of isWholeFrame
+	int16_t zeroes[INTERCHIP_PWM_CHANNELS];
+	fill(zeroes, 0);
+	Interchip_SetFrame(zeroes, (1u << INTERCHIP_PWM_CHANNELS) - 1, 0);
+
+	/********************STEPTHROUGH********************/
+
+	// The interchip task, sending commands as they come and publishing what it receives
+	thread interchipTask([&]()
+	{
+		Interchip_StoA_Packet received;
+		memset(&received, 0, sizeof(received));
+
+		for (uint32_t n = 1; n <= STRESS_NUM_FRAMES; n++)
+		{
+			Interchip_AtoS_Packet sending;
+
+			if (InterchipFrames_TakeCommands(&sending))
+			{
+				commandReads++;
+				tornCommands += (isWholeFrame(sending.PWM, sending.sample_time_us)) ? 0 : 1;
+			}
+
+			fill(received.PWM, n);
+			received.autonomous_level = (uint16_t) n;
+			InterchipFrames_PublishReceived(&received);
+		}
+	});
+
+	// The attitude task, committing whole frames
+	thread attitudeTask([&]()
+	{
+		int16_t pwm[INTERCHIP_PWM_CHANNELS];
+
+		for (uint32_t n = 1; n <= STRESS_NUM_FRAMES; n++)
+		{
+			fill(pwm, n);
+			Interchip_SetFrame(pwm, (1u << INTERCHIP_PWM_CHANNELS) - 1, n);
+		}
+	});
+
+	vector<thread> readers;
+
+	for (int r = 0; r < STRESS_NUM_READERS; r++)
+	{
+		readers.push_back(thread([&]()
+		{
+			while ( ! writersDone.load())
+			{
+				int16_t pwm[INTERCHIP_PWM_CHANNELS];
+
+				if (Interchip_GetPWM(pwm))
+				{
+					receivedReads++;
+					tornReceived += isWholeFrame(pwm, (uint16_t) pwm[0]) ? 0 : 1;
+				}
+			}
+		}));
+	}
+
+	interchipTask.join();
+	attitudeTask.join();
+	writersDone.store(true);
+
+	for (size_t r = 0; r < readers.size(); r++)
+	{
+		readers[r].join();
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_GT(commandReads.load(), 0u);
+	EXPECT_GT(receivedReads.load(), 0u);
+
+	EXPECT_EQ(tornCommands.load(), 0u);
+	EXPECT_EQ(tornReceived.load(), 0u);
+}
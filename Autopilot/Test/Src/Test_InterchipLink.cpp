@@ -0,0 +1,441 @@
+/*
+* Tests for the interchip framing and the double buffers of the autopilot end of the link, against a loopback stand-in
+* for the safety chip.
+*/
+
+#include <gtest/gtest.h>
+
+#include "InterchipLink.h"
+
+#include <string.h>
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define TRANSFER_US 190u                    // 40 bytes at the SPI clock of the target
+#define TRANSFER_INTERVAL_US 1000u
+
+// What the safety end does with each transfer: keeps what the autopilot sent if it checks out, and answers with its
+// own sealed packet, the autopilot's PWM values echoed back. Its statistics fill in the reply the way the autopilot's
+// do, with what it knew when the transfer started.
+class SafetyStandIn
+{
+	public:
+		SafetyStandIn() : sequence(0), received(0), rejected(0), corruptNextReply(false), repeatNextReply(false),
+		                  corruptNextRequest(false)
+		{
+			memset(&lastReceived, 0, sizeof(lastReceived));
+			memset(&reply, 0, sizeof(reply));
+			InterchipStats_Init(&stats);
+		}
+
+		// One full duplex transfer, both directions at once
+		void exchange(const uint8_t *txData, uint8_t *rxData, uint32_t endUs = 0)
+		{
+			uint8_t request[INTERCHIP_PACKET_SIZE];
+			memcpy(request, txData, sizeof(request));
+
+			if (corruptNextRequest)
+			{
+				request[5] ^= 0x01;
+			}
+
+			if ( ! repeatNextReply)
+			{
+				reply.ack_sequence = InterchipStats_GetAckSequence(&stats);
+				reply.crc_errors = (uint16_t) stats.counters.crcErrors;
+			}
+
+			if (InterchipFraming_Check(request, InterchipFraming_SoftwareCrc))
+			{
+				memcpy(&lastReceived, request, sizeof(lastReceived));
+				InterchipStats_OnReceive(&stats, lastReceived.sequence, lastReceived.ack_sequence, lastReceived.crc_errors, endUs);
+				received++;
+			}
+			else
+			{
+				InterchipStats_OnCrcError(&stats);
+				rejected++;
+			}
+
+			if ( ! repeatNextReply)
+			{
+				memcpy(reply.PWM, lastReceived.PWM, sizeof(reply.PWM));
+				reply.autonomous_level = 1;
+				InterchipFraming_Seal(&reply, sequence++, InterchipFraming_SoftwareCrc);
+			}
+
+			memcpy(rxData, &reply, INTERCHIP_PACKET_SIZE);
+
+			if (corruptNextReply)
+			{
+				rxData[3] ^= 0x10;
+			}
+
+			corruptNextReply = false;
+			repeatNextReply = false;
+			corruptNextRequest = false;
+		}
+
+		Interchip_AtoS_Packet lastReceived;
+		Interchip_StoA_Packet reply;
+		InterchipStats_t stats;
+		uint16_t sequence;
+		int received, rejected;
+		bool corruptNextReply, repeatNextReply, corruptNextRequest;
+};
+
+class InterchipLinkTest : public ::testing::Test
+{
+	public:
+		virtual void SetUp()
+		{
+			InterchipLink_Init(&link, InterchipFraming_SoftwareCrc);
+		}
+
+		InterchipFrameStatus_t transfer(uint32_t startUs = 0, uint32_t durationUs = 0)
+		{
+			uint8_t *txData, *rxData;
+
+			InterchipLink_PrepareTransfer(&link, startUs, &txData, &rxData);
+			safety.exchange(txData, rxData, startUs + durationUs);
+
+			return InterchipLink_CompleteTransfer(&link, startUs + durationUs);
+		}
+
+		// The safety end saw the whole transfer, but the autopilot end got an error from the SPI or the DMA
+		void failedTransfer(uint32_t startUs)
+		{
+			uint8_t *txData, *rxData;
+
+			InterchipLink_PrepareTransfer(&link, startUs, &txData, &rxData);
+			safety.exchange(txData, rxData, startUs);
+
+			InterchipLink_FailTransfer(&link);
+		}
+
+		InterchipLink_t link;
+		SafetyStandIn safety;
+};
+
+/***********************************************************************************************************************
+ * Framing Tests
+ **********************************************************************************************************************/
+
+TEST(InterchipFraming, SoftwareCrcMatchesTheStm32CrcUnit) {
+
+   	/***********************SETUP***********************/
+
+	const uint8_t checkString[] = "123456789";
+
+	/********************STEPTHROUGH********************/
+
+	uint32_t crc = InterchipFraming_SoftwareCrc(checkString, 9);
+
+	/**********************ASSERTS**********************/
+
+	// The CRC-32/MPEG-2 check value, which the CRC unit gives in its reset configuration
+	EXPECT_EQ(crc, 0x0376E6E7u);
+}
+
+TEST(InterchipFraming, EveryFlippedBitFailsTheCheck) {
+
+   	/***********************SETUP***********************/
+
+	Interchip_AtoS_Packet packet;
+	memset(&packet, 0, sizeof(packet));
+
+	for (int i = 0; i < 12; i++)
+	{
+		packet.PWM[i] = (int16_t) (i * 1000 - 6000);
+	}
+
+	packet.sample_time_us = 123456789u;
+
+	InterchipFraming_Seal(&packet, 0xBEEF, InterchipFraming_SoftwareCrc);
+
+	bool sealedPasses = InterchipFraming_Check(&packet, InterchipFraming_SoftwareCrc);
+	int undetected = 0;
+
+	/********************STEPTHROUGH********************/
+
+	for (size_t bit = 0; bit < 8 * INTERCHIP_PACKET_SIZE; bit++)
+	{
+		Interchip_AtoS_Packet corrupted = packet;
+		((uint8_t *) &corrupted)[bit / 8] ^= (uint8_t) (1u << (bit % 8));
+
+		undetected += InterchipFraming_Check(&corrupted, InterchipFraming_SoftwareCrc) ? 1 : 0;
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_TRUE(sealedPasses);
+	EXPECT_EQ(packet.sequence, 0xBEEF);
+	EXPECT_EQ(InterchipFraming_GetSequence(&packet), 0xBEEF);
+	EXPECT_EQ(undetected, 0);
+}
+
+/***********************************************************************************************************************
+ * Double Buffer Tests
+ **********************************************************************************************************************/
+
+TEST_F(InterchipLinkTest, FrameOnTheWireIsNotTouchedByTheNextOne) {
+
+   	/***********************SETUP***********************/
+
+	uint8_t *txData, *rxData;
+
+	InterchipLink_GetTxPacket(&link)->PWM[0] = 100;
+	InterchipLink_GetTxPacket(&link)->PWM[1] = 200;
+
+	/********************STEPTHROUGH********************/
+
+	InterchipLink_PrepareTransfer(&link, 0, &txData, &rxData);
+
+	// The next frame is written while the first one is still going out, and only updates one channel
+	InterchipLink_GetTxPacket(&link)->PWM[0] = -100;
+
+	Interchip_AtoS_Packet onTheWire;
+	memcpy(&onTheWire, txData, sizeof(onTheWire));
+
+	const Interchip_AtoS_Packet *next = InterchipLink_GetTxPacket(&link);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_NE((const void *) txData, (const void *) next);
+	EXPECT_NE((const void *) rxData, (const void *) InterchipLink_GetLatestRx(&link));
+
+	EXPECT_EQ(onTheWire.PWM[0], 100);
+	EXPECT_EQ(onTheWire.PWM[1], 200);
+	EXPECT_TRUE(InterchipFraming_Check(txData, InterchipFraming_SoftwareCrc));
+
+	// The channel that was not set again carries over
+	EXPECT_EQ(next->PWM[0], -100);
+	EXPECT_EQ(next->PWM[1], 200);
+}
+
+TEST_F(InterchipLinkTest, EachTransferGetsTheNextSequenceNumber) {
+
+   	/***********************SETUP***********************/
+
+	uint16_t sequences[4];
+
+	/********************STEPTHROUGH********************/
+
+	for (int i = 0; i < 4; i++)
+	{
+		uint8_t *txData, *rxData;
+
+		InterchipLink_PrepareTransfer(&link, 0, &txData, &rxData);
+		sequences[i] = InterchipFraming_GetSequence(txData);
+		InterchipLink_CompleteTransfer(&link, 0);
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(sequences[0], 0);
+	EXPECT_EQ(sequences[1], 1);
+	EXPECT_EQ(sequences[2], 2);
+	EXPECT_EQ(sequences[3], 3);
+}
+
+/***********************************************************************************************************************
+ * Loopback Tests
+ **********************************************************************************************************************/
+
+TEST_F(InterchipLinkTest, LoopbackDeliversEveryFrameBothWays) {
+
+   	/***********************SETUP***********************/
+
+	int accepted = 0;
+	int echoMismatches = 0;
+
+	/********************STEPTHROUGH********************/
+
+	for (int i = 0; i < 100; i++)
+	{
+		int16_t pwm = (int16_t) (i * 37);
+
+		InterchipLink_GetTxPacket(&link)->PWM[5] = pwm;
+		accepted += (transfer() == INTERCHIP_FRAME_OK) ? 1 : 0;
+
+		echoMismatches += (InterchipLink_GetLatestRx(&link)->PWM[5] == pwm) ? 0 : 1;
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(accepted, 100);
+	EXPECT_EQ(echoMismatches, 0);
+	EXPECT_EQ(safety.received, 100);
+	EXPECT_EQ(safety.rejected, 0);
+	EXPECT_EQ(safety.lastReceived.sequence, 99);
+	EXPECT_EQ(InterchipLink_GetLatestRx(&link)->sequence, 99);
+	EXPECT_EQ(InterchipLink_GetLatestRx(&link)->autonomous_level, 1);
+}
+
+TEST_F(InterchipLinkTest, CorruptedOrRepeatedFrameKeepsTheLastGoodOne) {
+
+   	/***********************SETUP***********************/
+
+	InterchipLink_GetTxPacket(&link)->PWM[0] = 10;
+	transfer();
+
+	/********************STEPTHROUGH********************/
+
+	InterchipLink_GetTxPacket(&link)->PWM[0] = 20;
+	safety.repeatNextReply = true;
+	InterchipFrameStatus_t repeated = transfer();
+	int16_t afterRepeated = InterchipLink_GetLatestRx(&link)->PWM[0];
+
+	InterchipLink_GetTxPacket(&link)->PWM[0] = 30;
+	safety.corruptNextReply = true;
+	InterchipFrameStatus_t corrupted = transfer();
+	int16_t afterCorrupted = InterchipLink_GetLatestRx(&link)->PWM[0];
+
+	InterchipLink_GetTxPacket(&link)->PWM[0] = 40;
+	InterchipFrameStatus_t recovered = transfer();
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(repeated, INTERCHIP_FRAME_REPEATED);
+	EXPECT_EQ(afterRepeated, 10);
+
+	EXPECT_EQ(corrupted, INTERCHIP_FRAME_CRC_ERROR);
+	EXPECT_EQ(afterCorrupted, 10);
+
+	EXPECT_EQ(recovered, INTERCHIP_FRAME_OK);
+	EXPECT_EQ(InterchipLink_GetLatestRx(&link)->PWM[0], 40);
+}
+
+TEST_F(InterchipLinkTest, NothingReceivedIsNotAFrame) {
+
+   	/***********************SETUP***********************/
+
+	uint8_t *txData, *rxData;
+
+	/********************STEPTHROUGH********************/
+
+	// The safety chip is not answering, the receive buffer stays as it was
+	InterchipLink_PrepareTransfer(&link, 0, &txData, &rxData);
+	InterchipFrameStatus_t status = InterchipLink_CompleteTransfer(&link, 0);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(status, INTERCHIP_FRAME_CRC_ERROR);
+	EXPECT_EQ(InterchipLink_GetLatestRx(&link)->autonomous_level, 0);
+}
+
+/***********************************************************************************************************************
+ * Statistics Tests
+ **********************************************************************************************************************/
+
+TEST_F(InterchipLinkTest, StatisticsCountWhatGoesWrongInEitherDirection) {
+
+   	/***********************SETUP***********************/
+
+	uint32_t nowUs = 0;
+
+	for (int i = 0; i < 10; i++, nowUs += TRANSFER_INTERVAL_US)
+	{
+		transfer(nowUs, TRANSFER_US);
+	}
+
+	/********************STEPTHROUGH********************/
+
+	// Lost on the autopilot end, then retried
+	failedTransfer(nowUs);
+	nowUs += TRANSFER_INTERVAL_US;
+	transfer(nowUs, TRANSFER_US);
+	nowUs += TRANSFER_INTERVAL_US;
+
+	safety.corruptNextReply = true;
+	transfer(nowUs, TRANSFER_US);
+	nowUs += TRANSFER_INTERVAL_US;
+
+	safety.corruptNextRequest = true;
+	transfer(nowUs, TRANSFER_US);
+	nowUs += TRANSFER_INTERVAL_US;
+
+	safety.repeatNextReply = true;
+	transfer(nowUs, TRANSFER_US);
+	nowUs += TRANSFER_INTERVAL_US;
+
+	for (int i = 0; i < 5; i++, nowUs += TRANSFER_INTERVAL_US)
+	{
+		transfer(nowUs, TRANSFER_US);
+	}
+
+	const InterchipLinkStats_t *stats = InterchipLink_GetStats(&link);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(stats->transfers, 20u);
+	EXPECT_EQ(stats->failedTransfers, 1u);
+	EXPECT_EQ(stats->retries, 1u);
+	EXPECT_EQ(stats->received, 18u);
+	EXPECT_EQ(stats->crcErrors, 1u);
+	EXPECT_EQ(stats->repeats, 1u);
+
+	// The replies of the failed transfer and of the corrupted one
+	EXPECT_EQ(stats->gaps, 2u);
+	EXPECT_EQ(stats->lostPackets, 2u);
+
+	// The corrupted request, as the safety end counted it and reported it back
+	EXPECT_EQ(safety.stats.counters.crcErrors, 1u);
+	EXPECT_EQ(stats->peerCrcErrors, 1u);
+
+	// And the other way round, with the safety end missing one packet
+	EXPECT_EQ(safety.stats.counters.peerCrcErrors, 1u);
+	EXPECT_EQ(safety.stats.counters.gaps, 1u);
+}
+
+TEST_F(InterchipLinkTest, RoundTripTimesFollowTheDelaysOnTheLink) {
+
+   	/***********************SETUP***********************/
+
+	uint32_t nowUs = 0;
+
+	/********************STEPTHROUGH********************/
+
+	// Every packet is acknowledged by the reply of the next transfer, so a round trip is an interval and a transfer
+	for (int i = 0; i < 10; i++, nowUs += TRANSFER_INTERVAL_US)
+	{
+		transfer(nowUs, TRANSFER_US);
+	}
+
+	// The task falls behind for a few transfers
+	for (int i = 0; i < 4; i++, nowUs += 3 * INTERCHIP_RTT_BIN_WIDTH_US)
+	{
+		transfer(nowUs, TRANSFER_US);
+	}
+
+	// Then stalls for longer than the histogram covers
+	nowUs += INTERCHIP_RTT_BINS * INTERCHIP_RTT_BIN_WIDTH_US;
+	transfer(nowUs, TRANSFER_US);
+
+	const InterchipLinkStats_t *stats = InterchipLink_GetStats(&link);
+	uint32_t histogramTotal = 0;
+
+	for (int bin = 0; bin < INTERCHIP_RTT_BINS; bin++)
+	{
+		histogramTotal += stats->rttHistogram[bin];
+	}
+
+	/**********************ASSERTS**********************/
+
+	// Nothing to acknowledge before the first transfer
+	EXPECT_EQ(stats->rttSamples, 14u);
+	EXPECT_EQ(histogramTotal, stats->rttSamples);
+
+	EXPECT_EQ(stats->rttHistogram[0], 10u);
+	EXPECT_EQ(stats->rttHistogram[3], 3u);
+	EXPECT_EQ(stats->rttHistogram[INTERCHIP_RTT_BINS - 1], 1u);
+
+	EXPECT_EQ(stats->rttMinUs, TRANSFER_INTERVAL_US + TRANSFER_US);
+	EXPECT_EQ(stats->rttMaxUs, 3u * INTERCHIP_RTT_BIN_WIDTH_US + INTERCHIP_RTT_BINS * INTERCHIP_RTT_BIN_WIDTH_US + TRANSFER_US);
+	EXPECT_EQ(stats->rttLatestUs, stats->rttMaxUs);
+}
@@ -0,0 +1,187 @@
+/*
+* Tests for the pacing of the interchip transfers, on their own and driving a simulated SPI.
+*/
+
+#include <gtest/gtest.h>
+
+#include "InterchipPacer.h"
+#include "SimulatedInterchip.hpp"
+
+#include <algorithm>
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define MIN_INTERVAL_US 1000
+#define KEEP_ALIVE_US 20000
+#define START_US 1000000u
+
+#define SIMULATED_US 10000000ULL
+
+/***********************************************************************************************************************
+ * Pacer Tests
+ **********************************************************************************************************************/
+
+TEST(InterchipPacer, StartsStraightAwayThenWaitsForTheTransferToEnd) {
+
+   	/***********************SETUP***********************/
+
+	InterchipPacer_t pacer;
+	InterchipPacer_Init(&pacer, MIN_INTERVAL_US, KEEP_ALIVE_US);
+
+	uint32_t firstWaitUs, inFlightWaitUs;
+
+	/********************STEPTHROUGH********************/
+
+	uint8_t first = InterchipPacer_Poll(&pacer, START_US, &firstWaitUs);
+
+	// A frame comes in while the first packet is still on the wire
+	InterchipPacer_OnEvents(&pacer, INTERCHIP_EVENT_FRAME);
+	uint8_t whileInFlight = InterchipPacer_Poll(&pacer, START_US + 2 * MIN_INTERVAL_US, &inFlightWaitUs);
+
+	InterchipPacer_OnEvents(&pacer, INTERCHIP_EVENT_TRANSFER_DONE);
+	uint32_t unusedUs;
+	uint8_t afterDone = InterchipPacer_Poll(&pacer, START_US + 2 * MIN_INTERVAL_US, &unusedUs);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(first, 1);
+	EXPECT_EQ(firstWaitUs, (uint32_t) KEEP_ALIVE_US);
+
+	EXPECT_EQ(whileInFlight, 0);
+	EXPECT_EQ(inFlightWaitUs, (uint32_t) KEEP_ALIVE_US);
+
+	EXPECT_EQ(afterDone, 1);
+}
+
+TEST(InterchipPacer, FrameWaitsOutTheMinimumInterval) {
+
+   	/***********************SETUP***********************/
+
+	InterchipPacer_t pacer;
+	InterchipPacer_Init(&pacer, MIN_INTERVAL_US, KEEP_ALIVE_US);
+
+	uint32_t waitUs;
+	InterchipPacer_Poll(&pacer, START_US, &waitUs);
+	InterchipPacer_OnEvents(&pacer, INTERCHIP_EVENT_TRANSFER_DONE);
+
+	/********************STEPTHROUGH********************/
+
+	InterchipPacer_OnEvents(&pacer, INTERCHIP_EVENT_FRAME);
+	uint8_t early = InterchipPacer_Poll(&pacer, START_US + 300, &waitUs);
+	uint32_t earlyWaitUs = waitUs;
+
+	uint8_t onTime = InterchipPacer_Poll(&pacer, START_US + MIN_INTERVAL_US, &waitUs);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(early, 0);
+	EXPECT_EQ(earlyWaitUs, MIN_INTERVAL_US - 300u);
+	EXPECT_EQ(onTime, 1);
+}
+
+TEST(InterchipPacer, KeepsTheLinkAliveWithoutFramesAcrossTheTimeStampWrap) {
+
+   	/***********************SETUP***********************/
+
+	InterchipPacer_t pacer;
+	InterchipPacer_Init(&pacer, MIN_INTERVAL_US, KEEP_ALIVE_US);
+
+	const uint32_t startUs = UINT32_MAX - KEEP_ALIVE_US / 2;
+	uint32_t waitUs, idleWaitUs;
+
+	InterchipPacer_Poll(&pacer, startUs, &waitUs);
+	InterchipPacer_OnEvents(&pacer, INTERCHIP_EVENT_TRANSFER_DONE);
+
+	/********************STEPTHROUGH********************/
+
+	uint8_t idle = InterchipPacer_Poll(&pacer, startUs + MIN_INTERVAL_US, &idleWaitUs);
+	uint8_t beforeKeepAlive = InterchipPacer_Poll(&pacer, startUs + KEEP_ALIVE_US - 1, &waitUs);
+	uint8_t keepAlive = InterchipPacer_Poll(&pacer, startUs + KEEP_ALIVE_US, &waitUs);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(idle, 0);
+	EXPECT_EQ(idleWaitUs, (uint32_t) (KEEP_ALIVE_US - MIN_INTERVAL_US));
+	EXPECT_EQ(beforeKeepAlive, 0);
+	EXPECT_EQ(keepAlive, 1);
+}
+
+/***********************************************************************************************************************
+ * Simulated SPI Tests
+ **********************************************************************************************************************/
+
+TEST(InterchipPacer, EventDrivenFramesGoOutWithinOneTransfer) {
+
+   	/***********************SETUP***********************/
+
+	SimulatedInterchipConfig_t config = SimulatedInterchip_DefaultConfig();
+	config.commitPhaseUs = 2345;
+
+	/********************STEPTHROUGH********************/
+
+	SimulatedInterchipResult_t polling = SimulatedInterchip_Run(SIMULATED_INTERCHIP_POLLING, config, SIMULATED_US);
+	SimulatedInterchipResult_t eventDriven = SimulatedInterchip_Run(SIMULATED_INTERCHIP_EVENT_DRIVEN, config, SIMULATED_US);
+
+	uint32_t pollingMaxUs = *max_element(polling.latenciesUs.begin(), polling.latenciesUs.end());
+	uint32_t eventDrivenMaxUs = *max_element(eventDriven.latenciesUs.begin(), eventDriven.latenciesUs.end());
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(eventDriven.superseded, 0);
+	EXPECT_EQ((int) eventDriven.latenciesUs.size(), eventDriven.commits);
+	EXPECT_EQ(eventDrivenMaxUs, config.transferUs);
+
+	// The polling loop picks each frame up on its next wake up, most of a period later with this phase
+	EXPECT_GT(pollingMaxUs, 2 * config.tickUs);
+}
+
+TEST(InterchipPacer, BurstOfCommitsIsPacedByTheMinimumInterval) {
+
+   	/***********************SETUP***********************/
+
+	SimulatedInterchipConfig_t config = SimulatedInterchip_DefaultConfig();
+	config.commitPeriodUs = 150;
+	config.commitJitterUs = 50;
+
+	/********************STEPTHROUGH********************/
+
+	SimulatedInterchipResult_t result = SimulatedInterchip_Run(SIMULATED_INTERCHIP_EVENT_DRIVEN, config, SIMULATED_US);
+
+	uint32_t maxLatencyUs = *max_element(result.latenciesUs.begin(), result.latenciesUs.end());
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_GE(result.minStartSpacingUs, config.minIntervalUs);
+	EXPECT_GT(result.superseded, 0);
+
+	// Every frame either went out or was overwritten by a newer one, but for the one waiting when the simulation ends
+	EXPECT_LE(result.commits - result.superseded - (int) result.latenciesUs.size(), 1);
+
+	// The newest frame waits at most for the guard, rounded up to a tick, and then its own transfer
+	EXPECT_LE(maxLatencyUs, config.minIntervalUs + config.tickUs + config.transferUs);
+}
+
+TEST(InterchipPacer, IdleLinkExchangesAtTheKeepAliveInterval) {
+
+   	/***********************SETUP***********************/
+
+	SimulatedInterchipConfig_t config = SimulatedInterchip_DefaultConfig();
+	config.commitPeriodUs = 0;
+
+	/********************STEPTHROUGH********************/
+
+	SimulatedInterchipResult_t result = SimulatedInterchip_Run(SIMULATED_INTERCHIP_EVENT_DRIVEN, config, SIMULATED_US);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(result.transfers, (int) (SIMULATED_US / config.keepAliveUs));
+	EXPECT_GE(result.minStartSpacingUs, config.keepAliveUs);
+
+	// Once per keep alive and once per transfer done, the task sleeps the rest of the time
+	EXPECT_LE(result.taskWakeUps, 2 * result.transfers + 1);
+}
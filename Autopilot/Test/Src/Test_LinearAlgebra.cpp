@@ -0,0 +1,183 @@
+/*
+* Tests for the fixed size vector, matrix and quaternion types.
+*/
+
+#include <gtest/gtest.h>
+
+#include "LinearAlgebra.hpp"
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define TOLERANCE 1e-6f
+
+// The dimensions are usable in constant expressions
+static_assert(Vec<5>::size() == 5, "Vec size");
+static_assert(Mat<2, 7>::rows() == 2 && Mat<2, 7>::cols() == 7, "Mat dimensions");
+static_assert(sizeof(Mat<15, 15>) == 15 * 15 * sizeof(float), "Mat carries nothing but its elements");
+
+static void expectVecNear(const Vec3 &actual, float x, float y, float z)
+{
+	EXPECT_NEAR(actual[0], x, TOLERANCE);
+	EXPECT_NEAR(actual[1], y, TOLERANCE);
+	EXPECT_NEAR(actual[2], z, TOLERANCE);
+}
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(LinearAlgebra, VectorArithmetic) {
+
+   	/***********************SETUP***********************/
+
+	Vec3 a = {{1.0f, 2.0f, 3.0f}};
+	Vec3 b = {{-2.0f, 0.5f, 4.0f}};
+
+	/********************STEPTHROUGH********************/
+
+	Vec3 sum = a + b;
+	Vec3 scaled = 2.0f * a - b / 2.0f;
+	Vec3 crossed = cross(a, b);
+	Vec3 unit = normalized(b);
+	Vec3 zero = normalized(Vec3::zeros());
+
+	/**********************ASSERTS**********************/
+
+	expectVecNear(sum, -1.0f, 2.5f, 7.0f);
+	expectVecNear(scaled, 3.0f, 3.75f, 4.0f);
+	expectVecNear(crossed, 6.5f, -10.0f, 4.5f);
+	EXPECT_NEAR(dot(a, b), 11.0f, TOLERANCE);
+	EXPECT_NEAR(dot(crossed, a), 0.0f, TOLERANCE);
+	EXPECT_NEAR(norm(a), sqrtf(14.0f), TOLERANCE);
+	EXPECT_NEAR(distance(a, b), norm(a - b), TOLERANCE);
+	EXPECT_NEAR(norm(unit), 1.0f, TOLERANCE);
+	expectVecNear(zero, 0.0f, 0.0f, 0.0f);
+}
+
+TEST(LinearAlgebra, MatrixProductsAndBlocks) {
+
+   	/***********************SETUP***********************/
+
+	Mat<2, 3> a = {{{1.0f, 2.0f, 3.0f},
+	                {4.0f, 5.0f, 6.0f}}};
+	Mat<3, 2> b = {{{7.0f, 8.0f},
+	                {9.0f, 10.0f},
+	                {11.0f, 12.0f}}};
+	Vec3 x = {{1.0f, 0.0f, -1.0f}};
+
+	/********************STEPTHROUGH********************/
+
+	Mat<2, 2> product = a * b;
+	Mat<2, 2> productTransposed = multiplyTransposed(a, b.transposed());
+	Vec<2> applied = a * x;
+
+	Mat<4, 4> big = Mat<4, 4>::identity();
+	big.setBlock(1, 2, product);
+	Mat<2, 2> readBack = big.block<2, 2>(1, 2);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(product(0, 0), 58.0f);
+	EXPECT_EQ(product(0, 1), 64.0f);
+	EXPECT_EQ(product(1, 0), 139.0f);
+	EXPECT_EQ(product(1, 1), 154.0f);
+
+	for (size_t i = 0; i < 2; i++)
+	{
+		for (size_t j = 0; j < 2; j++)
+		{
+			EXPECT_EQ(productTransposed(i, j), product(i, j));
+			EXPECT_EQ(readBack(i, j), product(i, j));
+		}
+	}
+
+	EXPECT_EQ(applied[0], -2.0f);
+	EXPECT_EQ(applied[1], -2.0f);
+
+	EXPECT_EQ(big(0, 0), 1.0f);
+	EXPECT_EQ(big(3, 3), 1.0f);
+	EXPECT_EQ(big(1, 1), 1.0f);
+	EXPECT_EQ(big(1, 2), 58.0f);
+}
+
+TEST(LinearAlgebra, SkewIsTheCrossProduct) {
+
+   	/***********************SETUP***********************/
+
+	Vec3 a = {{0.3f, -1.2f, 2.0f}};
+	Vec3 b = {{4.0f, 0.5f, -0.7f}};
+
+	/**********************ASSERTS**********************/
+
+	Vec3 expected = cross(a, b);
+	Vec3 actual = skew(a) * b;
+
+	expectVecNear(actual, expected[0], expected[1], expected[2]);
+}
+
+TEST(LinearAlgebra, QuaternionRotationsAgree) {
+
+   	/***********************SETUP***********************/
+
+	Vec3 axisAngle = {{0.4f, -0.9f, 1.3f}};
+	Quat q = Quat::fromRotationVector(axisAngle);
+	Vec3 v = {{1.0f, 2.0f, -0.5f}};
+
+	/********************STEPTHROUGH********************/
+
+	Vec3 byQuaternion = q.rotate(v);
+	Vec3 byMatrix = q.toRotationMatrix() * v;
+	Vec3 andBack = q.conjugate().rotate(byQuaternion);
+
+	// The axis itself does not move
+	Vec3 axis = q.rotate(axisAngle);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_NEAR(q.normSquared(), 1.0f, TOLERANCE);
+	expectVecNear(byQuaternion, byMatrix[0], byMatrix[1], byMatrix[2]);
+	expectVecNear(andBack, v[0], v[1], v[2]);
+	expectVecNear(axis, axisAngle[0], axisAngle[1], axisAngle[2]);
+	EXPECT_NEAR(norm(byQuaternion), norm(v), TOLERANCE);
+}
+
+TEST(LinearAlgebra, QuaternionProductsCompose) {
+
+   	/***********************SETUP***********************/
+
+	const float QUARTER_TURN = 1.57079633f;
+
+	Vec3 halfAboutZ = {{0.0f, 0.0f, 0.5f * QUARTER_TURN}};
+	Vec3 xAxis = {{1.0f, 0.0f, 0.0f}};
+
+	/********************STEPTHROUGH********************/
+
+	Quat half = Quat::fromRotationVector(halfAboutZ);
+	Quat quarter = (half * half).normalized();
+
+	Vec3 rotated = quarter.rotate(xAxis);
+
+	float array[4];
+	quarter.toArray(array);
+	Quat copied = Quat::fromArray(array);
+
+	// Tiny angles take the first order branch
+	Quat tiny = Quat::fromRotationVector(xAxis * 1e-8f);
+
+	/**********************ASSERTS**********************/
+
+	expectVecNear(rotated, 0.0f, 1.0f, 0.0f);
+	EXPECT_EQ(copied.w, quarter.w);
+	EXPECT_EQ(copied.z, quarter.z);
+	EXPECT_EQ(tiny.w, 1.0f);
+	EXPECT_NEAR(tiny.x, 0.5e-8f, 1e-12f);
+
+	Quat identity = quarter * quarter.conjugate();
+	EXPECT_NEAR(identity.w, 1.0f, TOLERANCE);
+	EXPECT_NEAR(identity.z, 0.0f, TOLERANCE);
+}
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+
+#include "PID.hpp"
+#include "PIDBank.hpp"
+
+#include <cmath>
+#include <stdint.h>
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define AXES 4
+
+// Gains and limits of each axis, as the PIDController constructor takes them. The last axis has a negative i_max.
+static const float GAINS[AXES][6] = {
+	{1.2f, 0.05f, 0.3f, 20.0f, -100.0f, 100.0f},
+	{0.8f, 0.1f, 0.0f, 5.0f, -30.0f, 30.0f},
+	{2.0f, 0.0f, 1.5f, 0.0f, 0.0f, 100.0f},
+	{0.5f, 0.2f, 0.7f, -3.0f, -10.0f, 50.0f},
+};
+
+// Uniform in [-1, 1], reproducible
+static float noise(uint32_t &seed)
+{
+	seed = seed * 1664525u + 1013904223u;
+	return (float) (seed >> 8) / (float) (1u << 23) - 1.0f;
+}
+
+static PIDBank<AXES> makeBank()
+{
+	PIDBank<AXES> bank;
+
+	for (int axis = 0; axis < AXES; axis++)
+	{
+		bank.setAxis(axis, GAINS[axis][0], GAINS[axis][1], GAINS[axis][2], GAINS[axis][3], GAINS[axis][4], GAINS[axis][5]);
+	}
+
+	return bank;
+}
+
+static PIDController makeController(int axis)
+{
+	return PIDController(GAINS[axis][0], GAINS[axis][1], GAINS[axis][2], GAINS[axis][3], GAINS[axis][4], GAINS[axis][5]);
+}
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(PIDBank, OutputCannotBeLargerThanMaxOutput) {
+
+   	/***********************SETUP***********************/
+
+	float maxOutput = 100;
+
+	PIDBank<1> bank;
+	bank.setAxis(0, 1, 0, 0, 0, 0, maxOutput);
+
+	const float desired[1] = {1000000};
+	const float actual[1] = {0};
+	float output[1];
+
+	/********************STEPTHROUGH********************/
+
+	bank.execute(desired, actual, nullptr, output);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(output[0], maxOutput);
+}
+
+TEST(PIDBank, OutputCannotBeSmallerThanMinOutput) {
+
+   	/***********************SETUP***********************/
+
+	float minOutput = -100;
+
+	PIDBank<1> bank;
+	bank.setAxis(0, 1, 0, 0, 0, minOutput, 0);
+
+	const float desired[1] = {-1000000};
+	const float actual[1] = {0};
+	float output[1];
+
+	/********************STEPTHROUGH********************/
+
+	bank.execute(desired, actual, nullptr, output);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(output[0], minOutput);
+}
+
+TEST(PIDBank, EveryAxisMatchesAPIDController) {
+
+   	/***********************SETUP***********************/
+
+	PIDBank<AXES> bank = makeBank();
+	PIDController controllers[AXES] = {makeController(0), makeController(1), makeController(2), makeController(3)};
+	uint32_t seed = 11;
+	int mismatches = 0;
+
+	/********************STEPTHROUGH********************/
+
+	// Large enough steps to saturate the outputs and the integrals, and the measured rate comes and goes
+	for (int step = 0; step < 5000; step++)
+	{
+		float desired[AXES], actual[AXES], actualRate[AXES], output[AXES];
+
+		for (int axis = 0; axis < AXES; axis++)
+		{
+			desired[axis] = 40.0f * noise(seed);
+			actual[axis] = 40.0f * noise(seed);
+			actualRate[axis] = ((step / 7 + axis) % 3 == 0) ? std::nanf("") : 10.0f * noise(seed);
+		}
+
+		bank.execute(desired, actual, actualRate, output);
+
+		for (int axis = 0; axis < AXES; axis++)
+		{
+			mismatches += (output[axis] != controllers[axis].execute(desired[axis], actual[axis], actualRate[axis]));
+		}
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(mismatches, 0);
+}
+
+TEST(PIDBank, AxesLeftOutKeepTheirState) {
+
+   	/***********************SETUP***********************/
+
+	PIDBank<AXES> bank = makeBank();
+	PIDController controllers[AXES] = {makeController(0), makeController(1), makeController(2), makeController(3)};
+	uint32_t seed = 5;
+	int mismatches = 0;
+	int untouched = 0;
+
+	/********************STEPTHROUGH********************/
+
+	for (int step = 0; step < 2000; step++)
+	{
+		uint32_t axes = (step % 3 == 0) ? 0x3u : 0xCu;
+		float desired[AXES], actual[AXES];
+		float output[AXES] = {-1.0f, -1.0f, -1.0f, -1.0f};
+
+		for (int axis = 0; axis < AXES; axis++)
+		{
+			desired[axis] = 40.0f * noise(seed);
+			actual[axis] = 40.0f * noise(seed);
+		}
+
+		bank.execute(desired, actual, nullptr, output, axes);
+
+		for (int axis = 0; axis < AXES; axis++)
+		{
+			if (axes & (1u << axis))
+			{
+				mismatches += (output[axis] != controllers[axis].execute(desired[axis], actual[axis]));
+			}
+			else
+			{
+				untouched += (output[axis] == -1.0f);
+			}
+		}
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(mismatches, 0);
+	EXPECT_EQ(untouched, 2 * 2000);
+}
@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "PathGuidance.hpp"
+#include "SetpointInterpolator.hpp"
+#include "AttitudeDataBus.hpp"
+#include "AutoSteer.hpp"
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define ATTITUDE_PERIOD_US (1000000UL / ATTITUDE_TASK_RATE_HZ)
+#define START_US 1000000u
+
+#define NUM_WAYPOINTS 6
+
+// Two positions far apart on the flight path, that need very different headings and altitudes
+static const _WaypointManager_Data_In POSITIONS[2] = {
+	{43.467998128, -80.537331184, 11, 100},         // latitude, longitude, altitude, heading
+	{43.469649460242174, -80.55044911526599, 34, 86},
+};
+
+// The aircraft jumps from one position to the other every time the path manager looks
+class AlternatingPositionSource : public PathGuidanceInputSource
+{
+	public:
+		AlternatingPositionSource() : reads(0), hasFix(true) {}
+
+		bool getInput(PathGuidanceInput_t &input)
+		{
+			if ( ! hasFix)
+			{
+				return false;
+			}
+
+			input.position = POSITIONS[reads % 2];
+			input.accY = 0.0f;
+			reads++;
+
+			return true;
+		}
+
+		int reads;
+		bool hasFix;
+};
+
+class PathManager_PathGuidance : public ::testing::Test
+{
+	public:
+
+		PathManager_PathGuidance() : waypoints(43.467998128, -80.537331184) {}
+
+		virtual void SetUp()
+		{
+			const float latitudes[NUM_WAYPOINTS] = {43.47075830402289, 43.469649460242174, 43.46764349709017, 43.46430420301871, 43.461854997441996, 43.46144872072057};
+			const float longitudes[NUM_WAYPOINTS] = {-80.5479053969044, -80.55044911526599, -80.54172626568685, -80.54806720987989, -80.5406705046026, -80.53505945389745};
+			const int altitudes[NUM_WAYPOINTS] = {10, 20, 30, 33, 32, 50};
+
+			_PathData *initialPaths[PATH_BUFFER_SIZE] = {nullptr};
+
+			for (int i = 0; i < NUM_WAYPOINTS; i++)
+			{
+				initialPaths[i] = waypoints.initialize_waypoint(longitudes[i], latitudes[i], altitudes[i], PATH_FOLLOW);
+			}
+
+			ASSERT_EQ(waypoints.initialize_flight_path(initialPaths, NUM_WAYPOINTS), WAYPOINT_SUCCESS);
+		}
+
+		WaypointManager waypoints;
+		AlternatingPositionSource positions;
+};
+
+/***********************************************************************************************************************
+ * Path Guidance Tests
+ **********************************************************************************************************************/
+
+TEST_F(PathManager_PathGuidance, RunsOnceEveryRateRatioCycles) {
+
+   	/***********************SETUP***********************/
+
+	PathGuidance guidance(waypoints, positions);
+
+	uint32_t generationBefore = PathSetpointTopic.getGeneration();
+	int updates = 0;
+	int misplacedUpdates = 0;
+
+	PathSetpoint_t latest;
+
+	/********************STEPTHROUGH********************/
+
+	for (int cycle = 0; cycle < 3 * PATH_TO_ATTITUDE_RATE_RATIO + 1; cycle++)
+	{
+		_PathGuidanceStatus status = guidance.execute(START_US + cycle * ATTITUDE_PERIOD_US);
+
+		if (status == PATH_GUIDANCE_UPDATED)
+		{
+			updates++;
+			misplacedUpdates += (cycle % PATH_TO_ATTITUDE_RATE_RATIO == 0) ? 0 : 1;
+		}
+	}
+
+	PathSetpointTopic.read(latest);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(updates, 4);
+	EXPECT_EQ(misplacedUpdates, 0);
+	EXPECT_EQ(positions.reads, 4);
+	EXPECT_EQ(guidance.getUpdateCount(), 4u);
+	EXPECT_EQ(PathSetpointTopic.getGeneration(), generationBefore + 4);
+
+	EXPECT_EQ(latest.timeUs, START_US + 3 * PATH_TO_ATTITUDE_RATE_RATIO * ATTITUDE_PERIOD_US);
+	EXPECT_EQ(latest.airspeed, CRUISING_SPEED);
+}
+
+TEST_F(PathManager_PathGuidance, NoPositionFixPublishesNothingUntilTheNextSlot) {
+
+   	/***********************SETUP***********************/
+
+	PathGuidance guidance(waypoints, positions);
+	positions.hasFix = false;
+
+	uint32_t generationBefore = PathSetpointTopic.getGeneration();
+
+	/********************STEPTHROUGH********************/
+
+	_PathGuidanceStatus withoutFix = guidance.execute(START_US);
+
+	// The fix comes back straight away, but the path manager keeps to its rate
+	positions.hasFix = true;
+	_PathGuidanceStatus nextCycle = guidance.execute(START_US + ATTITUDE_PERIOD_US);
+
+	uint32_t generationWithoutFix = PathSetpointTopic.getGeneration();
+
+	for (int cycle = 2; cycle <= PATH_TO_ATTITUDE_RATE_RATIO; cycle++)
+	{
+		guidance.execute(START_US + cycle * ATTITUDE_PERIOD_US);
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(withoutFix, PATH_GUIDANCE_NO_INPUT);
+	EXPECT_EQ(nextCycle, PATH_GUIDANCE_SKIPPED);
+	EXPECT_EQ(generationWithoutFix, generationBefore);
+	EXPECT_EQ(PathSetpointTopic.getGeneration(), generationBefore + 1);
+}
+
+TEST_F(PathManager_PathGuidance, AttitudeCommandsAreContinuousAcrossSetpointUpdates) {
+
+   	/***********************SETUP***********************/
+
+	PathGuidance guidance(waypoints, positions);
+
+	const PMCommands initial = {0.0f, 0.0f, 0.0f, CRUISING_SPEED};
+	SetpointInterpolator interpolator(PATH_GUIDANCE_PERIOD_US, initial);
+	SeqlockSubscriber<PathSetpoint_t> subscriber(PathSetpointTopic);
+
+	PathSetpoint_t setpoint;
+	subscriber.poll(setpoint); // skip whatever the other tests left on the topic
+
+	PMCommands previous = initial;
+	PathSetpoint_t previousSetpoint = {0.0f, 0.0f, 0.0f, CRUISING_SPEED, 0};
+
+	float maxRollStep = 0.0f, maxPitchStep = 0.0f, maxYawStep = 0.0f;
+	float maxRollJump = 0.0f, maxPitchJump = 0.0f, maxYawJump = 0.0f;
+	float maxRudder = 0.0f;
+	float maxLagError = 0.0f;
+
+	/********************STEPTHROUGH********************/
+
+	for (int cycle = 0; cycle < 20 * PATH_TO_ATTITUDE_RATE_RATIO; cycle++)
+	{
+		uint32_t nowUs = START_US + cycle * ATTITUDE_PERIOD_US;
+
+		guidance.execute(nowUs);
+
+		PMCommands commands;
+		bool isNew = (subscriber.poll(setpoint) == SEQLOCK_READ_NEW);
+
+		if (isNew)
+		{
+			interpolator.setTarget(setpoint, nowUs);
+		}
+
+		interpolator.getCommands(nowUs, commands);
+
+		maxRollStep = fmaxf(maxRollStep, fabsf(commands.roll - previous.roll));
+		maxPitchStep = fmaxf(maxPitchStep, fabsf(commands.pitch - previous.pitch));
+		maxYawStep = fmaxf(maxYawStep, fabsf(commands.yaw - previous.yaw));
+
+		if (isNew)
+		{
+			// The commands reach each setpoint just as the next one comes in
+			maxLagError = fmaxf(maxLagError, fabsf(commands.roll - previousSetpoint.roll));
+			maxRollJump = fmaxf(maxRollJump, fabsf(setpoint.roll - previousSetpoint.roll));
+			maxPitchJump = fmaxf(maxPitchJump, fabsf(setpoint.pitch - previousSetpoint.pitch));
+			maxYawJump = fmaxf(maxYawJump, fabsf(setpoint.rudder - previousSetpoint.rudder));
+			maxRudder = fmaxf(maxRudder, fabsf(setpoint.rudder));
+			previousSetpoint = setpoint;
+		}
+
+		previous = commands;
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(guidance.getUpdateCount(), 20u);
+
+	// Make sure the setpoints really do jump, from a full bank one way to a full bank the other
+	EXPECT_GT(maxRollJump, 0.9f);
+	EXPECT_GT(maxPitchJump, 0.3f);
+	EXPECT_GT(maxYawJump, 10.0f);
+
+	// The rudder follows the bank, within what OutputMixing accepts
+	EXPECT_LE(maxRudder, 100.0f);
+
+	// Spread evenly over the attitude cycles in between
+	EXPECT_LE(maxRollStep, maxRollJump / PATH_TO_ATTITUDE_RATE_RATIO * 1.001f);
+	EXPECT_LE(maxPitchStep, maxPitchJump / PATH_TO_ATTITUDE_RATE_RATIO * 1.001f);
+	EXPECT_LE(maxYawStep, maxYawJump / PATH_TO_ATTITUDE_RATE_RATIO * 1.001f);
+	EXPECT_LT(maxLagError, 1e-6f);
+}
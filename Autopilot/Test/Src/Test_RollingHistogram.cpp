@@ -0,0 +1,99 @@
+/*
+* Tests for the rolling window histogram.
+*/
+
+#include <gtest/gtest.h>
+
+#include "RollingHistogram.hpp"
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define BIN_WIDTH 10
+
+typedef RollingHistogram<8, 4> SmallHistogram;
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(RollingHistogram, EmptyHistogramReportsZero) {
+
+   	/***********************SETUP***********************/
+
+	SmallHistogram histogram(BIN_WIDTH);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(histogram.getWindowSize(), 0u);
+	EXPECT_EQ(histogram.percentile(50), 0u);
+	EXPECT_EQ(histogram.max(), 0u);
+}
+
+TEST(RollingHistogram, PercentilesAreUpperBinEdges) {
+
+   	/***********************SETUP***********************/
+
+	SmallHistogram histogram(BIN_WIDTH);
+
+	/********************STEPTHROUGH********************/
+
+	histogram.add(5);
+	histogram.add(12);
+	histogram.add(13);
+	histogram.add(31);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(histogram.percentile(25), 10u);
+	EXPECT_EQ(histogram.percentile(50), 20u);
+	EXPECT_EQ(histogram.percentile(75), 20u);
+	EXPECT_EQ(histogram.percentile(99), 40u);
+	EXPECT_EQ(histogram.max(), 40u);
+	EXPECT_EQ(histogram.getLatest(), 31u);
+}
+
+TEST(RollingHistogram, OldSamplesLeaveTheWindow) {
+
+   	/***********************SETUP***********************/
+
+	SmallHistogram histogram(BIN_WIDTH);
+
+	/********************STEPTHROUGH********************/
+
+	histogram.add(75); // pushed out by the four samples after it
+
+	for (int i = 0; i < 4; i++)
+	{
+		histogram.add(1);
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(histogram.getWindowSize(), 4u);
+	EXPECT_EQ(histogram.getTotalAdded(), 5u);
+	EXPECT_EQ(histogram.getBinCount(7), 0u);
+	EXPECT_EQ(histogram.getBinCount(0), 4u);
+	EXPECT_EQ(histogram.max(), 10u);
+}
+
+TEST(RollingHistogram, LargeValuesLandInTheLastBin) {
+
+   	/***********************SETUP***********************/
+
+	SmallHistogram histogram(BIN_WIDTH);
+
+	/********************STEPTHROUGH********************/
+
+	histogram.add(1000000);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(histogram.getBinCount(7), 1u);
+	EXPECT_EQ(histogram.max(), 80u);
+	EXPECT_EQ(histogram.getLatest(), 1000000u);
+}
@@ -0,0 +1,239 @@
+/*
+* Tests for the seqlock topics used to pass data between tasks.
+*/
+
+#include <gtest/gtest.h>
+
+#include "SeqlockTopic.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define STRESS_NUM_PUBLISHES 200000
+#define STRESS_NUM_READERS 3
+#define PAYLOAD_WORDS 16
+
+// Every field of a published payload holds the same value, so a torn read shows up as fields that disagree.
+struct StressPayload_t
+{
+    uint32_t field[PAYLOAD_WORDS];
+};
+
+struct SmallPayload_t
+{
+    float value;
+    bool flag;
+};
+
+static StressPayload_t makePayload(uint32_t value)
+{
+    StressPayload_t payload;
+
+    for (int i = 0; i < PAYLOAD_WORDS; i++)
+    {
+        payload.field[i] = value;
+    }
+
+    return payload;
+}
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(SeqlockTopic, EmptyTopicReadsGenerationZero) {
+
+   	/***********************SETUP***********************/
+
+	SeqlockTopic<SmallPayload_t> topic;
+	SeqlockSubscriber<SmallPayload_t> subscriber(topic);
+
+	SmallPayload_t value;
+	uint32_t generation = 1234;
+
+	/********************STEPTHROUGH********************/
+
+	bool readOk = topic.read(value, &generation);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_TRUE(readOk);
+	EXPECT_EQ(generation, 0u);
+	EXPECT_EQ(topic.getGeneration(), 0u);
+	EXPECT_EQ(subscriber.poll(value), SEQLOCK_READ_EMPTY);
+}
+
+TEST(SeqlockTopic, ReadReturnsLastPublishedValue) {
+
+   	/***********************SETUP***********************/
+
+	SeqlockTopic<SmallPayload_t> topic;
+
+	SmallPayload_t first = {1.5f, true};
+	SmallPayload_t second = {-7.25f, false};
+	SmallPayload_t value;
+	uint32_t generation;
+
+	/********************STEPTHROUGH********************/
+
+	topic.publish(first);
+	topic.publish(second);
+
+	bool readOk = topic.read(value, &generation);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_TRUE(readOk);
+	EXPECT_EQ(value.value, second.value);
+	EXPECT_EQ(value.flag, second.flag);
+	EXPECT_EQ(generation, 2u);
+}
+
+TEST(SeqlockTopic, SubscriberTellsFreshFromStaleData) {
+
+   	/***********************SETUP***********************/
+
+	SeqlockTopic<SmallPayload_t> topic;
+	SeqlockSubscriber<SmallPayload_t> subscriber(topic);
+
+	SmallPayload_t published = {3.0f, true};
+	SmallPayload_t value;
+
+	/********************STEPTHROUGH********************/
+
+	topic.publish(published);
+
+	_SeqlockReadStatus firstPoll = subscriber.poll(value);
+	_SeqlockReadStatus secondPoll = subscriber.poll(value);
+
+	topic.publish(published);
+
+	_SeqlockReadStatus thirdPoll = subscriber.poll(value);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(firstPoll, SEQLOCK_READ_NEW);
+	EXPECT_EQ(secondPoll, SEQLOCK_READ_STALE);
+	EXPECT_EQ(thirdPoll, SEQLOCK_READ_NEW);
+	EXPECT_EQ(subscriber.getMissedCount(), 0u);
+}
+
+TEST(SeqlockTopic, SubscriberCountsOverwrittenPublishes) {
+
+   	/***********************SETUP***********************/
+
+	SeqlockTopic<SmallPayload_t> topic;
+	SeqlockSubscriber<SmallPayload_t> subscriber(topic);
+
+	SmallPayload_t published = {0.0f, false};
+	SmallPayload_t value;
+
+	/********************STEPTHROUGH********************/
+
+	topic.publish(published);
+	subscriber.poll(value);
+
+	for (int i = 0; i < 5; i++)
+	{
+		topic.publish(published);
+	}
+
+	subscriber.poll(value);
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(subscriber.getMissedCount(), 4u);
+}
+
+TEST(SeqlockTopic, ConcurrentReadersNeverSeeTornWrites) {
+
+   	/***********************SETUP***********************/
+
+	SeqlockTopic<StressPayload_t> topic;
+
+	atomic<bool> writerDone(false);
+	atomic<uint32_t> tornReads(0);
+	atomic<uint32_t> backwardsGenerations(0);
+	atomic<uint32_t> mismatchedGenerations(0);
+	atomic<uint32_t> successfulReads(0);
+
+	/********************STEPTHROUGH********************/
+
+	vector<thread> readers;
+
+	for (int r = 0; r < STRESS_NUM_READERS; r++)
+	{
+		readers.push_back(thread([&]()
+		{
+			uint32_t lastGeneration = 0;
+
+			while ( ! writerDone.load())
+			{
+				StressPayload_t value;
+				uint32_t generation;
+
+				if ( ! topic.read(value, &generation))
+				{
+					continue;
+				}
+
+				successfulReads++;
+
+				for (int i = 1; i < PAYLOAD_WORDS; i++)
+				{
+					if (value.field[i] != value.field[0])
+					{
+						tornReads++;
+						break;
+					}
+				}
+
+				// the writer publishes the value n as the n-th generation
+				if (value.field[0] != generation)
+				{
+					mismatchedGenerations++;
+				}
+
+				if (generation < lastGeneration)
+				{
+					backwardsGenerations++;
+				}
+
+				lastGeneration = generation;
+			}
+		}));
+	}
+
+	thread writer([&]()
+	{
+		for (uint32_t i = 1; i <= STRESS_NUM_PUBLISHES; i++)
+		{
+			topic.publish(makePayload(i));
+		}
+
+		writerDone.store(true);
+	});
+
+	writer.join();
+
+	for (size_t r = 0; r < readers.size(); r++)
+	{
+		readers[r].join();
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(tornReads.load(), 0u);
+	EXPECT_EQ(mismatchedGenerations.load(), 0u);
+	EXPECT_EQ(backwardsGenerations.load(), 0u);
+	EXPECT_GT(successfulReads.load(), 0u);
+	EXPECT_EQ(topic.getGeneration(), (uint32_t) STRESS_NUM_PUBLISHES);
+}
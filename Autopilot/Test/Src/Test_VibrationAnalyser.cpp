@@ -0,0 +1,127 @@
+/*
+* Tests for the streaming gyro spectrum analysis, on synthetic sinusoids in noise.
+*/
+
+#include <gtest/gtest.h>
+
+#include "VibrationAnalyser.hpp"
+
+#include <math.h>
+#include <stdint.h>
+
+using namespace std;
+using ::testing::Test;
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define SAMPLE_RATE_HZ 200.0f
+#define PI_F 3.14159265f
+
+// Uniform in [-1, 1], reproducible
+static float noise(uint32_t &seed)
+{
+	seed = seed * 1664525u + 1013904223u;
+	return (float) (seed >> 8) / (float) (1u << 23) - 1.0f;
+}
+
+static float tone(float frequencyHz, int sample)
+{
+	return sinf(2.0f * PI_F * frequencyHz * sample / SAMPLE_RATE_HZ);
+}
+
+/***********************************************************************************************************************
+ * Tests
+ **********************************************************************************************************************/
+
+TEST(VibrationAnalyser, FindsTheDominantPeaksOfEachAxis) {
+
+   	/***********************SETUP***********************/
+
+	VibrationAnalyser analyser(VibrationAnalyser_DefaultConfig(SAMPLE_RATE_HZ));
+	uint32_t seed = 1;
+
+	/********************STEPTHROUGH********************/
+
+	for (int i = 0; i < 2000; i++)
+	{
+		float gyro[VIBRATION_AXES] = {
+			tone(47.0f, i) + 0.3f * noise(seed),
+			0.5f * tone(35.3f, i) + tone(71.6f, i) + 0.3f * noise(seed),
+			0.3f * noise(seed)
+		};
+
+		analyser.addSample(gyro);
+		analyser.step();
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_NEAR(analyser.getPeaks(0)[0], 47.0f, 0.5f);
+	EXPECT_EQ(analyser.getPeaks(0)[1], 0.0f);
+
+	EXPECT_NEAR(analyser.getPeaks(1)[0], 35.3f, 0.5f);
+	EXPECT_NEAR(analyser.getPeaks(1)[1], 71.6f, 0.5f);
+
+	EXPECT_EQ(analyser.getPeaks(2)[0], 0.0f);
+	EXPECT_EQ(analyser.getPeaks(2)[1], 0.0f);
+}
+
+TEST(VibrationAnalyser, NoStepDoesMoreThanItsBudget) {
+
+   	/***********************SETUP***********************/
+
+	VibrationAnalyserConfig_t config = VibrationAnalyser_DefaultConfig(SAMPLE_RATE_HZ);
+	config.workPerStep = 8;
+
+	VibrationAnalyser analyser(config);
+	uint32_t seed = 7;
+	int mostWork = 0;
+
+	/********************STEPTHROUGH********************/
+
+	for (int i = 0; i < 4000; i++)
+	{
+		float gyro[VIBRATION_AXES] = {tone(60.0f, i) + 0.2f * noise(seed), 0.0f, 0.0f};
+
+		analyser.addSample(gyro);
+		analyser.step();
+
+		mostWork = (analyser.getLastStepWork() > mostWork) ? analyser.getLastStepWork() : mostWork;
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_EQ(mostWork, 8);
+	EXPECT_GT(analyser.getAnalysisCount(), 20u);
+	EXPECT_NEAR(analyser.getPeaks(0)[0], 60.0f, 0.5f);
+}
+
+TEST(VibrationAnalyser, FollowsAPeakThatMovesWithThrottle) {
+
+   	/***********************SETUP***********************/
+
+	VibrationAnalyser analyser(VibrationAnalyser_DefaultConfig(SAMPLE_RATE_HZ));
+	uint32_t seed = 3;
+	float phase = 0.0f;
+	float frequencyHz = 40.0f;
+
+	/********************STEPTHROUGH********************/
+
+	// 40 Hz to 65 Hz over 20 s, then held for 4 s
+	for (int i = 0; i < 4800; i++)
+	{
+		frequencyHz = (i < 4000) ? 40.0f + 25.0f * i / 4000.0f : 65.0f;
+		phase += 2.0f * PI_F * frequencyHz / SAMPLE_RATE_HZ;
+
+		float gyro[VIBRATION_AXES] = {0.0f, 0.0f, sinf(phase) + 0.2f * noise(seed)};
+
+		analyser.addSample(gyro);
+		analyser.step();
+	}
+
+	/**********************ASSERTS**********************/
+
+	EXPECT_NEAR(analyser.getPeaks(2)[0], 65.0f, 0.5f);
+}
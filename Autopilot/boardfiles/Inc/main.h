@@ -108,6 +108,8 @@ void Error_Handler(void);
 #define LED3_GPIO_Port GPIOE
 #define MEM_WC_Pin GPIO_PIN_13
 #define MEM_WC_GPIO_Port GPIOE
+#define IMU_CS_Pin GPIO_PIN_12
+#define IMU_CS_GPIO_Port GPIOB
 #define USONIC_IC_Pin GPIO_PIN_8
 #define USONIC_IC_GPIO_Port GPIOB
 #define USONIC_OC_Pin GPIO_PIN_9
@@ -38,6 +38,9 @@ extern SPI_HandleTypeDef hspi5;
 
 /* USER CODE BEGIN Private defines */
 
+extern DMA_HandleTypeDef hdma_spi1_rx;
+extern DMA_HandleTypeDef hdma_spi1_tx;
+
 /* USER CODE END Private defines */
 
 void MX_SPI1_Init(void);
@@ -79,6 +79,8 @@ void USART3_IRQHandler(void);
 void UART4_IRQHandler(void);
 void I2C4_EV_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void DMA2_Stream0_IRQHandler(void);
+void DMA2_Stream3_IRQHandler(void);
 
 /* USER CODE END EFP */
 
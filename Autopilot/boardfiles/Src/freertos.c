@@ -141,11 +141,11 @@ void MX_FREERTOS_Init(void) {
   defaultTaskHandle = osThreadCreate(osThread(defaultTask), NULL);
 
   /* definition and creation of Interchip */
-  osThreadDef(Interchip, Interchip_Run, osPriorityNormal, 0, 128);
+  osThreadDef(Interchip, Interchip_Run, osPriorityAboveNormal, 0, 256);
   InterchipHandle = osThreadCreate(osThread(Interchip), NULL);
 
   /* definition and creation of Attitude */
-  osThreadDef(Attitude, Attitude_Run, osPriorityNormal, 0, 128);
+  osThreadDef(Attitude, Attitude_Run, osPriorityRealtime, 0, 1024);
   AttitudeHandle = osThreadCreate(osThread(Attitude), NULL);
 
   /* USER CODE BEGIN RTOS_THREADS */
@@ -61,6 +61,8 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "TimeStamp.h"
+#include "AttitudeTimerTick.h"
 
 /* USER CODE END Includes */
 
@@ -95,15 +97,6 @@ void MX_FREERTOS_Init(void);
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
 
-// TODO this should be removed once we have an actual function to call
-void Attitude_Run(void const * argument)
-{
-  while(1)
-  {
-    __asm("nop");
-  }
-}
-
 /* USER CODE END 0 */
 
 /**
@@ -152,6 +145,7 @@ int main(void)
   MX_CRC_Init();
   MX_I2C2_Init();
   /* USER CODE BEGIN 2 */
+  TimeStamp_Init();
 
   /* USER CODE END 2 */
 
@@ -261,6 +255,9 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
     HAL_IncTick();
   }
   /* USER CODE BEGIN Callback 1 */
+  if (htim->Instance == TIM10) {
+    AttitudeTimerTick_OnTimerElapsed();
+  }
 
   /* USER CODE END Callback 1 */
 }
@@ -83,6 +83,8 @@ extern WWDG_HandleTypeDef hwwdg;
 extern TIM_HandleTypeDef htim4;
 
 /* USER CODE BEGIN EV */
+extern DMA_HandleTypeDef hdma_spi1_rx;
+extern DMA_HandleTypeDef hdma_spi1_tx;
 
 /* USER CODE END EV */
 
@@ -324,5 +326,21 @@ void I2C4_EV_IRQHandler(void)
 
 /* USER CODE BEGIN 1 */
 
+/**
+  * @brief This function handles DMA2 stream0 global interrupt, the SPI1 (interchip) receive.
+  */
+void DMA2_Stream0_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_spi1_rx);
+}
+
+/**
+  * @brief This function handles DMA2 stream3 global interrupt, the SPI1 (interchip) transmit.
+  */
+void DMA2_Stream3_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_spi1_tx);
+}
+
 /* USER CODE END 1 */
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,212 @@
+/**
+ * Single precision approximations of the libm functions used in the control loops.
+ *
+ * Each function documents its worst case error over the stated domain, measured against the double precision libm by
+ * Autopilot/Test/Bench/Bench_FastMath.cpp, which sweeps the inputs and prints the errors in ulps next to the cost per
+ * call. Errors are absolute for the angle functions, whose outputs are used as angles, and relative for the roots.
+ *
+ * Defining FAST_MATH_USE_LIBM turns every function into a plain call to its libm counterpart, eg to rule the
+ * approximations out when chasing a numerical problem.
+ *
+ * Arguments outside the documented domains give unspecified results, NaN in gives NaN out.
+ */
+
+#ifndef FAST_MATH_HPP
+#define FAST_MATH_HPP
+
+#include <math.h>
+#include <stdint.h>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define FAST_MATH_PI 3.14159265f
+#define FAST_MATH_PI_2 1.57079633f
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+#ifdef FAST_MATH_USE_LIBM
+
+inline float FastMath_Atan2(float y, float x) {return atan2f(y, x);}
+inline float FastMath_Asin(float x) {return asinf(x);}
+inline float FastMath_Acos(float x) {return acosf(x);}
+inline float FastMath_Sin(float x) {return sinf(x);}
+inline float FastMath_Cos(float x) {return cosf(x);}
+inline float FastMath_Sqrt(float x) {return sqrtf(x);}
+inline float FastMath_InvSqrt(float x) {return 1.0f / sqrtf(x);}
+
+#else
+
+/**
+* atan(z) for z in [0, 1]. Abramowitz and Stegun 4.4.49, an odd polynomial of degree 17 with an error of 2e-8 in
+* exact arithmetic.
+*/
+inline float FastMath_AtanUnit(float z)
+{
+    float z2 = z * z;
+
+    float p = 0.0028662257f;
+    p = p * z2 - 0.0161657367f;
+    p = p * z2 + 0.0429096138f;
+    p = p * z2 - 0.0752896400f;
+    p = p * z2 + 0.1065626393f;
+    p = p * z2 - 0.1420889944f;
+    p = p * z2 + 0.1999355085f;
+    p = p * z2 - 0.3333314528f;
+
+    return z + z * z2 * p;
+}
+
+/**
+* atan2f. The ratio of the smaller to the larger magnitude goes through FastMath_AtanUnit, then the octant is
+* restored. Max error 3e-7 rad, 2 to 3 ulps. atan2(0, 0) is 0.
+*/
+inline float FastMath_Atan2(float y, float x)
+{
+    float absY = fabsf(y);
+    float absX = fabsf(x);
+
+    if (absX == 0.0f && absY == 0.0f)
+    {
+        return 0.0f;
+    }
+
+    bool steep = absY > absX;
+    float z = steep ? absX / absY : absY / absX;
+    float angle = FastMath_AtanUnit(z);
+
+    angle = steep ? FAST_MATH_PI_2 - angle : angle;
+    angle = (x < 0.0f) ? FAST_MATH_PI - angle : angle;
+
+    return (y < 0.0f) ? -angle : angle;
+}
+
+/**
+* asin for x in [0, 1/2]. Cephes asinf, an odd polynomial of degree 11.
+*/
+inline float FastMath_AsinHalf(float x)
+{
+    float z = x * x;
+
+    float p = 4.2163199048e-2f;
+    p = p * z + 2.4181311049e-2f;
+    p = p * z + 4.5470025998e-2f;
+    p = p * z + 7.4953002686e-2f;
+    p = p * z + 1.6666752422e-1f;
+
+    return x + x * z * p;
+}
+
+/**
+* asinf for x in [-1, 1]. Max error 2 ulps. Above 1/2 the argument goes through
+* asin(x) = pi/2 - 2 asin(sqrt((1 - x) / 2)) so the polynomial never sees the steep end.
+*/
+inline float FastMath_Asin(float x)
+{
+    float absX = fabsf(x);
+    float angle;
+
+    if (absX <= 0.5f)
+    {
+        angle = FastMath_AsinHalf(absX);
+    }
+    else
+    {
+        angle = FAST_MATH_PI_2 - 2.0f * FastMath_AsinHalf(__builtin_sqrtf(0.5f * (1.0f - absX)));
+    }
+
+    return (x < 0.0f) ? -angle : angle;
+}
+
+// acosf for x in [-1, 1]. Max error 3e-7 rad, from the same identities as FastMath_Asin.
+inline float FastMath_Acos(float x)
+{
+    if (x < -0.5f)
+    {
+        return FAST_MATH_PI - 2.0f * FastMath_AsinHalf(__builtin_sqrtf(0.5f * (1.0f + x)));
+    }
+    else if (x > 0.5f)
+    {
+        return 2.0f * FastMath_AsinHalf(__builtin_sqrtf(0.5f * (1.0f - x)));
+    }
+
+    return FAST_MATH_PI_2 - FastMath_AsinHalf(x);
+}
+
+/**
+* Reduces x to r in [-pi/4, pi/4] with x = r + quadrant * pi/2. pi/2 is split in three parts (Cody and Waite) so
+* that r stays accurate for |x| up to about 8000.
+*/
+inline float FastMath_ReduceQuarterPi(float x, int32_t &quadrant)
+{
+    const float TWO_OVER_PI = 0.636619772f;
+    const float PI_2_HIGH = 1.5703125f;
+    const float PI_2_MID = 4.83751297e-4f;
+    const float PI_2_LOW = 7.54978995e-8f;
+
+    // Rounds to nearest through the truncating conversion, floorf is a library call on most targets
+    quadrant = (int32_t) (x * TWO_OVER_PI + ((x < 0.0f) ? -0.5f : 0.5f));
+    float k = (float) quadrant;
+
+    return ((x - k * PI_2_HIGH) - k * PI_2_MID) - k * PI_2_LOW;
+}
+
+// Minimax polynomials on [-pi/4, pi/4], from Cephes sinf/cosf
+inline float FastMath_SinKernel(float r)
+{
+    float r2 = r * r;
+    return ((-1.9515295891e-4f * r2 + 8.3321608736e-3f) * r2 - 1.6666654611e-1f) * r2 * r + r;
+}
+
+inline float FastMath_CosKernel(float r)
+{
+    float r2 = r * r;
+    return ((2.443315711809948e-5f * r2 - 1.388731625493765e-3f) * r2 + 4.166664568298827e-2f) * r2 * r2 - 0.5f * r2 + 1.0f;
+}
+
+// sinf for |x| < 8000. Max error 1e-7, 2 ulps below 2 pi.
+inline float FastMath_Sin(float x)
+{
+    int32_t quadrant;
+    float r = FastMath_ReduceQuarterPi(x, quadrant);
+
+    float result = (quadrant & 1) ? FastMath_CosKernel(r) : FastMath_SinKernel(r);
+    return (quadrant & 2) ? -result : result;
+}
+
+// cosf for |x| < 8000. Max error 1e-7, 2 ulps below 2 pi.
+inline float FastMath_Cos(float x)
+{
+    int32_t quadrant;
+    float r = FastMath_ReduceQuarterPi(x, quadrant);
+
+    float result = (quadrant & 1) ? FastMath_SinKernel(r) : FastMath_CosKernel(r);
+    return ((quadrant + 1) & 2) ? -result : result;
+}
+
+/**
+* sqrtf. The Cortex-M7 has a square root instruction and it is exact, so there is nothing to approximate. The builtin
+* gets the instruction inlined, but nothing builds with -fno-math-errno, so the compiler still checks the operand and
+* calls sqrtf for a negative one to set errno: a compare and a branch that is never taken for valid inputs.
+*/
+inline float FastMath_Sqrt(float x)
+{
+    return __builtin_sqrtf(x);
+}
+
+/**
+* 1 / sqrtf(x) for x > 0, max error 1 ulp. The bit pattern estimate with Newton steps that Madgwick's reference code
+* uses is no faster than VSQRT followed by VDIV on the Cortex-M7 once it has the two steps it needs to get to 5e-6,
+* and with the one step it has it is off by up to 1.8e-3.
+*/
+inline float FastMath_InvSqrt(float x)
+{
+    return 1.0f / __builtin_sqrtf(x);
+}
+
+#endif
+
+#endif
@@ -0,0 +1,115 @@
+/**
+ * OutputMixing_Execute in Q15 or Q31 fixed point, for the safety controller, which has no FPU.
+ *
+ * Percentages are Q values of FIXED_MIXING_FULL_SCALE percent. 100 percent is 25/32 of that, exact in both formats, so
+ * the range checks and the clamp to [-100, 100] percent compare against the same limits as the float version and give
+ * the same error codes and saturated outputs. The channels are those of AttitudeDatatypes.hpp.
+ */
+
+#ifndef FIXED_OUTPUT_MIXING_HPP
+#define FIXED_OUTPUT_MIXING_HPP
+
+#include "FixedPoint.hpp"
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define FIXED_MIXING_FULL_SCALE 128.0f
+
+#ifndef NUM_MIXED_CHANNELS
+    #ifdef SPIKE
+        #define L_TAIL_OUT_CHANNEL 0 // Spike has ruddervators
+        #define R_TAIL_OUT_CHANNEL 1
+    #else
+        #define ELEVATOR_OUT_CHANNEL 0
+        #define RUDDER_OUT_CHANNEL 1
+    #endif
+
+    #define AILERON_OUT_CHANNEL 2
+    #define THROTTLE_OUT_CHANNEL 3
+
+    #define NUM_MIXED_CHANNELS 4
+#endif
+
+// PID_Output_t in fixed point
+template <typename Q>
+struct FixedPID_Output_t
+{
+    Q rollPercent;
+    Q pitchPercent;
+    Q yawPercent;
+    Q throttlePercent;
+};
+
+typedef struct
+{
+    int errorCode;
+
+}FixedOutputMixing_error_t;
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+/**
+* Converts the desired roll, pitch, yaw, and thrust percentages into the percentage each channel should be set to.
+* See OutputMixing_Execute.
+* @param[in]		PidOutput 		pointer to the struct containing the desired attitude percentages.
+* @param[out]		channelOut 		the array (size of NUM_MIXED_CHANNELS) of percentages each channel should be set to.
+* @return							the error struct, 1 when an input is below its range, 2 when one is above.
+*/
+template <typename Q>
+FixedOutputMixing_error_t FixedOutputMixing_Execute(const FixedPID_Output_t<Q> *PidOutput, Q *channelOut)
+{
+    typedef typename FixedPoint_Traits<Q>::Wide Wide;
+
+    const Wide HUNDRED = (FixedPoint_One<Q>() / 32) * 25;
+
+    FixedOutputMixing_error_t error;
+
+    if ( (PidOutput->rollPercent < -HUNDRED) || (PidOutput->pitchPercent < -HUNDRED) || (PidOutput->yawPercent < -HUNDRED) || (PidOutput->throttlePercent < 0) )
+    {
+        error.errorCode = 1;
+    }
+    else if ( (PidOutput->rollPercent > HUNDRED) || (PidOutput->pitchPercent > HUNDRED) || (PidOutput->yawPercent > HUNDRED) || (PidOutput->throttlePercent > HUNDRED) )
+    {
+        error.errorCode = 2;
+    }
+    else
+    {
+        error.errorCode = 0;
+    }
+
+    Wide mixed[NUM_MIXED_CHANNELS];
+
+#ifdef SPIKE
+    // 0.75 of the rudder and of the elevator, as RUDDER_PROPORTION and ELEVATOR_PROPORTION of OutputMixing.cpp
+    mixed[L_TAIL_OUT_CHANNEL] = (3 * ((Wide) PidOutput->yawPercent - (Wide) PidOutput->pitchPercent) + 2) >> 2;
+    mixed[R_TAIL_OUT_CHANNEL] = (3 * ((Wide) PidOutput->yawPercent + (Wide) PidOutput->pitchPercent) + 2) >> 2;
+#else
+    mixed[ELEVATOR_OUT_CHANNEL] = PidOutput->pitchPercent;
+    mixed[RUDDER_OUT_CHANNEL] = PidOutput->yawPercent;
+#endif
+
+    mixed[AILERON_OUT_CHANNEL] = PidOutput->rollPercent;
+    mixed[THROTTLE_OUT_CHANNEL] = PidOutput->throttlePercent;
+
+    for (int i = 0; i < NUM_MIXED_CHANNELS; i++)
+    {
+        if (mixed[i] < -HUNDRED)
+        {
+            mixed[i] = -HUNDRED;
+        }
+        else if (mixed[i] > HUNDRED)
+        {
+            mixed[i] = HUNDRED;
+        }
+
+        channelOut[i] = (Q) mixed[i];
+    }
+
+    return error;
+}
+
+#endif
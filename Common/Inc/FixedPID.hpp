@@ -0,0 +1,143 @@
+/**
+ * PIDController in Q15 or Q31 fixed point, for the safety controller, which has no FPU.
+ *
+ * FixedPIDController<Q> follows PIDController::execute step for step: the same integral clamp, the same finite
+ * difference derivative when no rate is measured and the same output clamp, with the comparisons in the same order so
+ * that inconsistent limits (a negative i_max, min_output above max_output) saturate the same way. The integral and the
+ * history hold exact sums of the quantised inputs, so the only errors against the float version are the quantisation
+ * of the inputs, the gains and the three products.
+ *
+ * desired, actual and actualRate are Q values of inputFullScale, the output is a Q value of outputFullScale. Choose
+ * outputFullScale with headroom above the output limits, eg 128 for percent, as a Q value only reaches 1 - 2^-FRAC_BITS
+ * of full scale. The gains, seen from the full scales, must stay below 2^GAIN_BITS and i_max within 4 input full
+ * scales. Each of the three products is clamped to 2^(FRAC_BITS - 2) output full scales, far outside any output limit,
+ * so that their sum cannot overflow.
+ */
+
+#ifndef FIXED_PID_HPP
+#define FIXED_PID_HPP
+
+#include "FixedPoint.hpp"
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+template <typename Q>
+class FixedPIDController
+{
+    typedef typename FixedPoint_Traits<Q>::Wide Wide;
+
+    public:
+        /**
+        * Initialises the Pid object, see PIDController::PIDController. Converts the gains and limits, the only float
+        * arithmetic of the class.
+        * @param[in]    inputFullScale      The value of 1.0 for desired, actual and actualRate, in the units of the gains.
+        * @param[in]    outputFullScale     The value of 1.0 for the output, in the units of the limits.
+        */
+        FixedPIDController(float _kp, float _ki, float _kd, float _i_max, float _min_output, float _max_output,
+                           float inputFullScale, float outputFullScale);
+
+        /**
+        * Executes a PID computation, computing the derivative from the given measurements. See PIDController::execute.
+        */
+        Q execute(Q desired, Q actual);
+
+        /**
+        * Executes a PID computation with a measured derivative. See PIDController::execute.
+        */
+        Q execute(Q desired, Q actual, Q actualRate);
+
+    private:
+        Q step(Wide error, Wide derivative);
+
+        FixedPoint_Gain_t<Q> kp, ki, kd;
+        Wide i_max;
+        Wide integral;
+        Wide historicalValue[3];
+        Wide min_output;
+        Wide max_output;
+};
+
+template <typename Q>
+FixedPIDController<Q>::FixedPIDController(float _kp, float _ki, float _kd, float _i_max, float _min_output,
+                                          float _max_output, float inputFullScale, float outputFullScale)
+{
+    const float gainScale = inputFullScale / outputFullScale;
+    const float I_MAX_LIMIT = 4.0f;
+
+    kp = FixedPoint_MakeGain<Q>(_kp * gainScale);
+    ki = FixedPoint_MakeGain<Q>(_ki * gainScale);
+    kd = FixedPoint_MakeGain<Q>(_kd * gainScale);
+
+    float scaledIMax = _i_max / inputFullScale;
+    scaledIMax = (scaledIMax > I_MAX_LIMIT) ? I_MAX_LIMIT : ((scaledIMax < -I_MAX_LIMIT) ? -I_MAX_LIMIT : scaledIMax);
+    i_max = FixedPoint_WideFromFloat<Q>(scaledIMax, 1.0f);
+
+    // Limits past the range of Q would never be reached, the saturation to Q is the clamp that applies then
+    min_output = FixedPoint_FromFloat<Q>(_min_output, outputFullScale);
+    max_output = FixedPoint_FromFloat<Q>(_max_output, outputFullScale);
+
+    integral = 0;
+    historicalValue[0] = 0;
+    historicalValue[1] = 0;
+    historicalValue[2] = 0;
+}
+
+template <typename Q>
+Q FixedPIDController<Q>::execute(Q desired, Q actual)
+{
+    historicalValue[2] = historicalValue[1];
+    historicalValue[1] = historicalValue[0];
+    historicalValue[0] = actual;
+
+    // Finite difference approximation gets rid of noise much better than first order derivative computation
+    Wide derivative = ((3 * historicalValue[0]) - (4 * historicalValue[1]) + (historicalValue[2]));
+
+    return step((Wide) desired - (Wide) actual, derivative);
+}
+
+template <typename Q>
+Q FixedPIDController<Q>::execute(Q desired, Q actual, Q actualRate)
+{
+    return step((Wide) desired - (Wide) actual, actualRate);
+}
+
+template <typename Q>
+Q FixedPIDController<Q>::step(Wide error, Wide derivative)
+{
+    const Wide TERM_LIMIT = (Wide) 1 << (2 * FixedPoint_Traits<Q>::FRAC_BITS - 2);
+
+    integral += error;
+
+    // avoid integral windup
+    if (integral < -i_max)
+    {
+        integral = -i_max;
+    }
+    else if (integral > i_max)
+    {
+        integral = i_max;
+    }
+
+    Wide terms[3] = {FixedPoint_Apply(kp, error), FixedPoint_Apply(ki, integral), -FixedPoint_Apply(kd, derivative)};
+    Wide ret = 0;
+
+    for (int i = 0; i < 3; i++)
+    {
+        ret += (terms[i] > TERM_LIMIT) ? TERM_LIMIT : ((terms[i] < -TERM_LIMIT) ? -TERM_LIMIT : terms[i]);
+    }
+
+    if (ret < min_output)
+    {
+        ret = min_output;
+    }
+    else if (ret > max_output)
+    {
+        ret = max_output;
+    }
+
+    return FixedPoint_Saturate<Q>(ret);
+}
+
+#endif
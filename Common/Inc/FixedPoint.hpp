@@ -0,0 +1,144 @@
+/**
+ * Q15 and Q31 fixed point arithmetic for the processors without an FPU, where every float operation is a call into the
+ * software floating point library.
+ *
+ * A Q value stands for value / 2^FRAC_BITS of a full scale the caller chooses, eg 180 degrees or 128 percent. The
+ * arithmetic is done in the Wide type of the format, which a Cortex-M0 has a single cycle multiply for in the Q15 case.
+ *
+ * Gains are kept as a mantissa of GAIN_BITS bits and a right shift, so that gains well above 1 keep their precision and
+ * a product of a gain with a few full scales still fits in Wide. The conversions from float are meant for
+ * initialisation; nothing in the per sample path uses floats.
+ */
+
+#ifndef FIXED_POINT_HPP
+#define FIXED_POINT_HPP
+
+#include <stdint.h>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+
+template <typename Q>
+struct FixedPoint_Traits;
+
+template <>
+struct FixedPoint_Traits<q15_t>
+{
+    typedef int32_t Wide;
+    static const int FRAC_BITS = 15;
+    static const int GAIN_BITS = 12;        // a gain times 8 full scales still fits in 31 bits
+    static const int MAX_SHIFT = 30;
+};
+
+template <>
+struct FixedPoint_Traits<q31_t>
+{
+    typedef int64_t Wide;
+    static const int FRAC_BITS = 31;
+    static const int GAIN_BITS = 28;
+    static const int MAX_SHIFT = 62;
+};
+
+// A gain of mantissa / 2^shift, applied with rounding to nearest
+template <typename Q>
+struct FixedPoint_Gain_t
+{
+    typename FixedPoint_Traits<Q>::Wide mantissa;
+    typename FixedPoint_Traits<Q>::Wide rounding;
+    int shift;
+};
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+template <typename Q>
+inline typename FixedPoint_Traits<Q>::Wide FixedPoint_One()
+{
+    return (typename FixedPoint_Traits<Q>::Wide) 1 << FixedPoint_Traits<Q>::FRAC_BITS;
+}
+
+template <typename Q>
+inline Q FixedPoint_Saturate(typename FixedPoint_Traits<Q>::Wide value)
+{
+    const typename FixedPoint_Traits<Q>::Wide max = FixedPoint_One<Q>() - 1;
+    const typename FixedPoint_Traits<Q>::Wide min = -FixedPoint_One<Q>();
+
+    return (Q) ((value > max) ? max : ((value < min) ? min : value));
+}
+
+/**
+* Converts value, in the units of fullScale, to the Wide type of the format, rounding to nearest. Not saturated to Q,
+* so that limits of a few full scales can be represented.
+*/
+template <typename Q>
+inline typename FixedPoint_Traits<Q>::Wide FixedPoint_WideFromFloat(float value, float fullScale)
+{
+    double scaled = (double) value / (double) fullScale * (double) FixedPoint_One<Q>();
+
+    return (typename FixedPoint_Traits<Q>::Wide) ((scaled < 0.0) ? scaled - 0.5 : scaled + 0.5);
+}
+
+// value, in the units of fullScale, to Q, rounding to nearest and saturating
+template <typename Q>
+inline Q FixedPoint_FromFloat(float value, float fullScale)
+{
+    double scaled = (double) value / (double) fullScale * (double) FixedPoint_One<Q>();
+    double max = (double) (FixedPoint_One<Q>() - 1);
+    double min = -(double) FixedPoint_One<Q>();
+
+    scaled = (scaled > max) ? max : ((scaled < min) ? min : scaled);
+
+    return (Q) ((scaled < 0.0) ? scaled - 0.5 : scaled + 0.5);
+}
+
+template <typename Q>
+inline float FixedPoint_ToFloat(typename FixedPoint_Traits<Q>::Wide value, float fullScale)
+{
+    return (float) ((double) value / (double) FixedPoint_One<Q>() * (double) fullScale);
+}
+
+/**
+* Splits gain into a mantissa of GAIN_BITS bits and a shift. Gains of 2^GAIN_BITS and above saturate, gains too small
+* for MAX_SHIFT lose their low bits.
+*/
+template <typename Q>
+inline FixedPoint_Gain_t<Q> FixedPoint_MakeGain(float gain)
+{
+    typedef typename FixedPoint_Traits<Q>::Wide Wide;
+
+    const double limit = (double) ((Wide) 1 << FixedPoint_Traits<Q>::GAIN_BITS);
+    double magnitude = (gain < 0.0f) ? -(double) gain : (double) gain;
+    int shift = 0;
+
+    while ((shift < FixedPoint_Traits<Q>::MAX_SHIFT) && (magnitude * 2.0 < limit) && (magnitude > 0.0))
+    {
+        magnitude *= 2.0;
+        shift++;
+    }
+
+    magnitude = (magnitude + 0.5 < limit) ? magnitude + 0.5 : limit - 1.0;
+
+    FixedPoint_Gain_t<Q> result;
+    result.mantissa = (gain < 0.0f) ? -(Wide) magnitude : (Wide) magnitude;
+    result.shift = shift;
+    result.rounding = (shift > 0) ? (Wide) 1 << (shift - 1) : 0;
+
+    return result;
+}
+
+/**
+* gain * value, rounded to nearest. value must be within 8 full scales, which keeps the product inside Wide.
+*/
+template <typename Q>
+inline typename FixedPoint_Traits<Q>::Wide FixedPoint_Apply(const FixedPoint_Gain_t<Q> &gain,
+                                                            typename FixedPoint_Traits<Q>::Wide value)
+{
+    return (gain.mantissa * value + gain.rounding) >> gain.shift;
+}
+
+#endif
@@ -4,14 +4,33 @@
 */
 #ifndef INTERCHIP_H
 #define INTERCHIP_H
+
+#include <stdint.h>
+
+/*
+* Both packets are exchanged in the same full duplex transfer, so they must stay the same size.
+* sequence and crc are sealed by InterchipFraming_Seal just before the packet goes on the wire, crc covers every
+* byte before it and must stay the last field. ack_sequence and crc_errors let each end see how the link looks from
+* the other one (see InterchipStats.h).
+*/
 typedef struct {
 	int16_t PWM[12];
 	uint16_t autonomous_level;
+	uint16_t sequence;
+	uint16_t ack_sequence;		// one more than the sequence number of the last good packet received, 0 before any
+	uint16_t crc_errors;		// packets the sender dropped for a bad CRC, wrapping
+	uint32_t sample_time_us;	// unused for now, keeps the packets the same size
+	uint32_t crc;
 } Interchip_StoA_Packet;    //Safety to Autopilot packet
 
 typedef struct {
 	int16_t PWM[12];
 	uint16_t autonomous_level;
+	uint16_t sequence;
+	uint16_t ack_sequence;		// one more than the sequence number of the last good packet received, 0 before any
+	uint16_t crc_errors;		// packets the sender dropped for a bad CRC, wrapping
+	uint32_t sample_time_us;	// Autopilot time stamp of the IMU sample the PWM values were computed from
+	uint32_t crc;
 } Interchip_AtoS_Packet;    //Autopilot to Safety packet
 
-#endif
\ No newline at end of file
+#endif
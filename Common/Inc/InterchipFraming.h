@@ -0,0 +1,108 @@
+/**
+ * Seals and checks the sequence number and CRC of the interchip packets in Interchip.h.
+ *
+ * The CRC is CRC-32/MPEG-2: polynomial 0x04C11DB7, initial value 0xFFFFFFFF, no reflection and no final XOR, over
+ * the bytes of the packet as they sit in memory. That is what the STM32 CRC unit computes in its default
+ * configuration with byte input, so either end can pass HAL_CRC_Calculate in, and the host tests pass
+ * InterchipFraming_SoftwareCrc.
+ */
+
+#ifndef INTERCHIP_FRAMING_H
+#define INTERCHIP_FRAMING_H
+
+#include "Interchip.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define INTERCHIP_PACKET_SIZE sizeof(Interchip_AtoS_Packet)
+#define INTERCHIP_SEQUENCE_OFFSET offsetof(Interchip_AtoS_Packet, sequence)
+#define INTERCHIP_CRC_OFFSET offsetof(Interchip_AtoS_Packet, crc)
+
+// Both packets go through the same functions, so they need the same size and the framing fields in the same places
+typedef char InterchipFraming_SizesMatch[(sizeof(Interchip_AtoS_Packet) == sizeof(Interchip_StoA_Packet)) ? 1 : -1];
+typedef char InterchipFraming_SequencesMatch[(offsetof(Interchip_AtoS_Packet, sequence) == offsetof(Interchip_StoA_Packet, sequence)) ? 1 : -1];
+typedef char InterchipFraming_CrcIsLast[(offsetof(Interchip_StoA_Packet, crc) + sizeof(uint32_t) == sizeof(Interchip_StoA_Packet)) ? 1 : -1];
+
+#define INTERCHIP_CRC_POLYNOMIAL 0x04C11DB7u
+#define INTERCHIP_CRC_INITIAL 0xFFFFFFFFu
+
+// Any function computing CRC-32/MPEG-2 over length bytes
+typedef uint32_t (*InterchipCrc_t)(const uint8_t *data, uint32_t length);
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+/**
+* Bit at a time, for the host and as a reference for the hardware unit.
+* @param[in]    data        length bytes.
+* @return                   the CRC-32/MPEG-2 of data.
+*/
+static inline uint32_t InterchipFraming_SoftwareCrc(const uint8_t *data, uint32_t length)
+{
+	uint32_t crc = INTERCHIP_CRC_INITIAL;
+
+	for (uint32_t i = 0; i < length; i++)
+	{
+		crc ^= (uint32_t) data[i] << 24;
+
+		for (int bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 0x80000000u) ? (crc << 1) ^ INTERCHIP_CRC_POLYNOMIAL : (crc << 1);
+		}
+	}
+
+	return crc;
+}
+
+/**
+* Writes the sequence number into a packet and then the CRC of everything before the crc field.
+* @param[in,out]    packet      an Interchip_AtoS_Packet or an Interchip_StoA_Packet.
+*/
+static inline void InterchipFraming_Seal(void *packet, uint16_t sequence, InterchipCrc_t crc)
+{
+	uint8_t *bytes = (uint8_t *) packet;
+
+	memcpy(bytes + INTERCHIP_SEQUENCE_OFFSET, &sequence, sizeof(sequence));
+
+	uint32_t value = crc(bytes, INTERCHIP_CRC_OFFSET);
+	memcpy(bytes + INTERCHIP_CRC_OFFSET, &value, sizeof(value));
+}
+
+/**
+* @param[in]    packet      an Interchip_AtoS_Packet or an Interchip_StoA_Packet, as it came off the wire.
+* @return                   1 if the crc field matches the rest of the packet.
+*/
+static inline int InterchipFraming_Check(const void *packet, InterchipCrc_t crc)
+{
+	const uint8_t *bytes = (const uint8_t *) packet;
+	uint32_t received;
+
+	memcpy(&received, bytes + INTERCHIP_CRC_OFFSET, sizeof(received));
+
+	return crc(bytes, INTERCHIP_CRC_OFFSET) == received;
+}
+
+static inline uint16_t InterchipFraming_GetSequence(const void *packet)
+{
+	uint16_t sequence;
+	memcpy(&sequence, (const uint8_t *) packet + INTERCHIP_SEQUENCE_OFFSET, sizeof(sequence));
+
+	return sequence;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
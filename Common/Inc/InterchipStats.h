@@ -0,0 +1,169 @@
+/**
+ * Link statistics for either end of the interchip link.
+ *
+ * Each end counts what it sees: the transfers it starts and how they end, the packets it receives and what is wrong
+ * with them. Two fields of every packet carry the other end's view across:
+ *  - ack_sequence  one more than the sequence number of the last good packet received. Every time it moves on, the
+ *                  packet it acknowledges is looked up among the last INTERCHIP_SEND_HISTORY sent, and the time since
+ *                  that one was sent goes into the round trip histogram.
+ *  - crc_errors    the other end's CRC error count, as peerCrcErrors.
+ * On a full duplex link a reply comes back one transfer after the packet it acknowledges at the earliest, so the
+ * round trip time includes the interval between transfers.
+ *
+ * Header only, so that both chips can use it without sharing a build.
+ */
+
+#ifndef INTERCHIP_STATS_H
+#define INTERCHIP_STATS_H
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+#define INTERCHIP_RTT_BINS 16
+#define INTERCHIP_RTT_BIN_WIDTH_US 2000     // 32 ms of range, anything slower lands in the last bin
+#define INTERCHIP_SEND_HISTORY 16           // a power of 2
+
+// What telemetry reports
+typedef struct {
+	uint32_t transfers;             // started
+	uint32_t failedTransfers;       // ended in an SPI or DMA error, or were aborted
+	uint32_t retries;               // started right after a failed one
+	uint32_t received;              // packets that passed their check
+	uint32_t crcErrors;
+	uint32_t repeats;               // the other end sent the same sequence number again
+	uint32_t gaps;                  // the other end's sequence number skipped ahead
+	uint32_t lostPackets;           // sequence numbers skipped over all the gaps
+	uint32_t peerCrcErrors;         // the other end's crcErrors, as last reported, modulo 2^16
+
+	uint32_t rttHistogram[INTERCHIP_RTT_BINS];
+	uint32_t rttSamples;
+	uint32_t rttLatestUs, rttMinUs, rttMaxUs;
+} InterchipLinkStats_t;
+
+typedef struct {
+	InterchipLinkStats_t counters;
+
+	uint32_t sendTimeUs[INTERCHIP_SEND_HISTORY];
+	uint16_t sendSequence[INTERCHIP_SEND_HISTORY];
+	uint8_t sendValid[INTERCHIP_SEND_HISTORY];
+
+	uint16_t lastPeerSequence;
+	uint16_t lastAck;
+	uint8_t hasPeer;
+	uint8_t lastTransferFailed;
+} InterchipStats_t;
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+static inline void InterchipStats_Init(InterchipStats_t *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+	stats->counters.rttMinUs = UINT32_MAX;
+}
+
+/**
+* @param[in]    sequence    of the packet going out.
+* @param[in]    nowUs       when the transfer starts.
+*/
+static inline void InterchipStats_OnSend(InterchipStats_t *stats, uint16_t sequence, uint32_t nowUs)
+{
+	uint32_t slot = sequence & (INTERCHIP_SEND_HISTORY - 1);
+
+	stats->sendTimeUs[slot] = nowUs;
+	stats->sendSequence[slot] = sequence;
+	stats->sendValid[slot] = 1;
+
+	stats->counters.transfers++;
+	stats->counters.retries += stats->lastTransferFailed;
+	stats->lastTransferFailed = 0;
+}
+
+static inline void InterchipStats_OnTransferFailed(InterchipStats_t *stats)
+{
+	stats->counters.failedTransfers++;
+	stats->lastTransferFailed = 1;
+}
+
+static inline void InterchipStats_OnCrcError(InterchipStats_t *stats)
+{
+	stats->counters.crcErrors++;
+}
+
+/**
+* For a packet that passed its check.
+* @param[in]    sequence, ackSequence, peerCrcErrors    the fields of the same names in the packet.
+* @param[in]    nowUs                                   when the transfer that brought it in ended.
+*/
+static inline void InterchipStats_OnReceive(InterchipStats_t *stats, uint16_t sequence, uint16_t ackSequence,
+                                            uint16_t peerCrcErrors, uint32_t nowUs)
+{
+	InterchipLinkStats_t *counters = &stats->counters;
+
+	counters->received++;
+	counters->peerCrcErrors = peerCrcErrors;
+
+	if (stats->hasPeer)
+	{
+		uint16_t step = (uint16_t) (sequence - stats->lastPeerSequence);
+
+		if (step == 0)
+		{
+			counters->repeats++;
+		}
+		else if (step > 1)
+		{
+			counters->gaps++;
+			counters->lostPackets += step - 1u;
+		}
+	}
+
+	stats->lastPeerSequence = sequence;
+	stats->hasPeer = 1;
+
+	if ((ackSequence == 0) || (ackSequence == stats->lastAck))
+	{
+		return;
+	}
+
+	stats->lastAck = ackSequence;
+
+	uint16_t acknowledged = (uint16_t) (ackSequence - 1u);
+	uint32_t slot = acknowledged & (INTERCHIP_SEND_HISTORY - 1);
+
+	// Older than the history, the slot has been reused since
+	if ( ! stats->sendValid[slot] || (stats->sendSequence[slot] != acknowledged))
+	{
+		return;
+	}
+
+	uint32_t rttUs = nowUs - stats->sendTimeUs[slot];
+	uint32_t bin = rttUs / INTERCHIP_RTT_BIN_WIDTH_US;
+
+	counters->rttHistogram[(bin < INTERCHIP_RTT_BINS) ? bin : INTERCHIP_RTT_BINS - 1]++;
+	counters->rttSamples++;
+	counters->rttLatestUs = rttUs;
+	counters->rttMinUs = (rttUs < counters->rttMinUs) ? rttUs : counters->rttMinUs;
+	counters->rttMaxUs = (rttUs > counters->rttMaxUs) ? rttUs : counters->rttMaxUs;
+}
+
+// What goes into the ack_sequence of the next packet sent
+static inline uint16_t InterchipStats_GetAckSequence(const InterchipStats_t *stats)
+{
+	return stats->hasPeer ? (uint16_t) (stats->lastPeerSequence + 1u) : 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
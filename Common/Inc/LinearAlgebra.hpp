@@ -0,0 +1,488 @@
+/**
+ * Fixed size vectors, matrices and quaternions for the estimators, guidance and mixing.
+ *
+ * The dimensions are template parameters, the storage is a plain array inside the object and every loop has a
+ * compile time trip count, so nothing is allocated and the compiler is free to unroll. With optimisation turned on
+ * the small cases (Vec<3>, Mat<3, 3>, Quat) compile to the same code as the hand written scalar versions, see
+ * Bench_LinearAlgebra.cpp.
+ *
+ * The types are aggregates, so they can be brace initialised (Vec<3> v = {1.0f, 0.0f, 0.0f};) and are trivially
+ * copyable. Matrices are row major.
+ */
+
+#ifndef LINEAR_ALGEBRA_HPP
+#define LINEAR_ALGEBRA_HPP
+
+#include <math.h>
+#include <stddef.h>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+// GCC only fully unrolls short loops at -O3. The products ask for it so that -O2, which the autopilot is built with,
+// gives the same straight line code as writing the sums out by hand.
+#if defined(__GNUC__) && !defined(__clang__)
+#define LINEAR_ALGEBRA_UNROLL _Pragma("GCC unroll 16")
+#else
+#define LINEAR_ALGEBRA_UNROLL
+#endif
+
+/***********************************************************************************************************************
+ * Vectors
+ **********************************************************************************************************************/
+
+template <size_t N>
+struct Vec
+{
+    float v[N];
+
+    static constexpr size_t size() {return N;}
+
+    float& operator[](size_t i) {return v[i];}
+    float operator[](size_t i) const {return v[i];}
+
+    static Vec zeros()
+    {
+        Vec result;
+
+        for (size_t i = 0; i < N; i++)
+        {
+            result.v[i] = 0.0f;
+        }
+
+        return result;
+    }
+
+    static Vec fromArray(const float values[N])
+    {
+        Vec result;
+
+        for (size_t i = 0; i < N; i++)
+        {
+            result.v[i] = values[i];
+        }
+
+        return result;
+    }
+
+    void toArray(float values[N]) const
+    {
+        for (size_t i = 0; i < N; i++)
+        {
+            values[i] = v[i];
+        }
+    }
+
+    Vec& operator+=(const Vec &other)
+    {
+        for (size_t i = 0; i < N; i++)
+        {
+            v[i] += other.v[i];
+        }
+
+        return *this;
+    }
+
+    Vec& operator-=(const Vec &other)
+    {
+        for (size_t i = 0; i < N; i++)
+        {
+            v[i] -= other.v[i];
+        }
+
+        return *this;
+    }
+
+    Vec& operator*=(float scale)
+    {
+        for (size_t i = 0; i < N; i++)
+        {
+            v[i] *= scale;
+        }
+
+        return *this;
+    }
+};
+
+typedef Vec<2> Vec2;
+typedef Vec<3> Vec3;
+
+template <size_t N>
+Vec<N> operator+(Vec<N> a, const Vec<N> &b) {return a += b;}
+
+template <size_t N>
+Vec<N> operator-(Vec<N> a, const Vec<N> &b) {return a -= b;}
+
+template <size_t N>
+Vec<N> operator-(Vec<N> a) {return a *= -1.0f;}
+
+template <size_t N>
+Vec<N> operator*(Vec<N> a, float scale) {return a *= scale;}
+
+template <size_t N>
+Vec<N> operator*(float scale, Vec<N> a) {return a *= scale;}
+
+// Multiplies by the reciprocal, like the hand written code does
+template <size_t N>
+Vec<N> operator/(Vec<N> a, float divisor) {return a *= 1.0f / divisor;}
+
+template <size_t N>
+float dot(const Vec<N> &a, const Vec<N> &b)
+{
+    float sum = a.v[0] * b.v[0];
+
+    LINEAR_ALGEBRA_UNROLL
+    for (size_t i = 1; i < N; i++)
+    {
+        sum += a.v[i] * b.v[i];
+    }
+
+    return sum;
+}
+
+template <size_t N>
+float normSquared(const Vec<N> &a) {return dot(a, a);}
+
+template <size_t N>
+float norm(const Vec<N> &a) {return sqrtf(dot(a, a));}
+
+template <size_t N>
+float distance(const Vec<N> &a, const Vec<N> &b) {return norm(a - b);}
+
+// The zero vector stays zero rather than becoming NaN
+template <size_t N>
+Vec<N> normalized(const Vec<N> &a)
+{
+    float length = norm(a);
+    return (length > 0.0f) ? a / length : a;
+}
+
+inline Vec3 cross(const Vec3 &a, const Vec3 &b)
+{
+    Vec3 result = {{a.v[1] * b.v[2] - a.v[2] * b.v[1],
+                    a.v[2] * b.v[0] - a.v[0] * b.v[2],
+                    a.v[0] * b.v[1] - a.v[1] * b.v[0]}};
+    return result;
+}
+
+/***********************************************************************************************************************
+ * Matrices
+ **********************************************************************************************************************/
+
+template <size_t ROWS, size_t COLS>
+struct Mat
+{
+    float m[ROWS][COLS];
+
+    static constexpr size_t rows() {return ROWS;}
+    static constexpr size_t cols() {return COLS;}
+
+    float& operator()(size_t row, size_t col) {return m[row][col];}
+    float operator()(size_t row, size_t col) const {return m[row][col];}
+
+    static Mat zeros()
+    {
+        Mat result;
+
+        for (size_t row = 0; row < ROWS; row++)
+        {
+            for (size_t col = 0; col < COLS; col++)
+            {
+                result.m[row][col] = 0.0f;
+            }
+        }
+
+        return result;
+    }
+
+    static Mat identity()
+    {
+        Mat result = zeros();
+
+        for (size_t i = 0; i < ROWS && i < COLS; i++)
+        {
+            result.m[i][i] = 1.0f;
+        }
+
+        return result;
+    }
+
+    // Copies a smaller matrix in with its top left corner at (row, col)
+    template <size_t BLOCK_ROWS, size_t BLOCK_COLS>
+    void setBlock(size_t row, size_t col, const Mat<BLOCK_ROWS, BLOCK_COLS> &block)
+    {
+        for (size_t i = 0; i < BLOCK_ROWS; i++)
+        {
+            for (size_t j = 0; j < BLOCK_COLS; j++)
+            {
+                m[row + i][col + j] = block.m[i][j];
+            }
+        }
+    }
+
+    template <size_t BLOCK_ROWS, size_t BLOCK_COLS>
+    Mat<BLOCK_ROWS, BLOCK_COLS> block(size_t row, size_t col) const
+    {
+        Mat<BLOCK_ROWS, BLOCK_COLS> result;
+
+        for (size_t i = 0; i < BLOCK_ROWS; i++)
+        {
+            for (size_t j = 0; j < BLOCK_COLS; j++)
+            {
+                result.m[i][j] = m[row + i][col + j];
+            }
+        }
+
+        return result;
+    }
+
+    Mat<COLS, ROWS> transposed() const
+    {
+        Mat<COLS, ROWS> result;
+
+        for (size_t row = 0; row < ROWS; row++)
+        {
+            for (size_t col = 0; col < COLS; col++)
+            {
+                result.m[col][row] = m[row][col];
+            }
+        }
+
+        return result;
+    }
+
+    Mat& operator+=(const Mat &other)
+    {
+        for (size_t row = 0; row < ROWS; row++)
+        {
+            for (size_t col = 0; col < COLS; col++)
+            {
+                m[row][col] += other.m[row][col];
+            }
+        }
+
+        return *this;
+    }
+
+    Mat& operator-=(const Mat &other)
+    {
+        for (size_t row = 0; row < ROWS; row++)
+        {
+            for (size_t col = 0; col < COLS; col++)
+            {
+                m[row][col] -= other.m[row][col];
+            }
+        }
+
+        return *this;
+    }
+
+    Mat& operator*=(float scale)
+    {
+        for (size_t row = 0; row < ROWS; row++)
+        {
+            for (size_t col = 0; col < COLS; col++)
+            {
+                m[row][col] *= scale;
+            }
+        }
+
+        return *this;
+    }
+};
+
+typedef Mat<3, 3> Mat3;
+
+template <size_t ROWS, size_t COLS>
+Mat<ROWS, COLS> operator+(Mat<ROWS, COLS> a, const Mat<ROWS, COLS> &b) {return a += b;}
+
+template <size_t ROWS, size_t COLS>
+Mat<ROWS, COLS> operator-(Mat<ROWS, COLS> a, const Mat<ROWS, COLS> &b) {return a -= b;}
+
+template <size_t ROWS, size_t COLS>
+Mat<ROWS, COLS> operator*(Mat<ROWS, COLS> a, float scale) {return a *= scale;}
+
+template <size_t ROWS, size_t COLS>
+Mat<ROWS, COLS> operator*(float scale, Mat<ROWS, COLS> a) {return a *= scale;}
+
+// Each element is summed in a register and stored once, which is what the hand written loops do. The sums start
+// from the first term rather than from 0, since adding 0.0f is not something the compiler may drop.
+template <size_t ROWS, size_t INNER, size_t COLS>
+Mat<ROWS, COLS> operator*(const Mat<ROWS, INNER> &a, const Mat<INNER, COLS> &b)
+{
+    Mat<ROWS, COLS> result;
+
+    for (size_t row = 0; row < ROWS; row++)
+    {
+        for (size_t col = 0; col < COLS; col++)
+        {
+            float sum = a.m[row][0] * b.m[0][col];
+
+            LINEAR_ALGEBRA_UNROLL
+            for (size_t i = 1; i < INNER; i++)
+            {
+                sum += a.m[row][i] * b.m[i][col];
+            }
+
+            result.m[row][col] = sum;
+        }
+    }
+
+    return result;
+}
+
+template <size_t ROWS, size_t COLS>
+Vec<ROWS> operator*(const Mat<ROWS, COLS> &a, const Vec<COLS> &x)
+{
+    Vec<ROWS> result;
+
+    for (size_t row = 0; row < ROWS; row++)
+    {
+        float sum = a.m[row][0] * x.v[0];
+
+        LINEAR_ALGEBRA_UNROLL
+        for (size_t col = 1; col < COLS; col++)
+        {
+            sum += a.m[row][col] * x.v[col];
+        }
+
+        result.v[row] = sum;
+    }
+
+    return result;
+}
+
+// a * b^T, without forming the transpose. Both operands are walked along their rows.
+template <size_t ROWS, size_t INNER, size_t COLS>
+Mat<ROWS, COLS> multiplyTransposed(const Mat<ROWS, INNER> &a, const Mat<COLS, INNER> &b)
+{
+    Mat<ROWS, COLS> result;
+
+    for (size_t row = 0; row < ROWS; row++)
+    {
+        for (size_t col = 0; col < COLS; col++)
+        {
+            float sum = a.m[row][0] * b.m[col][0];
+
+            LINEAR_ALGEBRA_UNROLL
+            for (size_t i = 1; i < INNER; i++)
+            {
+                sum += a.m[row][i] * b.m[col][i];
+            }
+
+            result.m[row][col] = sum;
+        }
+    }
+
+    return result;
+}
+
+// The matrix that does the cross product with a from the left, skew(a) * b == cross(a, b)
+inline Mat3 skew(const Vec3 &a)
+{
+    Mat3 result = {{{0.0f, -a.v[2], a.v[1]},
+                    {a.v[2], 0.0f, -a.v[0]},
+                    {-a.v[1], a.v[0], 0.0f}}};
+    return result;
+}
+
+/***********************************************************************************************************************
+ * Quaternions
+ **********************************************************************************************************************/
+
+// w is the scalar part. Used as a rotation it takes vectors from the body frame to the earth frame.
+struct Quat
+{
+    float w;
+    float x;
+    float y;
+    float z;
+
+    static Quat identity()
+    {
+        Quat result = {1.0f, 0.0f, 0.0f, 0.0f};
+        return result;
+    }
+
+    static Quat fromArray(const float q[4])
+    {
+        Quat result = {q[0], q[1], q[2], q[3]};
+        return result;
+    }
+
+    void toArray(float q[4]) const
+    {
+        q[0] = w;
+        q[1] = x;
+        q[2] = y;
+        q[3] = z;
+    }
+
+    // The rotation by |angle| about angle, for instance the gyro times the time step
+    static Quat fromRotationVector(const Vec3 &angle)
+    {
+        float length = norm(angle);
+
+        // Below this sin(length / 2) / length is 1/2 to float precision
+        if (length < 1e-6f)
+        {
+            Quat result = {1.0f, 0.5f * angle.v[0], 0.5f * angle.v[1], 0.5f * angle.v[2]};
+            return result;
+        }
+
+        float scale = sinf(0.5f * length) / length;
+        Quat result = {cosf(0.5f * length), angle.v[0] * scale, angle.v[1] * scale, angle.v[2] * scale};
+        return result;
+    }
+
+    Quat conjugate() const
+    {
+        Quat result = {w, -x, -y, -z};
+        return result;
+    }
+
+    Vec3 vector() const
+    {
+        Vec3 result = {{x, y, z}};
+        return result;
+    }
+
+    float normSquared() const {return w * w + x * x + y * y + z * z;}
+
+    Quat normalized() const
+    {
+        float recipNorm = 1.0f / sqrtf(normSquared());
+        Quat result = {w * recipNorm, x * recipNorm, y * recipNorm, z * recipNorm};
+        return result;
+    }
+
+    Mat3 toRotationMatrix() const
+    {
+        Mat3 R = {{{1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y - w * z), 2.0f * (x * z + w * y)},
+                   {2.0f * (x * y + w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z - w * x)},
+                   {2.0f * (x * z - w * y), 2.0f * (y * z + w * x), 1.0f - 2.0f * (x * x + y * y)}}};
+        return R;
+    }
+
+    // q * v * q^-1 for a unit quaternion, without building the matrix
+    Vec3 rotate(const Vec3 &v) const
+    {
+        Vec3 u = vector();
+        Vec3 t = cross(u, v) * 2.0f;
+
+        return v + t * w + cross(u, t);
+    }
+};
+
+// Hamilton product, a * b applies b first
+inline Quat operator*(const Quat &a, const Quat &b)
+{
+    Quat result = {a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+                   a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                   a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+                   a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w};
+    return result;
+}
+
+#endif
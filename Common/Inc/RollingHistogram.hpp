@@ -0,0 +1,125 @@
+/**
+ * Histogram over the most recent WINDOW samples.
+ *
+ * Samples fall into NUM_BINS bins of equal width, the last bin also catches everything above its lower edge. The
+ * bin of every sample in the window is kept in a ring, so the oldest sample can be taken back out when a new one
+ * comes in. Adding a sample is O(1), percentiles are O(NUM_BINS). No heap is used.
+ *
+ * Percentiles and the maximum are reported as the upper edge of the bin they fall in. Within the range of the bins
+ * that is never optimistic by more than one bin width. Past it they are capped: anything in the last bin reads as
+ * NUM_BINS * binWidth, however large it was. Only getLatest() gives a sample exactly.
+ */
+
+#ifndef ROLLING_HISTOGRAM_HPP
+#define ROLLING_HISTOGRAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+template <size_t NUM_BINS, size_t WINDOW>
+class RollingHistogram
+{
+    public:
+        explicit RollingHistogram(uint32_t _binWidth) : binWidth(_binWidth) {reset();}
+
+        void reset()
+        {
+            for (size_t i = 0; i < NUM_BINS; i++)
+            {
+                counts[i] = 0;
+            }
+
+            head = 0;
+            size = 0;
+            latest = 0;
+            totalAdded = 0;
+        }
+
+        void add(uint32_t value)
+        {
+            uint32_t bin = value / binWidth;
+            bin = (bin < NUM_BINS) ? bin : NUM_BINS - 1;
+
+            if (size == WINDOW)
+            {
+                counts[ring[head]]--;
+            }
+            else
+            {
+                size++;
+            }
+
+            ring[head] = (BinIndex) bin;
+            counts[bin]++;
+            head = (head + 1) % WINDOW;
+
+            latest = value;
+            totalAdded++;
+        }
+
+        /**
+        * @param[in]    percent     0 to 100.
+        * @return                   the value below which percent of the window falls, 0 if the window is empty.
+        */
+        uint32_t percentile(uint32_t percent) const
+        {
+            if (size == 0)
+            {
+                return 0;
+            }
+
+            // rank of the sample we are looking for, rounded up so the 100th percentile is the largest sample
+            uint32_t rank = (uint32_t) ((size * percent + 99) / 100);
+            rank = (rank == 0) ? 1 : rank;
+
+            uint32_t seen = 0;
+
+            for (size_t i = 0; i < NUM_BINS; i++)
+            {
+                seen += counts[i];
+
+                if (seen >= rank)
+                {
+                    return upperEdge(i);
+                }
+            }
+
+            return upperEdge(NUM_BINS - 1);
+        }
+
+        uint32_t max() const {return percentile(100);}
+
+        uint32_t getBinCount(size_t bin) const {return counts[bin];}
+        uint32_t getBinWidth() const {return binWidth;}
+        size_t getWindowSize() const {return size;}
+
+        uint32_t getLatest() const {return latest;}         // last sample exactly as it was added
+        uint32_t getTotalAdded() const {return totalAdded;} // including the ones that left the window
+
+    private:
+        static_assert(NUM_BINS > 0 && NUM_BINS <= 256, "Bin indices are stored in a byte");
+        static_assert(WINDOW > 0, "The window must hold at least one sample");
+
+        typedef uint8_t BinIndex;
+        typedef uint16_t BinCount;
+
+        static_assert(WINDOW <= UINT16_MAX, "Bin counts are 16 bits");
+
+        uint32_t upperEdge(size_t bin) const {return (uint32_t) (bin + 1) * binWidth;}
+
+        const uint32_t binWidth;
+
+        BinCount counts[NUM_BINS];
+        BinIndex ring[WINDOW];
+        size_t head;
+        size_t size;
+
+        uint32_t latest;
+        uint32_t totalAdded;
+};
+
+#endif
@@ -0,0 +1,191 @@
+/**
+ * Single writer, multi reader topics protected by a sequence lock.
+ *
+ * A topic holds the latest value of a structure that exactly one task publishes and that any number of other
+ * tasks read. Neither side ever blocks: the writer bumps a sequence counter around its copy and a reader retries
+ * its copy if the counter shows that the writer touched the value in the meantime. No mutexes and no heap are used.
+ *
+ * The sequence counter is odd while a publish is in progress. Every completed publish increments the generation
+ * (sequence / 2), so readers can tell fresh data from data they have already seen. Generation 0 means that
+ * nothing has been published yet.
+ *
+ * The payload is stored as an array of relaxed atomic words, which compile down to plain loads and stores on the
+ * Cortex-M but keep the concurrent accesses well defined. T must be trivially copyable.
+ */
+
+#ifndef SEQLOCK_TOPIC_HPP
+#define SEQLOCK_TOPIC_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/***********************************************************************************************************************
+ * Definitions
+ **********************************************************************************************************************/
+
+// A reader that keeps colliding with the writer gives up after this many attempts rather than spinning forever.
+// This matters on a single core, where a high priority reader that preempted the writer mid publish would otherwise
+// never let the writer finish.
+#define SEQLOCK_MAX_READ_ATTEMPTS 8
+
+enum _SeqlockReadStatus {SEQLOCK_READ_NEW = 0, SEQLOCK_READ_STALE, SEQLOCK_READ_EMPTY, SEQLOCK_READ_BUSY};
+
+/***********************************************************************************************************************
+ * Code
+ **********************************************************************************************************************/
+
+template <typename T>
+class SeqlockTopic
+{
+    public:
+        SeqlockTopic() : sequence(0)
+        {
+            for (size_t i = 0; i < NUM_WORDS; i++)
+            {
+                words[i].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+        * Replaces the value of the topic. Must only ever be called from one task (or interrupt).
+        * @param[in]    value       The new value.
+        */
+        void publish(const T &value)
+        {
+            uint32_t buffer[NUM_WORDS];
+            buffer[NUM_WORDS - 1] = 0;
+            memcpy(buffer, &value, sizeof(T));
+
+            uint32_t seq = sequence.load(std::memory_order_relaxed);
+
+            sequence.store(seq + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            for (size_t i = 0; i < NUM_WORDS; i++)
+            {
+                words[i].store(buffer[i], std::memory_order_relaxed);
+            }
+
+            sequence.store(seq + 2, std::memory_order_release);
+        }
+
+        /**
+        * Takes a consistent snapshot of the topic. Safe to call from any number of tasks.
+        * @param[out]   value       Receives the snapshot. Left untouched if the read fails.
+        * @param[out]   generation  Optional. Receives the generation of the snapshot (0 if nothing was published yet).
+        * @return                   false if no consistent snapshot could be taken within SEQLOCK_MAX_READ_ATTEMPTS.
+        */
+        bool read(T &value, uint32_t *generation = nullptr) const
+        {
+            uint32_t buffer[NUM_WORDS];
+
+            for (int attempt = 0; attempt < SEQLOCK_MAX_READ_ATTEMPTS; attempt++)
+            {
+                uint32_t before = sequence.load(std::memory_order_acquire);
+
+                if (before & 1u)
+                {
+                    continue; // publish in progress
+                }
+
+                for (size_t i = 0; i < NUM_WORDS; i++)
+                {
+                    buffer[i] = words[i].load(std::memory_order_relaxed);
+                }
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if (sequence.load(std::memory_order_relaxed) == before)
+                {
+                    memcpy(&value, buffer, sizeof(T));
+
+                    if (generation != nullptr)
+                    {
+                        *generation = before >> 1;
+                    }
+
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        /**
+        * @return the number of completed publishes.
+        */
+        uint32_t getGeneration() const {return sequence.load(std::memory_order_acquire) >> 1;}
+
+    private:
+        static_assert(std::is_trivially_copyable<T>::value, "Seqlock topics can only carry trivially copyable types");
+
+        static const size_t NUM_WORDS = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+        SeqlockTopic(const SeqlockTopic& other);
+        SeqlockTopic& operator =(const SeqlockTopic& other);
+
+        std::atomic<uint32_t> sequence;
+        std::atomic<uint32_t> words[NUM_WORDS];
+};
+
+/**
+ * Remembers which generation of a topic a reader has already consumed, so it can tell fresh data from stale data.
+ * Each reading task owns its own subscriber.
+ */
+template <typename T>
+class SeqlockSubscriber
+{
+    public:
+        explicit SeqlockSubscriber(const SeqlockTopic<T> &_topic) : topic(_topic), lastGeneration(0), missed(0) {}
+
+        /**
+        * Reads the latest value of the topic.
+        * @param[out]   value       Receives the snapshot, unless SEQLOCK_READ_BUSY is returned.
+        * @return                   SEQLOCK_READ_NEW if the value was published since the last poll,
+        *                           SEQLOCK_READ_STALE if it was already seen, SEQLOCK_READ_EMPTY if nothing was
+        *                           published yet and SEQLOCK_READ_BUSY if the writer kept the topic busy.
+        */
+        _SeqlockReadStatus poll(T &value)
+        {
+            uint32_t generation;
+
+            if (!topic.read(value, &generation))
+            {
+                return SEQLOCK_READ_BUSY;
+            }
+
+            if (generation == 0)
+            {
+                return SEQLOCK_READ_EMPTY;
+            }
+
+            if (generation == lastGeneration)
+            {
+                return SEQLOCK_READ_STALE;
+            }
+
+            if (lastGeneration != 0)
+            {
+                missed += generation - lastGeneration - 1;
+            }
+
+            lastGeneration = generation;
+
+            return SEQLOCK_READ_NEW;
+        }
+
+        /**
+        * @return the number of publishes that were overwritten before this subscriber got to see them.
+        */
+        uint32_t getMissedCount() const {return missed;}
+
+    private:
+        const SeqlockTopic<T> &topic;
+        uint32_t lastGeneration;
+        uint32_t missed;
+};
+
+#endif